@@ -351,6 +351,9 @@ namespace OpenPSTD
                     ("wave-length", value<float>(), "help")
                     ("time-step", value<float>(), "help")
                     ("rk-coefficients", value<std::vector<float>>()->multitoken(), "help")
+                    ("frame-storage", value<std::string>(), "storage of the result frames: raw, lossless or visualization")
+                    ("visualization-error-bound", value<float>(),
+                     "maximum error of the visualization frame storage in dB relative to the frame peak (e.g. -60)")
                 //todo fix these arguments
                 //("window", value<Eigen::ArrayXf>(), "help")
                     ;
@@ -380,6 +383,20 @@ namespace OpenPSTD
             if (input.count("rk-coefficients") > 0)
                 model->Settings.SetRKCoefficients(input["rk-coefficients"].as<std::vector<float>>());
             //if(input.count("window") > 0) model->Settings.SetWindow(input["window"].as<Eigen::ArrayXf>());
+            if (input.count("frame-storage") > 0)
+            {
+                std::string storage = input["frame-storage"].as<std::string>();
+                if (storage == "raw")
+                    model->Settings.SetFrameStorage(Kernel::FRAMESTORAGE::RAW);
+                else if (storage == "lossless")
+                    model->Settings.SetFrameStorage(Kernel::FRAMESTORAGE::LOSSLESS);
+                else if (storage == "visualization")
+                    model->Settings.SetFrameStorage(Kernel::FRAMESTORAGE::VISUALIZATION);
+                else
+                    throw po::validation_error(po::validation_error::invalid_option_value, "frame-storage", storage);
+            }
+            if (input.count("visualization-error-bound") > 0)
+                model->Settings.SetVisualizationErrorBound(input["visualization-error-bound"].as<float>());
         }
     }
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <boost/program_options.hpp>
 #include <shared/export/Image.h>
 #include <shared/export/HDF5Export.h>
+#include <shared/export/Wav.h>
+#include <shared/export/Npy.h>
 
 
 namespace po = boost::program_options;
@@ -20,6 +22,10 @@ std::vector<std::string> CLIImageExport::GetFormats()
 void CLIImageExport::AddOptions(po::options_description_easy_init add_option)
 {
     add_option("image-fullview", po::value<bool>()->default_value(true), "shows all the domains in a single image per frame");
+    add_option("image-frame-scale", po::value<bool>()->default_value(false), "scales the colors of every frame with the peak of that frame");
+    add_option("image-level", po::value<unsigned int>()->default_value(0), "exports the preview level of the frames, every level halves the size of the images");
+    add_option("video-fps", po::value<int>()->default_value(25), "frames per second of the video formats");
+    add_option("jobs,j", po::value<int>()->default_value(0), "number of threads used for colorizing and for encoding the images, 0 uses all cores");
 }
 
 void CLIImageExport::Execute(std::string format, std::shared_ptr <Shared::PSTDFile> file, std::string directory, std::string name,
@@ -27,6 +33,10 @@ void CLIImageExport::Execute(std::string format, std::shared_ptr <Shared::PSTDFi
 {
     Shared::ExportImage realExport;
     realExport.SetFullView(input["image-fullview"].as<bool>());
+    realExport.SetFrameScale(input["image-frame-scale"].as<bool>());
+    realExport.SetLevel(input["image-level"].as<unsigned int>());
+    realExport.SetFrameRate(input["video-fps"].as<int>());
+    realExport.SetJobs(input["jobs"].as<int>());
     realExport.ExportData(format, file, directory, name, domains, startFrame, endFrame);
 }
 
@@ -41,7 +51,12 @@ std::vector<std::string> CLIHDF5Export::GetFormats()
 
 void CLIHDF5Export::AddOptions(po::options_description_easy_init add_option)
 {
-
+    add_option("hdf5-chunk-frames", po::value<int>()->default_value(16), "number of frames in a single HDF5 chunk");
+    add_option("hdf5-chunk-height", po::value<int>()->default_value(0), "number of rows in a single HDF5 chunk, 0 uses the domain height");
+    add_option("hdf5-chunk-width", po::value<int>()->default_value(0), "number of columns in a single HDF5 chunk, 0 uses the domain width");
+    add_option("hdf5-deflate", po::value<int>()->default_value(0), "deflate level(1-9) of the HDF5 datasets, 0 disables compression");
+    add_option("hdf5-shuffle", po::value<bool>()->default_value(true), "applies the shuffle filter before deflate");
+    add_option("hdf5-batch-frames", po::value<int>()->default_value(64), "number of frames written to the HDF5 file at once");
 }
 
 void CLIHDF5Export::Execute(std::string format, std::shared_ptr<Shared::PSTDFile> file, std::string directory,
@@ -49,5 +64,63 @@ void CLIHDF5Export::Execute(std::string format, std::shared_ptr<Shared::PSTDFile
                             po::variables_map input)
 {
     OpenPSTD::Shared::HDF5 realExport;
+    realExport.SetChunkFrames(input["hdf5-chunk-frames"].as<int>());
+    realExport.SetChunkSize(input["hdf5-chunk-height"].as<int>(), input["hdf5-chunk-width"].as<int>());
+    realExport.SetDeflateLevel(input["hdf5-deflate"].as<int>());
+    realExport.SetShuffle(input["hdf5-shuffle"].as<bool>());
+    realExport.SetBatchFrames(input["hdf5-batch-frames"].as<int>());
     realExport.ExportData(format, file, directory+"/"+name+".h5", domains, startFrame, endFrame);
-}
\ No newline at end of file
+}
+
+
+
+std::vector<std::string> CLIWavExport::GetFormats()
+{
+    Shared::ExportWav realExport;
+    return realExport.GetFormats();
+}
+
+void CLIWavExport::AddOptions(po::options_description_easy_init add_option)
+{
+    add_option("wav-rate", po::value<int>()->default_value(44100), "sample rate of the WAV file");
+    add_option("wav-normalize", po::value<bool>()->default_value(true), "scales the receivers so that the peak is full scale");
+    add_option("wav-float", po::value<bool>()->default_value(false), "writes 32 bits float samples instead of 16 bits samples");
+    add_option("wav-receivers", po::value<std::vector<int>>(), "receiver that is written as the next channel of the WAV file, by default all receivers");
+}
+
+void CLIWavExport::Execute(std::string format, std::shared_ptr<Shared::PSTDFile> file, std::string directory,
+                           std::string name, std::vector<int> domains, int startFrame, int endFrame,
+                           po::variables_map input)
+{
+    Shared::ExportWav realExport;
+    realExport.SetSampleRate(input["wav-rate"].as<int>());
+    realExport.SetNormalize(input["wav-normalize"].as<bool>());
+    realExport.SetFloatSamples(input["wav-float"].as<bool>());
+
+    std::vector<int> receivers;
+    if (input.count("wav-receivers") > 0)
+    {
+        receivers = input["wav-receivers"].as<std::vector<int>>();
+    }
+    realExport.ExportData(format, file, directory + "/" + name + ".wav", receivers);
+}
+
+
+
+std::vector<std::string> CLINpyExport::GetFormats()
+{
+    Shared::ExportNpy realExport;
+    return realExport.GetFormats();
+}
+
+void CLINpyExport::AddOptions(po::options_description_easy_init add_option)
+{
+}
+
+void CLINpyExport::Execute(std::string format, std::shared_ptr<Shared::PSTDFile> file, std::string directory,
+                           std::string name, std::vector<int> domains, int startFrame, int endFrame,
+                           po::variables_map input)
+{
+    Shared::ExportNpy realExport;
+    realExport.ExportData(format, file, directory, name, domains, startFrame, endFrame);
+}
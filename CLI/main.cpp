@@ -31,12 +31,21 @@
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 #include <boost/program_options.hpp>
 #include <boost/regex.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <kernel/PSTDKernel.h>
 #include <kernel/MockKernel.h>
+#include <kernel/core/Logger.h>
+#include <kernel/core/Checkpoint.h>
+#include <kernel/core/Transport.h>
+#include <kernel/SweepRunner.h>
 
 #include <shared/PSTDFile.h>
 
@@ -370,12 +379,82 @@ namespace OpenPSTD
             return "Run the OpenPSTD algorithm, see OpenPSTD-cli run -h";
         }
 
+        /**
+         * Connects the processes of a distributed run with the transport of the options
+         */
+        static std::shared_ptr<Kernel::Transport> CreateTransport(const po::variables_map &vm, int rank, int ranks)
+        {
+            std::string transport = vm["transport"].as<std::string>();
+            double timeout = vm["transport-timeout"].as<double>();
+            if (transport == "shm")
+            {
+                return std::make_shared<Kernel::SharedMemoryTransport>(vm["transport-name"].as<std::string>(), rank,
+                                                                       ranks, timeout);
+            }
+            else if (transport == "tcp")
+            {
+                std::vector<std::string> endpoints;
+                if (vm.count("endpoints") > 0)
+                {
+                    std::istringstream list(vm["endpoints"].as<std::string>());
+                    std::string endpoint;
+                    while (std::getline(list, endpoint, ','))
+                    {
+                        endpoints.push_back(endpoint);
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < ranks; i++)
+                    {
+                        endpoints.push_back("localhost:" + std::to_string(47800 + i));
+                    }
+                }
+                if (endpoints.size() != (unsigned long) ranks)
+                {
+                    throw std::runtime_error("the number of endpoints differs from the number of ranks");
+                }
+                return std::make_shared<Kernel::TcpTransport>(rank, endpoints, timeout);
+            }
+            throw std::runtime_error("unknown transport " + transport + ", use shm or tcp");
+        }
+
+        /**
+         * Sends the configuration of rank 0 to the other ranks, so that only rank 0 reads the scene file
+         */
+        static void SendConfiguration(Kernel::Transport &transport, std::shared_ptr<Kernel::PSTDConfiguration> conf)
+        {
+            std::ostringstream stream;
+            {
+                boost::archive::text_oarchive archive(stream);
+                archive << *conf;
+            }
+            std::string data = stream.str();
+            for (int rank = 1; rank < transport.get_size(); rank++)
+            {
+                transport.send(rank, std::vector<char>(data.begin(), data.end()));
+            }
+        }
+
+        static std::shared_ptr<Kernel::PSTDConfiguration> ReceiveConfiguration(Kernel::Transport &transport)
+        {
+            std::vector<char> data = transport.receive(0);
+            std::istringstream stream(std::string(data.begin(), data.end()));
+            auto conf = std::make_shared<Kernel::PSTDConfiguration>();
+            boost::archive::text_iarchive archive(stream);
+            archive >> *conf;
+            return conf;
+        }
+
         int RunCommand::execute(int argc, const char **argv)
         {
             po::variables_map vm;
+            //the other ranks of a distributed run are told when this process fails
+            std::shared_ptr<Kernel::Transport> transport;
 
             try
             {
+                Shared::CommitPolicy defaultPolicy = Shared::CommitPolicy::Default();
                 po::options_description desc("Allowed options");
                 desc.add_options()
                         ("help,h", "produce help message")
@@ -384,6 +463,49 @@ namespace OpenPSTD
                         ("gpu-accelerated,g",
                          "Use the gpu for the calculations (mutually exclusive with multithreaded)")
                         ("mock,M", "Use the mock kernel(only useful for development)")
+                        ("commit-frames", po::value<unsigned int>()->default_value(defaultPolicy.Frames),
+                         "Commit the results to the file every N frames (0 disables this threshold)")
+                        ("commit-mb", po::value<double>()->default_value(defaultPolicy.Megabytes),
+                         "Commit the results to the file every M megabytes (0 disables this threshold)")
+                        ("commit-seconds", po::value<double>()->default_value(defaultPolicy.Seconds),
+                         "Commit the results to the file every T seconds (0 disables this threshold)")
+                        ("commit-stats", "Print the commit latency statistics after the run")
+                        ("histogram-bins", po::value<unsigned int>()->default_value(0),
+                         "Store a histogram with N bins of every frame (0 disables the histogram)")
+                        ("preview-levels", po::value<unsigned int>()->default_value(0),
+                         "Store N downsampled preview levels of every frame, this makes zoomed out views faster but "
+                                 "adds up to a third to the size of the results (0 disables the previews)")
+                        ("time-index", "Write the time-major index of the results after the run, so that the time "
+                                "series of any cell can be read quickly (see OpenPSTD-cli probe)")
+                        ("profile", "Time the phases of the calculation, a summary is printed after the run and the "
+                                "profile is stored with the results")
+                        ("trace", po::value<std::string>(), "Write a timeline of the tasks of the solver to this file "
+                                "in the Chrome trace-event JSON format")
+                        ("trace-events", po::value<unsigned int>()->default_value(1 << 20),
+                         "Number of trace events that are kept per thread, older events are dropped")
+                        ("log-level", po::value<std::string>()->default_value("info"),
+                         "Minimal level of the messages of the kernel: trace, debug, info, warning, error or off")
+                        ("progress-interval", po::value<double>()->default_value(0.1),
+                         "Minimal number of seconds between two progress messages, 0 reports every frame")
+                        ("checkpoint-frames", po::value<unsigned int>()->default_value(0),
+                         "Write a checkpoint of the simulation every N frames, so that the run can be resumed "
+                                 "(0 disables checkpoints)")
+                        ("checkpoint", po::value<std::string>(), "The checkpoint file (default: the scene file with "
+                                "the extension .checkpoint)")
+                        ("resume", "Resume the simulation from the checkpoint, the results after the checkpoint are "
+                                "overwritten")
+                        ("ranks", po::value<int>()->default_value(1), "Number of processes that compute the "
+                                "simulation together, every process is started with the same options and its own rank")
+                        ("rank", po::value<int>()->default_value(0), "Rank of this process in a distributed run, rank 0 "
+                                "reads the scene file and writes the results, the other ranks do not need the file")
+                        ("transport", po::value<std::string>()->default_value("shm"), "Transport between the "
+                                "processes of a distributed run: shm(shared memory, on a single machine) or tcp")
+                        ("transport-name", po::value<std::string>()->default_value("openpstd"), "Name of the shared "
+                                "memory queues of a distributed run, unique for every run on the machine")
+                        ("endpoints", po::value<std::string>(), "Comma separated host:port of every rank for the tcp "
+                                "transport (default: localhost with the ports from 47800)")
+                        ("transport-timeout", po::value<double>()->default_value(60), "Seconds that a process of a "
+                                "distributed run waits for the others to start and for their messages")
                     //("write-plot,p", "Plots are written to the output directory")
                     //("write-array,a", "Arrays are written to the output directory")
                         ;
@@ -400,7 +522,7 @@ namespace OpenPSTD
                     return 0;
                 }
 
-                if (vm.count("scene-file") == 0)
+                if (vm.count("scene-file") == 0 && vm["rank"].as<int>() == 0)
                 {
                     std::cerr << "scene file is required" << std::endl;
                     std::cout << desc << std::endl;
@@ -420,17 +542,70 @@ namespace OpenPSTD
                             "using normal version" << std::endl;
                 }
 
+                bool resume = vm.count("resume") > 0;
+                if (resume && vm.count("mock") > 0)
+                {
+                    std::cerr << "the mock kernel can not resume from a checkpoint" << std::endl;
+                    return 1;
+                }
+
+                Kernel::Logger::get_instance().set_level(
+                        Kernel::Logger::parse_level(vm["log-level"].as<std::string>()));
+
+                int ranks = vm["ranks"].as<int>();
+                int rank = vm["rank"].as<int>();
+                if (ranks < 1 || rank < 0 || rank >= ranks)
+                {
+                    std::cerr << "the rank should be between 0 and the number of ranks" << std::endl;
+                    return 1;
+                }
+                if (ranks > 1)
+                {
+                    if (vm.count("mock") > 0 || resume)
+                    {
+                        std::cerr << "a distributed run can not use the mock kernel or resume from a checkpoint"
+                                  << std::endl;
+                        return 1;
+                    }
+                    transport = CreateTransport(vm, rank, ranks);
+                    if (rank != 0)
+                    {
+                        //only rank 0 reads the scene file and writes the results
+                        Kernel::PSTDKernel kernel;
+                        kernel.initialize_kernel(ReceiveConfiguration(*transport));
+                        kernel.run_distributed(nullptr, transport);
+                        Kernel::Logger::get_instance().flush();
+                        return 0;
+                    }
+                }
+
                 std::string filename = vm["scene-file"].as<std::string>();
+                std::string checkpointFile = vm.count("checkpoint") > 0 ? vm["checkpoint"].as<std::string>() :
+                                             filename + ".checkpoint";
 
                 //open file (and make a shared_ptr of the unique_ptr)
                 std::shared_ptr<Shared::PSTDFile> file = Shared::PSTDFile::Open(filename);
-                //get conf for the kernel
-                std::shared_ptr<Kernel::PSTDConfiguration> conf = file->GetSceneConf();
-                //initilize output in file
-                std::cout << "Delete old results(if any)" << std::endl;
-                file->DeleteResults();
-                std::cout << "initilize new results" << std::endl;
-                file->InitializeResults();
+                std::shared_ptr<Kernel::PSTDConfiguration> conf;
+                if (resume)
+                {
+                    //continue with the scene of the results, the scene could be edited after the checkpoint
+                    int frame = Kernel::Checkpoint::read_frame(checkpointFile);
+                    std::cout << "Resume after frame " << frame << std::endl;
+                    conf = file->GetResultsSceneConf();
+                    file->TruncateResults(frame + 1);
+                }
+                else
+                {
+                    //get conf for the kernel
+                    conf = file->GetSceneConf();
+                    //initilize output in file
+                    std::cout << "Delete old results(if any)" << std::endl;
+                    file->DeleteResults();
+                    std::cout << "initilize new results" << std::endl;
+                    file->InitializeResults();
+                }
+                file->SetStatisticsHistogramBins(vm["histogram-bins"].as<unsigned int>());
+                file->SetPreviewLevels(vm["preview-levels"].as<unsigned int>());
                 //create kernel
                 std::unique_ptr<Kernel::KernelInterface> kernel;
                 if (vm.count("mock") > 0)
@@ -443,28 +618,127 @@ namespace OpenPSTD
                     //use the real kernel
                     kernel = std::unique_ptr<Kernel::PSTDKernel>(new Kernel::PSTDKernel());
                 }
-                //configure the kernel
+                //configure the kernel, the switches of the run are not part of the scene
+                Kernel::KernelRunOptions options;
+                options.Profiling = vm.count("profile") > 0;
+                options.TraceBufferSize = vm.count("trace") > 0 ? vm["trace-events"].as<unsigned int>() : 0;
+                options.ProgressInterval = vm["progress-interval"].as<double>();
+                options.CheckpointFile = checkpointFile;
+                options.CheckpointInterval = vm["checkpoint-frames"].as<unsigned int>();
+                options.Resume = resume;
+                if (transport)
+                {
+                    SendConfiguration(*transport, conf);
+                }
                 kernel->initialize_kernel(conf);
-                //create output
-                std::shared_ptr<Kernel::KernelCallback> output = std::make_shared<CLIOutput>(file);
+                //create output, the results are committed periodically so that the journal stays bounded
+                Shared::CommitPolicy policy;
+                policy.Frames = vm["commit-frames"].as<unsigned int>();
+                policy.Megabytes = vm["commit-mb"].as<double>();
+                policy.Seconds = vm["commit-seconds"].as<double>();
+                std::shared_ptr<CLIOutput> output = std::make_shared<CLIOutput>(file, policy);
+                if (vm.count("trace") > 0)
+                {
+                    output->SetTraceFile(vm["trace"].as<std::string>());
+                }
                 //run kernel
-                kernel->run(output.get());
+                if (transport)
+                {
+                    static_cast<Kernel::PSTDKernel *>(kernel.get())->run_distributed(output.get(), transport, options);
+                }
+                else
+                {
+                    kernel->run(output.get(), options);
+                }
+                //the messages of the kernel are written before the summaries
+                Kernel::Logger::get_instance().flush();
 
-                file->Commit();
+                output->Finish();
+                if (vm.count("commit-stats") > 0)
+                {
+                    std::cout << output->GetCommitMetrics().ToString() << std::endl;
+                }
+
+                if (vm.count("time-index") > 0)
+                {
+                    std::cout << "Write time index" << std::endl;
+                    file->BuildTimeSeriesIndex();
+                    file->Commit();
+                }
+
+                if (vm.count("profile") > 0)
+                {
+                    auto profile = file->GetResultsProfile();
+                    if (profile)
+                    {
+                        PrintProfile(*profile);
+                    }
+                }
                 return 0;
             }
             catch (std::exception &e)
             {
                 std::cerr << "error: " << e.what() << "\n";
+                if (transport)
+                {
+                    transport->abort(e.what());
+                }
                 return 1;
             }
             catch (...)
             {
                 std::cerr << "Exception of unknown type!\n";
+                if (transport)
+                {
+                    transport->abort("exception of unknown type");
+                }
                 return 1;
             }
         }
 
+        void RunCommand::PrintProfile(const Kernel::KernelProfile &profile)
+        {
+            std::cout << "=============================================================" << std::endl;
+            std::cout << "== Profile                                                 ==" << std::endl;
+            std::cout << "=============================================================" << std::endl;
+
+            int frames = (int) profile.FrameSeconds.size();
+            std::cout << "Total: " << profile.TotalSeconds << " s, " << frames << " frames" << std::endl;
+            std::cout << std::endl;
+
+            std::cout << std::left << std::setw(20) << "phase" << std::right << std::setw(12) << "seconds"
+                    << std::setw(10) << "%" << std::setw(14) << "ms/frame" << std::endl;
+            std::cout << std::fixed << std::setprecision(3);
+            double profiled = 0;
+            for (int i = 0; i < Kernel::PROFILEPHASE_COUNT; ++i)
+            {
+                Kernel::PROFILEPHASE phase = (Kernel::PROFILEPHASE) i;
+                double seconds = profile.GetPhaseSeconds(phase);
+                profiled += seconds;
+                std::cout << std::left << std::setw(20) << Kernel::KernelProfile::GetPhaseName(phase) << std::right
+                        << std::setw(12) << seconds
+                        << std::setw(10) << (profile.TotalSeconds > 0 ? 100 * seconds / profile.TotalSeconds : 0)
+                        << std::setw(14) << (frames > 0 ? 1000 * seconds / frames : 0) << std::endl;
+            }
+            //time outside of the phases, e.g. the callbacks of the progress
+            double other = std::max(0.0, profile.TotalSeconds - profiled);
+            std::cout << std::left << std::setw(20) << "other" << std::right << std::setw(12) << other
+                    << std::setw(10) << (profile.TotalSeconds > 0 ? 100 * other / profile.TotalSeconds : 0)
+                    << std::setw(14) << (frames > 0 ? 1000 * other / frames : 0) << std::endl;
+
+            std::cout << std::endl;
+            std::cout << "Domains: " << std::endl;
+            for (size_t d = 0; d < profile.DomainSeconds.size(); ++d)
+            {
+                bool pml = std::find(profile.PMLDomains.begin(), profile.PMLDomains.end(), (int) d) !=
+                           profile.PMLDomains.end();
+                std::cout << "  " << d << (pml ? " (pml)" : "") << ": " << profile.GetDomainSeconds(d) << " s"
+                        << std::endl;
+            }
+            std::cout.unsetf(std::ios_base::floatfield);
+            std::cout << std::setprecision(6);
+        }
+
         std::string ExportCommand::GetName()
         {
             return "export";
@@ -481,6 +755,8 @@ namespace OpenPSTD
             std::vector<std::shared_ptr<OpenPSTD::CLI::CLIExport>> exports;
             exports.push_back(std::make_shared<OpenPSTD::CLI::CLIImageExport>());
             exports.push_back(std::make_shared<OpenPSTD::CLI::CLIHDF5Export>());
+            exports.push_back(std::make_shared<OpenPSTD::CLI::CLIWavExport>());
+            exports.push_back(std::make_shared<OpenPSTD::CLI::CLINpyExport>());
 
             try
             {
@@ -544,6 +820,9 @@ namespace OpenPSTD
                     return 1;
                 }
 
+                Kernel::Logger::get_instance().set_level(
+                        Kernel::Logger::parse_level(vm["log-level"].as<std::string>()));
+
                 std::string filename = vm["scene-file"].as<std::string>();
 
                 //open file (and make a shared_ptr of the unique_ptr)
@@ -583,6 +862,570 @@ namespace OpenPSTD
                 return 1;
             }
         }
+
+        std::string CompactCommand::GetName()
+        {
+            return "compact";
+        }
+
+        std::string CompactCommand::GetDescription()
+        {
+            return "Rewrites the scene file to reclaim the space of deleted results, see OpenPSTD-cli compact -h";
+        }
+
+        int CompactCommand::execute(int argc, const char **argv)
+        {
+            po::variables_map vm;
+
+            try
+            {
+                po::options_description desc("Allowed options");
+                desc.add_options()
+                        ("help,h", "produce help message")
+                        ("scene-file,f", po::value<std::string>(), "The scene file that has to be used (required)");
+
+                po::positional_options_description p;
+                p.add("scene-file", 1);
+
+                po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+                po::notify(vm);
+
+                if (vm.count("help"))
+                {
+                    std::cout << desc << std::endl;
+                    return 0;
+                }
+
+                if (vm.count("scene-file") == 0)
+                {
+                    std::cerr << "scene file is required" << std::endl;
+                    std::cout << desc << std::endl;
+                    return 1;
+                }
+
+                std::string filename = vm["scene-file"].as<std::string>();
+
+                uintmax_t before = boost::filesystem::file_size(filename);
+                Shared::PSTDFile::Compact(filename);
+                uintmax_t after = boost::filesystem::file_size(filename);
+
+                std::cout << "compacted " << filename << ": " << before << " bytes -> " << after << " bytes" << std::endl;
+                return 0;
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "error: " << e.what() << "\n";
+                return 1;
+            }
+            catch (...)
+            {
+                std::cerr << "Exception of unknown type!\n";
+                return 1;
+            }
+        }
+
+        std::string UpgradeCommand::GetName()
+        {
+            return "upgrade";
+        }
+
+        std::string UpgradeCommand::GetDescription()
+        {
+            return "Converts a scene file of an older version to the current version, see OpenPSTD-cli upgrade -h";
+        }
+
+        int UpgradeCommand::execute(int argc, const char **argv)
+        {
+            po::variables_map vm;
+
+            try
+            {
+                po::options_description desc("Allowed options");
+                desc.add_options()
+                        ("help,h", "produce help message")
+                        ("scene-file,f", po::value<std::string>(), "The scene file that has to be used (required)");
+
+                po::positional_options_description p;
+                p.add("scene-file", 1);
+
+                po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+                po::notify(vm);
+
+                if (vm.count("help"))
+                {
+                    std::cout << desc << std::endl;
+                    return 0;
+                }
+
+                if (vm.count("scene-file") == 0)
+                {
+                    std::cerr << "scene file is required" << std::endl;
+                    std::cout << desc << std::endl;
+                    return 1;
+                }
+
+                std::string filename = vm["scene-file"].as<std::string>();
+                if (Shared::PSTDFile::Upgrade(filename))
+                {
+                    std::cout << "upgraded " << filename << std::endl;
+                }
+                else
+                {
+                    std::cout << filename << " has the current version already" << std::endl;
+                }
+                return 0;
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "error: " << e.what() << "\n";
+                return 1;
+            }
+            catch (...)
+            {
+                std::cerr << "Exception of unknown type!\n";
+                return 1;
+            }
+        }
+
+        std::string ProbeCommand::GetName()
+        {
+            return "probe";
+        }
+
+        std::string ProbeCommand::GetDescription()
+        {
+            return "Prints the time series of a point of the results, see OpenPSTD-cli probe -h";
+        }
+
+        int ProbeCommand::execute(int argc, const char **argv)
+        {
+            po::variables_map vm;
+
+            try
+            {
+                po::options_description desc("Allowed options");
+                desc.add_options()
+                        ("help,h", "produce help message")
+                        ("scene-file,f", po::value<std::string>(), "The scene file that has to be used (required)")
+                        ("point,p", po::value<std::string>(), "The point in the scene, --point x,y (required)")
+                        ("build-index,b", "Write the time-major index of the results first if it does not exist");
+
+                po::positional_options_description p;
+                p.add("scene-file", 1);
+
+                po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+                po::notify(vm);
+
+                if (vm.count("help"))
+                {
+                    std::cout << desc << std::endl;
+                    return 0;
+                }
+
+                if (vm.count("scene-file") == 0 || vm.count("point") == 0)
+                {
+                    std::cerr << "scene file and point are required" << std::endl;
+                    std::cout << desc << std::endl;
+                    return 1;
+                }
+
+                static regex r("\\[?([^,]*),([^,\\]]*)\\]?");
+                smatch match;
+                std::string point = vm["point"].as<std::string>();
+                if (!regex_match(point, match, r))
+                {
+                    std::cerr << "invalid point: " << point << std::endl;
+                    return 1;
+                }
+
+                std::string filename = vm["scene-file"].as<std::string>();
+                std::shared_ptr<Shared::PSTDFile> file = Shared::PSTDFile::Open(filename);
+                std::shared_ptr<Kernel::PSTDConfiguration> conf = file->GetResultsSceneConf();
+                Kernel::SimulationMetadata metadata = file->GetResultsMetadata();
+
+                //find the domain and the cell of the point
+                float gridSpacing = metadata.GridSpacing;
+                int cellX = (int)std::floor(lexical_cast<float>(match[1]) / gridSpacing);
+                int cellY = (int)std::floor(lexical_cast<float>(match[2]) / gridSpacing);
+                int domain = -1;
+                for (int d = 0; d < metadata.DomainMetadata.size() && domain < 0; d++)
+                {
+                    int x = cellX - metadata.DomainPositions[d][0];
+                    int y = cellY - metadata.DomainPositions[d][1];
+                    if (x >= 0 && y >= 0 && x < metadata.DomainMetadata[d][0] && y < metadata.DomainMetadata[d][1])
+                    {
+                        domain = d;
+                    }
+                }
+
+                if (domain < 0)
+                {
+                    std::cerr << "point " << point << " is not part of a domain" << std::endl;
+                    return 1;
+                }
+
+                if (vm.count("build-index") > 0 && file->GetTimeSeriesLayout(domain).IsEmpty())
+                {
+                    file->BuildTimeSeriesIndex();
+                    file->Commit();
+                }
+
+                int x = cellX - metadata.DomainPositions[domain][0];
+                int y = cellY - metadata.DomainPositions[domain][1];
+                Kernel::PSTD_RECEIVER_DATA_PTR values = file->GetResultsTimeSeries(domain, x, y);
+
+                float frameTime = metadata.TimeStep * conf->Settings.GetSaveNth();
+                std::cout << "# domain " << domain << ", cell " << x << "," << y << std::endl;
+                for (int i = 0; i < values->size(); i++)
+                {
+                    std::cout << i * frameTime << "\t" << (*values)[i] << "\n";
+                }
+                std::cout.flush();
+                return 0;
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "error: " << e.what() << "\n";
+                return 1;
+            }
+            catch (...)
+            {
+                std::cerr << "Exception of unknown type!\n";
+                return 1;
+            }
+        }
+
+        std::string EstimateCommand::GetName()
+        {
+            return "estimate";
+        }
+
+        std::string EstimateCommand::GetDescription()
+        {
+            return "Estimates the memory, output and runtime of a scene, see OpenPSTD-cli estimate -h";
+        }
+
+        static std::string FormatBytes(long long bytes)
+        {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(1);
+            if (bytes >= 1024LL * 1024 * 1024)
+                ss << bytes / (1024.0 * 1024 * 1024) << " GB";
+            else if (bytes >= 1024 * 1024)
+                ss << bytes / (1024.0 * 1024) << " MB";
+            else
+                ss << bytes / 1024.0 << " kB";
+            return ss.str();
+        }
+
+        void EstimateCommand::Print(const Kernel::SceneEstimate &estimate)
+        {
+            std::cout << "=============================================================" << std::endl;
+            std::cout << "== Estimate                                                ==" << std::endl;
+            std::cout << "=============================================================" << std::endl;
+            std::cout << "Grid spacing: " << estimate.grid_spacing << " m";
+            if (estimate.recommended_grid_spacing > 0)
+                std::cout << " (recommended for the maximum frequency: " << estimate.recommended_grid_spacing << " m)";
+            else
+                std::cout << " (the maximum frequency is too high for any grid spacing)";
+            std::cout << std::endl;
+            std::cout << "Domains: " << estimate.domains.size() << ", of which " << estimate.get_pml_domain_count()
+                    << " PML domains" << std::endl;
+            std::cout << std::endl;
+
+            std::cout << std::left << std::setw(6) << "id" << std::setw(11) << "type" << std::right
+                    << std::setw(14) << "top left" << std::setw(12) << "size" << std::setw(10) << "cells"
+                    << std::setw(16) << "fft x(p/v)" << std::setw(16) << "fft y(p/v)" << std::setw(12) << "state"
+                    << std::endl;
+            for (auto &domain: estimate.domains)
+            {
+                std::string type = domain.is_secondary_pml ? "pml corner" : (domain.is_pml ? "pml" : "air");
+                std::ostringstream topLeft, size, fftX, fftY;
+                topLeft << domain.top_left.x << "," << domain.top_left.y;
+                size << domain.size.x << "x" << domain.size.y;
+                for (auto &fft: domain.ffts)
+                {
+                    std::ostringstream &out = fft.direction == Kernel::CalcDirection::X ? fftX : fftY;
+                    out << (fft.type == Kernel::CalculationType::PRESSURE ? "" : "/") << fft.length;
+                }
+                fftX << "x" << domain.ffts.at(0).batch;
+                fftY << "x" << domain.ffts.at(2).batch;
+                std::cout << std::left << std::setw(6) << domain.id << std::setw(11) << type << std::right
+                        << std::setw(14) << topLeft.str() << std::setw(12) << size.str()
+                        << std::setw(10) << domain.cells << std::setw(16) << fftX.str() << std::setw(16) << fftY.str()
+                        << std::setw(12) << FormatBytes(domain.state_bytes) << std::endl;
+            }
+            std::cout << std::endl;
+
+            std::cout << "Cells: " << estimate.cells << std::endl;
+            std::cout << "Frames: " << estimate.frame_count << ", saved: " << estimate.saved_frame_count << std::endl;
+            std::cout << "State: " << FormatBytes(estimate.state_bytes) << ", FFT workspace: "
+                    << FormatBytes(estimate.workspace_bytes) << ", peak: "
+                    << FormatBytes(estimate.get_memory_bytes()) << std::endl;
+            std::cout << "Output: " << FormatBytes(estimate.output_bytes) << " (" << estimate.saved_frame_count
+                    << " frames, " << estimate.receiver_count << " receivers)" << std::endl;
+            std::cout << "Runtime: " << std::fixed << std::setprecision(1) << estimate.seconds << " s at "
+                    << estimate.cell_updates_per_second / 1e6 << " Mcells/s" << std::endl;
+        }
+
+        int EstimateCommand::execute(int argc, const char **argv)
+        {
+            po::variables_map vm;
+
+            try
+            {
+                po::options_description desc("Allowed options");
+                desc.add_options()
+                        ("help,h", "produce help message")
+                        ("scene-file,f", po::value<std::string>(), "The scene file that has to be used (required)")
+                        ("calibration,c", po::value<std::string>(),
+                         "JSON output of OpenPSTD-throughput that is used for the cell updates per second")
+                        ("threads,t", po::value<int>()->default_value(1),
+                         "number of threads of the calibration results that are used")
+                        ("cell-rate", po::value<double>(),
+                         "cell updates per second, overrides the calibration");
+
+                po::positional_options_description p;
+                p.add("scene-file", 1);
+
+                po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+                po::notify(vm);
+
+                if (vm.count("help"))
+                {
+                    std::cout << desc << std::endl;
+                    return 0;
+                }
+
+                if (vm.count("scene-file") == 0)
+                {
+                    std::cerr << "scene file is required" << std::endl;
+                    std::cout << desc << std::endl;
+                    return 1;
+                }
+
+                double cellRate = Kernel::default_cell_updates_per_second;
+                if (vm.count("cell-rate"))
+                    cellRate = vm["cell-rate"].as<double>();
+                else if (vm.count("calibration"))
+                    cellRate = Kernel::read_cell_updates_per_second(vm["calibration"].as<std::string>(),
+                                                                    vm["threads"].as<int>());
+
+                std::string filename = vm["scene-file"].as<std::string>();
+                std::unique_ptr<Shared::PSTDFile> file = Shared::PSTDFile::Open(filename);
+                this->Print(Kernel::estimate_scene(file->GetSceneConf(), cellRate));
+                return 0;
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "error: " << e.what() << "\n";
+                return 1;
+            }
+            catch (...)
+            {
+                std::cerr << "Exception of unknown type!\n";
+                return 1;
+            }
+        }
+
+        std::string SweepCommand::GetName()
+        {
+            return "sweep";
+        }
+
+        std::string SweepCommand::GetDescription()
+        {
+            return "Runs variants of a scene that share the domains, see OpenPSTD-cli sweep -h";
+        }
+
+        std::vector<std::shared_ptr<Kernel::PSTDConfiguration>> SweepCommand::ReadVariants(
+                std::shared_ptr<Kernel::PSTDConfiguration> conf, const std::string &filename)
+        {
+            std::ifstream input(filename);
+            if (!input)
+            {
+                throw std::runtime_error("can not open the variants file " + filename);
+            }
+
+            std::vector<std::shared_ptr<Kernel::PSTDConfiguration>> variants;
+            std::string line;
+            int lineNumber = 0;
+            while (std::getline(input, line))
+            {
+                lineNumber++;
+                std::vector<std::string> args = po::split_unix(line);
+                if (args.empty() || args[0][0] == '#')
+                    continue;
+
+                //the parts keep state between parsing and executing, so every variant has its own parts
+                std::vector<std::unique_ptr<EditCommandPart>> commands;
+                commands.push_back(
+                        std::unique_ptr<ChangeEdgeAbsorptionEditCommandPart>(new ChangeEdgeAbsorptionEditCommandPart()));
+                commands.push_back(std::unique_ptr<ChangeEdgeLREditCommandPart>(new ChangeEdgeLREditCommandPart()));
+                commands.push_back(std::unique_ptr<AddSpeakerEditCommandPart>(new AddSpeakerEditCommandPart()));
+                commands.push_back(std::unique_ptr<RemoveSpeakerEditCommandPart>(new RemoveSpeakerEditCommandPart()));
+                commands.push_back(std::unique_ptr<AddReceiverEditCommandPart>(new AddReceiverEditCommandPart()));
+                commands.push_back(
+                        std::unique_ptr<RemoveReceiverEditCommandPart>(new RemoveReceiverEditCommandPart()));
+
+                po::options_description desc("Variant options");
+                for (int i = 0; i < commands.size(); ++i)
+                {
+                    commands[i]->AddOptions(desc.add_options());
+                }
+
+                po::variables_map vm;
+                try
+                {
+                    po::store(po::command_line_parser(args).options(desc).run(), vm);
+                    po::notify(vm);
+                }
+                catch (std::exception &e)
+                {
+                    throw std::runtime_error("line " + std::to_string(lineNumber) + " of " + filename + ": " +
+                                             e.what());
+                }
+
+                auto variant = std::make_shared<Kernel::PSTDConfiguration>(*conf);
+                for (int i = 0; i < commands.size(); ++i)
+                {
+                    commands[i]->Execute(variant, vm);
+                }
+                variants.push_back(variant);
+            }
+            return variants;
+        }
+
+        int SweepCommand::execute(int argc, const char **argv)
+        {
+            po::variables_map vm;
+
+            try
+            {
+                Shared::CommitPolicy defaultPolicy = Shared::CommitPolicy::Default();
+                po::options_description desc("Allowed options");
+                desc.add_options()
+                        ("help,h", "produce help message")
+                        ("scene-file,f", po::value<std::string>(), "The scene file that has to be used (required)")
+                        ("variants,v", po::value<std::string>(), "File with a variant on every line (required). A "
+                                "variant is written with the options of OpenPSTD-cli edit that change the edge "
+                                "absorption, the edge local reaction, the speakers or the receivers, e.g. "
+                                "\"-a 0,l,0.5 -p [1,2]\". Empty lines and lines that start with # are skipped.")
+                        ("output,o", po::value<std::string>(), "Directory of the results, variant N is written to "
+                                "<scene>-N.pstd (default: the directory of the scene file)")
+                        ("threads,t", po::value<unsigned int>()->default_value(0),
+                         "Number of batches of variants that run concurrently, 0 uses all the cores")
+                        ("batch,b", po::value<unsigned int>()->default_value(1),
+                         "Number of consecutive variants that are calculated together in a single FFT batch, the "
+                                 "variants of a batch can only differ in the speakers and receivers")
+                        ("commit-frames", po::value<unsigned int>()->default_value(defaultPolicy.Frames),
+                         "Commit the results to the file every N frames (0 disables this threshold)")
+                        ("commit-mb", po::value<double>()->default_value(defaultPolicy.Megabytes),
+                         "Commit the results to the file every M megabytes (0 disables this threshold)")
+                        ("commit-seconds", po::value<double>()->default_value(defaultPolicy.Seconds),
+                         "Commit the results to the file every T seconds (0 disables this threshold)")
+                        ("log-level", po::value<std::string>()->default_value("info"),
+                         "Minimal level of the messages of the kernel: trace, debug, info, warning, error or off")
+                        ("progress-interval", po::value<double>()->default_value(1),
+                         "Minimal number of seconds between two progress messages of a variant");
+
+                po::positional_options_description p;
+                p.add("scene-file", 1);
+
+                po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+                po::notify(vm);
+
+                if (vm.count("help"))
+                {
+                    std::cout << desc << std::endl;
+                    return 0;
+                }
+
+                if (vm.count("scene-file") == 0 || vm.count("variants") == 0)
+                {
+                    std::cerr << "scene file and variants file are required" << std::endl;
+                    std::cout << desc << std::endl;
+                    return 1;
+                }
+
+                Kernel::Logger::get_instance().set_level(
+                        Kernel::Logger::parse_level(vm["log-level"].as<std::string>()));
+
+                boost::filesystem::path scenePath(vm["scene-file"].as<std::string>());
+                boost::filesystem::path outputPath = vm.count("output") > 0 ?
+                                                     boost::filesystem::path(vm["output"].as<std::string>()) :
+                                                     scenePath.parent_path();
+
+                std::unique_ptr<Shared::PSTDFile> file = Shared::PSTDFile::Open(scenePath.string());
+                auto conf = file->GetSceneConf();
+                Kernel::KernelRunOptions options;
+                options.ProgressInterval = vm["progress-interval"].as<double>();
+                auto variants = this->ReadVariants(conf, vm["variants"].as<std::string>());
+                if (variants.empty())
+                {
+                    std::cerr << "the variants file contains no variants" << std::endl;
+                    return 1;
+                }
+
+                Shared::CommitPolicy policy;
+                policy.Frames = vm["commit-frames"].as<unsigned int>();
+                policy.Megabytes = vm["commit-mb"].as<double>();
+                policy.Seconds = vm["commit-seconds"].as<double>();
+
+                std::cout << "Initialize the scene for " << variants.size() << " variants" << std::endl;
+                Kernel::SweepRunner runner(conf);
+                std::vector<std::string> filenames(variants.size());
+                for (unsigned long i = 0; i < variants.size(); ++i)
+                {
+                    filenames[i] = (outputPath / (scenePath.stem().string() + "-" + std::to_string(i) +
+                                                  ".pstd")).string();
+                }
+
+                runner.run_batches(variants, [&](const std::vector<unsigned long> &batch,
+                                                 Kernel::PSTDKernel &kernel)
+                {
+                    std::vector<std::shared_ptr<Kernel::PSTDConfiguration>> configurations;
+                    std::vector<std::shared_ptr<CLIOutput>> outputs;
+                    std::vector<Kernel::KernelCallback *> callbacks;
+                    for (unsigned long variant: batch)
+                    {
+                        //the results of an earlier sweep are replaced
+                        boost::filesystem::remove(filenames[variant]);
+                        std::shared_ptr<Shared::PSTDFile> result = Shared::PSTDFile::New(filenames[variant]);
+                        result->SetSceneConf(variants[variant]);
+                        result->InitializeResults();
+
+                        std::shared_ptr<CLIOutput> output = std::make_shared<CLIOutput>(result, policy);
+                        output->SetName("variant " + std::to_string(variant));
+                        configurations.push_back(variants[variant]);
+                        outputs.push_back(output);
+                        callbacks.push_back(output.get());
+                    }
+                    kernel.run_batch(configurations, callbacks, options);
+                    for (auto &output: outputs)
+                    {
+                        output->Finish();
+                    }
+                }, vm["batch"].as<unsigned int>(), vm["threads"].as<unsigned int>());
+                Kernel::Logger::get_instance().flush();
+
+                for (auto &filename: filenames)
+                {
+                    std::cout << "Results written to " << filename << std::endl;
+                }
+                return 0;
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "error: " << e.what() << "\n";
+                return 1;
+            }
+            catch (...)
+            {
+                std::cerr << "Exception of unknown type!\n";
+                return 1;
+            }
+        }
     }
 }
 
@@ -595,6 +1438,11 @@ int main(int argc, const char *argv[])
     commands.push_back(std::unique_ptr<EditCommand>(new EditCommand()));
     commands.push_back(std::unique_ptr<RunCommand>(new RunCommand()));
     commands.push_back(std::unique_ptr<ExportCommand>(new ExportCommand()));
+    commands.push_back(std::unique_ptr<CompactCommand>(new CompactCommand()));
+    commands.push_back(std::unique_ptr<UpgradeCommand>(new UpgradeCommand()));
+    commands.push_back(std::unique_ptr<ProbeCommand>(new ProbeCommand()));
+    commands.push_back(std::unique_ptr<EstimateCommand>(new EstimateCommand()));
+    commands.push_back(std::unique_ptr<SweepCommand>(new SweepCommand()));
 
     if (argc >= 2)
     {
@@ -8,6 +8,7 @@
 #include <string>
 #include <memory>
 #include <shared/export/Export.h>
+#include <kernel/core/Estimator.h>
 
 namespace OpenPSTD
 {
@@ -59,6 +60,9 @@ namespace OpenPSTD
 
         class RunCommand : public Command
         {
+        private:
+            void PrintProfile(const Kernel::KernelProfile &profile);
+
         public:
             std::string GetName() override;
 
@@ -76,6 +80,63 @@ namespace OpenPSTD
 
             int execute(int argc, const char *argv[]) override;
         };
+
+        class CompactCommand : public Command
+        {
+        public:
+            std::string GetName() override;
+
+            std::string GetDescription() override;
+
+            int execute(int argc, const char *argv[]) override;
+        };
+
+        class UpgradeCommand : public Command
+        {
+        public:
+            std::string GetName() override;
+
+            std::string GetDescription() override;
+
+            int execute(int argc, const char *argv[]) override;
+        };
+
+        class ProbeCommand : public Command
+        {
+        public:
+            std::string GetName() override;
+
+            std::string GetDescription() override;
+
+            int execute(int argc, const char *argv[]) override;
+        };
+
+        class EstimateCommand : public Command
+        {
+        private:
+            void Print(const Kernel::SceneEstimate &estimate);
+
+        public:
+            std::string GetName() override;
+
+            std::string GetDescription() override;
+
+            int execute(int argc, const char *argv[]) override;
+        };
+
+        class SweepCommand : public Command
+        {
+        private:
+            std::vector<std::shared_ptr<Kernel::PSTDConfiguration>> ReadVariants(
+                    std::shared_ptr<Kernel::PSTDConfiguration> conf, const std::string &filename);
+
+        public:
+            std::string GetName() override;
+
+            std::string GetDescription() override;
+
+            int execute(int argc, const char *argv[]) override;
+        };
     }
 }
 #endif //OPENPSTD_MAIN_CLI_H_H
@@ -4,6 +4,7 @@
 
 #include "output.h"
 #include <iostream>
+#include <fstream>
 #include <boost/lexical_cast.hpp>
 namespace OpenPSTD
 {
@@ -13,29 +14,93 @@ namespace OpenPSTD
 
         void CLIOutput::Callback(CALLBACKSTATUS status, std::string message, int frame)
         {
+            if (!_name.empty())
+            {
+                message = _name + ": " + message;
+            }
+
             if (status == CALLBACKSTATUS::STARTING)
             {
-                std::cout << message << std::endl;
+                std::cout << message + "\n" << std::flush;
             }
             else if (status == CALLBACKSTATUS::RUNNING)
             {
-                std::cout << message << std::endl;
+                std::cout << message + "\n" << std::flush;
             }
             else if (status == CALLBACKSTATUS::FINISHED)
             {
-                std::cout << message << std::endl;
+                std::cout << message + "\n" << std::flush;
             }
         }
 
         void CLIOutput::WriteFrame(int frame, int domain, PSTD_FRAME_PTR data)
         {
-            _file->SaveNextResultsFrame(domain, data);
+            unsigned long long bytes = _file->SaveNextResultsFrame(domain, data);
+            _committer.FrameWritten(_file.get(), bytes);
         }
 
         void CLIOutput::WriteSample(int startSample, int receiver, std::vector<float> data)
         {
             Kernel::PSTD_RECEIVER_DATA_PTR data_ptr = std::make_shared<Kernel::PSTD_RECEIVER_DATA>(data);
             _file->SaveReceiverData(receiver, data_ptr);
+            _committer.DataWritten(_file.get(), data_ptr->size() * sizeof(PSTD_FRAME_UNIT));
+        }
+
+        void CLIOutput::WriteProfile(const KernelProfile &profile)
+        {
+            _file->SaveResultsProfile(profile);
+        }
+
+        void CLIOutput::SetTraceFile(const std::string &filename)
+        {
+            _traceFile = filename;
+        }
+
+        void CLIOutput::SetName(const std::string &name)
+        {
+            _name = name;
+        }
+
+        void CLIOutput::WriteTrace(const KernelTrace &trace)
+        {
+            if (_traceFile.empty())
+                return;
+
+            //the results are already written, a trace that can not be written is only reported
+            std::ofstream output(_traceFile);
+            if (!output)
+            {
+                std::cerr << "error: can not open the trace file " << _traceFile << std::endl;
+                return;
+            }
+            trace.WriteChromeTrace(output);
+            output.close();
+            if (!output)
+            {
+                std::cerr << "error: can not write the trace file " << _traceFile << std::endl;
+                return;
+            }
+            std::cout << "Trace with " << trace.Events.size() << " events written to " << _traceFile;
+            if (trace.DroppedEvents > 0)
+            {
+                std::cout << " (" << trace.DroppedEvents << " older events dropped)";
+            }
+            std::cout << std::endl;
+        }
+
+        void CLIOutput::Checkpoint(int frame)
+        {
+            _committer.Commit(_file.get());
+        }
+
+        void CLIOutput::Finish()
+        {
+            _committer.Commit(_file.get());
+        }
+
+        Shared::CommitMetrics CLIOutput::GetCommitMetrics() const
+        {
+            return _committer.GetMetrics();
         }
     }
 }
\ No newline at end of file
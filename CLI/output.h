@@ -6,6 +6,7 @@
 #define OPENPSTD_OUTPUT_CLI_H
 
 #include <shared/PSTDFile.h>
+#include <shared/CommitPolicy.h>
 namespace OpenPSTD
 {
     namespace CLI
@@ -14,15 +15,50 @@ namespace OpenPSTD
         {
         private:
             std::shared_ptr<Shared::PSTDFile> _file;
+            Shared::PeriodicCommitter _committer;
+            std::string _traceFile;
+            std::string _name;
         public:
-            CLIOutput(std::shared_ptr<Shared::PSTDFile> file) : _file(file)
+            CLIOutput(std::shared_ptr<Shared::PSTDFile> file) : _file(file), _committer(Shared::CommitPolicy())
             { };
 
+            CLIOutput(std::shared_ptr<Shared::PSTDFile> file, Shared::CommitPolicy policy) : _file(file),
+                                                                                             _committer(policy)
+            { };
+
+            /**
+             * Commits the data that is not yet committed by the commit policy
+             */
+            void Finish();
+
+            Shared::CommitMetrics GetCommitMetrics() const;
+
+            /**
+             * The trace of the run is written to this file in the Chrome trace-event format, the trace is only
+             * received if tracing is enabled in the run options(KernelRunOptions::TraceBufferSize, set by --trace)
+             */
+            void SetTraceFile(const std::string &filename);
+
+            /**
+             * The messages of the kernel are prefixed with this name, so that the messages of concurrent runs can be
+             * told apart
+             */
+            void SetName(const std::string &name);
+
             virtual void Callback(Kernel::CALLBACKSTATUS status, std::string message, int frame) override;
 
             virtual void WriteFrame(int frame, int domain, Kernel::PSTD_FRAME_PTR data) override;
 
             virtual void WriteSample(int startSample, int receiver, std::vector<float> data) override;
+
+            virtual void WriteProfile(const Kernel::KernelProfile &profile) override;
+
+            virtual void WriteTrace(const Kernel::KernelTrace &trace) override;
+
+            /**
+             * Commits the results, so that a resumed run finds all the results up to the checkpoint
+             */
+            virtual void Checkpoint(int frame) override;
         };
     }
 }
@@ -46,12 +46,16 @@ void ApplicationSettings::UpdateFromModel(std::shared_ptr<Model> const &model)
         ui->rbMCPU->setChecked(model->settings->CPUAcceleration);
         ui->rbGPU->setChecked(model->settings->GPUAcceleration);
         ui->cbUseMockKernel->setChecked(model->settings->UseMockKernel);
+        ui->cbIndexResults->setChecked(model->settings->IndexResults);
+        ui->sbPreviewLevels->setValue(model->settings->PreviewLevels);
     }
 }
 
 void ApplicationSettings::UpdateToModel(std::shared_ptr<Model> const &model)
 {
     model->settings->UseMockKernel = ui->cbUseMockKernel->isChecked();
+    model->settings->IndexResults = ui->cbIndexResults->isChecked();
+    model->settings->PreviewLevels = (unsigned int)ui->sbPreviewLevels->value();
     model->settings->CPUAcceleration = ui->rbMCPU->isChecked();
     model->settings->GPUAcceleration = ui->rbGPU->isChecked();
 }
@@ -50,6 +50,8 @@ namespace OpenPSTD
             ui->sbSoundSpeed->setValue(settings.GetSoundSpeed());
             ui->sbCFLNumerRKScheme->setValue(settings.GetFactRK());
             ui->sbSaveEveryNth->setValue(settings.GetSaveNth());
+            ui->cbFrameStorage->setCurrentIndex((int)settings.GetFrameStorage());
+            ui->sbVisualizationErrorBound->setValue(settings.GetVisualizationErrorBound());
             this->settings = settings;
         }
 
@@ -64,6 +66,8 @@ namespace OpenPSTD
             settings.SetSoundSpeed(ui->sbSoundSpeed->value());
             settings.SetFactRK(ui->sbCFLNumerRKScheme->value());
             settings.SetSaveNth(ui->sbSaveEveryNth->value());
+            settings.SetFrameStorage((Kernel::FRAMESTORAGE)ui->cbFrameStorage->currentIndex());
+            settings.SetVisualizationErrorBound(ui->sbVisualizationErrorBound->value());
 
             return settings;
         }
@@ -15,7 +15,8 @@ set(SOURCE_FILES_GUI ${SOURCE_FILES_GUI}
 # Long operations
 set(SOURCE_FILES_GUI ${SOURCE_FILES_GUI}
         GUI/operations/long/LongOperationRunner.cpp
-        GUI/operations/long/SimulateLOperation.cpp)
+        GUI/operations/long/SimulateLOperation.cpp
+        GUI/operations/long/IndexResultsLOperation.cpp)
 # mouse handlers
 set(SOURCE_FILES_GUI ${SOURCE_FILES_GUI}
         GUI/mouse/MouseCreateDomainStrategy.cpp
@@ -40,6 +40,7 @@
 #include "operations/LambdaOperation.h"
 #include "operations/long/LOperationOperation.h"
 #include "operations/long/SimulateLOperation.h"
+#include "operations/long/IndexResultsLOperation.h"
 #include "mouse/MouseSelectStrategy.h"
 #include "mouse/MouseMoveSceneStrategy.h"
 #include "mouse/MouseCreateDomainStrategy.h"
@@ -155,6 +156,16 @@ namespace OpenPSTD
                                  auto startLOpOp = std::make_shared<StartLOperation>(simulationOp);
                                  //execute operation
                                  this->operationRunner.lock()->RunOperation(startLOpOp);
+                                 //index the results in the background after the simulation, if enabled
+                                 this->operationRunner.lock()->RunOperation(std::make_shared<LambdaOperation>(
+                                         [](const Reciever &reciever) {
+                                             if(reciever.model->settings->IndexResults)
+                                             {
+                                                 reciever.operationRunner->RunOperation(
+                                                         std::make_shared<StartLOperation>(
+                                                                 std::make_shared<IndexResultsLOperation>()));
+                                             }
+                                         }));
                              });
             QObject::connect(ui->actionStopAction, &QAction::triggered, this,
                              [&](bool checked) {
@@ -328,14 +339,14 @@ namespace OpenPSTD
             bool documentEdit = model->documentAccess->IsDocumentLoaded();
             if(documentEdit && model->documentAccess->IsChanged())
             {
-                auto doc = model->documentAccess->GetDocument();
+                auto snapshot = model->documentAccess->GetDocument()->GetResultsSnapshot();
                 bool anyFrame = false;
                 int max = 0;
-                int domains = doc->GetResultsDomainCount();
+                int domains = snapshot->GetResultsDomainCount();
 
                 for(int d = 0; d < domains; d++)
                 {
-                    int frameCount = doc->GetResultsFrameCount(d);
+                    int frameCount = snapshot->GetResultsFrameCount(d);
                     anyFrame |= frameCount > 0;
                     max = std::max(max, frameCount-1);
                 }
@@ -37,6 +37,7 @@
 #include <shared/InvalidationData.h>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
 
 namespace OpenPSTD
 {
@@ -74,6 +75,37 @@ namespace OpenPSTD
             float EdgeSize = 5.0f;
         };
 
+        /**
+         * Periodic commits of the results during a simulation. They are disabled by default, a commit saves the whole
+         * document, so also the changes of the scene that are not saved yet.
+         */
+        class CommitSettings
+        {
+        private:
+            friend class boost::serialization::access;
+            template<class Archive>
+            void serialize(Archive & ar, const unsigned int version)
+            {
+                ar & BOOST_SERIALIZATION_NVP(Frames);
+                ar & BOOST_SERIALIZATION_NVP(Megabytes);
+                ar & BOOST_SERIALIZATION_NVP(Seconds);
+            }
+
+        public:
+            /**
+             * Commit the results during a simulation every N frames (0 is disabled)
+             */
+            unsigned int Frames = 0;
+            /**
+             * Commit the results during a simulation every M megabytes (0 is disabled)
+             */
+            double Megabytes = 0;
+            /**
+             * Commit the results during a simulation every T seconds (0 is disabled)
+             */
+            double Seconds = 0;
+        };
+
 
         class Settings : public OpenPSTD::Shared::InvalidationData
         {
@@ -87,15 +119,38 @@ namespace OpenPSTD
                 ar & BOOST_SERIALIZATION_NVP(GPUAcceleration);
                 ar & BOOST_SERIALIZATION_NVP(CPUAcceleration);
                 ar & BOOST_SERIALIZATION_NVP(UseMockKernel);
+                if(version >= 1)
+                {
+                    ar & BOOST_SERIALIZATION_NVP(commit);
+                }
+                if(version >= 2)
+                {
+                    ar & BOOST_SERIALIZATION_NVP(IndexResults);
+                }
+                if(version >= 3)
+                {
+                    ar & BOOST_SERIALIZATION_NVP(PreviewLevels);
+                }
             }
 
         public:
             SnappingSettings snapping;
             VisualSettings visual;
+            CommitSettings commit;
 
             bool GPUAcceleration = false;
             bool CPUAcceleration = false;
             bool UseMockKernel = false;
+            /**
+             * Build the time-major index of the results after a simulation, this makes reading the time series of a
+             * point faster, but writes a second copy of the results to the document
+             */
+            bool IndexResults = false;
+            /**
+             * The number of downsampled preview levels that are stored with the results of a simulation, the results
+             * layer shows the levels up to 3 when the view is zoomed out(0 creates the levels when they are shown)
+             */
+            unsigned int PreviewLevels = 3;
 
             static std::shared_ptr<Settings> Load();
             void Save();
@@ -103,4 +158,6 @@ namespace OpenPSTD
     }
 }
 
+BOOST_CLASS_VERSION(OpenPSTD::GUI::Settings, 3)
+
 #endif //OPENPSTD_SETTINGS_H
@@ -30,14 +30,18 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "ResultsLayer.h"
-#include <kernel/MockKernel.h>
+#include <shared/FramePyramid.h>
 #include <queue>
+#include <cmath>
+
+//the maximum preview level that is used, levels that are not stored with the results are created from the frames
+#define RESULTS_LAYER_MAX_PREVIEW_LEVEL 3
 
 namespace OpenPSTD
 {
     namespace GUI
     {
-        ResultsLayer::ResultsLayer()
+        ResultsLayer::ResultsLayer(): incomplete(false), previewLevel(0), gridSpacing(0)
         {
 
         }
@@ -106,23 +110,41 @@ namespace OpenPSTD
                                        std::unique_ptr<QOpenGLFunctions, void (*)(void *)> const &f)
         {
             program->bind();
+            bool levelChanged = false;
             if (m->view->IsChanged())
             {
                 program->setUniformValue("u_view", m->view->viewMatrix);
+
+                //zooming out shows the frames with less cells, the textures are only uploaded again if that changes
+                unsigned int level = this->ComputePreviewLevel(m, f);
+                levelChanged = level != this->previewLevel;
+                this->previewLevel = level;
             }
 
-            if (m->documentAccess->IsChanged() || m->interactive->IsChanged())
+            if (m->documentAccess->IsChanged() || m->interactive->IsChanged() || this->incomplete || levelChanged)
             {
+                //the snapshot does not wait for a running simulation that is writing results
                 auto doc = m->documentAccess->GetDocument();
-                auto conf = doc->GetResultsSceneConf();
+                auto snapshot = doc->GetResultsSnapshot();
                 int frame = m->interactive->visibleFrame;
+                this->incomplete = false;
+
+                //scale the colors with the peak of the results, the statistics are stored when the frames are written
+                float peak = snapshot->GetResultsStatistics().GetPeak();
+                if(peak > 0)
+                {
+                    program->setUniformValue("vmin", -peak);
+                    program->setUniformValue("vmax", peak);
+                }
+
+                const Kernel::SimulationMetadata &metadata = snapshot->GetResultsMetadata();
 
-                Kernel::SimulationMetadata metadata;
+                if(this->gridSpacing != metadata.GridSpacing)
                 {
-                    Kernel::MockKernel k;
-                    k.initialize_kernel(conf);
-                    metadata = k.get_metadata();
+                    this->gridSpacing = metadata.GridSpacing;
+                    this->previewLevel = this->ComputePreviewLevel(m, f);
                 }
+                unsigned int level = this->previewLevel;
 
                 //store buffers in queue for re-use. Using queues, because in most cases the former sizes matches the
                 //new sizes, this will speed up the reusage.
@@ -137,18 +159,26 @@ namespace OpenPSTD
                 this->RenderInfo.clear();
                 if(frame >= 0)
                 {
-                    for (int i = 0; i < doc->GetResultsDomainCount(); i++)
+                    for (int i = 0; i < snapshot->GetResultsDomainCount(); i++)
                     {
-                        int frameCount = doc->GetResultsFrameCount(i);
+                        int frameCount = snapshot->GetResultsFrameCount(i);
+                        Kernel::PSTD_FRAME_CONST_PTR values;
                         if (frame < frameCount)
+                        {
+                            values = doc->GetSnapshotFrame(*snapshot, frame, i, level);
+                            //the writer is busy with the file, try again with the next update
+                            this->incomplete |= !values;
+                        }
+
+                        if (values)
                         {
                             DomainGLInfo info;
 
                             //create positions buffer
                             QVector2D pos(metadata.DomainPositions[i][0], metadata.DomainPositions[i][1]);
                             QVector2D size(metadata.DomainMetadata[i][0], metadata.DomainMetadata[i][1]);
-                            pos *= conf->Settings.GetGridSpacing();
-                            size *= conf->Settings.GetGridSpacing();
+                            pos *= metadata.GridSpacing;
+                            size *= metadata.GridSpacing;
 
                             std::vector<QVector2D> worldPos;
                             worldPos.push_back(pos + QVector2D(0, 0) * size);
@@ -171,8 +201,6 @@ namespace OpenPSTD
                                             GL_DYNAMIC_DRAW);
 
                             //create the values texture
-                            Kernel::PSTD_FRAME_PTR values = doc->GetResultsFrame(frame, i);
-
                             if (ReUsePosBuffer.size() > 0)
                             {
                                 info.texture = ReUseTexture.front();
@@ -185,8 +213,10 @@ namespace OpenPSTD
 
                             f->glActiveTexture(GL_TEXTURE1);
                             f->glBindTexture(GL_TEXTURE_2D, info.texture);
-                            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, metadata.DomainMetadata[i][0],
-                                         metadata.DomainMetadata[i][1], 0, GL_RED, GL_FLOAT, values->data());
+                            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F,
+                                         Shared::FramePyramid::LevelSize(metadata.DomainMetadata[i][0], level),
+                                         Shared::FramePyramid::LevelSize(metadata.DomainMetadata[i][1], level), 0,
+                                         GL_RED, GL_FLOAT, values->data());
 
                             f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                             f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -213,6 +243,24 @@ namespace OpenPSTD
             }
         }
 
+        unsigned int ResultsLayer::ComputePreviewLevel(std::shared_ptr<Model> const &m,
+                                                       std::unique_ptr<QOpenGLFunctions, void (*)(void *)> const &f)
+        {
+            if(this->gridSpacing <= 0)
+                return 0;
+
+            GLint viewport[4];
+            f->glGetIntegerv(GL_VIEWPORT, viewport);
+
+            //the view matrix maps the world to [-1, 1], half of the width of the viewport
+            float pixelsPerCell = std::abs(m->view->viewMatrix(0, 0)) * viewport[2] / 2 * this->gridSpacing;
+            if(pixelsPerCell <= 0 || pixelsPerCell >= 1)
+                return 0;
+
+            int level = (int)std::floor(std::log2(1 / pixelsPerCell));
+            return (unsigned int)std::max(0, std::min(level, RESULTS_LAYER_MAX_PREVIEW_LEVEL));
+        }
+
         MinMaxValue ResultsLayer::GetMinMax()
         {
             return GUI::MinMaxValue();
@@ -52,6 +52,19 @@ namespace OpenPSTD
             std::unique_ptr<QOpenGLShaderProgram> program;
             GLuint texCoordsBuffer;
             std::vector<DomainGLInfo> RenderInfo;
+            /**
+             * True if not all frames could be read from the snapshot without waiting
+             */
+            bool incomplete;
+            /**
+             * The preview level of the frames that are shown and the grid spacing of the shown results, the level is
+             * chosen so that a cell of the level is not much smaller than a pixel on the screen
+             */
+            unsigned int previewLevel;
+            float gridSpacing;
+
+            unsigned int ComputePreviewLevel(std::shared_ptr<Model> const &m,
+                                             std::unique_ptr<QOpenGLFunctions, void (*)(void *)> const &f);
 
         public:
             ResultsLayer();
@@ -161,14 +161,14 @@ namespace OpenPSTD
 
         void ChangeViewingFrame::Run(const Reciever &reciever)
         {
-            auto doc = reciever.model->documentAccess->GetDocument();
+            auto snapshot = reciever.model->documentAccess->GetDocument()->GetResultsSnapshot();
             int min = INT_MAX;
             int max = INT_MIN;
-            int domains = doc->GetResultsDomainCount();
+            int domains = snapshot->GetResultsDomainCount();
 
             for(int d = 0; d < domains; d++)
             {
-                int frameCount = doc->GetResultsFrameCount(d);
+                int frameCount = snapshot->GetResultsFrameCount(d);
                 if(frameCount > 0)
                 {
                     min = 0;
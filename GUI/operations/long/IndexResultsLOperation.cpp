@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Writes the time-major index of the results in the background
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IndexResultsLOperation.h"
+#include "../../Model.h"
+#include <shared/CommitPolicy.h>
+
+using namespace OpenPSTD::GUI;
+
+IndexResultsLOperation::IndexResultsLOperation():
+    progress(0),
+    started(false),
+    finished(false)
+{
+
+}
+
+std::string IndexResultsLOperation::GetName()
+{
+    return "Index results";
+}
+
+float IndexResultsLOperation::GetProgress()
+{
+    return this->progress;
+}
+
+void IndexResultsLOperation::Run(const Reciever &reciever)
+{
+    this->started = true;
+
+    std::shared_ptr<OpenPSTD::Shared::PSTDFile> file;
+    {
+        auto doc = reciever.model->documentAccess->GetDocument();
+        file = doc.get();
+    }//the index is written without the document lock, the file only locks the backend for single reads and writes
+
+    file->BuildTimeSeriesIndex(32, 64, [this](float progress) {
+        this->progress = progress;
+        this->Update();
+    });
+
+    //with periodic commits the results are committed, otherwise the index is saved with the document
+    OpenPSTD::Shared::CommitPolicy policy;
+    policy.Frames = reciever.model->settings->commit.Frames;
+    policy.Megabytes = reciever.model->settings->commit.Megabytes;
+    policy.Seconds = reciever.model->settings->commit.Seconds;
+    if(policy.IsEnabled())
+    {
+        file->Commit();
+    }
+
+    this->progress = 1;
+    this->finished = true;
+}
+
+bool IndexResultsLOperation::Started()
+{
+    return started;
+}
+
+bool IndexResultsLOperation::Finished()
+{
+    return finished;
+}
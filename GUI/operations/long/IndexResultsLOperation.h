@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Writes the time-major index of the results in the background
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_INDEXRESULTSLOPERATION_H
+#define OPENPSTD_INDEXRESULTSLOPERATION_H
+
+#include "LongOperationRunner.h"
+#include <shared/PSTDFileAccess.h>
+
+namespace OpenPSTD
+{
+    namespace GUI
+    {
+
+        /**
+         * Writes the time-major index of the results(see PSTDFile::BuildTimeSeriesIndex), so that the time series of
+         * any cell can be read quickly. This is enqueued after the simulation.
+         */
+        class IndexResultsLOperation : public LongOperation
+        {
+        private:
+            float progress;
+            bool started;
+            bool finished;
+
+        public:
+            IndexResultsLOperation();
+
+            //interface of LongOperation and BaseOperation
+            std::string GetName();
+            float GetProgress();
+            void Run(const Reciever &reciever);
+            bool Started();
+            bool Finished();
+        };
+    }
+}
+
+#endif //OPENPSTD_INDEXRESULTSLOPERATION_H
@@ -59,16 +59,27 @@ void SimulateLOperation::Run(const Reciever &reciever)
 {
     this->started = true;
     this->pstdFileAccess = reciever.model->documentAccess;
+
+    OpenPSTD::Shared::CommitPolicy policy;
+    policy.Frames = reciever.model->settings->commit.Frames;
+    policy.Megabytes = reciever.model->settings->commit.Megabytes;
+    policy.Seconds = reciever.model->settings->commit.Seconds;
+    this->committer = std::unique_ptr<OpenPSTD::Shared::PeriodicCommitter>(
+            new OpenPSTD::Shared::PeriodicCommitter(policy));
+
     std::shared_ptr<PSTDConfiguration> conf;
     {
         auto doc = this->pstdFileAccess->GetDocument();
 
         //make room in the document for results
         doc->DeleteResults();
+        doc->SetPreviewLevels(reciever.model->settings->PreviewLevels);
         doc->InitializeResults();
 
         //get the configuration
         conf = doc->GetResultsSceneConf();
+
+        this->file = doc.get();
     }//make sure the doc ptr does not exist (release of the lock)
     //create and initialize kernel
     std::unique_ptr<KernelInterface> kernel;
@@ -87,6 +98,17 @@ void SimulateLOperation::Run(const Reciever &reciever)
     metadata = kernel->get_metadata();
     //execute kernel
     kernel->run(this);
+
+    //commit the remaining results when periodic commits are used, otherwise the results are saved with the document
+    if(policy.IsEnabled())
+    {
+        this->committer->Commit(this->file.get());
+    }
+    else
+    {
+        this->file->PublishResults();
+    }
+    this->file = nullptr;
     this->finished = true;
 }
 
@@ -107,19 +129,23 @@ void SimulateLOperation::Callback(CALLBACKSTATUS status, std::string message,
     if(frame >= 0)
     {
         this->currentFrame = frame;
+        //make the finished frame visible for the readers
+        this->file->PublishResults();
     }
     //todo something with status and message
 }
 
 void SimulateLOperation::WriteFrame(int frame, int domain, PSTD_FRAME_PTR data)
 {
-    this->pstdFileAccess->GetDocument()->SaveNextResultsFrame(domain, data);
+    unsigned long long bytes = this->file->SaveNextResultsFrame(domain, data);
+    this->committer->FrameWritten(this->file.get(), bytes);
 }
 
 void SimulateLOperation::WriteSample(int startSample, int receiver, std::vector<float> data)
 {
     Kernel::PSTD_RECEIVER_DATA_PTR data_ptr = std::make_shared<Kernel::PSTD_RECEIVER_DATA>(data);
-    this->pstdFileAccess->GetDocument()->SaveReceiverData(receiver, data_ptr);
+    this->file->SaveReceiverData(receiver, data_ptr);
+    this->committer->DataWritten(this->file.get(), data_ptr->size() * sizeof(PSTD_FRAME_UNIT));
 }
 
 
@@ -35,6 +35,7 @@
 #include "LongOperationRunner.h"
 #include <kernel/KernelInterface.h>
 #include <shared/PSTDFileAccess.h>
+#include <shared/CommitPolicy.h>
 
 namespace OpenPSTD
 {
@@ -48,7 +49,13 @@ namespace OpenPSTD
         {
         private:
             std::shared_ptr<OpenPSTD::Shared::PSTDFileAccess> pstdFileAccess;
+            /**
+             * The file the results are written to, the PSTDFile synchronizes the writes itself, so the document lock is
+             * not held while the kernel runs(readers use the published snapshots of the results).
+             */
+            std::shared_ptr<OpenPSTD::Shared::PSTDFile> file;
             OpenPSTD::Kernel::SimulationMetadata metadata;
+            std::unique_ptr<OpenPSTD::Shared::PeriodicCommitter> committer;
             int currentFrame;
             bool started;
             bool finished;
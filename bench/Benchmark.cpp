@@ -0,0 +1,262 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+namespace OpenPSTD
+{
+    namespace Bench
+    {
+        using namespace std::chrono;
+
+        BenchmarkState::BenchmarkState(int size, double minSeconds, unsigned long long minIterations):
+                size(size),
+                minSeconds(minSeconds),
+                minIterations(minIterations)
+        {
+        }
+
+        int BenchmarkState::GetSize() const
+        {
+            return this->size;
+        }
+
+        bool BenchmarkState::KeepRunning()
+        {
+            if(!this->started)
+            {
+                this->started = true;
+                this->start = steady_clock::now();
+                return true;
+            }
+
+            this->iterations++;
+            if(this->iterations < this->minIterations)
+                return true;
+
+            steady_clock::duration total = this->elapsed;
+            if(!this->paused)
+                total += steady_clock::now() - this->start;
+
+            if(duration<double>(total).count() < this->minSeconds)
+                return true;
+
+            this->elapsed = total;
+            this->paused = true;
+            return false;
+        }
+
+        void BenchmarkState::PauseTiming()
+        {
+            if(this->paused)
+                return;
+            this->elapsed += steady_clock::now() - this->start;
+            this->paused = true;
+        }
+
+        void BenchmarkState::ResumeTiming()
+        {
+            if(!this->paused)
+                return;
+            this->start = steady_clock::now();
+            this->paused = false;
+        }
+
+        void BenchmarkState::SetCellsPerIteration(double value)
+        {
+            this->cells = value;
+        }
+
+        void BenchmarkState::SetBytesPerIteration(double value)
+        {
+            this->bytes = value;
+        }
+
+        unsigned long long BenchmarkState::GetIterations() const
+        {
+            return this->iterations;
+        }
+
+        double BenchmarkState::GetSeconds() const
+        {
+            return duration<double>(this->elapsed).count();
+        }
+
+        double BenchmarkState::GetCellsPerIteration() const
+        {
+            return this->cells;
+        }
+
+        double BenchmarkState::GetBytesPerIteration() const
+        {
+            return this->bytes;
+        }
+
+        std::vector<Benchmark> &GetBenchmarks()
+        {
+            static std::vector<Benchmark> benchmarks;
+            return benchmarks;
+        }
+
+        BenchmarkRegistrar::BenchmarkRegistrar(std::string name, std::vector<int> sizes, BenchmarkFunction function)
+        {
+            Benchmark benchmark;
+            benchmark.Name = name;
+            benchmark.Sizes = sizes;
+            benchmark.Function = function;
+            GetBenchmarks().push_back(benchmark);
+        }
+
+        BenchmarkResult RunBenchmark(const Benchmark &benchmark, int size, double minSeconds, int repetitions)
+        {
+            //warm up the caches, plans and allocations, the result is not used
+            BenchmarkState warmup(size, 0, 1);
+            benchmark.Function(warmup);
+
+            BenchmarkResult result;
+            result.Name = benchmark.Name;
+            result.Size = size;
+
+            std::vector<double> seconds;
+            double cells = 0;
+            double bytes = 0;
+            for (int r = 0; r < std::max(1, repetitions); r++)
+            {
+                BenchmarkState state(size, minSeconds, 1);
+                benchmark.Function(state);
+                if(state.GetIterations() == 0)
+                    continue;
+
+                seconds.push_back(state.GetSeconds() / state.GetIterations());
+                result.Iterations += state.GetIterations();
+                cells = state.GetCellsPerIteration();
+                bytes = state.GetBytesPerIteration();
+            }
+
+            if(seconds.empty())
+                return result;
+
+            std::sort(seconds.begin(), seconds.end());
+            result.Seconds = seconds[seconds.size() / 2];
+            result.MinSeconds = seconds.front();
+            if(result.Seconds > 0)
+            {
+                result.CellsPerSecond = cells / result.Seconds;
+                result.BytesPerSecond = bytes / result.Seconds;
+            }
+            return result;
+        }
+
+        void WriteResults(std::ostream &out, const std::vector<BenchmarkResult> &results)
+        {
+            std::time_t now = system_clock::to_time_t(system_clock::now());
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+            out << std::setprecision(9);
+            out << "{\n";
+            out << "  \"context\": {\n";
+            out << "    \"date\": \"" << date << "\",\n";
+            out << "    \"threads\": " << std::thread::hardware_concurrency() << "\n";
+            out << "  },\n";
+            out << "  \"benchmarks\": [";
+            for (unsigned int i = 0; i < results.size(); i++)
+            {
+                const BenchmarkResult &result = results[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    {\n";
+                out << "      \"name\": \"" << result.Name << "\",\n";
+                out << "      \"size\": " << result.Size << ",\n";
+                out << "      \"iterations\": " << result.Iterations << ",\n";
+                out << "      \"seconds\": " << result.Seconds << ",\n";
+                out << "      \"min_seconds\": " << result.MinSeconds << ",\n";
+                out << "      \"cells_per_second\": " << result.CellsPerSecond << ",\n";
+                out << "      \"bytes_per_second\": " << result.BytesPerSecond << "\n";
+                out << "    }";
+            }
+            out << (results.empty() ? "]\n" : "\n  ]\n");
+            out << "}\n";
+        }
+
+        std::vector<BenchmarkResult> ReadResults(std::string filename)
+        {
+            boost::property_tree::ptree tree;
+            boost::property_tree::read_json(filename, tree);
+
+            std::vector<BenchmarkResult> results;
+            for (auto &item : tree.get_child("benchmarks"))
+            {
+                BenchmarkResult result;
+                result.Name = item.second.get<std::string>("name");
+                result.Size = item.second.get<int>("size");
+                result.Iterations = item.second.get<unsigned long long>("iterations");
+                result.Seconds = item.second.get<double>("seconds");
+                result.MinSeconds = item.second.get<double>("min_seconds");
+                result.CellsPerSecond = item.second.get<double>("cells_per_second");
+                result.BytesPerSecond = item.second.get<double>("bytes_per_second");
+                results.push_back(result);
+            }
+            return results;
+        }
+
+        void PrintResults(std::ostream &out, const std::vector<BenchmarkResult> &results,
+                          const std::vector<BenchmarkResult> &baseline)
+        {
+            std::map<std::pair<std::string, int>, double> baselineSeconds;
+            for (auto &result : baseline)
+            {
+                baselineSeconds[std::make_pair(result.Name, result.Size)] = result.Seconds;
+            }
+
+            out << std::left << std::setw(40) << "benchmark" << std::right << std::setw(8) << "size"
+                << std::setw(14) << "time(us)" << std::setw(14) << "Mcells/s" << std::setw(10) << "GB/s";
+            if(!baseline.empty())
+                out << std::setw(10) << "speedup";
+            out << std::endl;
+
+            for (auto &result : results)
+            {
+                out << std::left << std::setw(40) << result.Name << std::right << std::setw(8) << result.Size
+                    << std::fixed << std::setprecision(2)
+                    << std::setw(14) << result.Seconds * 1e6
+                    << std::setw(14) << result.CellsPerSecond / 1e6
+                    << std::setw(10) << result.BytesPerSecond / 1e9;
+
+                auto it = baselineSeconds.find(std::make_pair(result.Name, result.Size));
+                if(it != baselineSeconds.end() && result.Seconds > 0)
+                    out << std::setw(9) << it->second / result.Seconds << "x";
+                out << std::endl;
+                out.unsetf(std::ios::fixed);
+            }
+        }
+
+        static volatile float keptValue;
+
+        void KeepValue(float value)
+        {
+            keptValue = value;
+        }
+    }
+}
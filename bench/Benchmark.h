@@ -0,0 +1,173 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Registration, timing and reporting of the micro-benchmarks
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_BENCHMARK_H
+#define OPENPSTD_BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Bench
+    {
+        /**
+         * The state of a single run of a benchmark. The benchmark does its setup, then repeats the measured work
+         * while KeepRunning returns true. Only the time between the first and the last call of KeepRunning is
+         * measured.
+         */
+        class BenchmarkState
+        {
+        private:
+            int size;
+            double minSeconds;
+            unsigned long long minIterations;
+            unsigned long long iterations = 0;
+            bool started = false;
+            bool paused = false;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::duration::zero();
+            double cells = 0;
+            double bytes = 0;
+
+        public:
+            BenchmarkState(int size, double minSeconds, unsigned long long minIterations);
+
+            /**
+             * The size of the sweep that is measured, the meaning depends on the benchmark(e.g. the number of cells
+             * in a single dimension of a domain)
+             */
+            int GetSize() const;
+
+            /**
+             * True as long as the work should be repeated
+             */
+            bool KeepRunning();
+
+            /**
+             * Excludes work from the measurement(e.g. setup that has to be done for every iteration)
+             */
+            void PauseTiming();
+            void ResumeTiming();
+
+            /**
+             * The number of cells that are updated by a single iteration, used for the cells per second
+             */
+            void SetCellsPerIteration(double value);
+
+            /**
+             * The number of bytes that are read and written by a single iteration, used for the bandwidth. This is
+             * the data that is used by the primitive, not the traffic to memory.
+             */
+            void SetBytesPerIteration(double value);
+
+            unsigned long long GetIterations() const;
+            double GetSeconds() const;
+            double GetCellsPerIteration() const;
+            double GetBytesPerIteration() const;
+        };
+
+        typedef std::function<void(BenchmarkState &)> BenchmarkFunction;
+
+        class Benchmark
+        {
+        public:
+            std::string Name;
+            std::vector<int> Sizes;
+            BenchmarkFunction Function;
+        };
+
+        class BenchmarkResult
+        {
+        public:
+            std::string Name;
+            int Size = 0;
+            unsigned long long Iterations = 0;
+
+            /**
+             * The median and the minimum of the time of a single iteration over the repetitions
+             */
+            double Seconds = 0;
+            double MinSeconds = 0;
+
+            double CellsPerSecond = 0;
+            double BytesPerSecond = 0;
+        };
+
+        /**
+         * All the benchmarks that are registered with OPENPSTD_BENCHMARK
+         */
+        std::vector<Benchmark> &GetBenchmarks();
+
+        class BenchmarkRegistrar
+        {
+        public:
+            BenchmarkRegistrar(std::string name, std::vector<int> sizes, BenchmarkFunction function);
+        };
+
+        /**
+         * Runs a benchmark for a single size. The benchmark is run once to warm up, after that it is run for a number
+         * of repetitions that take at least minSeconds each.
+         */
+        BenchmarkResult RunBenchmark(const Benchmark &benchmark, int size, double minSeconds, int repetitions);
+
+        /**
+         * Writes the results as JSON, so that results of different builds can be compared
+         */
+        void WriteResults(std::ostream &out, const std::vector<BenchmarkResult> &results);
+
+        /**
+         * Reads results that are written with WriteResults
+         */
+        std::vector<BenchmarkResult> ReadResults(std::string filename);
+
+        /**
+         * Prints a table with the results, when a baseline is given the speedup compared to the baseline is added
+         */
+        void PrintResults(std::ostream &out, const std::vector<BenchmarkResult> &results,
+                          const std::vector<BenchmarkResult> &baseline);
+
+        /**
+         * Makes sure that the compiler does not remove the computation of a value that is not used
+         */
+        void KeepValue(float value);
+    }
+}
+
+/**
+ * Registers a benchmark that is run for every size that is given, for example:
+ * OPENPSTD_BENCHMARK(my_benchmark, 64, 128, 256)
+ * {
+ *     while (state.KeepRunning()) { ... }
+ * }
+ */
+#define OPENPSTD_BENCHMARK(name, ...) \
+    static void name(OpenPSTD::Bench::BenchmarkState &state); \
+    static OpenPSTD::Bench::BenchmarkRegistrar name##_registrar(#name, std::vector<int>{__VA_ARGS__}, &name); \
+    static void name(OpenPSTD::Bench::BenchmarkState &state)
+
+#endif //OPENPSTD_BENCHMARK_H
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Benchmarks of the domain updates, the field update of the solver and the speaker contribution
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.h"
+#include <kernel/PSTDKernel.h>
+#include <kernel/Solver.h>
+#include <kernel/core/Domain.h>
+#include <kernel/core/Speaker.h>
+
+using namespace OpenPSTD;
+using namespace OpenPSTD::Kernel;
+
+namespace
+{
+    /**
+     * Creates a scene with a single square domain of size x size cells(surrounded by the PML domains) with a speaker
+     * in the center
+     */
+    std::shared_ptr<Scene> CreateScene(int size)
+    {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        float gridSpacing = conf->Settings.GetGridSpacing();
+
+        DomainConf domain;
+        domain.TopLeft = QVector2D(0, 0);
+        domain.Size = QVector2D(size * gridSpacing, size * gridSpacing);
+        domain.SetAbsorption(PSTD_DOMAIN_SIDE_ALL, 0.2f);
+        domain.SetLR(PSTD_DOMAIN_SIDE_ALL, false);
+        conf->Domains.clear();
+        conf->Domains.push_back(domain);
+        conf->Speakers.clear();
+        conf->Speakers.push_back(QVector3D(size * gridSpacing / 2, size * gridSpacing / 2, 0));
+        conf->Receivers.clear();
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        return kernel.get_scene();
+    }
+
+    void BenchmarkCalc(Bench::BenchmarkState &state, CalcDirection cd, CalculationType ct)
+    {
+        auto scene = CreateScene(state.GetSize());
+        auto domain = scene->domain_list.at(0);
+
+        while (state.KeepRunning())
+        {
+            domain->calc(cd, ct);
+        }
+
+        double cells = (double) domain->size.x * domain->size.y;
+        state.SetCellsPerIteration(cells);
+        //the own field, the fields of both neighbours and the derivative
+        state.SetBytesPerIteration(4 * sizeof(float) * cells);
+    }
+
+    /**
+     * Gives access to the field update of the solver
+     */
+    class BenchmarkSolver : public SingleThreadSolver
+    {
+    public:
+        using SingleThreadSolver::SingleThreadSolver;
+        using Solver::update_field_values;
+    };
+}
+
+OPENPSTD_BENCHMARK(domain_calc_pressure_x, 64, 128, 256, 512)
+{
+    BenchmarkCalc(state, CalcDirection::X, CalculationType::PRESSURE);
+}
+
+OPENPSTD_BENCHMARK(domain_calc_pressure_y, 64, 128, 256, 512)
+{
+    BenchmarkCalc(state, CalcDirection::Y, CalculationType::PRESSURE);
+}
+
+OPENPSTD_BENCHMARK(domain_calc_velocity_x, 64, 128, 256, 512)
+{
+    BenchmarkCalc(state, CalcDirection::X, CalculationType::VELOCITY);
+}
+
+OPENPSTD_BENCHMARK(domain_calc_velocity_y, 64, 128, 256, 512)
+{
+    BenchmarkCalc(state, CalcDirection::Y, CalculationType::VELOCITY);
+}
+
+OPENPSTD_BENCHMARK(solver_update_field_values, 64, 128, 256, 512, 1024)
+{
+    auto scene = CreateScene(state.GetSize());
+    auto domain = scene->domain_list.at(0);
+    domain->push_values();
+    BenchmarkSolver solver(scene, nullptr);
+
+    unsigned long rk_step = 0;
+    while (state.KeepRunning())
+    {
+        solver.update_field_values(domain, rk_step, 0);
+        rk_step = (rk_step + 1) % 6;
+    }
+
+    double cells = (double) domain->size.x * domain->size.y;
+    state.SetCellsPerIteration(cells);
+    //reads the previous fields and the derivatives, writes the current fields(4 arrays each)
+    state.SetBytesPerIteration(12 * sizeof(float) * cells);
+}
+
+OPENPSTD_BENCHMARK(speaker_add_domain_contribution, 64, 128, 256, 512)
+{
+    auto scene = CreateScene(state.GetSize());
+    auto domain = scene->domain_list.at(0);
+    Speaker speaker({state.GetSize() / 2.0f, state.GetSize() / 2.0f, 0});
+
+    while (state.KeepRunning())
+    {
+        speaker.addDomainContribution(domain);
+    }
+
+    double cells = (double) domain->size.x * domain->size.y;
+    state.SetCellsPerIteration(cells);
+    //reads and writes the pressure and both the pressure components
+    state.SetBytesPerIteration(6 * sizeof(float) * cells);
+}
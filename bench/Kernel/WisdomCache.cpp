@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Benchmarks of the lookups in the wisdom cache
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.h"
+#include <kernel/core/WisdomCache.h>
+
+using namespace OpenPSTD;
+using namespace OpenPSTD::Kernel;
+
+OPENPSTD_BENCHMARK(wisdom_discretization_lookup, 128, 512, 2048)
+{
+    WisdomCache wnd;
+    float dx = 0.2f;
+    wnd.get_discretization(dx, state.GetSize());
+
+    while (state.KeepRunning())
+    {
+        WisdomCache::Discretization discretization = wnd.get_discretization(dx, state.GetSize());
+        Bench::KeepValue(discretization.wave_numbers(1));
+    }
+
+    //the discretization is copied on every lookup
+    auto discretization = wnd.get_discretization(dx, state.GetSize());
+    state.SetBytesPerIteration(sizeof(float) * discretization.wave_numbers.size() +
+                               sizeof(std::complex<float>) * (discretization.complex_factors.size() +
+                                                              discretization.pressure_deriv_factors.size() +
+                                                              discretization.velocity_deriv_factors.size()));
+}
+
+OPENPSTD_BENCHMARK(wisdom_fftw_planset_lookup, 128, 512, 2048)
+{
+    WisdomCache wnd;
+    wnd.get_fftw_planset(state.GetSize(), state.GetSize());
+
+    while (state.KeepRunning())
+    {
+        WisdomCache::Planset_FFTW planset = wnd.get_fftw_planset(state.GetSize(), state.GetSize());
+        Bench::KeepValue(planset.plan != nullptr ? 1 : 0);
+    }
+}
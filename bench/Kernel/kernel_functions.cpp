@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Benchmarks of the spatial derivatives
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.h"
+#include <kernel/core/kernel_functions.h>
+#include <kernel/core/WisdomCache.h>
+#include <kernel/KernelInterface.h>
+#include <cmath>
+
+using namespace OpenPSTD;
+using namespace OpenPSTD::Kernel;
+
+namespace
+{
+    /**
+     * The input of spatderp3 for a square domain of size x size cells with a neighbour on both sides, the shapes and
+     * the derivative factors are created the same way as in Domain::calc
+     */
+    struct SpatialDerivativeInput
+    {
+        Eigen::ArrayXXf p1, p2, p3;
+        Eigen::ArrayXcf derfact;
+        RhoArray rho_array;
+        Eigen::ArrayXf window;
+        int wlen;
+    };
+
+    SpatialDerivativeInput CreateInput(int size, CalculationType ct, CalcDirection cd)
+    {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        SpatialDerivativeInput input;
+
+        input.wlen = conf->Settings.GetWindowSize();
+        while (input.wlen > size)
+        {
+            input.wlen = input.wlen / 2;
+        }
+        input.window = get_window_coefficients(input.wlen, conf->Settings.GetPatchError());
+        input.rho_array = get_rho_array(1.2f, 1.2f, 1.2f);
+
+        //the velocity has an extra cell in the direction of the velocity
+        int rows = size, cols = size;
+        if (ct == CalculationType::VELOCITY)
+        {
+            if (cd == CalcDirection::X)
+                cols++;
+            else
+                rows++;
+        }
+
+        //smooth and deterministic fields, so that every run does the same work
+        input.p1 = Eigen::ArrayXXf(rows, cols);
+        input.p2 = Eigen::ArrayXXf(rows, cols);
+        input.p3 = Eigen::ArrayXXf(rows, cols);
+        for (int j = 0; j < cols; j++)
+        {
+            for (int i = 0; i < rows; i++)
+            {
+                input.p1(i, j) = std::sin(0.05f * i + 0.03f * j);
+                input.p2(i, j) = std::sin(0.07f * i - 0.02f * j);
+                input.p3(i, j) = std::cos(0.04f * i + 0.06f * j);
+            }
+        }
+
+        int N_total = 2 * input.wlen + (cd == CalcDirection::X ? cols : rows);
+        WisdomCache wnd;
+        if (ct == CalculationType::PRESSURE)
+        {
+            input.derfact = wnd.get_discretization(conf->Settings.GetGridSpacing(), N_total).pressure_deriv_factors;
+        }
+        else
+        {
+            input.derfact = wnd.get_discretization(conf->Settings.GetGridSpacing(), N_total).velocity_deriv_factors;
+        }
+        return input;
+    }
+
+    void BenchmarkSpatialDerivative(Bench::BenchmarkState &state, CalculationType ct, CalcDirection cd)
+    {
+        SpatialDerivativeInput input = CreateInput(state.GetSize(), ct, cd);
+
+        Eigen::ArrayXXf result;
+        while (state.KeepRunning())
+        {
+            result = spatderp3(input.p1, input.p2, input.p3, input.derfact, input.rho_array, input.window, input.wlen,
+                               ct, cd);
+            Bench::KeepValue(result(0, 0));
+        }
+
+        state.SetCellsPerIteration((double) state.GetSize() * state.GetSize());
+        state.SetBytesPerIteration(sizeof(float) * (3.0 * input.p2.size() + result.size()));
+    }
+}
+
+OPENPSTD_BENCHMARK(spatderp3_pressure_x, 64, 128, 256, 512, 1024)
+{
+    BenchmarkSpatialDerivative(state, CalculationType::PRESSURE, CalcDirection::X);
+}
+
+OPENPSTD_BENCHMARK(spatderp3_pressure_y, 64, 128, 256, 512, 1024)
+{
+    BenchmarkSpatialDerivative(state, CalculationType::PRESSURE, CalcDirection::Y);
+}
+
+OPENPSTD_BENCHMARK(spatderp3_velocity_x, 64, 128, 256, 512, 1024)
+{
+    BenchmarkSpatialDerivative(state, CalculationType::VELOCITY, CalcDirection::X);
+}
+
+OPENPSTD_BENCHMARK(spatderp3_velocity_y, 64, 128, 256, 512, 1024)
+{
+    BenchmarkSpatialDerivative(state, CalculationType::VELOCITY, CalcDirection::Y);
+}
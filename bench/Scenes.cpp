@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Scenes.h"
+
+namespace OpenPSTD
+{
+    namespace Bench
+    {
+        using namespace OpenPSTD::Kernel;
+
+        namespace
+        {
+            /**
+             * Creates the default configuration without domains, speakers and receivers
+             */
+            std::shared_ptr<PSTDConfiguration> CreateEmptyConf()
+            {
+                std::shared_ptr<PSTDConfiguration> conf = PSTDConfiguration::CreateDefaultConf();
+                conf->Domains.clear();
+                conf->Speakers.clear();
+                conf->Receivers.clear();
+                return conf;
+            }
+
+            void AddDomain(std::shared_ptr<PSTDConfiguration> conf, int scale, float x, float y, float width,
+                           float height, float absorption)
+            {
+                DomainConf domain;
+                domain.TopLeft = QVector2D(x * scale, y * scale);
+                domain.Size = QVector2D(width * scale, height * scale);
+                domain.SetAbsorption(PSTD_DOMAIN_SIDE_ALL, absorption);
+                domain.SetLR(PSTD_DOMAIN_SIDE_ALL, false);
+                conf->Domains.push_back(domain);
+            }
+        }
+
+        std::shared_ptr<PSTDConfiguration> CreateSingleRoom(int scale)
+        {
+            auto conf = CreateEmptyConf();
+            AddDomain(conf, scale, 0, 0, 10, 8, 0.2f);
+            conf->Speakers.push_back(QVector3D(3 * scale, 3 * scale, 0));
+            conf->Receivers.push_back(QVector3D(7 * scale, 5 * scale, 0));
+            return conf;
+        }
+
+        std::shared_ptr<PSTDConfiguration> CreateLCorridor(int scale)
+        {
+            auto conf = CreateEmptyConf();
+            AddDomain(conf, scale, 0, 0, 30, 7, 0.3f);
+            AddDomain(conf, scale, 23, 7, 7, 30, 0.3f);
+            conf->Speakers.push_back(QVector3D(3 * scale, 3.5f * scale, 0));
+            conf->Receivers.push_back(QVector3D(26.5f * scale, 34 * scale, 0));
+            return conf;
+        }
+
+        std::shared_ptr<PSTDConfiguration> CreateOffice(int scale)
+        {
+            auto conf = CreateEmptyConf();
+            for (int i = 0; i < 10; i++)
+            {
+                for (int j = 0; j < 10; j++)
+                {
+                    AddDomain(conf, scale, 7 * i, 7 * j, 7, 7, 0.5f);
+                }
+            }
+            conf->Speakers.push_back(QVector3D(3.5f * scale, 3.5f * scale, 0));
+            conf->Receivers.push_back(QVector3D(66.5f * scale, 66.5f * scale, 0));
+            return conf;
+        }
+
+        std::shared_ptr<PSTDConfiguration> CreateOutdoorPlane(int scale)
+        {
+            auto conf = CreateEmptyConf();
+            AddDomain(conf, scale, 0, 0, 100, 100, 1);
+            conf->Speakers.push_back(QVector3D(50 * scale, 50 * scale, 0));
+            conf->Receivers.push_back(QVector3D(80 * scale, 50 * scale, 0));
+            return conf;
+        }
+
+        std::vector<CanonicalScene> GetCanonicalScenes()
+        {
+            std::vector<CanonicalScene> result;
+            result.push_back({"single-room", "single room of 10x8 m", &CreateSingleRoom});
+            result.push_back({"l-corridor", "L-shaped corridor of two domains", &CreateLCorridor});
+            result.push_back({"office", "office of 10x10 rooms, 100 domains", &CreateOffice});
+            result.push_back({"outdoor-plane", "outdoor plane of 100x100 m", &CreateOutdoorPlane});
+            return result;
+        }
+    }
+}
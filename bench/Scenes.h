@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: The canonical scenes that are used to measure the throughput of the kernel
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_SCENES_H
+#define OPENPSTD_SCENES_H
+
+#include <kernel/KernelInterface.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Bench
+    {
+        /**
+         * A scene with a fixed geometry, the scale multiplies all the coordinates of the scene, so that the number
+         * of cells grows with the square of the scale.
+         *
+         * The scenes use the default settings. Every domain is at least as large as the window of the spatial
+         * derivatives(32 cells, 6.4 meters), the kernel does not support smaller domains with neighbours.
+         */
+        class CanonicalScene
+        {
+        public:
+            std::string Name;
+            std::string Description;
+            std::function<std::shared_ptr<Kernel::PSTDConfiguration>(int scale)> Create;
+        };
+
+        /**
+         * A single room of 10 by 8 meters with reflecting walls
+         */
+        std::shared_ptr<Kernel::PSTDConfiguration> CreateSingleRoom(int scale);
+
+        /**
+         * Two domains of 30 by 7 meters that form an L-shaped corridor
+         */
+        std::shared_ptr<Kernel::PSTDConfiguration> CreateLCorridor(int scale);
+
+        /**
+         * An office of 10 by 10 rooms of 7 by 7 meters, a domain per room
+         */
+        std::shared_ptr<Kernel::PSTDConfiguration> CreateOffice(int scale);
+
+        /**
+         * A large plane of 100 by 100 meters with absorbing edges
+         */
+        std::shared_ptr<Kernel::PSTDConfiguration> CreateOutdoorPlane(int scale);
+
+        /**
+         * All the canonical scenes
+         */
+        std::vector<CanonicalScene> GetCanonicalScenes();
+    }
+}
+
+#endif //OPENPSTD_SCENES_H
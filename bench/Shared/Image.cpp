@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Benchmarks of drawing the frames into images
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.h"
+#include <shared/export/Image.h>
+#include <shared/ColorLUT.h>
+#include <shared/Colors.h>
+#include <cmath>
+
+using namespace OpenPSTD;
+using namespace OpenPSTD::Kernel;
+using namespace OpenPSTD::Shared;
+
+OPENPSTD_BENCHMARK(image_draw_data, 64, 256, 1024, 2048)
+{
+    int size = state.GetSize();
+    Kernel::PSTD_FRAME frame((size_t) size * size);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            frame[y * size + x] = std::sin(0.05f * x) * std::cos(0.03f * y);
+        }
+    }
+
+    StandardColorScheme colorScheme;
+    ColorLUT lut(*colorScheme.ResultsColorGradient(), 256);
+    QImage image(size, size, QImage::Format_Indexed8);
+    ExportImage exportImage;
+
+    while (state.KeepRunning())
+    {
+        exportImage.drawData(image, frame, lut, -1, 1, {0, 0}, {size, size});
+    }
+
+    double cells = (double) size * size;
+    state.SetCellsPerIteration(cells);
+    //reads a float and writes an index for every cell
+    state.SetBytesPerIteration((sizeof(float) + 1) * cells);
+}
@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Benchmarks of writing and reading the frames of the results
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.h"
+#include <shared/PSTDFile.h>
+#include <boost/filesystem.hpp>
+#include <cmath>
+
+using namespace OpenPSTD;
+using namespace OpenPSTD::Kernel;
+using namespace OpenPSTD::Shared;
+
+namespace
+{
+    /**
+     * Frames that are written between two commits, so that the uncommitted data does not grow with the run time
+     */
+    const int COMMIT_FRAMES = 64;
+
+    /**
+     * Frames that are written before the frames are read
+     */
+    const int READ_FRAMES = 16;
+
+    /**
+     * Creates a file with a single domain of size x size cells and initialized results
+     */
+    std::shared_ptr<PSTDFile> CreateFile(boost::filesystem::path path, int size, FRAMESTORAGE storage)
+    {
+        std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+        auto conf = file->GetSceneConf();
+        float gridSpacing = conf->Settings.GetGridSpacing();
+        conf->Domains.resize(1);
+        conf->Domains[0].TopLeft = QVector2D(0, 0);
+        //half a cell more, the size is truncated to the grid
+        conf->Domains[0].Size = QVector2D((size + 0.5f) * gridSpacing, (size + 0.5f) * gridSpacing);
+        conf->Settings.SetFrameStorage(storage);
+        file->SetSceneConf(conf);
+        file->InitializeResults();
+        return file;
+    }
+
+    PSTD_FRAME_PTR CreateFrame(int size, int frame)
+    {
+        PSTD_FRAME_PTR result = std::make_shared<PSTD_FRAME>((size_t) size * size);
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                (*result)[y * size + x] = std::sin(0.05f * x + 0.1f * frame) * std::cos(0.03f * y);
+            }
+        }
+        return result;
+    }
+
+    boost::filesystem::path TemporaryPath()
+    {
+        return boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("bench-%%%%%%%%.pstd");
+    }
+
+    void BenchmarkSaveFrame(Bench::BenchmarkState &state, FRAMESTORAGE storage)
+    {
+        boost::filesystem::path path = TemporaryPath();
+        {
+            std::shared_ptr<PSTDFile> file = CreateFile(path, state.GetSize(), storage);
+            std::vector<PSTD_FRAME_PTR> frames;
+            for (int i = 0; i < READ_FRAMES; i++)
+            {
+                frames.push_back(CreateFrame(state.GetSize(), i));
+            }
+
+            int written = 0;
+            while (state.KeepRunning())
+            {
+                file->SaveNextResultsFrame(0, frames[written % frames.size()]);
+                written++;
+                if (written % COMMIT_FRAMES == 0)
+                {
+                    state.PauseTiming();
+                    file->Commit();
+                    state.ResumeTiming();
+                }
+            }
+        }
+        boost::filesystem::remove(path);
+
+        double cells = (double) state.GetSize() * state.GetSize();
+        state.SetCellsPerIteration(cells);
+        state.SetBytesPerIteration(sizeof(PSTD_FRAME_UNIT) * cells);
+    }
+
+    void BenchmarkGetFrame(Bench::BenchmarkState &state, FRAMESTORAGE storage)
+    {
+        boost::filesystem::path path = TemporaryPath();
+        {
+            std::shared_ptr<PSTDFile> file = CreateFile(path, state.GetSize(), storage);
+            for (int i = 0; i < READ_FRAMES; i++)
+            {
+                file->SaveNextResultsFrame(0, CreateFrame(state.GetSize(), i));
+            }
+            file->Commit();
+        }
+        {
+            //the file is opened again, so that the frames are not in the cache of the written frames
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            int read = 0;
+            while (state.KeepRunning())
+            {
+                PSTD_FRAME_PTR frame = file->GetResultsFrame(read % READ_FRAMES, 0);
+                Bench::KeepValue((*frame)[0]);
+                read++;
+            }
+        }
+        boost::filesystem::remove(path);
+
+        double cells = (double) state.GetSize() * state.GetSize();
+        state.SetCellsPerIteration(cells);
+        state.SetBytesPerIteration(sizeof(PSTD_FRAME_UNIT) * cells);
+    }
+}
+
+OPENPSTD_BENCHMARK(pstdfile_save_frame_raw, 64, 256, 512)
+{
+    BenchmarkSaveFrame(state, FRAMESTORAGE::RAW);
+}
+
+OPENPSTD_BENCHMARK(pstdfile_save_frame_lossless, 64, 256, 512)
+{
+    BenchmarkSaveFrame(state, FRAMESTORAGE::LOSSLESS);
+}
+
+OPENPSTD_BENCHMARK(pstdfile_get_frame_raw, 64, 256, 512)
+{
+    BenchmarkGetFrame(state, FRAMESTORAGE::RAW);
+}
+
+OPENPSTD_BENCHMARK(pstdfile_get_frame_lossless, 64, 256, 512)
+{
+    BenchmarkGetFrame(state, FRAMESTORAGE::LOSSLESS);
+}
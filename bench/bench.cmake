@@ -0,0 +1,33 @@
+#------------------------------------
+# Micro-benchmarks
+set(SOURCE_FILES_BENCH bench/Benchmark.cpp
+        bench/Kernel/kernel_functions.cpp bench/Kernel/Domain.cpp bench/Kernel/WisdomCache.cpp
+        bench/Shared/PSTDFile.cpp bench/Shared/Image.cpp)
+add_executable(OpenPSTD-bench bench/main.cpp ${SOURCE_FILES_BENCH})
+
+target_include_directories(OpenPSTD-bench PUBLIC ${Qt5_INCLUDE_DIRS})
+target_include_directories(OpenPSTD-bench PUBLIC unqlite)
+target_include_directories(OpenPSTD-bench PUBLIC ${Boost_INCLUDE_DIR})
+target_include_directories(OpenPSTD-bench PUBLIC ${EIGEN_INCLUDE})
+target_include_directories(OpenPSTD-bench PUBLIC ${FFTWF_INCLUDE_DIR})
+
+target_link_libraries(OpenPSTD-bench OpenPSTD)
+target_link_libraries(OpenPSTD-bench OpenPSTD-shared)
+target_link_libraries(OpenPSTD-bench unqlite)
+target_link_libraries(OpenPSTD-bench ${Boost_LIBRARIES})
+target_link_libraries(OpenPSTD-bench ${Qt5_LIBRARIES})
+target_link_libraries(OpenPSTD-bench ${FFTWF_LIBRARY})
+
+#------------------------------------
+# End-to-end throughput on the canonical scenes
+add_executable(OpenPSTD-throughput bench/throughput.cpp bench/Scenes.cpp)
+
+target_include_directories(OpenPSTD-throughput PUBLIC ${Qt5_INCLUDE_DIRS})
+target_include_directories(OpenPSTD-throughput PUBLIC ${Boost_INCLUDE_DIR})
+target_include_directories(OpenPSTD-throughput PUBLIC ${EIGEN_INCLUDE})
+target_include_directories(OpenPSTD-throughput PUBLIC ${FFTWF_INCLUDE_DIR})
+
+target_link_libraries(OpenPSTD-throughput OpenPSTD)
+target_link_libraries(OpenPSTD-throughput ${Boost_LIBRARIES})
+target_link_libraries(OpenPSTD-throughput ${Qt5_LIBRARIES})
+target_link_libraries(OpenPSTD-throughput ${FFTWF_LIBRARY})
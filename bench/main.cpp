@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: The main entry point for the benchmarks
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <fstream>
+#include <regex>
+
+namespace po = boost::program_options;
+using namespace OpenPSTD::Bench;
+
+int main(int argc, const char *argv[])
+{
+    po::options_description desc("Runs the micro-benchmarks of openPSTD");
+    desc.add_options()
+            ("help,h", "produce help message")
+            ("list,l", "lists the benchmarks and their sizes")
+            ("filter,f", po::value<std::string>()->default_value(".*"), "regular expression that selects the benchmarks that are run")
+            ("size,s", po::value<std::vector<int>>(), "runs the benchmarks only with this size(can be used multiple times)")
+            ("min-time", po::value<double>()->default_value(0.2), "minimal number of seconds of a single repetition")
+            ("repetitions,r", po::value<int>()->default_value(5), "number of repetitions, the median is reported")
+            ("json,o", po::value<std::string>(), "writes the results as JSON to this file")
+            ("compare,c", po::value<std::string>(), "JSON file of an earlier run, the speedup compared to that run is shown");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error &e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::regex filter(vm["filter"].as<std::string>());
+    std::vector<int> sizes;
+    if (vm.count("size"))
+    {
+        sizes = vm["size"].as<std::vector<int>>();
+    }
+
+    if (vm.count("list"))
+    {
+        for (auto &benchmark : GetBenchmarks())
+        {
+            std::cout << benchmark.Name << ":";
+            for (int size : benchmark.Sizes)
+                std::cout << " " << size;
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> baseline;
+    if (vm.count("compare"))
+    {
+        baseline = ReadResults(vm["compare"].as<std::string>());
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (auto &benchmark : GetBenchmarks())
+    {
+        if (!std::regex_search(benchmark.Name, filter))
+            continue;
+
+        for (int size : benchmark.Sizes)
+        {
+            if (!sizes.empty() && std::find(sizes.begin(), sizes.end(), size) == sizes.end())
+                continue;
+
+            results.push_back(RunBenchmark(benchmark, size, vm["min-time"].as<double>(),
+                                           vm["repetitions"].as<int>()));
+            std::cerr << benchmark.Name << "/" << size << " done" << std::endl;
+        }
+    }
+
+    PrintResults(std::cout, results, baseline);
+
+    if (vm.count("json"))
+    {
+        std::ofstream out(vm["json"].as<std::string>());
+        WriteResults(out, results);
+    }
+
+    return 0;
+}
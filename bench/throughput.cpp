@@ -0,0 +1,552 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Measures the end-to-end throughput of the kernel on the canonical scenes
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Scenes.h"
+#include <kernel/PSTDKernel.h>
+#include <kernel/core/Logger.h>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+using namespace OpenPSTD;
+using namespace OpenPSTD::Bench;
+using namespace std::chrono;
+
+namespace
+{
+    /**
+     * Ignores all the output of the kernel, so that only the computation is measured
+     */
+    class NullCallback : public Kernel::KernelCallback
+    {
+    public:
+        virtual void Callback(Kernel::CALLBACKSTATUS status, std::string message, int frame) override
+        {
+        }
+
+        virtual void WriteFrame(int frame, int domain, Kernel::PSTD_FRAME_PTR data) override
+        {
+        }
+
+        virtual void WriteSample(int startSample, int receiver, std::vector<float> data) override
+        {
+        }
+    };
+
+    /**
+     * Measurement of a scene at a scale, mode and number of threads, the key matches it with the baseline
+     */
+    class ThroughputResult
+    {
+    public:
+        std::string Scene;
+        int Scale = 1;
+        std::string Mode;
+        int Threads = 1;
+        int Jobs = 1;
+        double Cells = 0;
+        double Seconds = 0;
+        double StartupSeconds = 0;
+        double FramesPerSecond = 0;
+        double CellUpdatesPerSecond = 0;
+        double Efficiency = 0;
+        long long PeakRSS = 0;
+
+        std::tuple<std::string, int, std::string, int> Key() const
+        {
+            return std::make_tuple(Scene, Scale, Mode, Threads);
+        }
+    };
+
+    /**
+     * The peak resident set size of the resource usage in bytes
+     */
+    long long GetPeakRSS(const struct rusage &usage)
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        return usage.ru_maxrss * 1024LL;
+#endif
+    }
+
+    /**
+     * The number of cells of the scene, including the PML domains
+     */
+    double CountCells(std::shared_ptr<Kernel::PSTDConfiguration> conf)
+    {
+        Kernel::PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        double cells = 0;
+        for (auto domain : kernel.get_scene()->domain_list)
+        {
+            cells += (double) domain->size.x * domain->size.y;
+        }
+        return cells;
+    }
+
+    /**
+     * Runs a number of simulations of the same scene on a number of threads, every simulation has its own kernel.
+     * The threads take the next simulation until all the simulations are done.
+     */
+    ThroughputResult Measure(std::shared_ptr<Kernel::PSTDConfiguration> conf, int threads, int jobs, int frames,
+                             double cells)
+    {
+        std::atomic<int> next(0);
+        std::mutex resultMutex;
+        double startupSeconds = 0;
+        std::exception_ptr error;
+
+        steady_clock::time_point start = steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+        {
+            workers.push_back(std::thread([&]()
+            {
+                try
+                {
+                    while (next++ < jobs)
+                    {
+                        steady_clock::time_point jobStart = steady_clock::now();
+                        Kernel::PSTDKernel kernel;
+                        kernel.initialize_kernel(std::make_shared<Kernel::PSTDConfiguration>(*conf));
+                        steady_clock::time_point initialized = steady_clock::now();
+
+                        NullCallback callback;
+                        kernel.run(&callback);
+
+                        std::lock_guard<std::mutex> lock(resultMutex);
+                        startupSeconds += duration<double>(initialized - jobStart).count();
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(resultMutex);
+                    error = std::current_exception();
+                }
+            }));
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        ThroughputResult result;
+        result.Threads = threads;
+        result.Jobs = jobs;
+        result.Cells = cells;
+        result.Seconds = seconds;
+        result.StartupSeconds = startupSeconds / jobs;
+        result.FramesPerSecond = (double) jobs * frames / seconds;
+        result.CellUpdatesPerSecond = (double) jobs * frames * cells / seconds;
+        return result;
+    }
+
+    /**
+     * The timings that the child process of a measurement sends back
+     */
+    struct ChildTimings
+    {
+        double Seconds;
+        double StartupSeconds;
+        double FramesPerSecond;
+        double CellUpdatesPerSecond;
+    };
+
+    /**
+     * Runs Measure in a child process. The peak resident set size of a process only grows, so the peak of this
+     * process would be the peak of the largest configuration so far, the child only has the memory of this
+     * configuration.
+     */
+    ThroughputResult MeasureInChild(std::shared_ptr<Kernel::PSTDConfiguration> conf, int threads, int jobs,
+                                    int frames, double cells)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            throw std::runtime_error("could not create a pipe for the measurement");
+        }
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            throw std::runtime_error("could not start a process for the measurement");
+        }
+        if (pid == 0)
+        {
+            //the child sends the timings or the error message and exits without running the destructors of the
+            //parent, like the background thread of the logger that does not exist in the child
+            close(fds[0]);
+            std::string data;
+            int status = 0;
+            try
+            {
+                ThroughputResult result = Measure(conf, threads, jobs, frames, cells);
+                ChildTimings timings{result.Seconds, result.StartupSeconds, result.FramesPerSecond,
+                                     result.CellUpdatesPerSecond};
+                data.assign((const char *) &timings, sizeof(timings));
+            }
+            catch (std::exception &e)
+            {
+                data = e.what();
+                status = 1;
+            }
+            catch (...)
+            {
+                data = "exception of unknown type";
+                status = 1;
+            }
+            for (size_t written = 0; written < data.size();)
+            {
+                ssize_t n = write(fds[1], data.data() + written, data.size() - written);
+                if (n <= 0)
+                {
+                    _exit(1);
+                }
+                written += n;
+            }
+            close(fds[1]);
+            _exit(status);
+        }
+
+        close(fds[1]);
+        std::string data;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+        {
+            data.append(buffer, (size_t) n);
+        }
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage;
+        if (wait4(pid, &status, 0, &usage) != pid)
+        {
+            throw std::runtime_error("could not wait for the process of the measurement");
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || data.size() != sizeof(ChildTimings))
+        {
+            throw std::runtime_error("the measurement failed" + (data.empty() ? std::string() : ": " + data));
+        }
+
+        ChildTimings timings;
+        std::copy(data.begin(), data.end(), (char *) &timings);
+        ThroughputResult result;
+        result.Threads = threads;
+        result.Jobs = jobs;
+        result.Cells = cells;
+        result.Seconds = timings.Seconds;
+        result.StartupSeconds = timings.StartupSeconds;
+        result.FramesPerSecond = timings.FramesPerSecond;
+        result.CellUpdatesPerSecond = timings.CellUpdatesPerSecond;
+        result.PeakRSS = GetPeakRSS(usage);
+        return result;
+    }
+
+    void WriteResults(std::ostream &out, const std::vector<ThroughputResult> &results, int frames)
+    {
+        std::time_t now = system_clock::to_time_t(system_clock::now());
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << std::setprecision(9);
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"frames\": " << frames << "\n";
+        out << "  },\n";
+        out << "  \"results\": [";
+        for (unsigned int i = 0; i < results.size(); i++)
+        {
+            const ThroughputResult &result = results[i];
+            out << (i == 0 ? "\n" : ",\n");
+            out << "    {\n";
+            out << "      \"scene\": \"" << result.Scene << "\",\n";
+            out << "      \"scale\": " << result.Scale << ",\n";
+            out << "      \"mode\": \"" << result.Mode << "\",\n";
+            out << "      \"threads\": " << result.Threads << ",\n";
+            out << "      \"jobs\": " << result.Jobs << ",\n";
+            out << "      \"cells\": " << result.Cells << ",\n";
+            out << "      \"seconds\": " << result.Seconds << ",\n";
+            out << "      \"startup_seconds\": " << result.StartupSeconds << ",\n";
+            out << "      \"frames_per_second\": " << result.FramesPerSecond << ",\n";
+            out << "      \"cell_updates_per_second\": " << result.CellUpdatesPerSecond << ",\n";
+            out << "      \"efficiency\": " << result.Efficiency << ",\n";
+            out << "      \"peak_rss_bytes\": " << result.PeakRSS << "\n";
+            out << "    }";
+        }
+        out << (results.empty() ? "]\n" : "\n  ]\n");
+        out << "}\n";
+    }
+
+    std::vector<ThroughputResult> ReadResults(std::string filename)
+    {
+        boost::property_tree::ptree tree;
+        boost::property_tree::read_json(filename, tree);
+
+        std::vector<ThroughputResult> results;
+        for (auto &item : tree.get_child("results"))
+        {
+            ThroughputResult result;
+            result.Scene = item.second.get<std::string>("scene");
+            result.Scale = item.second.get<int>("scale");
+            result.Mode = item.second.get<std::string>("mode");
+            result.Threads = item.second.get<int>("threads");
+            result.Jobs = item.second.get<int>("jobs");
+            result.Cells = item.second.get<double>("cells");
+            result.Seconds = item.second.get<double>("seconds");
+            result.StartupSeconds = item.second.get<double>("startup_seconds");
+            result.FramesPerSecond = item.second.get<double>("frames_per_second");
+            result.CellUpdatesPerSecond = item.second.get<double>("cell_updates_per_second");
+            result.Efficiency = item.second.get<double>("efficiency");
+            result.PeakRSS = item.second.get<long long>("peak_rss_bytes");
+            results.push_back(result);
+        }
+        return results;
+    }
+
+    /**
+     * Compares the results with the baseline, a result is a regression when the cell updates per second are
+     * lower or the startup time is higher than the baseline by more than the threshold(relative).
+     * @return the number of regressions
+     */
+    int CompareResults(std::ostream &out, const std::vector<ThroughputResult> &results,
+                       const std::vector<ThroughputResult> &baseline, double threshold)
+    {
+        std::map<std::tuple<std::string, int, std::string, int>, ThroughputResult> baselineResults;
+        for (auto &result : baseline)
+        {
+            baselineResults[result.Key()] = result;
+        }
+
+        int regressions = 0;
+        for (auto &result : results)
+        {
+            auto it = baselineResults.find(result.Key());
+            if (it == baselineResults.end())
+                continue;
+
+            const ThroughputResult &base = it->second;
+            std::string name = result.Scene + "/" + std::to_string(result.Scale) + "/" + result.Mode + "/" +
+                               std::to_string(result.Threads);
+            if (result.CellUpdatesPerSecond < base.CellUpdatesPerSecond * (1 - threshold))
+            {
+                out << "REGRESSION " << name << ": " << result.CellUpdatesPerSecond / 1e6 << " Mcells/s, baseline "
+                    << base.CellUpdatesPerSecond / 1e6 << " Mcells/s" << std::endl;
+                regressions++;
+            }
+            if (result.StartupSeconds > base.StartupSeconds * (1 + threshold))
+            {
+                out << "REGRESSION " << name << ": startup " << result.StartupSeconds << " s, baseline "
+                    << base.StartupSeconds << " s" << std::endl;
+                regressions++;
+            }
+        }
+        return regressions;
+    }
+
+    void PrintResult(std::ostream &out, const ThroughputResult &result)
+    {
+        out << std::left << std::setw(16) << result.Scene << std::right << std::setw(6) << result.Scale
+            << std::setw(8) << result.Mode << std::setw(8) << result.Threads
+            << std::fixed << std::setprecision(3)
+            << std::setw(12) << result.Seconds
+            << std::setw(12) << result.StartupSeconds
+            << std::setw(10) << std::setprecision(1) << result.FramesPerSecond
+            << std::setw(12) << std::setprecision(2) << result.CellUpdatesPerSecond / 1e6
+            << std::setw(8) << result.Efficiency
+            << std::setw(10) << result.PeakRSS / (1024 * 1024)
+            << std::endl;
+        out.unsetf(std::ios::fixed);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    //keep the warnings of the kernel out of the results table
+    Kernel::Logger::get_instance().set_level(Kernel::LogLevel::ERROR);
+
+    std::vector<int> defaultThreads;
+    for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2)
+    {
+        defaultThreads.push_back((int) t);
+    }
+
+    po::options_description desc("Measures the throughput of the kernel on the canonical scenes");
+    desc.add_options()
+            ("help,h", "produce help message")
+            ("list,l", "lists the canonical scenes")
+            ("scene", po::value<std::vector<std::string>>(), "scene that is measured(can be used multiple times), by default all scenes")
+            ("scale", po::value<std::vector<int>>(), "scale of the scenes(can be used multiple times), by default 1")
+            ("threads,t", po::value<std::vector<int>>(), "number of threads(can be used multiple times), by default powers of 2 up to the number of cores")
+            ("frames,n", po::value<int>()->default_value(10), "number of time steps of every simulation")
+            ("mode", po::value<std::string>()->default_value("both"), "strong, weak or both")
+            ("json,o", po::value<std::string>(), "writes the results as JSON to this file")
+            ("baseline,b", po::value<std::string>(), "JSON file of an earlier run, fails when the results regress")
+            ("threshold", po::value<double>()->default_value(0.1), "relative difference with the baseline that is a regression");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error &e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::vector<CanonicalScene> scenes = GetCanonicalScenes();
+    if (vm.count("list"))
+    {
+        for (auto &scene : scenes)
+        {
+            std::cout << scene.Name << ": " << scene.Description << std::endl;
+        }
+        return 0;
+    }
+
+    if (vm.count("scene"))
+    {
+        std::vector<std::string> names = vm["scene"].as<std::vector<std::string>>();
+        std::vector<CanonicalScene> selected;
+        for (auto &name : names)
+        {
+            auto it = std::find_if(scenes.begin(), scenes.end(), [&name](const CanonicalScene &s) { return s.Name == name; });
+            if (it == scenes.end())
+            {
+                std::cerr << "ERROR: unknown scene " << name << std::endl;
+                return 1;
+            }
+            selected.push_back(*it);
+        }
+        scenes = selected;
+    }
+
+    std::vector<int> scales = vm.count("scale") ? vm["scale"].as<std::vector<int>>() : std::vector<int>{1};
+    std::vector<int> threadCounts = vm.count("threads") ? vm["threads"].as<std::vector<int>>() : defaultThreads;
+    int maxThreads = *std::max_element(threadCounts.begin(), threadCounts.end());
+    int frames = std::max(1, vm["frames"].as<int>());
+    std::string mode = vm["mode"].as<std::string>();
+    std::vector<std::string> modes;
+    if (mode == "strong" || mode == "both")
+        modes.push_back("strong");
+    if (mode == "weak" || mode == "both")
+        modes.push_back("weak");
+
+    std::cout << std::left << std::setw(16) << "scene" << std::right << std::setw(6) << "scale" << std::setw(8)
+              << "mode" << std::setw(8) << "threads" << std::setw(12) << "time(s)" << std::setw(12) << "startup(s)"
+              << std::setw(10) << "frames/s" << std::setw(12) << "Mcells/s" << std::setw(8) << "eff."
+              << std::setw(10) << "RSS(MB)" << std::endl;
+
+    std::vector<ThroughputResult> results;
+    for (auto &scene : scenes)
+    {
+        for (int scale : scales)
+        {
+            auto conf = scene.Create(scale);
+            //the number of time steps is the render time divided by the time step
+            conf->Settings.SetRenderTime((frames + 0.5f) * conf->Settings.GetTimeStep());
+
+            double cells = CountCells(conf);
+
+            for (auto &m : modes)
+            {
+                double reference = 0;
+                for (int threads : threadCounts)
+                {
+                    //strong scaling divides a fixed number of simulations over the threads, weak scaling runs a
+                    //simulation per thread
+                    int jobs = m == "strong" ? maxThreads : threads;
+
+                    ThroughputResult result = MeasureInChild(conf, threads, jobs, frames, cells);
+
+                    result.Scene = scene.Name;
+                    result.Scale = scale;
+                    result.Mode = m;
+                    //the ideal time is the time of a single simulation times the simulations per thread
+                    int rounds = (jobs + threads - 1) / threads;
+                    if (reference == 0)
+                        reference = result.Seconds / rounds;
+                    result.Efficiency = reference * rounds / result.Seconds;
+
+                    PrintResult(std::cout, result);
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    if (vm.count("json"))
+    {
+        std::ofstream out(vm["json"].as<std::string>());
+        WriteResults(out, results, frames);
+    }
+
+    if (vm.count("baseline"))
+    {
+        int regressions = CompareResults(std::cout, results, ReadResults(vm["baseline"].as<std::string>()),
+                                         vm["threshold"].as<double>());
+        if (regressions > 0)
+        {
+            std::cout << regressions << " regression(s) compared to the baseline" << std::endl;
+            return 2;
+        }
+        std::cout << "no regressions compared to the baseline" << std::endl;
+    }
+
+    return 0;
+}
@@ -4,6 +4,7 @@
 
 #include <kernel/core/kernel_functions.h>
 #include "KernelInterface.h"
+#include <iomanip>
 
 namespace OpenPSTD {
     namespace Kernel {
@@ -138,6 +139,22 @@ namespace OpenPSTD {
             this->multithread = value;
         }
 
+        FRAMESTORAGE PSTDSettings::GetFrameStorage() {
+            return (FRAMESTORAGE)this->frameStorage;
+        }
+
+        void PSTDSettings::SetFrameStorage(FRAMESTORAGE value) {
+            this->frameStorage = (int)value;
+        }
+
+        float PSTDSettings::GetVisualizationErrorBound() {
+            return this->visualizationErrorBound;
+        }
+
+        void PSTDSettings::SetVisualizationErrorBound(float value) {
+            this->visualizationErrorBound = value;
+        }
+
         float PSTDSettings::GetTimeStep() {
             return this->tfactRK * this->gridSpacing / this->c1;
         }
@@ -209,6 +226,98 @@ namespace OpenPSTD {
                 R.Absorption = absorption;
         }
 
+        bool DomainConf::HasSameEdges(const DomainConf &other) const {
+            return T.Absorption == other.T.Absorption && T.LR == other.T.LR &&
+                   B.Absorption == other.B.Absorption && B.LR == other.B.LR &&
+                   L.Absorption == other.L.Absorption && L.LR == other.L.LR &&
+                   R.Absorption == other.R.Absorption && R.LR == other.R.LR;
+        }
+
+        double KernelProfile::GetPhaseSeconds(PROFILEPHASE phase) const {
+            double result = 0;
+            for (auto &domain: this->DomainSeconds) {
+                result += domain[(int) phase];
+            }
+            return result;
+        }
+
+        double KernelProfile::GetDomainSeconds(int domain) const {
+            double result = 0;
+            for (double seconds: this->DomainSeconds.at(domain)) {
+                result += seconds;
+            }
+            return result;
+        }
+
+        std::string KernelProfile::GetPhaseName(PROFILEPHASE phase) {
+            switch (phase) {
+                case PROFILEPHASE::PLANNING:
+                    return "planning";
+                case PROFILEPHASE::WINDOWING:
+                    return "windowing";
+                case PROFILEPHASE::FFT:
+                    return "fft";
+                case PROFILEPHASE::SPECTRAL_MULTIPLY:
+                    return "spectral multiply";
+                case PROFILEPHASE::INVERSE_FFT:
+                    return "inverse fft";
+                case PROFILEPHASE::RK_UPDATE:
+                    return "rk update";
+                case PROFILEPHASE::PML:
+                    return "pml";
+                case PROFILEPHASE::RECEIVERS:
+                    return "receivers";
+                case PROFILEPHASE::WRITE_FRAME:
+                    return "write frame";
+                default:
+                    return "unknown";
+            }
+        }
+
+        void KernelTrace::WriteChromeTrace(std::ostream &output) const {
+            std::ios_base::fmtflags flags = output.flags();
+            std::streamsize precision = output.precision();
+            output << std::fixed << std::setprecision(3);
+
+            output << "{\"traceEvents\":[" << std::endl;
+            //the names of the threads are metadata events
+            for (int t = 0; t < this->ThreadCount; t++) {
+                output << (t == 0 ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                       << ",\"args\":{\"name\":\"" << (t == 0 ? "solver" : "worker " + std::to_string(t)) << "\"}}";
+            }
+            for (unsigned long i = 0; i < this->Events.size(); i++) {
+                const TraceEvent &event = this->Events[i];
+                output << (i == 0 && this->ThreadCount == 0 ? "" : ",\n");
+                output << "{\"name\":\"" << event.Name << "\",\"cat\":\"" << event.Category
+                       << "\",\"ph\":\"X\",\"ts\":" << event.Start << ",\"dur\":" << event.Duration
+                       << ",\"pid\":1,\"tid\":" << event.Thread << ",\"args\":{";
+                bool first = true;
+                auto write_int = [&](const char *name, int value) {
+                    if (value < 0)
+                        return;
+                    output << (first ? "" : ",") << "\"" << name << "\":" << value;
+                    first = false;
+                };
+                auto write_string = [&](const char *name, const char *value) {
+                    if (value == nullptr)
+                        return;
+                    output << (first ? "" : ",") << "\"" << name << "\":\"" << value << "\"";
+                    first = false;
+                };
+                write_int("frame", event.Frame);
+                write_int("domain", event.Domain);
+                write_int("rk_stage", event.Stage);
+                write_string("direction", event.Direction);
+                write_string("field", event.Field);
+                output << "}}";
+            }
+            output << std::endl << "],\"displayTimeUnit\":\"ms\","
+                   << "\"otherData\":{\"dropped_events\":" << this->DroppedEvents << "}}" << std::endl;
+
+            output.flags(flags);
+            output.precision(precision);
+        }
+
         std::shared_ptr<PSTDConfiguration> PSTDConfiguration::CreateDefaultConf() {
             std::shared_ptr<PSTDConfiguration> conf = std::make_shared<PSTDConfiguration>();
             conf->Settings.SetRenderTime(1.0f);
@@ -6,10 +6,12 @@
 #define OPENPSTD_KERNELINTERFACE_H
 
 #include <string>
+#include <ostream>
 #include "GeneralTypes.h"
 #include <QVector2D>
 #include <QVector3D>
 #include <Eigen/Core>
+#include <boost/serialization/version.hpp>
 
 
 namespace OpenPSTD {
@@ -23,6 +25,18 @@ namespace OpenPSTD {
             FINISHED
         };
 
+        /**
+         * How the frames of the results are stored
+         */
+        enum class FRAMESTORAGE {
+            /// Frames are stored as 32-bit floats
+            RAW = 0,
+            /// Frames are compressed without loss of precision
+            LOSSLESS = 1,
+            /// Frames are quantized to 8 or 16 bits, only for visualization(see visualization error bound)
+            VISUALIZATION = 2
+        };
+
         /**
          * Enums for the domain boundary representation in the interface
          */
@@ -79,6 +93,10 @@ namespace OpenPSTD {
             bool multithread;
             /// Window coefficients for attenuating the sound
             Eigen::ArrayXf window;
+            /// Storage of the frames of the results(see FRAMESTORAGE)
+            int frameStorage = 0;
+            /// Maximum error of the visualization storage in dB relative to the peak of the frame
+            float visualizationErrorBound = -60;
 
         public:
 
@@ -101,6 +119,14 @@ namespace OpenPSTD {
                 ar & SaveNth;
                 ar & gpu;
                 ar & multithread;
+                if(version >= 1)
+                {
+                    ar & frameStorage;
+                }
+                if(version >= 2)
+                {
+                    ar & visualizationErrorBound;
+                }
             }
 
             float GetGridSpacing();
@@ -170,6 +196,14 @@ namespace OpenPSTD {
             std::vector<float> GetRKCoefficients();
 
             void SetRKCoefficients(std::vector<float> coef);
+
+            FRAMESTORAGE GetFrameStorage();
+
+            void SetFrameStorage(FRAMESTORAGE value);
+
+            float GetVisualizationErrorBound();
+
+            void SetVisualizationErrorBound(float value);
         };
 
         /**
@@ -208,6 +242,12 @@ namespace OpenPSTD {
 
             void SetLR(PSTD_DOMAIN_SIDE sides, bool LR);
 
+            /**
+             * True if all the edges have the same absorption and locally reacting flag as the edges of the other
+             * domain, so that the domains can share their boundaries
+             */
+            bool HasSameEdges(const DomainConf &other) const;
+
             template<class Archive>
             void serialize(Archive & ar, const unsigned int version)
             {
@@ -255,6 +295,130 @@ namespace OpenPSTD {
             }
         };
 
+        /**
+         * The phases of the calculation that are timed when profiling is enabled
+         */
+        enum class PROFILEPHASE {
+            /// Creating the FFT plans and looking up the wave number discretizations
+            PLANNING = 0,
+            /// Windowing the neighbouring domains and assembling the input and output of the FFT
+            WINDOWING = 1,
+            /// Forward FFT of the spatial derivative
+            FFT = 2,
+            /// Multiplication of the spectrum with the derivative factors
+            SPECTRAL_MULTIPLY = 3,
+            /// Inverse FFT of the spatial derivative
+            INVERSE_FFT = 4,
+            /// Runge-Kutta update of the pressure and velocity fields
+            RK_UPDATE = 5,
+            /// Attenuation of the perfectly matched layers
+            PML = 6,
+            /// Computing and writing the receiver samples
+            RECEIVERS = 7,
+            /// Passing the frames to the callback(WriteFrame)
+            WRITE_FRAME = 8
+        };
+
+        /**
+         * Number of phases in PROFILEPHASE
+         */
+        const int PROFILEPHASE_COUNT = 9;
+
+        /**
+         * The time that a run spent in the phases of the calculation.
+         */
+        class KernelProfile {
+        public:
+            /**
+             * Seconds per phase for every domain, the domains are indexed by their id(this includes the PML domains)
+             */
+            std::vector<std::vector<double>> DomainSeconds;
+            /**
+             * Seconds per phase for every frame
+             */
+            std::vector<std::vector<double>> FrameSeconds;
+            /**
+             * The ids of the domains that are PML domains
+             */
+            std::vector<int> PMLDomains;
+            /**
+             * Wall clock time of the complete run in seconds
+             */
+            double TotalSeconds = 0;
+
+            /**
+             * Seconds of the phase summed over all domains
+             */
+            double GetPhaseSeconds(PROFILEPHASE phase) const;
+
+            /**
+             * Seconds of all phases of a domain
+             */
+            double GetDomainSeconds(int domain) const;
+
+            /**
+             * Human readable name of a phase
+             */
+            static std::string GetPhaseName(PROFILEPHASE phase);
+
+            template<class Archive>
+            void serialize(Archive & ar, const unsigned int version)
+            {
+                ar & DomainSeconds;
+                ar & FrameSeconds;
+                ar & PMLDomains;
+                ar & TotalSeconds;
+            }
+        };
+
+        /**
+         * A task of the solver that is recorded by the tracer
+         */
+        class TraceEvent {
+        public:
+            /// Name of the task, a string literal of the kernel
+            const char *Name = nullptr;
+            /// Category of the task, a string literal of the kernel
+            const char *Category = nullptr;
+            /// Start of the task in microseconds since the start of the run
+            double Start = 0;
+            /// Duration of the task in microseconds
+            double Duration = 0;
+            /// Index of the thread that executed the task
+            int Thread = 0;
+            /// The frame, domain id and RK stage of the task, -1 if the task does not belong to one
+            int Frame = -1;
+            int Domain = -1;
+            int Stage = -1;
+            /// The calculation direction("x" or "y") and field("pressure" or "velocity"), nullptr if not applicable
+            const char *Direction = nullptr;
+            const char *Field = nullptr;
+        };
+
+        /**
+         * The timeline of the tasks of a run, per thread only the last events are kept
+         */
+        class KernelTrace {
+        public:
+            /**
+             * The events of all threads, sorted on the start time
+             */
+            std::vector<TraceEvent> Events;
+            /**
+             * Number of threads that recorded events
+             */
+            int ThreadCount = 0;
+            /**
+             * Number of events that are overwritten because the buffer of a thread was full
+             */
+            unsigned long long DroppedEvents = 0;
+
+            /**
+             * Writes the events in the Chrome trace-event JSON format(chrome://tracing or Perfetto)
+             */
+            void WriteChromeTrace(std::ostream &output) const;
+        };
+
         /**
          * Callback interface for communication with the CLI or the GUI
          *
@@ -286,6 +450,48 @@ namespace OpenPSTD {
              * @param data: a set of data points
              */
             virtual void WriteSample(int startSample, int receiver, std::vector<float> data) = 0;
+
+            /**
+             * Return the profile of the run to the callback handler, only called when profiling is enabled in the
+             * run options. This is called once, after the last frame and before the finished status.
+             * @param profile: the time spent in the phases of the calculation
+             */
+            virtual void WriteProfile(const KernelProfile &profile) { }
+
+            /**
+             * Return the trace of the run to the callback handler, only called when tracing is enabled in the run
+             * options. This is called once, after the last frame and before the finished status.
+             * @param trace: the tasks that are executed during the run
+             */
+            virtual void WriteTrace(const KernelTrace &trace) { }
+
+            /**
+             * Called when the state after a frame is checkpointed, only called when checkpointing is enabled in the
+             * run options. The results up to and including this frame have to be stored durably, because a resumed
+             * run continues after this frame.
+             * @param frame: the last frame that is part of the checkpoint
+             */
+            virtual void Checkpoint(int frame) { }
+        };
+
+        /**
+         * Switches of a single run of the kernel. These are chosen by the caller of the run, they are not part of
+         * the scene and are not stored with the settings.
+         */
+        class KernelRunOptions {
+        public:
+            /// Time the phases of the calculation(see KernelProfile)
+            bool Profiling = false;
+            /// Number of trace events that are kept per thread(see KernelTrace), 0 disables tracing
+            unsigned int TraceBufferSize = 0;
+            /// Minimal number of seconds between two progress callbacks, 0 reports every frame
+            double ProgressInterval = 0.1;
+            /// File the state of the simulation is checkpointed to(see Checkpoint)
+            std::string CheckpointFile;
+            /// Number of frames between two checkpoints, 0 disables checkpointing
+            unsigned int CheckpointInterval = 0;
+            /// Continue the simulation from the checkpoint file
+            bool Resume = false;
         };
 
         /**
@@ -302,13 +508,28 @@ namespace OpenPSTD {
             /**
              * Number of frames generated by the kernel
              */
-            int Framecount;
+            int Framecount = 0;
             /**
              * The discretization of the domain positions, in order they were passed to the kernel.
              * A vector in which domain n is represented by a vector at the nth position.
              * In the "inner" vectors, v[0],v[1],v[2] correspond to size x,y,z.
              */
             std::vector<std::vector<int>> DomainPositions;
+            /**
+             * The size of a cell(dx) and the time step of the simulation(dt)
+             */
+            float GridSpacing = 0;
+            float TimeStep = 0;
+
+            template<class Archive>
+            void serialize(Archive & ar, const unsigned int version)
+            {
+                ar & DomainMetadata;
+                ar & Framecount;
+                ar & DomainPositions;
+                ar & GridSpacing;
+                ar & TimeStep;
+            }
         };
 
         /**
@@ -325,8 +546,9 @@ namespace OpenPSTD {
              * Runs the kernel. The callback has a single function that informs the rest of the
              * application of the progress of the kernel.
              * Must first be configured, else a PSTDKernelNotConfiguredException is thrown.
+             * @param options: switches of this run, like profiling and checkpointing
              */
-            virtual void run(KernelCallback *callback) = 0;
+            virtual void run(KernelCallback *callback, const KernelRunOptions &options = KernelRunOptions()) = 0;
 
             /**
              * Query the kernel for metadata about the simulation that is configured.
@@ -342,4 +564,6 @@ namespace OpenPSTD {
 }
 
 
+BOOST_CLASS_VERSION(OpenPSTD::Kernel::PSTDSettings, 2)
+
 #endif //OPENPSTD_KERNELINTERFACE_H
@@ -3,6 +3,10 @@
 //
 
 #include "MockKernel.h"
+#include "core/Profiler.h"
+#include "core/Tracer.h"
+#include "core/Logger.h"
+#include "core/Layout.h"
 #include <boost/lexical_cast.hpp>
 
 namespace OpenPSTD
@@ -14,7 +18,7 @@ namespace OpenPSTD
             _conf = config;
         }
 
-        void MockKernel::run(KernelCallback *callback)
+        void MockKernel::run(KernelCallback *callback, const KernelRunOptions &options)
         {
             if (!_conf)
                 throw PSTDKernelNotConfiguredException();
@@ -23,9 +27,30 @@ namespace OpenPSTD
 
             callback->Callback(CALLBACKSTATUS::STARTING, "Starting to mock", -1);
 
+            //only the writing of the frames can be profiled, there is no calculation
+            std::unique_ptr<Profiler> profiler;
+            if (options.Profiling)
+            {
+                profiler = std::unique_ptr<Profiler>(new Profiler((int) _conf->Domains.size()));
+            }
+            std::unique_ptr<Tracer> tracer;
+            if (options.TraceBufferSize > 0)
+            {
+                tracer = std::unique_ptr<Tracer>(new Tracer(options.TraceBufferSize));
+            }
+
+            ProgressThrottle progress(options.ProgressInterval);
             for (int i = 0; i < meta.Framecount; ++i)
             {
-                callback->Callback(CALLBACKSTATUS::RUNNING, "At frame " + boost::lexical_cast<std::string>(i), i);
+                TraceScope frameScope(tracer.get(), "frame", "mock", i);
+                if (profiler)
+                {
+                    profiler->start_frame();
+                }
+                if (progress.should_report(i, meta.Framecount))
+                {
+                    callback->Callback(CALLBACKSTATUS::RUNNING, "At frame " + boost::lexical_cast<std::string>(i), i);
+                }
                 for (int j = 0; j < _conf->Domains.size(); ++j)
                 {
                     PSTD_FRAME_PTR frame;
@@ -51,6 +76,8 @@ namespace OpenPSTD
                             frame = CreateVerticalGradientNeg(meta.DomainMetadata[j][0], meta.DomainMetadata[j][1]);
                             break;
                     }
+                    TraceScope scope(tracer.get(), "write frame", "io", i, j);
+                    ProfileTimer timer(profiler.get(), PROFILEPHASE::WRITE_FRAME, j);
                     callback->WriteFrame(i, j, frame);
                 }
                 for(int r = 0; r < _conf->Receivers.size(); r++)
@@ -66,6 +93,15 @@ namespace OpenPSTD
                 }
             }
 
+            if (profiler)
+            {
+                callback->WriteProfile(profiler->get_profile());
+            }
+            if (tracer)
+            {
+                callback->WriteTrace(tracer->get_trace());
+            }
+
             callback->Callback(CALLBACKSTATUS::FINISHED, "finished mocking", -1);
         }
 
@@ -79,22 +115,26 @@ namespace OpenPSTD
             float grid = _conf->Settings.GetGridSpacing();
             for (int i = 0; i < _conf->Domains.size(); ++i)
             {
+                //the same discretization as the scene of the real kernel
+                std::pair<Point, Point> cells = discretize_domain(_conf->Domains[i], grid);
                 std::vector<int> d;
-                d.push_back(roundf(_conf->Domains[i].Size.x() / grid));
-                d.push_back(roundf(_conf->Domains[i].Size.y() / grid));
+                d.push_back(cells.second.x);
+                d.push_back(cells.second.y);
                 d.push_back(1);
 
                 result.DomainMetadata.push_back(d);
 
                 std::vector<int> d2;
-                d2.push_back(roundf(_conf->Domains[i].TopLeft.x() / grid));
-                d2.push_back(roundf(_conf->Domains[i].TopLeft.y() / grid));
+                d2.push_back(cells.first.x);
+                d2.push_back(cells.first.y);
                 d2.push_back(1);
 
                 result.DomainPositions.push_back(d2);
             }
 
             result.Framecount = (int) (_conf->Settings.GetRenderTime() / _conf->Settings.GetTimeStep());
+            result.GridSpacing = grid;
+            result.TimeStep = _conf->Settings.GetTimeStep();
 
             return result;
         }
@@ -42,8 +42,9 @@ namespace OpenPSTD
              * Runs the kernel. The callback has a single function that informs the rest of the
              * application of the progress of the kernel.
              * Must first be configured, else a PSTDKernelNotConfiguredException is thrown.
+             * @param options: switches of this run, only profiling, tracing and the progress interval are supported
              */
-            virtual void run(KernelCallback *callback) override;
+            virtual void run(KernelCallback *callback, const KernelRunOptions &options = KernelRunOptions()) override;
 
             /**
              * Query the kernel for metadata about the simulation that is configured.
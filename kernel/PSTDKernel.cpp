@@ -40,24 +40,44 @@ namespace OpenPSTD {
 
         void PSTDKernel::initialize_kernel(std::shared_ptr<PSTDConfiguration> config) {
             using namespace Kernel;
-            debug("Initializing kernel");
+            OPENPSTD_LOG(LogLevel::DEBUG, "Initializing kernel");
             this->config = config;
             this->settings = make_shared<PSTDSettings>(config->Settings);
             this->wnd = make_shared<WisdomCache>();
             this->scene = make_shared<Scene>(this->settings);
             this->initialize_scene();
-            debug("Finished initializing kernel");
+            OPENPSTD_LOG(LogLevel::DEBUG, "Finished initializing kernel");
+        }
+
+
+        void PSTDKernel::initialize_variant(std::shared_ptr<PSTDConfiguration> config,
+                                            std::shared_ptr<Kernel::Scene> topology) {
+            using namespace Kernel;
+            OPENPSTD_LOG(LogLevel::DEBUG, "Initializing kernel from an existing scene");
+            this->config = config;
+            this->settings = topology->settings;
+            this->wnd = topology->domain_list.at(0)->wnd;
+            this->scene = topology->clone();
+            this->scene->reset();
+            //the domains of the configuration are the first domains of the scene, the PML domains follow
+            for (unsigned long i = 0; i < this->config->Domains.size(); i++) {
+                this->scene->set_edge_parameters(this->scene->domain_list.at(i),
+                                                 translate_edge_parameters(this->config->Domains.at(i)));
+            }
+            this->add_speakers(this->scene, this->config);
+            this->add_receivers(this->scene, this->config);
+            OPENPSTD_LOG(LogLevel::DEBUG, "Finished initializing kernel");
         }
 
 
         void PSTDKernel::initialize_scene() {
             using namespace Kernel;
-            debug("Initializing scene");
+            OPENPSTD_LOG(LogLevel::DEBUG, "Initializing scene");
             this->add_domains();
-            this->add_speakers();
-            this->add_receivers();
+            this->add_speakers(this->scene, this->config);
+            this->add_receivers(this->scene, this->config);
             scene->compute_pml_matrices();
-            debug("Finished initializing");
+            OPENPSTD_LOG(LogLevel::DEBUG, "Finished initializing");
         }
 
 
@@ -65,11 +85,11 @@ namespace OpenPSTD {
             int domain_id_int = 0;
             vector<shared_ptr<Kernel::Domain>> domains;
             for (auto domain: this->config->Domains) {
-                Kernel::debug("Initializing domain " + to_string(domain_id_int));
-                vector<float> tl = scale_to_grid(domain.TopLeft);
-                vector<float> s = scale_to_grid(domain.Size);
-                Kernel::Point grid_top_left((int) tl.at(0), (int) tl.at(1));
-                Kernel::Point grid_size((int) s.at(0), (int) s.at(1));
+                OPENPSTD_LOG(LogLevel::DEBUG, "Initializing domain " + to_string(domain_id_int));
+                pair<Kernel::Point, Kernel::Point> grid = Kernel::discretize_domain(domain,
+                                                                                    this->settings->GetGridSpacing());
+                Kernel::Point grid_top_left = grid.first;
+                Kernel::Point grid_size = grid.second;
                 map<Kernel::Direction, Kernel::EdgeParameters> edge_param_map = translate_edge_parameters(domain);
                 int domain_id = scene->get_new_id();
                 shared_ptr<Kernel::Domain> domain_ptr = std::make_shared<Kernel::Domain>(
@@ -84,32 +104,35 @@ namespace OpenPSTD {
             scene->add_pml_domains();
             for (auto domain:scene->domain_list) {
                 domain->post_initialization();
-                cout << *domain << endl;
+                OPENPSTD_LOG(LogLevel::DEBUG, to_log_string(*domain));
             }
         }
 
 
-        void PSTDKernel::add_speakers() {
+        void PSTDKernel::add_speakers(std::shared_ptr<Kernel::Scene> scene,
+                                      std::shared_ptr<PSTDConfiguration> config) {
             using namespace Kernel;
             //Inconsistent: We created domains in this class, and speakers in the scene class
-            for (auto speaker: this->config->Speakers) {
+            for (auto speaker: config->Speakers) {
                 vector<float> location = scale_to_grid(speaker);
-                debug("Initializing Speaker (" + to_string(location.at(0)) + ", " + to_string(location.at(1)) + ")");
-                this->scene->add_speaker(location.at(0), location.at(1), 0); // Z-coordinate is 0
+                OPENPSTD_LOG(LogLevel::DEBUG, "Initializing Speaker (" + to_string(location.at(0)) + ", " +
+                                              to_string(location.at(1)) + ")");
+                scene->add_speaker(location.at(0), location.at(1), 0); // Z-coordinate is 0
             }
         }
 
-        void PSTDKernel::add_receivers() {
+        void PSTDKernel::add_receivers(std::shared_ptr<Kernel::Scene> scene,
+                                       std::shared_ptr<PSTDConfiguration> config) {
             using namespace Kernel;
             //Inconsistent: We created domains in this class, and receivers in the scene class
-            for (unsigned long i = 0; i < this->config->Receivers.size(); i++) {
-                auto receiver = this->config->Receivers.at(i);
+            for (unsigned long i = 0; i < config->Receivers.size(); i++) {
+                auto receiver = config->Receivers.at(i);
                 vector<float> location = scale_to_grid(receiver);
-                this->scene->add_receiver(location.at(0), location.at(1), 0, i);
+                scene->add_receiver(location.at(0), location.at(1), 0, i);
             }
         }
 
-        void PSTDKernel::run(KernelCallback *callback) {
+        void PSTDKernel::run(KernelCallback *callback, const KernelRunOptions &options) {
             if (!config)
                 throw PSTDKernelNotConfiguredException();
 
@@ -118,16 +141,16 @@ namespace OpenPSTD {
             std::shared_ptr<Kernel::Solver> solver;
             switch (solver_num) {
                 case 0:
-                    solver = std::make_shared<Kernel::SingleThreadSolver>(this->scene, callback);
+                    solver = std::make_shared<Kernel::SingleThreadSolver>(this->scene, callback, options);
                     break;
                 case 1:
-                    solver = std::make_shared<Kernel::GPUSingleThreadSolver>(this->scene, callback);
+                    solver = std::make_shared<Kernel::GPUSingleThreadSolver>(this->scene, callback, options);
                     break;
                 case 2:
-                    solver = std::make_shared<Kernel::MultiThreadSolver>(this->scene, callback);
+                    solver = std::make_shared<Kernel::MultiThreadSolver>(this->scene, callback, options);
                     break;
                 case 3:
-                    solver = std::make_shared<Kernel::GPUMultiThreadSolver>(this->scene, callback);
+                    solver = std::make_shared<Kernel::GPUMultiThreadSolver>(this->scene, callback, options);
                     break;
                 default:
                     //TODO Raise Error
@@ -136,6 +159,46 @@ namespace OpenPSTD {
             solver->compute_propagation();
         }
 
+        void PSTDKernel::run_batch(const vector<shared_ptr<PSTDConfiguration>> &sources,
+                                   const vector<KernelCallback *> &callbacks, const KernelRunOptions &options) {
+            if (!config)
+                throw PSTDKernelNotConfiguredException();
+
+            vector<shared_ptr<Kernel::Scene>> scenes;
+            for (auto source: sources) {
+                if (source->Domains.size() != this->config->Domains.size()) {
+                    throw runtime_error("The configurations of a batch need the same domains");
+                }
+                for (unsigned long i = 0; i < source->Domains.size(); i++) {
+                    const DomainConf &domain = source->Domains.at(i);
+                    const DomainConf &base = this->config->Domains.at(i);
+                    if (domain.TopLeft.x() != base.TopLeft.x() || domain.TopLeft.y() != base.TopLeft.y() ||
+                        domain.Size.x() != base.Size.x() || domain.Size.y() != base.Size.y() ||
+                        !domain.HasSameEdges(base)) {
+                        throw runtime_error("Domain " + to_string(i) + " of a configuration in the batch differs "
+                                "from the domain of the kernel");
+                    }
+                }
+                //every configuration has its own fields on a copy of the domains
+                shared_ptr<Kernel::Scene> scene = this->scene->clone();
+                scene->reset();
+                this->add_speakers(scene, source);
+                this->add_receivers(scene, source);
+                scenes.push_back(scene);
+            }
+            Kernel::BatchSolver solver(scenes, callbacks, options);
+            solver.compute_propagation();
+        }
+
+        void PSTDKernel::run_distributed(KernelCallback *callback, shared_ptr<Kernel::Transport> transport,
+                                         const KernelRunOptions &options) {
+            if (!config)
+                throw PSTDKernelNotConfiguredException();
+
+            Kernel::DistributedSolver solver(this->scene, callback, transport, options);
+            solver.compute_propagation();
+        }
+
         std::shared_ptr<Kernel::Scene> PSTDKernel::get_scene() {
             return this->scene;
         }
@@ -153,6 +216,8 @@ namespace OpenPSTD {
             }
 
             result.Framecount = (int) (this->settings->GetRenderTime() / this->settings->GetTimeStep());
+            result.GridSpacing = this->settings->GetGridSpacing();
+            result.TimeStep = this->settings->GetTimeStep();
             return result;
         }
 
@@ -42,6 +42,7 @@
 
 namespace OpenPSTD {
     namespace Kernel {
+        class Transport;
 
         /**
          * The API with methods that run the simulation from a PSTDFile
@@ -82,14 +83,14 @@ namespace OpenPSTD {
              * Note that speakers are not bound to grid coordinates.
              * We find the corresponding grid by flooring the location divided by the grid size.
              */
-            void add_speakers();
+            void add_speakers(std::shared_ptr<Kernel::Scene> scene, std::shared_ptr<PSTDConfiguration> config);
 
             /*
              * Computes the location of the receivers and creates new objects for them.
              * Expects real world coordinates from the scene descriptor file
              * @see add_speakers();
              */
-            void add_receivers();
+            void add_receivers(std::shared_ptr<Kernel::Scene> scene, std::shared_ptr<PSTDConfiguration> config);
 
             /**
              * Convert format and scale of GUI vectors to simulation vectors
@@ -125,11 +126,49 @@ namespace OpenPSTD {
              */
             void initialize_kernel(std::shared_ptr<PSTDConfiguration> config) override;
 
+            /**
+             * Initializes the kernel with a copy of an initialized scene, only the speakers, the receivers and the
+             * edge parameters are taken from the configuration. The domains, PML domains and the wisdom cache are
+             * reused, so the domains of the configuration have to be the same as the domains of the scene.
+             * @param config: Configuration of the variant of the scene
+             * @param topology: Scene of a kernel that is initialized with the same domains
+             * @see SweepRunner
+             */
+            void initialize_variant(std::shared_ptr<PSTDConfiguration> config, std::shared_ptr<Kernel::Scene> topology);
+
             /**
              * Runs the kernel. The callback has a single function that informs the rest of the
              * application of the progress of the kernel.
+             * @param options: switches of this run, like profiling and checkpointing
+             */
+            void run(KernelCallback *callback, const KernelRunOptions &options = KernelRunOptions()) override;
+
+            /**
+             * Runs the speakers and receivers of several configurations on the domains of this kernel at once. The
+             * configurations only differ in the speakers and receivers, so the derivatives of all the configurations
+             * are computed in the same FFT batch. The settings of the kernel are used for all the configurations.
+             * @param sources: Configurations with the same domains and edges as the configuration of the kernel
+             * @param callbacks: Callback of every configuration, the frames and receiver samples of a configuration
+             * are written to its own callback
+             * @param options: switches of this run, a batch can not be checkpointed or resumed
+             * @throws std::runtime_error if a configuration has other domains or edges
+             * @see BatchSolver
+             */
+            void run_batch(const std::vector<std::shared_ptr<PSTDConfiguration>> &sources,
+                           const std::vector<KernelCallback *> &callbacks,
+                           const KernelRunOptions &options = KernelRunOptions());
+
+            /**
+             * Runs the kernel as one rank of a simulation that is distributed over several processes. Every rank
+             * initializes its kernel with the same configuration, the domains are divided over the ranks.
+             * @param callback: callback of rank 0 that receives the frames and samples of all the ranks, the other
+             * ranks may pass nullptr
+             * @param transport: connection with the other ranks
+             * @param options: switches of this run, only the progress interval is supported
+             * @see DistributedSolver
              */
-            void run(KernelCallback *callback) override;
+            void run_distributed(KernelCallback *callback, std::shared_ptr<Kernel::Transport> transport,
+                                 const KernelRunOptions &options = KernelRunOptions());
 
             /**
              * Query the kernel for metadata about the simulation that is configured.
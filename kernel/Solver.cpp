@@ -27,84 +27,526 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "Solver.h"
+#include "core/Transport.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstring>
+#include <set>
 
 namespace OpenPSTD {
     namespace Kernel {
-        Solver::Solver(std::shared_ptr<Scene> scene, KernelCallback *callback) {
-            this->scene = scene;
+        Solver::Solver(std::shared_ptr<Scene> scene, KernelCallback *callback, const KernelRunOptions &options) :
+                Solver(std::vector<std::shared_ptr<Scene>>{scene}, std::vector<KernelCallback *>{callback}, options) {
+        }
+
+        Solver::Solver(std::vector<std::shared_ptr<Scene>> scenes, std::vector<KernelCallback *> callbacks,
+                       const KernelRunOptions &options) : options(options) {
+            if (scenes.empty() or scenes.size() != callbacks.size()) {
+                throw std::runtime_error("Every scene of the solver needs a callback");
+            }
+            for (auto other: scenes) {
+                if (other->domain_list.size() != scenes.at(0)->domain_list.size()) {
+                    throw std::runtime_error("The scenes of a batch need the same domains");
+                }
+            }
+            this->scenes = scenes;
+            this->scene = scenes.at(0);
             this->settings = scene->settings;
-            this->callback = callback;
-            Kernel::debug("Number of render time: " + std::to_string(this->settings->GetRenderTime()));
-            Kernel::debug("Number of time step: " + std::to_string(this->settings->GetTimeStep()));
+            this->callbacks = callbacks;
+            this->callback = callbacks.at(0);
+            OPENPSTD_LOG(LogLevel::DEBUG, "Number of render time: " + std::to_string(this->settings->GetRenderTime()));
+            OPENPSTD_LOG(LogLevel::DEBUG, "Number of time step: " + std::to_string(this->settings->GetTimeStep()));
 
             this->number_of_time_steps = (int) (this->settings->GetRenderTime() / this->settings->GetTimeStep());
         }
 
-        SingleThreadSolver::SingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback) : Solver::Solver(
-                scene, callback) {
+        SingleThreadSolver::SingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                               const KernelRunOptions &options) : Solver::Solver(scene, callback,
+                                                                                                 options) {
         }
 
-        GPUSingleThreadSolver::GPUSingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback)
-                : Solver::Solver(scene, callback) {
+        GPUSingleThreadSolver::GPUSingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                                     const KernelRunOptions &options)
+                : Solver::Solver(scene, callback, options) {
         }
 
-        MultiThreadSolver::MultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback) : Solver::Solver(
-                scene,
-                callback) {
+        BatchSolver::BatchSolver(std::vector<std::shared_ptr<Scene>> scenes, std::vector<KernelCallback *> callbacks,
+                                 const KernelRunOptions &options)
+                : Solver::Solver(scenes, callbacks, options) {
         }
 
-        GPUMultiThreadSolver::GPUMultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback)
-                : Solver::Solver(
-                scene, callback) {
+        DistributedSolver::DistributedSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                             std::shared_ptr<Transport> transport, const KernelRunOptions &options)
+                : Solver::Solver(scene, callback, options), transport(transport) {
+            int rank = transport->get_rank();
+            int size = transport->get_size();
+            this->partition = partition_domains(scene->domain_list, size);
+            this->send_halos.resize((unsigned long) size);
+            this->receive_halos.resize((unsigned long) size);
+            std::map<std::shared_ptr<Domain>, unsigned long> order;
+            for (unsigned long i = 0; i < this->partition->domains.size(); i++) {
+                order[this->partition->domains[i]] = i;
+            }
+            //the halos are listed in the order of the partition, so both ranks of a halo list it at the same position
+            std::set<std::shared_ptr<Domain>> halo_domains;
+            for (unsigned long i = 0; i < this->partition->domains.size(); i++) {
+                auto domain = this->partition->domains[i];
+                int owner = this->partition->ranks[i];
+                for (Direction side: all_directions) {
+                    std::vector<std::shared_ptr<Domain>> neighbours = domain->get_neighbours_at(side);
+                    std::sort(neighbours.begin(), neighbours.end(),
+                              [&](std::shared_ptr<Domain> a, std::shared_ptr<Domain> b) {
+                                  return order.at(a) < order.at(b);
+                              });
+                    for (auto neighbour: neighbours) {
+                        int neighbour_owner = this->partition->get_rank(neighbour);
+                        if (neighbour_owner == owner) {
+                            continue;
+                        }
+                        if (neighbour_owner == rank) {
+                            this->send_halos[owner].push_back({neighbour, side});
+                        }
+                        if (owner == rank) {
+                            this->receive_halos[neighbour_owner].push_back({neighbour, side});
+                            halo_domains.insert(neighbour);
+                        }
+                    }
+                }
+            }
+            //only the strips of the domains of other ranks are used, the remaining fields are freed
+            for (auto domain: scene->domain_list) {
+                if (this->partition->get_rank(domain) == rank) {
+                    this->local_domains.push_back(domain);
+                    continue;
+                }
+                if (halo_domains.count(domain) == 0) {
+                    domain->current_values = FieldValues();
+                }
+                domain->previous_values = FieldValues();
+                domain->l_values = FieldLValues();
+            }
+            OPENPSTD_LOG(LogLevel::DEBUG, "Rank " + std::to_string(rank) + " computes " +
+                                          std::to_string(this->local_domains.size()) + " of " +
+                                          std::to_string(scene->domain_list.size()) + " domains");
         }
 
+        MultiThreadSolver::MultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                             const KernelRunOptions &options) : Solver::Solver(scene, callback,
+                                                                                               options) {
+        }
+
+        GPUMultiThreadSolver::GPUMultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                                   const KernelRunOptions &options)
+                : Solver::Solver(scene, callback, options) {
+        }
+
+
+        /**
+         * Names of the calculation directions and types in the trace, these are string literals
+         */
+        static const char *trace_name(CalcDirection calc_dir) {
+            return calc_dir == CalcDirection::X ? "x" : "y";
+        }
+
+        static const char *trace_name(CalculationType calc_type) {
+            return calc_type == CalculationType::PRESSURE ? "pressure" : "velocity";
+        }
 
         // Todo: Overwrite solver for GPU/Multithreaded
         void Solver::compute_propagation() {
-            this->callback->Callback(CALLBACKSTATUS::STARTING, "Starting simulation", -1);
-            for (int frame = 0; frame < this->number_of_time_steps; frame++) {
+            for (auto scene_callback:this->callbacks) {
+                scene_callback->Callback(CALLBACKSTATUS::STARTING, "Starting simulation", -1);
+            }
+            if (this->options.Profiling) {
+                this->profiler = std::make_shared<Profiler>(this->scene->domain_list);
                 for (auto domain:this->scene->domain_list) {
-                    domain->push_values();
-                    //std::cout << *domain << std::endl;
+                    domain->profiler = this->profiler;
+                }
+            }
+            Profiler *profiler = this->profiler.get();
+            if (this->options.TraceBufferSize > 0) {
+                this->tracer = std::make_shared<Tracer>(this->options.TraceBufferSize);
+            }
+            Tracer *tracer = this->tracer.get();
+            ProgressThrottle progress(this->options.ProgressInterval);
+            //the same domain in every scene, the first domain is the one of this->scene
+            std::vector<std::vector<std::shared_ptr<Domain>>> batch_domains(this->scene->domain_list.size());
+            for (unsigned long i = 0; i < batch_domains.size(); i++) {
+                for (auto batch_scene:this->scenes) {
+                    batch_domains[i].push_back(batch_scene->domain_list.at(i));
+                }
+            }
+            int first_frame = 0;
+            bool resumed = false;
+            std::string checkpoint_file = this->options.CheckpointFile;
+            if (not checkpoint_file.empty() and this->scenes.size() > 1) {
+                if (this->options.Resume) {
+                    throw std::runtime_error("A batch of scenes can not be resumed from a checkpoint");
+                }
+                if (this->options.CheckpointInterval > 0) {
+                    OPENPSTD_LOG(LogLevel::WARNING, "Checkpoints are not written for a batch of scenes");
+                }
+                checkpoint_file.clear();
+            }
+            if (not checkpoint_file.empty() and this->options.Resume) {
+                std::shared_ptr<Checkpoint> checkpoint = Checkpoint::read(checkpoint_file);
+                checkpoint->restore(this->scene);
+                first_frame = checkpoint->frame + 1;
+                resumed = true;
+                OPENPSTD_LOG(LogLevel::INFO, "Resuming from frame " + std::to_string(first_frame));
+            }
+            unsigned int checkpoint_interval = this->options.CheckpointInterval;
+            std::unique_ptr<CheckpointWriter> checkpoint_writer;
+            if (not checkpoint_file.empty() and checkpoint_interval > 0) {
+                checkpoint_writer.reset(new CheckpointWriter(checkpoint_file));
+            }
+            for (int frame = first_frame; frame < this->number_of_time_steps; frame++) {
+                TraceScope frame_scope(tracer, "frame", "solver", frame);
+                if (profiler != nullptr) {
+                    profiler->start_frame();
+                }
+                for (auto &batch:batch_domains) {
+                    for (auto domain:batch) {
+                        domain->push_values();
+                        //std::cout << *domain << std::endl;
+                    }
                 }
                 for (unsigned long rk_step = 0; rk_step < 6; rk_step++) {
+                    TraceScope stage_scope(tracer, "rk stage", "solver", frame, -1, (int) rk_step);
                     for (Kernel::CalcDirection calc_dir: Kernel::all_calc_directions) {
                         for (Kernel::CalculationType calc_type: Kernel::all_calculation_types) {
-                            for (auto domain:this->scene->domain_list) {
+                            for (auto &batch:batch_domains) {
+                                auto domain = batch.front();
                                 //std::cout << *domain << std::endl;
                                 if (not domain->is_rigid()) {
                                     if (domain->should_update[calc_dir]) {
-                                        domain->calc(calc_dir, calc_type);
+                                        TraceScope scope(tracer, "calc", "solver", frame, domain->id, (int) rk_step,
+                                                         trace_name(calc_dir), trace_name(calc_type));
+                                        domain->calc(batch, calc_dir, calc_type);
                                     }
                                 }
                             }
                         }
                     }
-                    for (auto domain:this->scene->domain_list) {
+                    for (auto &batch:batch_domains) {
+                        if (not batch.front()->is_rigid()) {
+                            TraceScope scope(tracer, "rk update", "solver", frame, batch.front()->id, (int) rk_step);
+                            ProfileTimer timer(profiler, PROFILEPHASE::RK_UPDATE, batch.front()->id);
+                            for (auto domain:batch) {
+                                this->update_field_values(domain, rk_step, frame);
+                            }
+                        }
+                    }
+                    for (auto &batch:batch_domains) {
+                        ProfileTimer timer(profiler, PROFILEPHASE::RK_UPDATE, batch.front()->id);
+                        for (auto domain:batch) {
+                            domain->current_values.p0 = domain->current_values.px0 + domain->current_values.py0;
+                        }
+                    }
+                }
+                for (auto &batch:batch_domains) {
+                    if (frame % this->settings->GetSaveNth() == 0 and not batch.front()->is_pml) {
+                        TraceScope scope(tracer, "write frame", "io", frame, batch.front()->id);
+                        ProfileTimer timer(profiler, PROFILEPHASE::WRITE_FRAME, batch.front()->id);
+                        for (unsigned long b = 0; b < batch.size(); b++) {
+                            this->callbacks[b]->WriteFrame(frame, batch[b]->id, this->get_pressure_vector(batch[b]));
+                        }
+                    }
+                }
+                {
+                    TraceScope scope(tracer, "pml", "solver", frame);
+                    for (auto batch_scene:this->scenes) {
+                        batch_scene->apply_pml_matrices();
+                    }
+                }
+                for (unsigned long b = 0; b < this->scenes.size(); b++) {
+                    for (auto receiver:this->scenes[b]->receiver_list) {
+                        TraceScope scope(tracer, "receiver", "solver", frame, receiver->container_domain->id);
+                        ProfileTimer timer(profiler, PROFILEPHASE::RECEIVERS, receiver->container_domain->id);
+                        receiver->compute_local_pressure();
+                        if (frame % this->settings->GetSaveNth() == 0) {
+                            this->callbacks[b]->WriteSample(frame, (int) receiver->id,
+                                                            *this->get_receiver_pressure(receiver));
+                        }
+                    }
+                }
+                if (checkpoint_writer and (frame + 1) % checkpoint_interval == 0 and
+                    frame + 1 < this->number_of_time_steps) {
+                    //when the previous checkpoint is still written this one is skipped, the solver never waits
+                    if (checkpoint_writer->is_idle()) {
+                        TraceScope scope(tracer, "checkpoint", "io", frame);
+                        this->callback->Checkpoint(frame);
+                        checkpoint_writer->submit(Checkpoint::capture(this->scene, frame));
+                    } else {
+                        OPENPSTD_LOG(LogLevel::WARNING, "Skipped checkpoint of frame " + std::to_string(frame) +
+                                                        ", the previous checkpoint is still written");
+                    }
+                }
+                if (progress.should_report(frame, this->number_of_time_steps)) {
+                    for (auto scene_callback:this->callbacks) {
+                        scene_callback->Callback(CALLBACKSTATUS::RUNNING, "Finished frame: " + std::to_string(frame),
+                                                 frame);
+                    }
+                }
+            }
+            if (checkpoint_writer) {
+                checkpoint_writer->wait();
+                checkpoint_writer.reset();
+            }
+            if (not checkpoint_file.empty() and (checkpoint_interval > 0 or resumed)) {
+                //the simulation is complete, so there is nothing left to resume(also the checkpoint that is resumed
+                //without writing new checkpoints)
+                boost::filesystem::remove(checkpoint_file);
+            }
+            if (profiler != nullptr) {
+                for (auto domain:this->scene->domain_list) {
+                    domain->profiler.reset();
+                }
+                this->callback->WriteProfile(profiler->get_profile());
+            }
+            if (tracer != nullptr) {
+                this->callback->WriteTrace(tracer->get_trace());
+            }
+            for (auto scene_callback:this->callbacks) {
+                scene_callback->Callback(CALLBACKSTATUS::FINISHED, "Succesfully finished simulation",
+                                         this->number_of_time_steps);
+            }
+        }
+
+        /**
+         * Part of a field that is read by the neighbour at the side of the domain. A derivative reads at most the
+         * window size of the neighbour, plus one value for the staggered velocity grid.
+         */
+        static Eigen::Block<Eigen::ArrayXXf> get_halo_strip(Eigen::ArrayXXf &field, Direction side, int depth) {
+            int rows = (int) field.rows();
+            int cols = (int) field.cols();
+            switch (side) {
+                case Direction::LEFT:
+                    depth = std::min(depth, cols);
+                    return field.block(0, cols - depth, rows, depth);
+                case Direction::RIGHT:
+                    return field.block(0, 0, rows, std::min(depth, cols));
+                case Direction::BOTTOM:
+                    depth = std::min(depth, rows);
+                    return field.block(rows - depth, 0, depth, cols);
+                default:
+                    return field.block(0, 0, std::min(depth, rows), cols);
+            }
+        }
+
+        /**
+         * The velocity field that is read by the neighbour at the side of the domain
+         */
+        static Eigen::ArrayXXf &get_halo_velocity(std::shared_ptr<Domain> domain, Direction side) {
+            if (direction_to_calc_direction(side) == CalcDirection::X) {
+                return domain->current_values.vx0;
+            }
+            return domain->current_values.vy0;
+        }
+
+        /**
+         * Appends floats to a message, the ranks have the same byte order
+         */
+        static void append_floats(std::vector<char> &message, const float *values, unsigned long count) {
+            const char *bytes = reinterpret_cast<const char *>(values);
+            message.insert(message.end(), bytes, bytes + count * sizeof(float));
+        }
+
+        static void append_floats(std::vector<char> &message, const Eigen::ArrayXXf &values) {
+            append_floats(message, values.data(), (unsigned long) values.size());
+        }
+
+        /**
+         * Reads floats from a message at the offset and moves the offset past them
+         * @throws std::runtime_error if the message is too short
+         */
+        static void read_floats(const std::vector<char> &message, unsigned long &offset, float *values,
+                                unsigned long count) {
+            if (offset + count * sizeof(float) > message.size()) {
+                throw std::runtime_error("A message of another rank is shorter than expected");
+            }
+            memcpy(values, message.data() + offset, count * sizeof(float));
+            offset += count * sizeof(float);
+        }
+
+        static void read_floats(const std::vector<char> &message, unsigned long &offset,
+                                Eigen::Block<Eigen::ArrayXXf> values) {
+            Eigen::ArrayXXf strip(values.rows(), values.cols());
+            read_floats(message, offset, strip.data(), (unsigned long) strip.size());
+            values = strip;
+        }
+
+        void DistributedSolver::exchange_halos() {
+            int depth = this->settings->GetWindowSize() + 1;
+            for (int peer = 0; peer < this->transport->get_size(); peer++) {
+                if (this->send_halos[peer].empty()) {
+                    continue;
+                }
+                std::vector<char> message;
+                for (auto &halo: this->send_halos[peer]) {
+                    append_floats(message, get_halo_strip(halo.domain->current_values.p0, halo.side, depth));
+                    append_floats(message, get_halo_strip(get_halo_velocity(halo.domain, halo.side), halo.side, depth));
+                }
+                this->transport->send(peer, message);
+            }
+            for (int peer = 0; peer < this->transport->get_size(); peer++) {
+                if (this->receive_halos[peer].empty()) {
+                    continue;
+                }
+                std::vector<char> message = this->transport->receive(peer);
+                unsigned long offset = 0;
+                for (auto &halo: this->receive_halos[peer]) {
+                    read_floats(message, offset, get_halo_strip(halo.domain->current_values.p0, halo.side, depth));
+                    read_floats(message, offset, get_halo_strip(get_halo_velocity(halo.domain, halo.side), halo.side,
+                                                                depth));
+                }
+                if (offset != message.size()) {
+                    throw std::runtime_error("The halos of rank " + std::to_string(peer) + " do not match");
+                }
+            }
+        }
+
+        void DistributedSolver::gather_results(int frame,
+                                               const std::map<std::shared_ptr<Domain>, PSTD_FRAME_PTR> &frames) {
+            int rank = this->transport->get_rank();
+            if (rank != 0) {
+                std::vector<char> message;
+                for (unsigned long i = 0; i < this->partition->domains.size(); i++) {
+                    if (this->partition->ranks[i] == rank and not this->partition->domains[i]->is_pml) {
+                        PSTD_FRAME_PTR data = frames.at(this->partition->domains[i]);
+                        append_floats(message, data->data(), data->size());
+                    }
+                }
+                for (auto receiver: this->scene->receiver_list) {
+                    if (this->partition->get_rank(receiver->container_domain) == rank) {
+                        append_floats(message, &receiver->received_values.back(), 1);
+                    }
+                }
+                this->transport->send(0, message);
+                return;
+            }
+            std::map<std::shared_ptr<Domain>, PSTD_FRAME_PTR> all_frames = frames;
+            std::map<std::shared_ptr<Receiver>, float> samples;
+            for (auto receiver: this->scene->receiver_list) {
+                if (this->partition->get_rank(receiver->container_domain) == 0) {
+                    samples[receiver] = receiver->received_values.back();
+                }
+            }
+            for (int peer = 1; peer < this->transport->get_size(); peer++) {
+                std::vector<char> message = this->transport->receive(peer);
+                unsigned long offset = 0;
+                for (unsigned long i = 0; i < this->partition->domains.size(); i++) {
+                    auto domain = this->partition->domains[i];
+                    if (this->partition->ranks[i] == peer and not domain->is_pml) {
+                        auto data = std::make_shared<PSTD_FRAME>((unsigned long) domain->size.x * domain->size.y);
+                        read_floats(message, offset, data->data(), data->size());
+                        all_frames[domain] = data;
+                    }
+                }
+                for (auto receiver: this->scene->receiver_list) {
+                    if (this->partition->get_rank(receiver->container_domain) == peer) {
+                        read_floats(message, offset, &samples[receiver], 1);
+                    }
+                }
+                if (offset != message.size()) {
+                    throw std::runtime_error("The results of rank " + std::to_string(peer) + " do not match");
+                }
+            }
+            //the same order as the single process solver
+            for (auto domain: this->scene->domain_list) {
+                if (not domain->is_pml) {
+                    this->callback->WriteFrame(frame, domain->id, all_frames.at(domain));
+                }
+            }
+            for (auto receiver: this->scene->receiver_list) {
+                this->callback->WriteSample(frame, (int) receiver->id, PSTD_FRAME{samples.at(receiver)});
+            }
+        }
+
+        void DistributedSolver::compute_propagation() {
+            //the other ranks would wait for the messages of this rank until the timeout of the transport
+            try {
+                this->propagate();
+            }
+            catch (std::exception &e) {
+                this->transport->abort(e.what());
+                throw;
+            }
+        }
+
+        void DistributedSolver::propagate() {
+            int rank = this->transport->get_rank();
+            if (not this->options.CheckpointFile.empty() and this->options.Resume) {
+                throw std::runtime_error("A distributed simulation can not be resumed from a checkpoint");
+            }
+            if (rank == 0) {
+                this->callback->Callback(CALLBACKSTATUS::STARTING, "Starting simulation", -1);
+                if (this->options.Profiling or this->options.TraceBufferSize > 0 or
+                    (not this->options.CheckpointFile.empty() and this->options.CheckpointInterval > 0)) {
+                    OPENPSTD_LOG(LogLevel::WARNING, "Profiling, tracing and checkpoints are not supported in a "
+                            "distributed simulation");
+                }
+            }
+            ProgressThrottle progress(this->options.ProgressInterval);
+            //after the PML the strips are exchanged for the receivers, these are also the strips of the next frame
+            this->exchange_halos();
+            for (int frame = 0; frame < this->number_of_time_steps; frame++) {
+                for (auto domain:this->local_domains) {
+                    domain->push_values();
+                }
+                for (unsigned long rk_step = 0; rk_step < 6; rk_step++) {
+                    if (rk_step > 0) {
+                        this->exchange_halos();
+                    }
+                    for (Kernel::CalcDirection calc_dir: Kernel::all_calc_directions) {
+                        for (Kernel::CalculationType calc_type: Kernel::all_calculation_types) {
+                            for (auto domain:this->local_domains) {
+                                if (not domain->is_rigid() and domain->should_update[calc_dir]) {
+                                    domain->calc(calc_dir, calc_type);
+                                }
+                            }
+                        }
+                    }
+                    for (auto domain:this->local_domains) {
                         if (not domain->is_rigid()) {
                             this->update_field_values(domain, rk_step, frame);
                         }
                     }
-                    for (auto domain:this->scene->domain_list) {
+                    for (auto domain:this->local_domains) {
                         domain->current_values.p0 = domain->current_values.px0 + domain->current_values.py0;
                     }
                 }
-                for (auto domain:this->scene->domain_list) {
-                    if (frame % this->settings->GetSaveNth() == 0 and not domain->is_pml) {
-                        this->callback->WriteFrame(frame, domain->id, this->get_pressure_vector(domain));
+                bool save = frame % this->settings->GetSaveNth() == 0;
+                std::map<std::shared_ptr<Domain>, PSTD_FRAME_PTR> frames;
+                for (auto domain:this->local_domains) {
+                    if (save and not domain->is_pml) {
+                        frames[domain] = this->get_pressure_vector(domain);
+                    }
+                }
+                for (auto domain:this->local_domains) {
+                    if (domain->is_pml) {
+                        domain->apply_pml_matrices();
                     }
                 }
-                this->scene->apply_pml_matrices();
+                this->exchange_halos();
                 for (auto receiver:this->scene->receiver_list) {
-                    receiver->compute_local_pressure();
-                    if (frame % this->settings->GetSaveNth() == 0) {
-                        this->callback->WriteSample(frame, (int) receiver->id, *this->get_receiver_pressure(receiver));
+                    if (this->partition->get_rank(receiver->container_domain) == rank) {
+                        receiver->compute_local_pressure();
                     }
                 }
-                this->callback->Callback(CALLBACKSTATUS::RUNNING, "Finished frame: "+std::to_string(frame), frame);
+                if (save) {
+                    this->gather_results(frame, frames);
+                }
+                if (rank == 0 and progress.should_report(frame, this->number_of_time_steps)) {
+                    this->callback->Callback(CALLBACKSTATUS::RUNNING, "Finished frame: " + std::to_string(frame),
+                                             frame);
+                }
+            }
+            this->transport->barrier();
+            if (rank == 0) {
+                this->callback->Callback(CALLBACKSTATUS::FINISHED, "Succesfully finished simulation",
+                                         this->number_of_time_steps);
             }
-            this->callback->Callback(CALLBACKSTATUS::FINISHED, "Succesfully finished simulation",
-                                     this->number_of_time_steps);
         }
 
         void Solver::update_field_values(std::shared_ptr<Domain> domain, unsigned long rk_step,
@@ -33,12 +33,19 @@
 #ifndef OPENPSTD_SOLVER_H
 #define OPENPSTD_SOLVER_H
 
+#include <map>
 #include "KernelInterface.h"
 #include "core/Scene.h"
+#include "core/Tracer.h"
+#include "core/Logger.h"
+#include "core/Checkpoint.h"
+#include "core/Partitioner.h"
 #include "PSTDKernel.h"
 
 namespace OpenPSTD {
     namespace Kernel {
+        /// Connection with the other ranks of a distributed simulation, see core/Transport.h
+        class Transport;
 
         /**
          * Component that computes the state variables of the scene for consecutive time steps.
@@ -49,14 +56,27 @@ namespace OpenPSTD {
          * The time integration is performed with a RK6 method described in <paper>.
          */
         class Solver {
-        private:
+        protected:
             /// Parameters and settings
             std::shared_ptr<PSTDSettings> settings;
-            /// Scene (initialized before passed to the solver)
+            /// Switches of the run, like profiling and checkpointing
+            KernelRunOptions options;
+            /// Scene (initialized before passed to the solver), the first scene of the batch
             std::shared_ptr<Scene> scene;
+            /// Scenes that are advanced together, these only differ in the speakers and receivers
+            std::vector<std::shared_ptr<Scene>> scenes;
 
-        protected:
             KernelCallback *callback;
+            /// Callback of every scene of the batch, the frames and samples of a scene are written to its callback
+            std::vector<KernelCallback *> callbacks;
+            /**
+             * Times the phases of the calculation, nullptr if profiling is disabled in the run options
+             */
+            std::shared_ptr<Profiler> profiler;
+            /**
+             * Records the tasks of the run, nullptr if tracing is disabled in the run options
+             */
+            std::shared_ptr<Tracer> tracer;
             /**
              * The final number of computed frames
              */
@@ -82,16 +102,29 @@ namespace OpenPSTD {
              * Solver constructor (abstract). Initialized parameters for running the openPSTD algorithm
              * @param scene: Pointer to scene object.
              * @param callback: Pointer to callback function
+             * @param options: Switches of the run
              * @return: New solver object.
              */
-            Solver(std::shared_ptr<Scene> scene, KernelCallback *callback);
+            Solver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                   const KernelRunOptions &options = KernelRunOptions());
+
+            /**
+             * Solver constructor (abstract) for a batch of scenes. The scenes have the same domains and parameters,
+             * the derivatives of a domain are computed for all the scenes in a single FFT batch.
+             * @param scenes: Scenes with the same domains, these only differ in the speakers and receivers
+             * @param callbacks: Callback of every scene, the profile and trace are written to the first callback
+             * @param options: Switches of the run
+             * @throws std::runtime_error if the scenes have different domains
+             */
+            Solver(std::vector<std::shared_ptr<Scene>> scenes, std::vector<KernelCallback *> callbacks,
+                   const KernelRunOptions &options = KernelRunOptions());
 
             /**
              * Start the simulation solver.
              * Runs until the simulation is finished, but meanwhile makes calls to the callback.
              * A more badass name is welcome
              */
-            void compute_propagation();
+            virtual void compute_propagation();
         };
 
         /**
@@ -103,7 +136,83 @@ namespace OpenPSTD {
              * Default constructor. Blocking call: will not return before the solver is done.
              * @see Solver
              */
-            SingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback);
+            SingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                               const KernelRunOptions &options = KernelRunOptions());
+        };
+
+        /**
+         * Solver that advances several scenes with the same domains together.
+         * The sound propagation is linear, so the scenes of different speakers on the same geometry are independent
+         * and the derivatives of all the scenes are computed in one larger FFT batch.
+         */
+        class BatchSolver : public Solver {
+        public:
+            /**
+             * Batch solver. Blocking call: will not return before the solver is done.
+             * @see Solver
+             */
+            BatchSolver(std::vector<std::shared_ptr<Scene>> scenes, std::vector<KernelCallback *> callbacks,
+                        const KernelRunOptions &options = KernelRunOptions());
+        };
+
+        /**
+         * Solver for one rank of a simulation that is distributed over several processes.
+         *
+         * Every rank creates the same scene, the domains are partitioned over the ranks and every rank only computes
+         * its own domains. Before the derivatives are computed, the ranks exchange the strips of their domains that
+         * the derivatives of the neighbouring domains on other ranks read. The computation of a domain is the same as
+         * in the single process solver, so the results are identical. The frames and samples are gathered on rank 0
+         * and written to its callback, the callbacks of the other ranks are not used.
+         */
+        class DistributedSolver : public Solver {
+        private:
+            /**
+             * Strip of a domain that a neighbour on another rank reads. The side is the direction in which the domain
+             * lies from the neighbour.
+             */
+            struct Halo {
+                std::shared_ptr<Domain> domain;
+                Direction side;
+            };
+
+            std::shared_ptr<Transport> transport;
+            std::shared_ptr<Partition> partition;
+            /// Domains of this rank, in the order of the scene
+            std::vector<std::shared_ptr<Domain>> local_domains;
+            /// Strips of the own domains that are sent to every rank
+            std::vector<std::vector<Halo>> send_halos;
+            /// Strips of the domains of every rank that are received
+            std::vector<std::vector<Halo>> receive_halos;
+
+            /**
+             * Sends the strips of the own domains and receives the strips of the neighbouring domains on other ranks
+             */
+            void exchange_halos();
+
+            /**
+             * Sends the frames of the own domains and the samples of the own receivers to rank 0, where all the frames
+             * and samples are written to the callback in the same order as the single process solver.
+             * @param frames: frame of every own domain that is not a PML domain
+             */
+            void gather_results(int frame, const std::map<std::shared_ptr<Domain>, PSTD_FRAME_PTR> &frames);
+
+            /**
+             * Computes the frames of the own domains, compute_propagation aborts the other ranks if this fails
+             */
+            void propagate();
+
+        public:
+            /**
+             * Solver of one rank, the scene must be initialized with the same configuration on every rank.
+             * Blocking call: will not return before all the ranks are done.
+             * @param callback: callback of rank 0, the other ranks may use nullptr
+             * @see Solver
+             */
+            DistributedSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                              std::shared_ptr<Transport> transport,
+                              const KernelRunOptions &options = KernelRunOptions());
+
+            void compute_propagation() override;
         };
 
         /**
@@ -115,7 +224,8 @@ namespace OpenPSTD {
              * Multithreaded solver. This instance employs multiple CPU's
              * @see Solver
              */
-            MultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback);
+            MultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                              const KernelRunOptions &options = KernelRunOptions());
         };
 
         /**
@@ -127,7 +237,8 @@ namespace OpenPSTD {
              * GPU solver. This instance runs the PSTD computations on the graphics card
              * @see Solver
              */
-            GPUSingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback);
+            GPUSingleThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                  const KernelRunOptions &options = KernelRunOptions());
         };
 
         /**
@@ -139,7 +250,8 @@ namespace OpenPSTD {
              * Multithreaded GPU solver. This instance employs both multiple CPU's as well as the graphics card.
              * @see Solver
              */
-            GPUMultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback);
+            GPUMultiThreadSolver(std::shared_ptr<Scene> scene, KernelCallback *callback,
+                                 const KernelRunOptions &options = KernelRunOptions());
         };
     }
 }
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "SweepRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+
+        static const char edge_names[] = {'t', 'b', 'l', 'r'};
+
+        static vector<float> get_absorptions(const DomainConf &domain) {
+            return {domain.T.Absorption, domain.B.Absorption, domain.L.Absorption, domain.R.Absorption};
+        }
+
+        SweepRunner::SweepRunner(shared_ptr<PSTDConfiguration> config) {
+            this->config = config;
+            this->topology.initialize_kernel(config);
+        }
+
+        void SweepRunner::check_variant(shared_ptr<PSTDConfiguration> variant) {
+            if (variant->Domains.size() != this->config->Domains.size()) {
+                throw runtime_error("The variant has " + to_string(variant->Domains.size()) + " domains instead of " +
+                                    to_string(this->config->Domains.size()));
+            }
+            for (unsigned long i = 0; i < variant->Domains.size(); i++) {
+                const DomainConf &domain = variant->Domains[i];
+                const DomainConf &base = this->config->Domains[i];
+                if (domain.TopLeft.x() != base.TopLeft.x() || domain.TopLeft.y() != base.TopLeft.y() ||
+                    domain.Size.x() != base.Size.x() || domain.Size.y() != base.Size.y()) {
+                    throw runtime_error("Domain " + to_string(i) + " of the variant has another position or size");
+                }
+                vector<float> absorptions = get_absorptions(domain);
+                vector<float> base_absorptions = get_absorptions(base);
+                for (unsigned long edge = 0; edge < absorptions.size(); edge++) {
+                    if ((absorptions[edge] > 0) != (base_absorptions[edge] > 0)) {
+                        throw runtime_error("Edge " + string(1, edge_names[edge]) + " of domain " + to_string(i) +
+                                            " of the variant can not change between reflecting and absorbing");
+                    }
+                }
+            }
+        }
+
+        void SweepRunner::run(const vector<shared_ptr<PSTDConfiguration>> &variants, VariantFunction run_variant,
+                              unsigned int threads) {
+            this->run_batches(variants, [&](const vector<unsigned long> &batch, PSTDKernel &kernel) {
+                run_variant(batch.at(0), kernel);
+            }, 1, threads);
+        }
+
+        void SweepRunner::run_batches(const vector<shared_ptr<PSTDConfiguration>> &variants, BatchFunction run_batch,
+                                      unsigned int batch_size, unsigned int threads) {
+            batch_size = max(batch_size, 1u);
+            for (unsigned long variant = 0; variant < variants.size(); variant++) {
+                this->check_variant(variants[variant]);
+                unsigned long first = variant - variant % batch_size;
+                for (unsigned long i = 0; i < variants[variant]->Domains.size(); i++) {
+                    if (!variants[variant]->Domains[i].HasSameEdges(variants[first]->Domains[i])) {
+                        throw runtime_error("The edges of domain " + to_string(i) + " of variant " +
+                                            to_string(variant) + " differ from the other variants of its batch");
+                    }
+                }
+            }
+            unsigned long batches = (variants.size() + batch_size - 1) / batch_size;
+            if (threads == 0) {
+                threads = max(thread::hardware_concurrency(), 1u);
+            }
+            threads = (unsigned int) min((unsigned long) threads, batches);
+
+            atomic<unsigned long> next_batch(0);
+            mutex error_mutex;
+            exception_ptr error;
+            auto worker = [&]() {
+                while (true) {
+                    unsigned long batch_index = next_batch++;
+                    if (batch_index >= batches) {
+                        return;
+                    }
+                    {
+                        lock_guard<mutex> lock(error_mutex);
+                        if (error) {
+                            return;
+                        }
+                    }
+                    try {
+                        vector<unsigned long> batch;
+                        for (unsigned long variant = batch_index * batch_size;
+                             variant < min((batch_index + 1) * batch_size, (unsigned long) variants.size());
+                             variant++) {
+                            batch.push_back(variant);
+                        }
+                        PSTDKernel kernel;
+                        kernel.initialize_variant(variants[batch.front()], this->topology.get_scene());
+                        run_batch(batch, kernel);
+                        for (unsigned long variant: batch) {
+                            OPENPSTD_LOG(LogLevel::INFO, "Finished variant " + to_string(variant));
+                        }
+                    }
+                    catch (...) {
+                        lock_guard<mutex> lock(error_mutex);
+                        if (!error) {
+                            error = current_exception();
+                        }
+                        return;
+                    }
+                }
+            };
+
+            vector<thread> workers;
+            for (unsigned int i = 0; i < threads; i++) {
+                workers.push_back(thread(worker));
+            }
+            for (auto &worker_thread: workers) {
+                worker_thread.join();
+            }
+            if (error) {
+                rethrow_exception(error);
+            }
+        }
+
+        shared_ptr<Scene> SweepRunner::get_scene() {
+            return this->topology.get_scene();
+        }
+    }
+}
@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Runs a sweep of variants of a scene that only differ in the
+//      speakers, receivers and absorption of the edges. The domains, PML
+//      domains and wisdom cache are created once for all the variants.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_SWEEPRUNNER_H
+#define OPENPSTD_SWEEPRUNNER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "PSTDKernel.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+
+        /**
+         * Runs the variants of a scene concurrently.
+         *
+         * The scene of the base configuration is initialized once, every variant runs on a copy of this scene in
+         * which only the fields, speakers, receivers and edge parameters are replaced. The settings of the base
+         * configuration are used for all the variants. The run options are passed by the functions that run the
+         * variants, the variants can not share a checkpoint file.
+         */
+        class SweepRunner {
+        public:
+            /**
+             * Runs a variant on an initialized kernel, this is called concurrently for different variants
+             * @param variant: index of the variant
+             * @param kernel: kernel that is initialized with the variant
+             */
+            typedef std::function<void(unsigned long variant, PSTDKernel &kernel)> VariantFunction;
+
+            /**
+             * Runs a batch of variants on a kernel that is initialized with the first variant of the batch, e.g.
+             * kernel.run_batch(configurations, callbacks)
+             * @param batch: indices of the variants of the batch
+             * @param kernel: kernel that is initialized with the first variant of the batch
+             */
+            typedef std::function<void(const std::vector<unsigned long> &batch, PSTDKernel &kernel)> BatchFunction;
+
+        private:
+            std::shared_ptr<PSTDConfiguration> config;
+            PSTDKernel topology;
+
+        public:
+            /**
+             * Initializes the scene of the base configuration
+             */
+            SweepRunner(std::shared_ptr<PSTDConfiguration> config);
+
+            /**
+             * Checks if a variant has the same domains as the base configuration.
+             * The edges along which PML domains are created can not change between reflecting(absorption 0) and
+             * absorbing.
+             * @throws std::runtime_error if the variant needs another scene
+             */
+            void check_variant(std::shared_ptr<PSTDConfiguration> variant);
+
+            /**
+             * Runs all the variants, the variants are checked before any variant is run.
+             * @param variants: configurations of the variants
+             * @param run_variant: runs a single variant, e.g. kernel.run(callback)
+             * @param threads: number of variants that run concurrently, 0 uses all cores
+             * @throws the first exception of a variant, the variants that are not started yet are skipped
+             */
+            void run(const std::vector<std::shared_ptr<PSTDConfiguration>> &variants, VariantFunction run_variant,
+                     unsigned int threads = 0);
+
+            /**
+             * Runs the variants in batches of consecutive variants, the variants of a batch are advanced together by
+             * one solver. The variants of a batch can only differ in the speakers and receivers.
+             * @param variants: configurations of the variants
+             * @param run_batch: runs a single batch, this is called concurrently for different batches
+             * @param batch_size: maximal number of variants in a batch
+             * @param threads: number of batches that run concurrently, 0 uses all cores
+             * @throws std::runtime_error if the edges of the variants of a batch differ
+             * @see PSTDKernel::run_batch
+             */
+            void run_batches(const std::vector<std::shared_ptr<PSTDConfiguration>> &variants, BatchFunction run_batch,
+                             unsigned int batch_size, unsigned int threads = 0);
+
+            /**
+             * The scene that is shared by the variants
+             */
+            std::shared_ptr<Scene> get_scene();
+        };
+    }
+}
+
+#endif //OPENPSTD_SWEEPRUNNER_H
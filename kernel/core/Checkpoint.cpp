@@ -0,0 +1,364 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Checkpoint.h"
+#include "Receiver.h"
+#include "Logger.h"
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+        using namespace Eigen;
+
+        static const char checkpoint_magic[8] = {'O', 'P', 'S', 'T', 'D', 'C', 'K', '1'};
+
+        template<typename T>
+        static void write_value(ostream &out, T value) {
+            out.write((const char *) &value, sizeof(T));
+        }
+
+        template<typename T>
+        static T read_value(istream &in) {
+            T value;
+            in.read((char *) &value, sizeof(T));
+            return value;
+        }
+
+        /**
+         * The number of bytes after the current position, the sizes that are read from the file are checked against
+         * this before they are allocated, so a corrupt size is not allocated
+         */
+        static unsigned long long remaining_bytes(istream &in) {
+            streampos position = in.tellg();
+            in.seekg(0, ios::end);
+            streampos end = in.tellg();
+            in.seekg(position);
+            if (position < 0 || end < position) {
+                return 0;
+            }
+            return (unsigned long long) (end - position);
+        }
+
+        static void write_array(ostream &out, const ArrayXXf &array) {
+            write_value<int>(out, (int) array.rows());
+            write_value<int>(out, (int) array.cols());
+            out.write((const char *) array.data(), sizeof(float) * array.size());
+        }
+
+        static ArrayXXf read_array(istream &in) {
+            int rows = read_value<int>(in);
+            int cols = read_value<int>(in);
+            if (!in || rows < 0 || cols < 0) {
+                throw runtime_error("invalid array in checkpoint");
+            }
+            if ((unsigned long long) rows * cols * sizeof(float) > remaining_bytes(in)) {
+                throw runtime_error("invalid array in checkpoint, an array of " + to_string(rows) + "x" +
+                                    to_string(cols) + " values is larger than the rest of the file");
+            }
+            ArrayXXf array(rows, cols);
+            in.read((char *) array.data(), sizeof(float) * array.size());
+            return array;
+        }
+
+        static void write_point(ostream &out, const Point &point) {
+            write_value<int>(out, point.x);
+            write_value<int>(out, point.y);
+        }
+
+        static Point read_point(istream &in) {
+            int x = read_value<int>(in);
+            int y = read_value<int>(in);
+            return Point(x, y);
+        }
+
+        static void write_fields(ostream &out, const FieldValues &fields) {
+            write_array(out, fields.vx0);
+            write_array(out, fields.vy0);
+            write_array(out, fields.p0);
+            write_array(out, fields.px0);
+            write_array(out, fields.py0);
+        }
+
+        static FieldValues read_fields(istream &in) {
+            FieldValues fields;
+            fields.vx0 = read_array(in);
+            fields.vy0 = read_array(in);
+            fields.p0 = read_array(in);
+            fields.px0 = read_array(in);
+            fields.py0 = read_array(in);
+            return fields;
+        }
+
+        static int read_header(istream &in, const string &filename) {
+            char magic[sizeof(checkpoint_magic)];
+            in.read(magic, sizeof(magic));
+            if (!in || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0) {
+                throw runtime_error(filename + " is not a checkpoint");
+            }
+            return read_value<int>(in);
+        }
+
+        shared_ptr<Checkpoint> Checkpoint::capture(shared_ptr<Scene> scene, int frame) {
+            shared_ptr<Checkpoint> checkpoint = make_shared<Checkpoint>();
+            checkpoint->frame = frame;
+            for (auto domain: scene->domain_list) {
+                checkpoint->domains.push_back({domain->id, domain->top_left, domain->size, domain->is_pml,
+                                               domain->current_values, domain->previous_values, domain->pml_arrays});
+            }
+            for (auto receiver: scene->receiver_list) {
+                checkpoint->receivers.push_back(receiver->received_values);
+            }
+            return checkpoint;
+        }
+
+        static bool same_place(const DomainState &state, shared_ptr<Domain> domain) {
+            return state.is_pml == domain->is_pml &&
+                   state.top_left.x == domain->top_left.x && state.top_left.y == domain->top_left.y &&
+                   state.size.x == domain->size.x && state.size.y == domain->size.y;
+        }
+
+        static void check_shape(const ArrayXXf &state, const ArrayXXf &target, int id, const string &name) {
+            if (state.rows() != target.rows() || state.cols() != target.cols()) {
+                throw runtime_error("the checkpoint is taken from a different scene, " + name + " of domain " +
+                                    to_string(id) + " has " + to_string(state.rows()) + "x" +
+                                    to_string(state.cols()) + " values instead of " + to_string(target.rows()) +
+                                    "x" + to_string(target.cols()));
+            }
+        }
+
+        /**
+         * The fields and the PML arrays of a domain have their sizes after the scene is initialized, the previous
+         * values are empty until the first frame is computed
+         */
+        static void check_shapes(const DomainState &state, const FieldValues &fields, const PMLArrays &pml, int id) {
+            check_shape(state.current_values.vx0, fields.vx0, id, "vx0");
+            check_shape(state.current_values.vy0, fields.vy0, id, "vy0");
+            check_shape(state.current_values.p0, fields.p0, id, "p0");
+            check_shape(state.current_values.px0, fields.px0, id, "px0");
+            check_shape(state.current_values.py0, fields.py0, id, "py0");
+            if (state.previous_values.p0.size() > 0) {
+                check_shape(state.previous_values.vx0, fields.vx0, id, "previous vx0");
+                check_shape(state.previous_values.vy0, fields.vy0, id, "previous vy0");
+                check_shape(state.previous_values.p0, fields.p0, id, "previous p0");
+                check_shape(state.previous_values.px0, fields.px0, id, "previous px0");
+                check_shape(state.previous_values.py0, fields.py0, id, "previous py0");
+            }
+            check_shape(state.pml_arrays.px, pml.px, id, "PML px");
+            check_shape(state.pml_arrays.py, pml.py, id, "PML py");
+            check_shape(state.pml_arrays.vx, pml.vx, id, "PML vx");
+            check_shape(state.pml_arrays.vy, pml.vy, id, "PML vy");
+        }
+
+        void Checkpoint::restore(shared_ptr<Scene> scene) const {
+            if (scene->domain_list.size() != this->domains.size() ||
+                scene->receiver_list.size() != this->receivers.size()) {
+                throw runtime_error("the checkpoint is taken from a different scene");
+            }
+            vector<const DomainState *> states;
+            vector<bool> used(this->domains.size(), false);
+            for (auto domain: scene->domain_list) {
+                const DomainState *found = nullptr;
+                for (unsigned long i = 0; i < this->domains.size() && found == nullptr; i++) {
+                    if (!used[i] && same_place(this->domains[i], domain)) {
+                        used[i] = true;
+                        found = &this->domains[i];
+                    }
+                }
+                if (found == nullptr) {
+                    throw runtime_error("the checkpoint is taken from a different scene, domain " +
+                                        to_string(domain->id) + " does not match");
+                }
+                //all the domains are checked before the scene is changed
+                check_shapes(*found, domain->current_values, domain->pml_arrays, domain->id);
+                states.push_back(found);
+            }
+
+            for (unsigned long i = 0; i < states.size(); i++) {
+                auto domain = scene->domain_list.at(i);
+                domain->current_values = states[i]->current_values;
+                domain->previous_values = states[i]->previous_values;
+                domain->pml_arrays = states[i]->pml_arrays;
+            }
+            for (unsigned long i = 0; i < this->receivers.size(); i++) {
+                scene->receiver_list.at(i)->received_values = this->receivers.at(i);
+            }
+        }
+
+        void Checkpoint::write(const string &filename) const {
+            string temporary = filename + ".tmp";
+            {
+                ofstream out(temporary, ios::binary | ios::trunc);
+                out.write(checkpoint_magic, sizeof(checkpoint_magic));
+                write_value<int>(out, this->frame);
+                write_value<unsigned int>(out, (unsigned int) this->domains.size());
+                for (const DomainState &state: this->domains) {
+                    write_value<int>(out, state.id);
+                    write_point(out, state.top_left);
+                    write_point(out, state.size);
+                    write_value<char>(out, state.is_pml);
+                    write_fields(out, state.current_values);
+                    write_fields(out, state.previous_values);
+                    write_array(out, state.pml_arrays.px);
+                    write_array(out, state.pml_arrays.py);
+                    write_array(out, state.pml_arrays.vx);
+                    write_array(out, state.pml_arrays.vy);
+                }
+                write_value<unsigned int>(out, (unsigned int) this->receivers.size());
+                for (const vector<float> &values: this->receivers) {
+                    write_value<unsigned long long>(out, values.size());
+                    out.write((const char *) values.data(), sizeof(float) * values.size());
+                }
+                out.flush();
+                if (!out) {
+                    throw runtime_error("could not write checkpoint " + temporary);
+                }
+            }
+            //the old checkpoint is only replaced by a complete checkpoint
+            boost::filesystem::rename(temporary, filename);
+        }
+
+        shared_ptr<Checkpoint> Checkpoint::read(const string &filename) {
+            ifstream in(filename, ios::binary);
+            if (!in) {
+                throw runtime_error("could not open checkpoint " + filename);
+            }
+            shared_ptr<Checkpoint> checkpoint = make_shared<Checkpoint>();
+            checkpoint->frame = read_header(in, filename);
+            unsigned int domain_count = read_value<unsigned int>(in);
+            for (unsigned int i = 0; i < domain_count && in; i++) {
+                DomainState state;
+                state.id = read_value<int>(in);
+                state.top_left = read_point(in);
+                state.size = read_point(in);
+                state.is_pml = read_value<char>(in) != 0;
+                state.current_values = read_fields(in);
+                state.previous_values = read_fields(in);
+                state.pml_arrays.px = read_array(in);
+                state.pml_arrays.py = read_array(in);
+                state.pml_arrays.vx = read_array(in);
+                state.pml_arrays.vy = read_array(in);
+                checkpoint->domains.push_back(state);
+            }
+            unsigned int receiver_count = read_value<unsigned int>(in);
+            for (unsigned int i = 0; i < receiver_count && in; i++) {
+                unsigned long long sample_count = read_value<unsigned long long>(in);
+                if (!in || sample_count > remaining_bytes(in) / sizeof(float)) {
+                    throw runtime_error("checkpoint " + filename + " is incomplete, receiver " + to_string(i) +
+                                        " has more values than the rest of the file");
+                }
+                vector<float> values(sample_count);
+                in.read((char *) values.data(), sizeof(float) * values.size());
+                checkpoint->receivers.push_back(values);
+            }
+            if (!in) {
+                throw runtime_error("checkpoint " + filename + " is incomplete");
+            }
+            return checkpoint;
+        }
+
+        int Checkpoint::read_frame(const string &filename) {
+            ifstream in(filename, ios::binary);
+            if (!in) {
+                throw runtime_error("could not open checkpoint " + filename);
+            }
+            return read_header(in, filename);
+        }
+
+        CheckpointWriter::CheckpointWriter(string filename) : filename(filename) {
+            this->worker = thread(&CheckpointWriter::write_checkpoints, this);
+        }
+
+        CheckpointWriter::~CheckpointWriter() {
+            {
+                lock_guard<std::mutex> lock(this->mutex);
+                this->stopping = true;
+            }
+            this->changed.notify_all();
+            this->worker.join();
+        }
+
+        void CheckpointWriter::write_checkpoints() {
+            unique_lock<std::mutex> lock(this->mutex);
+            while (true) {
+                this->changed.wait(lock, [this]() { return this->pending || this->stopping; });
+                if (!this->pending) {
+                    return;
+                }
+                shared_ptr<Checkpoint> checkpoint = this->pending;
+                this->pending = nullptr;
+
+                lock.unlock();
+                string error;
+                try {
+                    checkpoint->write(this->filename);
+                }
+                catch (const exception &e) {
+                    error = e.what();
+                    OPENPSTD_LOG(LogLevel::WARNING, "Could not write the checkpoint of frame " +
+                                                    to_string(checkpoint->frame) + ": " + error);
+                }
+                lock.lock();
+
+                //the error of an earlier checkpoint is cleared, the file holds the checkpoint that is written
+                this->error = error;
+                if (error.empty()) {
+                    this->written++;
+                }
+                this->busy = false;
+                this->changed.notify_all();
+            }
+        }
+
+        bool CheckpointWriter::is_idle() {
+            lock_guard<std::mutex> lock(this->mutex);
+            return !this->busy;
+        }
+
+        bool CheckpointWriter::submit(shared_ptr<Checkpoint> checkpoint) {
+            {
+                lock_guard<std::mutex> lock(this->mutex);
+                if (this->busy) {
+                    return false;
+                }
+                this->busy = true;
+                this->pending = checkpoint;
+            }
+            this->changed.notify_all();
+            return true;
+        }
+
+        void CheckpointWriter::wait() {
+            unique_lock<std::mutex> lock(this->mutex);
+            this->changed.wait(lock, [this]() { return !this->busy; });
+        }
+
+        string CheckpointWriter::get_error() {
+            lock_guard<std::mutex> lock(this->mutex);
+            return this->error;
+        }
+
+        int CheckpointWriter::get_written_count() {
+            lock_guard<std::mutex> lock(this->mutex);
+            return this->written;
+        }
+    }
+}
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Checkpoints of the state of a running simulation, so that a
+//      simulation can be restarted after the last checkpoint.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_CHECKPOINT_H
+#define OPENPSTD_CHECKPOINT_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Domain.h"
+#include "Scene.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        /**
+         * The state of a domain that is not recomputed by the next frame.
+         * The ids of the secondary PML domains differ between runs of the same scene, so a state is restored to the
+         * domain with the same location and size.
+         */
+        struct DomainState {
+            int id;
+            Point top_left;
+            Point size;
+            bool is_pml;
+            FieldValues current_values;
+            FieldValues previous_values;
+            PMLArrays pml_arrays;
+        };
+
+        /**
+         * A copy of the state of a scene after a frame.
+         * The file is written in the native byte order, it is meant to restart on the same kind of machine.
+         */
+        class Checkpoint {
+        public:
+            /// The last frame that is part of the state
+            int frame = -1;
+            std::vector<DomainState> domains;
+            /// The received values of the receivers, in the order of the receiver list of the scene
+            std::vector<std::vector<float>> receivers;
+
+            /**
+             * Copies the state of the scene
+             */
+            static std::shared_ptr<Checkpoint> capture(std::shared_ptr<Scene> scene, int frame);
+
+            /**
+             * Copies the state back in the scene
+             * @throws std::runtime_error if the checkpoint is taken from a different scene, or the size of an array does
+             * not match its domain
+             */
+            void restore(std::shared_ptr<Scene> scene) const;
+
+            /**
+             * Writes the checkpoint to a temporary file first, the file is replaced when the checkpoint is complete
+             * @throws std::runtime_error if the file can not be written
+             */
+            void write(const std::string &filename) const;
+
+            /**
+             * The sizes in the file are checked against the length of the file, so a corrupt file is not allocated
+             * @throws std::runtime_error if the file does not exist or is not a complete checkpoint
+             */
+            static std::shared_ptr<Checkpoint> read(const std::string &filename);
+
+            /**
+             * Reads only the frame of a checkpoint file
+             * @throws std::runtime_error if the file does not exist or is not a checkpoint
+             */
+            static int read_frame(const std::string &filename);
+        };
+
+        /**
+         * Writes checkpoints on a background thread, so that the solver continues while the file is written. A
+         * checkpoint that can not be written is logged as a warning, the simulation continues without it.
+         */
+        class CheckpointWriter {
+        private:
+            std::string filename;
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::shared_ptr<Checkpoint> pending;
+            bool busy = false;
+            bool stopping = false;
+            int written = 0;
+            std::string error;
+            std::thread worker;
+
+            void write_checkpoints();
+
+        public:
+            CheckpointWriter(std::string filename);
+
+            /**
+             * Waits until the checkpoint that is written is finished
+             */
+            ~CheckpointWriter();
+
+            /**
+             * True if no checkpoint is being written, a new checkpoint can be submitted without waiting
+             */
+            bool is_idle();
+
+            /**
+             * Writes the checkpoint on the background thread
+             * @return false if a checkpoint is still being written, the checkpoint is not written then
+             */
+            bool submit(std::shared_ptr<Checkpoint> checkpoint);
+
+            /**
+             * Waits until all checkpoints are written
+             */
+            void wait();
+
+            /**
+             * The error of the last checkpoint, empty if it is written or no checkpoint is submitted
+             */
+            std::string get_error();
+
+            /**
+             * Number of checkpoints that are written
+             */
+            int get_written_count();
+        };
+    }
+}
+
+#endif //OPENPSTD_CHECKPOINT_H
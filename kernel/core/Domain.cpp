@@ -61,19 +61,16 @@ namespace OpenPSTD {
             this->wnd = wnd;
             this->id = id;
             this->edge_param_map = edge_param_map;
-            this->alpha = alpha; 
-            //Todo: (TK): Probably wrong, especially with two neighbouring PML domains
-            this->impedance = -((sqrt(1 - alpha) + 1) / (sqrt(1 - alpha) - 1));
+            this->set_alpha(alpha);
             if (is_pml) { // Ugly... Fix when possible
                 this->pml_for_domain_list.push_back(pml_for_domain);
             }
-            if (this->is_rigid()) {
-                this->rho = 1E30;
-            } else {
-                this->rho = this->settings->GetDensityOfAir()*this->impedance;
-            }
             this->is_pml = is_pml;
             this->is_secondary_pml = false;
+            //read by find_update_directions before compute_pml_matrices sets them, so these must not be left
+            //uninitialized, otherwise the result differs between runs and between the processes of a simulation
+            this->has_horizontal_attenuation = false;
+            this->is_corner_domain = false;
             for (auto domain:this->pml_for_domain_list) {
                 if (domain->is_pml) {
                     is_secondary_pml = true;
@@ -90,11 +87,36 @@ namespace OpenPSTD {
             this->local = false;
         }
 
+        /**
+         * The field that is derived for the calculation type and direction
+         */
+        static const ArrayXXf &get_field(const FieldValues &values, CalcDirection cd, CalculationType ct) {
+            if (ct == CalculationType::PRESSURE) {
+                return values.p0;
+            }
+            else if (cd == CalcDirection::X) {
+                return values.vx0;
+            }
+            else {
+                return values.vy0;
+            }
+        }
+
         // version of calc that would have a return value.
         ArrayXXf Domain::calc(CalcDirection cd, CalculationType ct, ArrayXcf dest) {
-            ArrayXXf source;
+            return this->calc(vector<shared_ptr<Domain>>{shared_from_this()}, cd, ct, dest).at(0);
+        }
+
+        vector<ArrayXXf> Domain::calc(const vector<shared_ptr<Domain>> &batch, CalcDirection cd, CalculationType ct,
+                                      ArrayXcf dest) {
+            unsigned long batch_size = batch.size();
+            vector<ArrayXXf> sources(batch_size);
             vector<shared_ptr<Domain>> domains1, domains2;
+            //the neighbours of the domain in every scene of the batch, in the same order as domains1 and domains2
+            vector<vector<shared_ptr<Domain>>> batch_domains1(batch_size), batch_domains2(batch_size);
             vector<int> own_range = get_range(cd);
+            //only the derivatives of the propagation are profiled, not the interpolation of the receivers
+            Profiler *profiler = dest.rows() == 0 ? this->profiler.get() : nullptr;
 
             if (cd == CalcDirection::X) {
                 domains1 = left;
@@ -104,6 +126,10 @@ namespace OpenPSTD {
                 domains1 = bottom;
                 domains2 = top;
             }
+            for (unsigned long b = 0; b < batch_size; b++) {
+                batch_domains1[b] = cd == CalcDirection::X ? batch[b]->left : batch[b]->bottom;
+                batch_domains2[b] = cd == CalcDirection::X ? batch[b]->right : batch[b]->top;
+            }
             /*//debug
             cout << "\n\ndomains1:\n";
             for(auto domain : domains1) {
@@ -116,38 +142,40 @@ namespace OpenPSTD {
             }
             cout << "\n\n";*/
 
-            if (dest.rows() != 0) {
-                if (cd == CalcDirection::X) {
-                    source = extended_zeros(0, 1);
-                }
-                else {
-                    source = extended_zeros(1, 0);
-                }
-            }
-            else {
-                if (ct == CalculationType::PRESSURE) {
+            for (unsigned long b = 0; b < batch_size; b++) {
+                if (dest.rows() != 0) {
                     if (cd == CalcDirection::X) {
-                        source = this->l_values.Lpx;
+                        sources[b] = extended_zeros(0, 1);
                     }
                     else {
-                        source = this->l_values.Lpy;
+                        sources[b] = extended_zeros(1, 0);
                     }
                 }
                 else {
-                    if (cd == CalcDirection::X) {
-                        source = this->l_values.Lvx;
+                    if (ct == CalculationType::PRESSURE) {
+                        if (cd == CalcDirection::X) {
+                            sources[b] = batch[b]->l_values.Lpx;
+                        }
+                        else {
+                            sources[b] = batch[b]->l_values.Lpy;
+                        }
                     }
                     else {
-                        source = this->l_values.Lvy;
+                        if (cd == CalcDirection::X) {
+                            sources[b] = batch[b]->l_values.Lvx;
+                        }
+                        else {
+                            sources[b] = batch[b]->l_values.Lvy;
+                        }
                     }
                 }
             }
 
             // loop over all possible combinations of neighbours for this domain (including null on one side)
             shared_ptr<Domain> d1, d2;
-            for (int i = 0; i != domains1.size() + 1; i++) { //the +1 because a null pointer is also needed
+            for (unsigned long i = 0; i != domains1.size() + 1; i++) { //the +1 because a null pointer is also needed
                 d1 = (i != domains1.size()) ? domains1[i] : nullptr;
-                for (int j = 0; j != domains2.size() + 1; j++) {
+                for (unsigned long j = 0; j != domains2.size() + 1; j++) {
                     d2 = (j != domains2.size()) ? domains2[j] : nullptr;
 
                     //The range is determined and clipped to the neighbour domain ranges
@@ -192,18 +220,18 @@ namespace OpenPSTD {
                         wlen = wlen/2;
                         //cout << "using reduced window length" << endl;
                     }
-                    int N_total = 2 * wlen + primary_dimension;
                     ArrayXf wind = get_window_coefficients(wlen, settings->GetPatchError());
 
                     if (ct == CalculationType::PRESSURE) {
-                        N_total++;
                         result_dimension++;
                     }
                     else {
                         primary_dimension++;
                     }
+                    //spatderp3 transforms the main matrix with both windows, the derivative factors must match that length
+                    int N_total = 2 * wlen + primary_dimension;
 
-                    ArrayXXf matrix_main, matrix_side1, matrix_side2;
+                    ArrayXXf zero_side;
                     if (ct == CalculationType::VELOCITY && d1 == nullptr && d2 == nullptr) {
                         // For a PML layer parallel to its interface direction the matrix is concatenated with zeros
                         // a PML domain can also have a neighbour, see:
@@ -213,12 +241,10 @@ namespace OpenPSTD {
                         //  <--------------->
                         d1 = d2 = shared_from_this();
                         if (cd == CalcDirection::X) {
-                            matrix_side1 = extended_zeros(0, 1);
-                            matrix_side2 = extended_zeros(0, 1);
+                            zero_side = extended_zeros(0, 1);
                         }
                         else {
-                            matrix_side1 = extended_zeros(1, 0);
-                            matrix_side2 = extended_zeros(1, 0);
+                            zero_side = extended_zeros(1, 0);
                         }
                     }
                     else {
@@ -230,44 +256,25 @@ namespace OpenPSTD {
                         }
                     }
 
-                    if (ct == CalculationType::PRESSURE) {
-                        matrix_main = current_values.p0;
-                    }
-                    else if (cd == CalcDirection::X) {
-                        matrix_main = current_values.vx0;
-                    }
-                    else {
-                        matrix_main = current_values.vy0;
-                    }
-
-                    // If the matrices are _not_ already filled with zeroes, choose which values to fill them with.
-                    if (matrix_side1.cols() == 0) {
-                        if (ct == CalculationType::PRESSURE) {
-                            matrix_side1 = d1->current_values.p0;
+                    // The fields of the scenes of the batch, a missing neighbour is replaced by the domain itself
+                    // unless the matrices are filled with zeroes.
+                    vector<const ArrayXXf *> matrix_main(batch_size), matrix_side1(batch_size),
+                            matrix_side2(batch_size);
+                    for (unsigned long b = 0; b < batch_size; b++) {
+                        matrix_main[b] = &get_field(batch[b]->current_values, cd, ct);
+                        if (zero_side.cols() != 0) {
+                            matrix_side1[b] = &zero_side;
+                            matrix_side2[b] = &zero_side;
                         }
                         else {
-                            if (cd == CalcDirection::X) {
-                                matrix_side1 = d1->current_values.vx0;
-                            }
-                            else {
-                                matrix_side1 = d1->current_values.vy0;
-                            }
-                        }
-                    }
-                    if (matrix_side2.cols() == 0) {
-                        if (ct == CalculationType::PRESSURE) {
-                            matrix_side2 = d2->current_values.p0;
-                        }
-                        else {
-                            if (cd == CalcDirection::X) {
-                                matrix_side2 = d2->current_values.vx0;
-                            }
-                            else {
-                                matrix_side2 = d2->current_values.vy0;
-                            }
+                            shared_ptr<Domain> side1 = i != domains1.size() ? batch_domains1[b].at(i) : batch[b];
+                            shared_ptr<Domain> side2 = j != domains2.size() ? batch_domains2[b].at(j) : batch[b];
+                            matrix_side1[b] = &get_field(side1->current_values, cd, ct);
+                            matrix_side2[b] = &get_field(side2->current_values, cd, ct);
                         }
                     }
 
+                    ProfileTimer lookup_timer(profiler, PROFILEPHASE::PLANNING, this->id);
                     ArrayXcf derfact;
                     if (dest.rows() != 0) {
                         derfact = dest;
@@ -283,75 +290,107 @@ namespace OpenPSTD {
                         }
                     }
 
+                    lookup_timer.stop();
+
                     float max_rho = 1E10;
                     RhoArray rho_array = get_rho_array(d1 != nullptr ? d1->rho : max_rho,
                                                        this->rho,
                                                        d2 != nullptr ? d2->rho : max_rho);
 
-                    // Calculate the spatial derivatives for the current intersection range and store
+                    // Calculate the spatial derivatives for the current intersection range and store, the ranges of
+                    // all the scenes of the batch are stacked along the batch dimension of a single transform
                     int matrix_main_offset, matrix_side1_offset, matrix_side2_offset;
                     ArrayXXf matrix_main_indexed, matrix_side1_indexed, matrix_side2_indexed;
                     if (cd == CalcDirection::X) {
+                        int nrows = range_end - range_start;
+
+                        //the plans of the transform of the range of all the scenes of the batch
+                        ProfileTimer timer(profiler, PROFILEPHASE::PLANNING, this->id);
                         WisdomCache::Planset_FFTW planset = wnd->get_fftw_planset(
-                                next_2_power(matrix_main.cols() + 2 * wlen), matrix_main.rows());
+                                next_2_power(matrix_main[0]->cols() + 2 * wlen), nrows * batch_size);
+                        timer.next(PROFILEPHASE::WINDOWING);
                         matrix_main_offset = this->top_left.y;
                         matrix_side1_offset = d1->top_left.y;
                         matrix_side2_offset = d2->top_left.y;
 
-                        int nrows = range_end - range_start;
-
-                        matrix_main_indexed = matrix_main.block(range_start - matrix_main_offset, 0,
-                                                                  nrows, matrix_main.cols());
-                        matrix_side1_indexed = matrix_side1.block(range_start - matrix_side1_offset, 0,
-                                                                  nrows, matrix_side1.cols());
-                        matrix_side2_indexed = matrix_side2.block(range_start - matrix_side2_offset, 0,
-                                                                  nrows, matrix_side2.cols());
+                        matrix_main_indexed.resize(nrows * batch_size, matrix_main[0]->cols());
+                        matrix_side1_indexed.resize(nrows * batch_size, matrix_side1[0]->cols());
+                        matrix_side2_indexed.resize(nrows * batch_size, matrix_side2[0]->cols());
+                        for (unsigned long b = 0; b < batch_size; b++) {
+                            matrix_main_indexed.middleRows(b * nrows, nrows) = matrix_main[b]->block(
+                                    range_start - matrix_main_offset, 0, nrows, matrix_main[b]->cols());
+                            matrix_side1_indexed.middleRows(b * nrows, nrows) = matrix_side1[b]->block(
+                                    range_start - matrix_side1_offset, 0, nrows, matrix_side1[b]->cols());
+                            matrix_side2_indexed.middleRows(b * nrows, nrows) = matrix_side2[b]->block(
+                                    range_start - matrix_side2_offset, 0, nrows, matrix_side2[b]->cols());
+                        }
 
+                        timer.stop();
                         Eigen:ArrayXXf spatresult = spatderp3(matrix_side1_indexed, matrix_main_indexed, matrix_side2_indexed, derfact,
-                                                              rho_array, wind, wlen, ct, cd, planset.plan, planset.plan_inv);
-                        source.block(range_start - matrix_main_offset, 0, full_range, result_dimension) = spatresult;
+                                                              rho_array, wind, wlen, ct, cd, planset.plan, planset.plan_inv,
+                                                              profiler, this->id);
+                        ProfileTimer store_timer(profiler, PROFILEPHASE::WINDOWING, this->id);
+                        for (unsigned long b = 0; b < batch_size; b++) {
+                            sources[b].block(range_start - matrix_main_offset, 0, full_range, result_dimension) =
+                                    spatresult.middleRows(b * full_range, full_range);
+                        }
                     }
                     else {
+                        int ncols = range_end - range_start;
+
+                        ProfileTimer timer(profiler, PROFILEPHASE::PLANNING, this->id);
                         WisdomCache::Planset_FFTW planset = wnd->get_fftw_planset(
-                                next_2_power(matrix_main.rows() + 2 * wlen), matrix_main.cols());
+                                next_2_power(matrix_main[0]->rows() + 2 * wlen), ncols * batch_size);
+                        timer.next(PROFILEPHASE::WINDOWING);
                         matrix_main_offset = this->top_left.x;
                         matrix_side1_offset = d1->top_left.x;
                         matrix_side2_offset = d2->top_left.x;
 
-                        int ncols = range_end - range_start;
-
-                        matrix_main_indexed = matrix_main.block(0, range_start - matrix_main_offset,
-                                                                matrix_main.rows(), ncols);
-                        matrix_side1_indexed = matrix_side1.block(0, range_start - matrix_side1_offset,
-                                                                  matrix_side1.rows(), ncols);
-                        matrix_side2_indexed = matrix_side2.block(0, range_start - matrix_side2_offset,
-                                                                  matrix_side2.rows(), ncols);
+                        matrix_main_indexed.resize(matrix_main[0]->rows(), ncols * batch_size);
+                        matrix_side1_indexed.resize(matrix_side1[0]->rows(), ncols * batch_size);
+                        matrix_side2_indexed.resize(matrix_side2[0]->rows(), ncols * batch_size);
+                        for (unsigned long b = 0; b < batch_size; b++) {
+                            matrix_main_indexed.middleCols(b * ncols, ncols) = matrix_main[b]->block(
+                                    0, range_start - matrix_main_offset, matrix_main[b]->rows(), ncols);
+                            matrix_side1_indexed.middleCols(b * ncols, ncols) = matrix_side1[b]->block(
+                                    0, range_start - matrix_side1_offset, matrix_side1[b]->rows(), ncols);
+                            matrix_side2_indexed.middleCols(b * ncols, ncols) = matrix_side2[b]->block(
+                                    0, range_start - matrix_side2_offset, matrix_side2[b]->rows(), ncols);
+                        }
 
+                        timer.stop();
                         ArrayXXf spatresult = spatderp3(matrix_side1_indexed, matrix_main_indexed, matrix_side2_indexed, derfact,
-                                                              rho_array, wind, wlen, ct, cd, planset.plan, planset.plan_inv);
-                        source.block(0, range_start - matrix_main_offset, result_dimension, ncols) = spatresult;
+                                                              rho_array, wind, wlen, ct, cd, planset.plan, planset.plan_inv,
+                                                              profiler, this->id);
+                        ProfileTimer store_timer(profiler, PROFILEPHASE::WINDOWING, this->id);
+                        for (unsigned long b = 0; b < batch_size; b++) {
+                            sources[b].block(0, range_start - matrix_main_offset, result_dimension, ncols) =
+                                    spatresult.middleCols(b * ncols, ncols);
+                        }
                     }
                 }
             }
             if (dest.rows() == 0) {
-                if (ct == CalculationType::PRESSURE) {
-                    if (cd == CalcDirection::X) {
-                        this->l_values.Lpx = source;
-                    }
-                    else {
-                        this->l_values.Lpy = source;
-                    }
-                }
-                else {
-                    if (cd == CalcDirection::X) {
-                        this->l_values.Lvx = source;
+                for (unsigned long b = 0; b < batch_size; b++) {
+                    if (ct == CalculationType::PRESSURE) {
+                        if (cd == CalcDirection::X) {
+                            batch[b]->l_values.Lpx = sources[b];
+                        }
+                        else {
+                            batch[b]->l_values.Lpy = sources[b];
+                        }
                     }
                     else {
-                        this->l_values.Lvy = source;
+                        if (cd == CalcDirection::X) {
+                            batch[b]->l_values.Lvx = sources[b];
+                        }
+                        else {
+                            batch[b]->l_values.Lvy = sources[b];
+                        }
                     }
                 }
             }
-            return source;
+            return sources;
         }
 
         /**
@@ -504,50 +543,6 @@ namespace OpenPSTD {
             }
         }
 
-        ArrayXXi Domain::get_vacant_range(Direction direction) {
-            vector<shared_ptr<Domain>> neighbour_list;
-            CalcDirection calc_dir = direction_to_calc_direction(direction);
-            vector<int> range = get_range(calc_dir);
-            set<int> range_set(range.begin(), range.end());
-            switch (direction) {
-                case Direction::LEFT:
-                    neighbour_list = left;
-                    break;
-                case Direction::RIGHT:
-                    neighbour_list = right;
-                    break;
-                case Direction::TOP:
-                    neighbour_list = top;
-                    break;
-                case Direction::BOTTOM:
-                    neighbour_list = bottom;
-                    break;
-            }
-            for (shared_ptr<Domain> domain: neighbour_list) {
-                vector<int> neighbour_range = domain->get_range(calc_dir);
-                set<int> neighbour_range_set(neighbour_range.begin(), neighbour_range.end());
-                set<int> set_diff;
-                set_difference(range_set.begin(), range_set.end(), neighbour_range_set.begin(),
-                               neighbour_range_set.end(), inserter(set_diff, set_diff.end()));
-                range_set.swap(set_diff);
-            }
-            ArrayXXi vacant_range(range_set.size(), 2);
-            range.assign(range_set.begin(), range_set.end());
-            int iterator = 0;
-            for (unsigned long i = 0; i < range.size(); i++) {
-                if (i == 0 || range.at(i - 1) + 1 < range.at(i)) {
-                    vacant_range(0, 0) = range.at(i);
-                    vacant_range(0, 1) = range.at(i);
-                    iterator++;
-                }
-                if (i == range.size() - 1 || range.at(i + 1) - 1 > range.at(i)) {
-                    vacant_range(iterator - 1, 1) = range.at(i) + 1;
-                }
-            }
-            return vacant_range.topRows(iterator);
-        }
-
-
         void Domain::find_update_directions() {
             for (CalcDirection calc_dir: all_calc_directions) {
                 bool should_update = true;
@@ -681,6 +676,7 @@ namespace OpenPSTD {
         {
             assert(number_of_neighbours(false) == 1 and is_pml or number_of_neighbours(true) <= 2 and
                    is_secondary_pml);
+            ProfileTimer timer(this->profiler.get(), PROFILEPHASE::PML, this->id);
             // The pressure and velocity matrices are multiplied by the PML values.
             current_values.px0 *= pml_arrays.px;
             current_values.py0 *= pml_arrays.py;
@@ -758,5 +754,24 @@ namespace OpenPSTD {
             compute_number_of_neighbours();
             find_update_directions();
         }
+
+        void Domain::set_alpha(float alpha) {
+            this->alpha = alpha;
+            //Todo: (TK): Probably wrong, especially with two neighbouring PML domains
+            this->impedance = -((sqrt(1 - alpha) + 1) / (sqrt(1 - alpha) - 1));
+            if (this->is_rigid()) {
+                this->rho = 1E30;
+            } else {
+                this->rho = this->settings->GetDensityOfAir()*this->impedance;
+            }
+        }
+
+        void Domain::replace_domains(const map<Domain *, shared_ptr<Domain>> &copies) {
+            for (vector<shared_ptr<Domain>> *domains: {&left, &right, &top, &bottom, &pml_for_domain_list}) {
+                for (auto &domain: *domains) {
+                    domain = copies.at(domain.get());
+                }
+            }
+        }
     }
 }
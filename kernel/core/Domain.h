@@ -140,6 +140,8 @@ namespace OpenPSTD {
             bool is_secondary_pml;
             /// List of domains that this domain functions for as a PML
             std::vector<std::shared_ptr<Domain>> pml_for_domain_list;
+            /// Profiler of the running solver, nullptr if profiling is disabled
+            std::shared_ptr<Profiler> profiler;
 
         private:
             std::vector<std::shared_ptr<Domain>> left;
@@ -151,6 +153,9 @@ namespace OpenPSTD {
             bool has_horizontal_attenuation, is_corner_domain;
             std::vector<bool> needs_reversed_attenuation;
             PMLArrays pml_arrays;
+
+            /// Stores and restores the PML arrays of the domain
+            friend class Checkpoint;
         public:
 
             /**
@@ -286,6 +291,18 @@ namespace OpenPSTD {
              */
             Eigen::ArrayXXf calc(CalcDirection cd, CalculationType ct, Eigen::ArrayXcf dest);
 
+            /**
+             * Calculate one timestep of propagation for the same domain in several scenes at once. The scenes have
+             * the same domains and parameters, the derivatives of all the scenes are computed in the same FFT
+             * batch.
+             * @param batch: this domain in every scene of the batch, the neighbours, parameters and plans are taken
+             * from this domain and only the fields are taken from the batch
+             * @see calc(CalcDirection, CalculationType, Eigen::ArrayXcf)
+             * @return the derivative of every domain of the batch
+             */
+            std::vector<Eigen::ArrayXXf> calc(const std::vector<std::shared_ptr<Domain>> &batch, CalcDirection cd,
+                                              CalculationType ct, Eigen::ArrayXcf dest = Eigen::ArrayXcf());
+
             /**
              * Calculate one time step of propagation in this domain
              * @param cd Boundary type (calculation direction)
@@ -301,11 +318,21 @@ namespace OpenPSTD {
             void post_initialization();
 
             /**
-             * Get ranges of boundary grid points not connected to a neighbour domain along a specified direction.
-             * @param direction: Domain side under consideration
-             * @return: 2D array each row a range start and end variable
+             * Clears the pressure and velocity fields, so that the domain can be reused for a new simulation
              */
-            Eigen::ArrayXXi get_vacant_range(Direction direction);
+            void clear_fields();
+
+            /**
+             * Changes the alpha of the domain, the impedance and density follow from the alpha
+             */
+            void set_alpha(float alpha);
+
+            /**
+             * Replaces the neighbours and the domains this domain is a PML for by their copies, used when the scene
+             * is copied.
+             * @param copies: the copy of every domain of the scene
+             */
+            void replace_domains(const std::map<Domain *, std::shared_ptr<Domain>> &copies);
 
             /**
              * Method that gives the current domain initialized with zeroes, extended by the input
@@ -323,8 +350,6 @@ namespace OpenPSTD {
                                    std::map<Direction, EdgeParameters> edge_param_map,
                                    const std::shared_ptr<Domain> pml_for_domain);
 
-            void clear_fields();
-
             void clear_pml_arrays();
 
             void find_update_directions();
@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Estimator.h"
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <stdexcept>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+
+        static DomainEstimate estimate_domain(const LayoutDomain &domain, shared_ptr<PSTDSettings> settings) {
+            DomainEstimate result;
+            result.id = domain.id;
+            result.top_left = domain.top_left;
+            result.size = domain.size;
+            result.is_pml = domain.is_pml;
+            result.is_secondary_pml = domain.is_secondary_pml;
+            result.pml_for = domain.pml_for;
+
+            long long w = domain.size.x, h = domain.size.y;
+            result.cells = w * h;
+            // current and previous fields: p0, px0, py0, vx0 and vy0
+            // spatial derivatives: Lpx, Lpy, Lvx and Lvy
+            // PML arrays: px, py, vx and vy
+            // every velocity-like array is one larger in its own direction
+            result.state_bytes = (long long) sizeof(float) * (18 * w * h + 4 * (w + h));
+
+            result.workspace_bytes = 0;
+            for (CalcDirection cd: all_calc_directions) {
+                for (CalculationType ct: all_calculation_types) {
+                    FFTEstimate fft;
+                    fft.direction = cd;
+                    fft.type = ct;
+                    int primary_dimension = cd == CalcDirection::X ? domain.size.x : domain.size.y;
+                    fft.window = settings->GetWindowSize();
+                    while (fft.window > primary_dimension) {
+                        fft.window = fft.window / 2;
+                    }
+                    if (ct == CalculationType::VELOCITY) {
+                        primary_dimension++;
+                    }
+                    fft.length = next_2_power(primary_dimension + 2 * fft.window);
+                    fft.batch = cd == CalcDirection::X ? domain.size.y : domain.size.x;
+                    result.ffts.push_back(fft);
+
+                    // input, windowed, transposed and derived real arrays and the complex spectrum
+                    long long workspace = (long long) fft.batch * (4 * fft.length * sizeof(float) +
+                                                                   (fft.length / 2 + 1) * 2 * sizeof(float));
+                    result.workspace_bytes = max(result.workspace_bytes, workspace);
+                }
+            }
+            return result;
+        }
+
+        SceneEstimate estimate_scene(shared_ptr<PSTDConfiguration> config, double cell_updates_per_second) {
+            shared_ptr<PSTDSettings> settings = make_shared<PSTDSettings>(config->Settings);
+            SceneEstimate result;
+            result.grid_spacing = settings->GetGridSpacing();
+            try {
+                result.recommended_grid_spacing = get_grid_spacing(*settings);
+            }
+            catch (std::invalid_argument &) {
+                result.recommended_grid_spacing = 0;
+            }
+
+            // the scene uses the same layout
+            SceneLayout layout;
+            for (auto &domain: config->Domains) {
+                pair<Point, Point> grid = discretize_domain(domain, result.grid_spacing);
+                LayoutDomain rectangle(layout.get_new_id(), grid.first, grid.second, false, false, {});
+                rectangle.alpha[Direction::LEFT] = domain.L.Absorption;
+                rectangle.alpha[Direction::RIGHT] = domain.R.Absorption;
+                rectangle.alpha[Direction::BOTTOM] = domain.B.Absorption;
+                rectangle.alpha[Direction::TOP] = domain.T.Absorption;
+                layout.add_domain(rectangle);
+            }
+            layout.add_pml_domains(settings->GetPMLCells());
+
+            result.cells = 0;
+            result.state_bytes = 0;
+            result.workspace_bytes = 0;
+            long long frame_cells = 0;
+            for (LayoutDomain &domain: layout.domains) {
+                DomainEstimate estimate = estimate_domain(domain, settings);
+                result.cells += estimate.cells;
+                result.state_bytes += estimate.state_bytes;
+                result.workspace_bytes = max(result.workspace_bytes, estimate.workspace_bytes);
+                if (!estimate.is_pml) {
+                    frame_cells += estimate.cells;
+                }
+                result.domains.push_back(estimate);
+            }
+
+            // same frame count and SaveNth condition as the solver
+            int save_nth = max(settings->GetSaveNth(), 1);
+            result.frame_count = (int) (settings->GetRenderTime() / settings->GetTimeStep());
+            result.saved_frame_count = (result.frame_count + save_nth - 1) / save_nth;
+            result.receiver_count = (int) config->Receivers.size();
+            //the receivers are sampled on the same frames as the domains
+            result.output_bytes = (long long) sizeof(float) * (result.saved_frame_count * frame_cells +
+                                                               (long long) result.saved_frame_count *
+                                                               result.receiver_count);
+
+            result.cell_updates_per_second = cell_updates_per_second;
+            result.seconds = (double) result.frame_count * result.cells / cell_updates_per_second;
+            return result;
+        }
+
+        long long SceneEstimate::get_memory_bytes() const {
+            return state_bytes + workspace_bytes;
+        }
+
+        int SceneEstimate::get_pml_domain_count() const {
+            int count = 0;
+            for (auto &domain: domains) {
+                if (domain.is_pml) {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        double read_cell_updates_per_second(const std::string &filename, int threads) {
+            boost::property_tree::ptree tree;
+            boost::property_tree::read_json(filename, tree);
+
+            double sum = 0;
+            int count = 0;
+            for (auto &item: tree.get_child("results")) {
+                if (item.second.get<std::string>("mode") == "strong" && item.second.get<int>("threads") == threads) {
+                    sum += item.second.get<double>("cell_updates_per_second");
+                    count++;
+                }
+            }
+            if (count == 0) {
+                throw std::runtime_error("no strong scaling results with " + to_string(threads) + " threads in " +
+                                         filename);
+            }
+            return sum / count;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Estimates the grid, memory, output and runtime of a scene from its
+//      configuration, without allocating the fields of the domains.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_ESTIMATOR_H
+#define OPENPSTD_ESTIMATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../KernelInterface.h"
+#include "kernel_functions.h"
+#include "Geometry.h"
+#include "Layout.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        /**
+         * Cell updates per second that are used when no calibration is given,
+         * measured with OpenPSTD-throughput on a single core.
+         */
+        const double default_cell_updates_per_second = 3e5;
+
+        /**
+         * The batched transform of one spatial derivative of a domain
+         */
+        struct FFTEstimate {
+            CalcDirection direction;
+            CalculationType type;
+            /// Window length after it is reduced to the size of the domain
+            int window;
+            /// Length of a single transform
+            int length;
+            /// Number of transforms in the batch
+            int batch;
+        };
+
+        /**
+         * The estimate of a domain, the PML domains are generated the same way as the scene does
+         */
+        struct DomainEstimate {
+            int id;
+            Point top_left;
+            Point size;
+            bool is_pml;
+            bool is_secondary_pml;
+            /// The ids of the domains this domain is a PML domain for
+            std::vector<int> pml_for;
+            std::vector<FFTEstimate> ffts;
+            long long cells;
+            /// Bytes of the fields, spatial derivatives and PML arrays
+            long long state_bytes;
+            /// Bytes of the buffers of the largest spatial derivative
+            long long workspace_bytes;
+        };
+
+        /**
+         * The estimate of a complete simulation
+         */
+        struct SceneEstimate {
+            /// The grid spacing of the settings, that is used by the kernel
+            float grid_spacing;
+            /// The grid spacing for the maximum frequency, 0 if the frequency is too high
+            float recommended_grid_spacing;
+            std::vector<DomainEstimate> domains;
+            int frame_count;
+            /// Number of frames that are written with the SaveNth setting
+            int saved_frame_count;
+            int receiver_count;
+            long long cells;
+            long long state_bytes;
+            /// The workspace of the largest domain, it is only allocated during a derivative
+            long long workspace_bytes;
+            /// Bytes of the frames and receiver samples that are written
+            long long output_bytes;
+            double cell_updates_per_second;
+            double seconds;
+
+            /**
+             * The peak memory of the kernel
+             */
+            long long get_memory_bytes() const;
+
+            /**
+             * Number of PML domains that are generated
+             */
+            int get_pml_domain_count() const;
+        };
+
+        /**
+         * Estimates the scene of a configuration without building it.
+         * @param config: configuration of the scene
+         * @param cell_updates_per_second: calibrated speed of the kernel
+         */
+        SceneEstimate estimate_scene(std::shared_ptr<PSTDConfiguration> config,
+                                     double cell_updates_per_second = default_cell_updates_per_second);
+
+        /**
+         * Reads the calibration from the JSON output of OpenPSTD-throughput.
+         * The strong scaling results with the given number of threads are averaged.
+         * @throws std::runtime_error if the file has no results for this number of threads
+         */
+        double read_cell_updates_per_second(const std::string &filename, int threads);
+    }
+}
+
+#endif //OPENPSTD_ESTIMATOR_H
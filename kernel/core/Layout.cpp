@@ -0,0 +1,289 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Layout.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+
+        pair<Point, Point> discretize_domain(const DomainConf &domain, float grid_spacing) {
+            QVector2D top_left = domain.TopLeft / grid_spacing;
+            QVector2D size = domain.Size / grid_spacing;
+            return make_pair(Point((int) top_left[0], (int) top_left[1]), Point((int) size[0], (int) size[1]));
+        }
+
+        LayoutDomain::LayoutDomain(int id, Point top_left, Point size, bool is_pml, bool is_secondary_pml,
+                                   vector<int> pml_for) {
+            this->id = id;
+            this->top_left = top_left;
+            this->size = size;
+            this->bottom_right = top_left + size;
+            this->is_pml = is_pml;
+            this->is_secondary_pml = is_secondary_pml;
+            this->pml_for = pml_for;
+        }
+
+        static bool contains(const vector<int> &ids, int id) {
+            return find(ids.begin(), ids.end(), id) != ids.end();
+        }
+
+        static bool is_neighbour_of(const LayoutDomain &domain, int other) {
+            for (auto &entry: domain.neighbours) {
+                if (contains(entry.second, other)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*
+         * Number of cells that two touching domains share along their common side
+         */
+        static int get_overlap(const LayoutDomain &a, const LayoutDomain &b, CalcDirection cd) {
+            if (cd == CalcDirection::X) {
+                return max(0, min(a.bottom_right.y, b.bottom_right.y) - max(a.top_left.y, b.top_left.y));
+            }
+            return max(0, min(a.bottom_right.x, b.bottom_right.x) - max(a.top_left.x, b.top_left.x));
+        }
+
+        int SceneLayout::get_new_id() {
+            number_of_domains++;
+            return number_of_domains - 1;
+        }
+
+        LayoutDomain &SceneLayout::get_domain(int id) {
+            for (LayoutDomain &domain: domains) {
+                if (domain.id == id) {
+                    return domain;
+                }
+            }
+            throw out_of_range("unknown domain " + to_string(id));
+        }
+
+        void SceneLayout::add_domain(LayoutDomain domain) {
+            for (LayoutDomain &other: domains) {
+                if (domain.is_secondary_pml && other.is_secondary_pml) {
+                    // Cannot interact, since no secondary PML domains are adjacent
+                    continue;
+                }
+                else if ((domain.is_secondary_pml && !other.is_pml) || (other.is_secondary_pml && !domain.is_pml)) {
+                    // Cannot interact, since a regular domain does not touch a secondary PML domain
+                    continue;
+                }
+                if (domain.is_pml && other.is_pml) {
+                    bool pml_for_domain = contains(other.pml_for, domain.id);
+                    bool pml_for_other_domain = contains(domain.pml_for, other.id);
+                    if ((domain.is_secondary_pml && pml_for_other_domain) ||
+                        (other.is_secondary_pml && pml_for_domain)) {
+                        // Important case: Domain is pml for second domain. Pass
+                    }
+                    else if (other.pml_for.size() != 1 || domain.pml_for.size() != 1) {
+                        continue;
+                    }
+                    else if (!is_neighbour_of(get_domain(other.pml_for.at(0)), domain.pml_for.at(0)) ||
+                             !is_neighbour_of(get_domain(domain.pml_for.at(0)), other.pml_for.at(0))) {
+                        continue;
+                    }
+                }
+                Direction orientation;
+                CalcDirection cd;
+                if (domain.bottom_right.x == other.top_left.x) {
+                    orientation = Direction::RIGHT;
+                    cd = CalcDirection::X;
+                }
+                else if (domain.top_left.x == other.bottom_right.x) {
+                    orientation = Direction::LEFT;
+                    cd = CalcDirection::X;
+                }
+                else if (domain.bottom_right.y == other.top_left.y) {
+                    orientation = Direction::BOTTOM;
+                    cd = CalcDirection::Y;
+                }
+                else if (domain.top_left.y == other.bottom_right.y) {
+                    orientation = Direction::TOP;
+                    cd = CalcDirection::Y;
+                }
+                else {
+                    continue;
+                }
+                bool other_pml_for_different_domain =
+                        other.is_pml && !domain.is_pml && !contains(other.pml_for, domain.id);
+                bool domain_pml_for_different_domain =
+                        domain.is_pml && !other.is_pml && !contains(domain.pml_for, other.id);
+                if (!other_pml_for_different_domain && !domain_pml_for_different_domain &&
+                    get_overlap(domain, other, cd) > 0) {
+                    domain.neighbours[orientation].push_back(other.id);
+                    other.neighbours[get_opposite(orientation)].push_back(domain.id);
+                }
+            }
+            domains.push_back(domain);
+        }
+
+        vector<pair<int, int>> SceneLayout::get_vacant_ranges(const LayoutDomain &domain, Direction direction) {
+            CalcDirection cd = direction_to_calc_direction(direction);
+            int start = cd == CalcDirection::X ? domain.top_left.y : domain.top_left.x;
+            int end = cd == CalcDirection::X ? domain.bottom_right.y : domain.bottom_right.x;
+            vector<bool> occupied((unsigned long) (end - start), false);
+            auto neighbours = domain.neighbours.find(direction);
+            if (neighbours != domain.neighbours.end()) {
+                for (int id: neighbours->second) {
+                    LayoutDomain &neighbour = get_domain(id);
+                    int n_start = cd == CalcDirection::X ? neighbour.top_left.y : neighbour.top_left.x;
+                    int n_end = cd == CalcDirection::X ? neighbour.bottom_right.y : neighbour.bottom_right.x;
+                    for (int i = max(start, n_start); i < min(end, n_end); i++) {
+                        occupied[i - start] = true;
+                    }
+                }
+            }
+            vector<pair<int, int>> ranges;
+            for (int i = start; i < end; i++) {
+                if (occupied[i - start]) {
+                    continue;
+                }
+                if (ranges.empty() || ranges.back().second != i) {
+                    ranges.push_back(make_pair(i, i + 1));
+                }
+                else {
+                    ranges.back().second = i + 1;
+                }
+            }
+            return ranges;
+        }
+
+        void SceneLayout::add_pml_domains(int number_of_cells) {
+            vector<Direction> directions{Direction::LEFT, Direction::TOP, Direction::RIGHT, Direction::BOTTOM};
+            vector<LayoutDomain> first_order_pmls;
+            vector<LayoutDomain> second_order_pmls;
+
+            unsigned long domain_count = domains.size();
+            for (unsigned long d = 0; d < domain_count; d++) {
+                //the vector is not changed until the PML domains are added, so the reference stays valid
+                LayoutDomain &domain = domains[d];
+                if (domain.is_pml) {
+                    continue;
+                }
+                for (unsigned long i = 0; i < directions.size(); i++) {
+                    Direction direction = directions.at(i);
+                    for (auto range: get_vacant_ranges(domain, direction)) {
+                        int pml_id = get_new_id();
+                        Point offset, size;
+                        //We only add secondary PML domains for primary PML domains that fully cover their air
+                        //domain. If primary PML domain does not, it's set to locally reacting.
+                        bool full_overlap = false;
+                        switch (direction) {
+                            case Direction::LEFT:
+                            case Direction::RIGHT:
+                                offset = Point(direction == Direction::LEFT ? -number_of_cells : domain.size.x,
+                                               range.first - domain.top_left.y);
+                                size = Point(number_of_cells, range.second - range.first);
+                                full_overlap = range.first == domain.top_left.y &&
+                                               range.second == domain.bottom_right.y;
+                                break;
+                            case Direction::TOP:
+                            case Direction::BOTTOM:
+                                offset = Point(range.first - domain.top_left.x,
+                                               direction == Direction::TOP ? -number_of_cells : domain.size.y);
+                                size = Point(range.second - range.first, number_of_cells);
+                                full_overlap = range.first == domain.top_left.x &&
+                                               range.second == domain.bottom_right.x;
+                                break;
+                        }
+                        LayoutDomain pml(pml_id, domain.top_left + offset, size, true, false, {domain.id});
+                        pml.side = direction;
+                        pml.local = !full_overlap;
+                        first_order_pmls.push_back(pml);
+
+                        if (domain.alpha[direction] > 0 and full_overlap) {
+                            // Find directions of the orthogonal calculation direction
+                            for (unsigned long second_dir_it: {(i + 1) % 4, (i + 3) % 4}) {
+                                Direction second_dir = directions.at(second_dir_it);
+                                Point sec_offset;
+                                switch (second_dir) {
+                                    case Direction::LEFT:
+                                        sec_offset = Point(-number_of_cells, 0);
+                                        break;
+                                    case Direction::RIGHT:
+                                        sec_offset = Point(size.x, 0);
+                                        break;
+                                    case Direction::TOP:
+                                        sec_offset = Point(0, -number_of_cells);
+                                        break;
+                                    case Direction::BOTTOM:
+                                        sec_offset = Point(0, size.y);
+                                        break;
+                                }
+                                LayoutDomain sec_pml(get_new_id(), domain.top_left + offset + sec_offset,
+                                                     Point(number_of_cells, number_of_cells), true, true, {pml_id});
+                                sec_pml.side = second_dir;
+                                second_order_pmls.push_back(sec_pml);
+                            }
+                        }
+                    }
+                }
+            }
+            for (LayoutDomain &pml: first_order_pmls) {
+                add_domain(pml);
+            }
+
+            //secondary PML domains with the same corners are merged if they are in the corner of the same domain
+            map<vector<int>, vector<LayoutDomain>> domains_by_cornerpoints;
+            for (LayoutDomain &sec_pml: second_order_pmls) {
+                LayoutDomain &parent = get_domain(sec_pml.pml_for.at(0));
+                if (!parent.neighbours[sec_pml.side].empty()) {
+                    continue;
+                }
+                vector<int> corner_points{sec_pml.top_left.x, sec_pml.top_left.y,
+                                          sec_pml.bottom_right.x, sec_pml.bottom_right.y};
+                domains_by_cornerpoints[corner_points].push_back(sec_pml);
+            }
+            vector<LayoutDomain> merged;
+            for (auto &entry: domains_by_cornerpoints) {
+                vector<LayoutDomain> &candidates = entry.second;
+                vector<bool> processed(candidates.size(), false);
+                for (unsigned long i = 0; i < candidates.size(); i++) {
+                    for (unsigned long j = i + 1; j < candidates.size(); j++) {
+                        if (processed[i] or processed[j]) {
+                            continue;
+                        }
+                        int grandparent_i = get_domain(candidates[i].pml_for.at(0)).pml_for.at(0);
+                        int grandparent_j = get_domain(candidates[j].pml_for.at(0)).pml_for.at(0);
+                        if (grandparent_i == grandparent_j) {
+                            processed[i] = processed[j] = true;
+                            for (int pml_for: candidates[j].pml_for) {
+                                candidates[i].pml_for.push_back(pml_for);
+                            }
+                            merged.push_back(candidates[i]);
+                        }
+                    }
+                }
+                for (unsigned long i = 0; i < candidates.size(); i++) {
+                    if (!processed[i]) {
+                        merged.push_back(candidates[i]);
+                    }
+                }
+            }
+            for (LayoutDomain &sec_pml: merged) {
+                add_domain(sec_pml);
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      The layout of the domains of a scene with only rectangles: which
+//      domains are neighbours and where the PML domains are created.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_LAYOUT_H
+#define OPENPSTD_LAYOUT_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "kernel_functions.h"
+#include "Geometry.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        /**
+         * The rectangle of a domain in the layout, without any fields
+         */
+        struct LayoutDomain {
+            int id;
+            Point top_left;
+            Point bottom_right;
+            Point size;
+            bool is_pml;
+            bool is_secondary_pml;
+            /// The ids of the domains this domain is a PML domain for
+            std::vector<int> pml_for;
+            /// The side of the first domain of pml_for along which this PML domain lies
+            Direction side = Direction::LEFT;
+            /// A PML domain that does not cover the complete side of its domain, it is locally reacting
+            bool local = false;
+            /// Absorption of the edges, secondary PML domains are only created along absorbing edges
+            std::map<Direction, float> alpha;
+            /// The ids of the neighbours in every direction, in the order they are added
+            std::map<Direction, std::vector<int>> neighbours;
+
+            LayoutDomain(int id, Point top_left, Point size, bool is_pml, bool is_secondary_pml,
+                         std::vector<int> pml_for);
+        };
+
+        /**
+         * The top left corner and the size of a domain of the configuration in grid cells. The world coordinates are
+         * truncated to the grid, the scene, the estimator and the metadata of the results use this discretization, so
+         * the frames that are written have the sizes of the metadata.
+         * @return the top left corner and the size
+         */
+        std::pair<Point, Point> discretize_domain(const DomainConf &domain, float grid_spacing);
+
+        /**
+         * The layout of the domains of a scene.
+         *
+         * The scene creates its domains and PML domains from the layout, and the estimator(see estimate_scene) uses
+         * the layout to estimate a scene without allocating the fields of the domains.
+         */
+        class SceneLayout {
+        private:
+            int number_of_domains = 0;
+
+        public:
+            /// The domains in the order they are added
+            std::vector<LayoutDomain> domains;
+
+            /**
+             * Returns a new domain ID integer
+             */
+            int get_new_id();
+
+            /**
+             * Returns the domain with the id
+             * @throws std::out_of_range if there is no domain with the id
+             */
+            LayoutDomain &get_domain(int id);
+
+            /**
+             * Adds a domain, it becomes the neighbour of every domain that it touches, except when a PML domain
+             * would touch a domain that it is not a PML domain for.
+             */
+            void add_domain(LayoutDomain domain);
+
+            /**
+             * The ranges along a side of a domain that have no neighbours, as [start, end) pairs
+             */
+            std::vector<std::pair<int, int>> get_vacant_ranges(const LayoutDomain &domain, Direction direction);
+
+            /**
+             * Adds a PML domain along every vacant range of the sides of the domains. A PML domain that covers a
+             * complete absorbing side gets secondary PML domains in the corners, the secondary PML domains in the
+             * same corner of a domain are merged.
+             * @param number_of_cells: thickness of the PML domains
+             */
+            void add_pml_domains(int number_of_cells);
+        };
+    }
+}
+
+#endif //OPENPSTD_LAYOUT_H
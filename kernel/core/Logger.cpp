@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Logger.h"
+#include <stdexcept>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+
+        /*
+         * The queue is a bounded multi-producer queue, every slot has a sequence number:
+         * - sequence == position: the slot is free for the producer of this position
+         * - sequence == position + 1: the message is ready for the background thread
+         * A producer claims a position with a compare-and-swap on the head, the background thread is the only
+         * consumer and releases the slot for the next round by adding the capacity to the sequence.
+         */
+        Logger::Logger(unsigned int capacity, ostream *sink) : head(0), written(0), dropped(0),
+                                                                 level((int) LogLevel::INFO), sink(sink),
+                                                                 running(true) {
+            this->capacity = 2;
+            while (this->capacity < capacity) {
+                this->capacity *= 2;
+            }
+            this->slots = unique_ptr<Slot[]>(new Slot[this->capacity]);
+            for (unsigned long long i = 0; i < this->capacity; i++) {
+                this->slots[i].sequence.store(i, memory_order_relaxed);
+            }
+            this->worker = thread(&Logger::write_messages, this);
+        }
+
+        Logger::~Logger() {
+            this->running.store(false);
+            this->wake.notify_one();
+            this->worker.join();
+        }
+
+        Logger &Logger::get_instance() {
+            static Logger instance;
+            return instance;
+        }
+
+        LogLevel Logger::get_level() const {
+            return (LogLevel) this->level.load();
+        }
+
+        void Logger::set_level(LogLevel level) {
+            this->level.store((int) level);
+        }
+
+        void Logger::set_sink(ostream *sink) {
+            this->flush();
+            lock_guard<mutex> lock(this->sink_mutex);
+            this->sink = sink;
+        }
+
+        bool Logger::log(LogLevel level, string message) {
+            if (!this->is_enabled(level)) {
+                return false;
+            }
+
+            unsigned long long position = this->head.load(memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &this->slots[position & (this->capacity - 1)];
+                unsigned long long sequence = slot->sequence.load(memory_order_acquire);
+                long long difference = (long long) sequence - (long long) position;
+                if (difference == 0) {
+                    if (this->head.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    //the slot of the previous round is not yet written, the buffer is full
+                    this->dropped.fetch_add(1, memory_order_relaxed);
+                    return false;
+                }
+                else {
+                    position = this->head.load(memory_order_relaxed);
+                }
+            }
+
+            slot->level = level;
+            slot->message = move(message);
+            slot->sequence.store(position + 1, memory_order_release);
+            this->wake.notify_one();
+            return true;
+        }
+
+        void Logger::write_messages() {
+            unsigned long long tail = 0;
+            while (true) {
+                Slot *slot = &this->slots[tail & (this->capacity - 1)];
+                if (slot->sequence.load(memory_order_acquire) == tail + 1) {
+                    lock_guard<mutex> lock(this->sink_mutex);
+                    do {
+                        *this->sink << get_level_name(slot->level) << ": " << slot->message << '\n';
+                        slot->message.clear();
+                        slot->sequence.store(tail + this->capacity, memory_order_release);
+                        tail++;
+                        this->written.store(tail, memory_order_release);
+                        slot = &this->slots[tail & (this->capacity - 1)];
+                    } while (slot->sequence.load(memory_order_acquire) == tail + 1);
+                    this->sink->flush();
+                }
+                else if (!this->running.load() && this->head.load() == tail) {
+                    break;
+                }
+                else {
+                    unique_lock<mutex> lock(this->wake_mutex);
+                    this->wake.wait_for(lock, chrono::milliseconds(10));
+                }
+            }
+        }
+
+        void Logger::flush() {
+            unsigned long long target = this->head.load(memory_order_acquire);
+            while (this->written.load(memory_order_acquire) < target) {
+                this->wake.notify_one();
+                this_thread::yield();
+            }
+            lock_guard<mutex> lock(this->sink_mutex);
+            this->sink->flush();
+        }
+
+        unsigned long long Logger::get_dropped() const {
+            return this->dropped.load();
+        }
+
+        const char *Logger::get_level_name(LogLevel level) {
+            switch (level) {
+                case LogLevel::TRACE:
+                    return "trace";
+                case LogLevel::DEBUG:
+                    return "debug";
+                case LogLevel::INFO:
+                    return "info";
+                case LogLevel::WARNING:
+                    return "warning";
+                case LogLevel::ERROR:
+                    return "error";
+                case LogLevel::OFF:
+                    return "off";
+            }
+            return "unknown";
+        }
+
+        LogLevel Logger::parse_level(const string &name) {
+            for (int i = (int) LogLevel::TRACE; i <= (int) LogLevel::OFF; i++) {
+                if (name == get_level_name((LogLevel) i)) {
+                    return (LogLevel) i;
+                }
+            }
+            throw invalid_argument("unknown log level: " + name);
+        }
+
+        ProgressThrottle::ProgressThrottle(double interval) : interval(interval), reported(false) {
+        }
+
+        bool ProgressThrottle::should_report(int frame, int frame_count) {
+            chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            if (this->reported && frame != frame_count - 1 && this->interval > 0 &&
+                chrono::duration<double>(now - this->last).count() < this->interval) {
+                return false;
+            }
+            this->reported = true;
+            this->last = now;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Levelled logging of the kernel. Messages are queued in a lock-free
+//      ring buffer and written by a background thread, so that the solver
+//      does not wait on console I/O.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_LOGGER_H
+#define OPENPSTD_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/**
+ * Messages below this level are removed at compile time, by default only the trace messages.
+ * 0 = trace, 1 = debug, 2 = info, 3 = warning, 4 = error
+ */
+#ifndef OPENPSTD_LOG_LEVEL
+#define OPENPSTD_LOG_LEVEL 1
+#endif
+
+/**
+ * Logs a message to the kernel logger, the message is only evaluated if the level is enabled
+ */
+#define OPENPSTD_LOG(level, message) \
+    do { \
+        if ((int) (level) >= OPENPSTD_LOG_LEVEL && \
+            OpenPSTD::Kernel::Logger::get_instance().is_enabled(level)) { \
+            OpenPSTD::Kernel::Logger::get_instance().log(level, message); \
+        } \
+    } while (0)
+
+namespace OpenPSTD {
+    namespace Kernel {
+        enum class LogLevel {
+            TRACE = 0, DEBUG, INFO, WARNING, ERROR, OFF
+        };
+
+        /**
+         * Writes the messages of all threads to a sink. Messages are dropped when the buffer is full, the logger
+         * never blocks the thread that logs.
+         */
+        class Logger {
+        private:
+            struct Slot {
+                /// Position in the queue this slot is ready for, see log() and write_messages()
+                std::atomic<unsigned long long> sequence;
+                LogLevel level;
+                std::string message;
+            };
+
+            std::unique_ptr<Slot[]> slots;
+            unsigned long long capacity;
+            std::atomic<unsigned long long> head;
+            /// Number of messages that are written to the sink, only changed by the background thread
+            std::atomic<unsigned long long> written;
+            std::atomic<unsigned long long> dropped;
+            std::atomic<int> level;
+
+            std::mutex sink_mutex;
+            std::ostream *sink;
+
+            std::mutex wake_mutex;
+            std::condition_variable wake;
+            std::atomic<bool> running;
+            std::thread worker;
+
+            void write_messages();
+
+        public:
+            /**
+             * Creates a logger and starts the background thread
+             * @param capacity: number of messages that can be queued, rounded up to a power of 2
+             * @param sink: stream the messages are written to
+             */
+            Logger(unsigned int capacity = 4096, std::ostream *sink = &std::cout);
+
+            /**
+             * Writes the queued messages and stops the background thread
+             */
+            ~Logger();
+
+            Logger(const Logger &) = delete;
+
+            Logger &operator=(const Logger &) = delete;
+
+            /**
+             * The logger of the kernel, the messages are written to std::cout
+             */
+            static Logger &get_instance();
+
+            bool is_enabled(LogLevel level) const {
+                return (int) level >= this->level.load(std::memory_order_relaxed);
+            }
+
+            LogLevel get_level() const;
+
+            /**
+             * Sets the minimal level of the messages that are logged, the default is INFO
+             */
+            void set_level(LogLevel level);
+
+            /**
+             * Writes the queued messages to the old sink and continues with the new sink
+             */
+            void set_sink(std::ostream *sink);
+
+            /**
+             * Queues a message, the message is not queued if its level is disabled
+             * @return false if the message is dropped
+             */
+            bool log(LogLevel level, std::string message);
+
+            /**
+             * Waits until all messages that are queued are written and flushes the sink
+             */
+            void flush();
+
+            /**
+             * Number of messages that are dropped because the buffer was full
+             */
+            unsigned long long get_dropped() const;
+
+            static const char *get_level_name(LogLevel level);
+
+            /**
+             * Parses the name of a level(trace, debug, info, warning, error or off)
+             * @throws std::invalid_argument if it is not the name of a level
+             */
+            static LogLevel parse_level(const std::string &name);
+        };
+
+        /**
+         * Formats a value with its stream operator, for the messages of the logger
+         */
+        template<typename T>
+        std::string to_log_string(const T &value) {
+            std::ostringstream ss;
+            ss << value;
+            return ss.str();
+        }
+
+        /**
+         * Limits the progress reports of a simulation to one per interval
+         */
+        class ProgressThrottle {
+        private:
+            double interval;
+            bool reported;
+            std::chrono::steady_clock::time_point last;
+
+        public:
+            /**
+             * @param interval: minimal number of seconds between two reports, 0 reports every frame
+             */
+            ProgressThrottle(double interval);
+
+            /**
+             * True if the progress has to be reported at this frame, the first and last frame are always reported
+             */
+            bool should_report(int frame, int frame_count);
+        };
+    }
+}
+
+#endif //OPENPSTD_LOGGER_H
@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Partitioner.h"
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+
+        /*
+         * The interfaces of the domains as a graph, the weight of an edge is the length of the interface
+         */
+        typedef vector<vector<pair<int, int>>> InterfaceGraph;
+
+        static InterfaceGraph get_interfaces(const vector<shared_ptr<Domain>> &domains) {
+            InterfaceGraph graph(domains.size());
+            for (unsigned long i = 0; i < domains.size(); i++) {
+                for (Direction direction: all_directions) {
+                    for (auto neighbour: domains[i]->get_neighbours_at(direction)) {
+                        auto position = find(domains.begin(), domains.end(), neighbour);
+                        if (position == domains.end()) {
+                            continue;
+                        }
+                        int length = (int) domains[i]->get_intersection_with(neighbour, direction).size();
+                        graph[i].push_back({(int) (position - domains.begin()), length});
+                    }
+                }
+            }
+            return graph;
+        }
+
+        /*
+         * Length of the interfaces of a domain with the domains of a rank
+         */
+        static int get_connection(const InterfaceGraph &graph, const vector<int> &ranks, int domain, int rank) {
+            int length = 0;
+            for (auto &edge: graph[domain]) {
+                if (ranks[edge.first] == rank) {
+                    length += edge.second;
+                }
+            }
+            return length;
+        }
+
+        int Partition::get_rank(shared_ptr<Domain> domain) const {
+            auto position = find(this->domains.begin(), this->domains.end(), domain);
+            if (position == this->domains.end()) {
+                throw out_of_range("The domain is not part of the partition");
+            }
+            return this->ranks[position - this->domains.begin()];
+        }
+
+        vector<long> Partition::get_loads() const {
+            vector<long> loads((unsigned long) this->size, 0);
+            for (unsigned long i = 0; i < this->domains.size(); i++) {
+                loads[this->ranks[i]] += (long) this->domains[i]->size.x * this->domains[i]->size.y;
+            }
+            return loads;
+        }
+
+        int Partition::get_interface_length() const {
+            InterfaceGraph graph = get_interfaces(this->domains);
+            int length = 0;
+            for (unsigned long i = 0; i < graph.size(); i++) {
+                for (auto &edge: graph[i]) {
+                    if (this->ranks[i] != this->ranks[edge.first]) {
+                        length += edge.second;
+                    }
+                }
+            }
+            //every interface is found from both sides
+            return length / 2;
+        }
+
+        shared_ptr<Partition> partition_domains(const vector<shared_ptr<Domain>> &domains, int size,
+                                                float imbalance) {
+            if (size < 1) {
+                throw runtime_error("A partition needs at least one rank");
+            }
+            auto partition = make_shared<Partition>();
+            partition->size = size;
+            partition->domains = domains;
+            sort(partition->domains.begin(), partition->domains.end(),
+                 [](const shared_ptr<Domain> &a, const shared_ptr<Domain> &b) {
+                     return make_tuple(a->top_left.x, a->top_left.y, a->size.x, a->size.y) <
+                            make_tuple(b->top_left.x, b->top_left.y, b->size.x, b->size.y);
+                 });
+
+            int count = (int) partition->domains.size();
+            InterfaceGraph graph = get_interfaces(partition->domains);
+            vector<long> cells((unsigned long) count);
+            long total = 0;
+            for (int i = 0; i < count; i++) {
+                cells[i] = (long) partition->domains[i]->size.x * partition->domains[i]->size.y;
+                total += cells[i];
+            }
+            double target = (double) total / size;
+
+            //grow every rank from the first free domain, the domain with the longest interface with the rank is added
+            vector<int> &ranks = partition->ranks;
+            ranks.assign((unsigned long) count, -1);
+            vector<long> loads((unsigned long) size, 0);
+            int free = count;
+            for (int rank = 0; rank < size && free > 0; rank++) {
+                while (free > 0 && (rank == size - 1 || loads[rank] < target)) {
+                    int best = -1, best_connection = -1;
+                    for (int i = 0; i < count; i++) {
+                        if (ranks[i] != -1) {
+                            continue;
+                        }
+                        int connection = get_connection(graph, ranks, i, rank);
+                        if (connection > best_connection) {
+                            best = i;
+                            best_connection = connection;
+                        }
+                    }
+                    //stop when the rank is closer to the target without the domain
+                    if (rank != size - 1 && loads[rank] > 0 &&
+                        loads[rank] + cells[best] - target > target - loads[rank]) {
+                        break;
+                    }
+                    ranks[best] = rank;
+                    loads[rank] += cells[best];
+                    free--;
+                }
+            }
+
+            //move domains to neighbouring ranks while the interfaces get shorter
+            long max_load = max((long) (target * (1 + imbalance)), *max_element(loads.begin(), loads.end()));
+            vector<int> domain_count((unsigned long) size, 0);
+            for (int rank: ranks) {
+                domain_count[rank]++;
+            }
+            bool improved = true;
+            for (int pass = 0; improved && pass < count; pass++) {
+                improved = false;
+                for (int i = 0; i < count; i++) {
+                    int own = ranks[i];
+                    if (domain_count[own] == 1) {
+                        continue;
+                    }
+                    int own_connection = get_connection(graph, ranks, i, own);
+                    int best = own, best_gain = 0;
+                    for (auto &edge: graph[i]) {
+                        int other = ranks[edge.first];
+                        if (other == own || loads[other] + cells[i] > max_load) {
+                            continue;
+                        }
+                        int gain = get_connection(graph, ranks, i, other) - own_connection;
+                        if (gain > best_gain || (gain == best_gain && gain > 0 && other < best)) {
+                            best = other;
+                            best_gain = gain;
+                        }
+                    }
+                    if (best != own) {
+                        ranks[i] = best;
+                        loads[own] -= cells[i];
+                        loads[best] += cells[i];
+                        domain_count[own]--;
+                        domain_count[best]++;
+                        improved = true;
+                    }
+                }
+            }
+            return partition;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Assigns the domains of a scene to the processes of a distributed
+//      simulation, with a balanced number of cells per process and a
+//      short total length of the interfaces between processes.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_PARTITIONER_H
+#define OPENPSTD_PARTITIONER_H
+
+#include <memory>
+#include <vector>
+#include "Domain.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        /**
+         * The assignment of the domains of a scene to ranks.
+         *
+         * The ids and the order of the secondary PML domains differ between processes that create the same scene,
+         * so the domains are ordered on their location. This order is the same in every process.
+         */
+        class Partition {
+        public:
+            /// Domains of the scene, ordered on their location
+            std::vector<std::shared_ptr<Domain>> domains;
+            /// Rank of every domain in domains
+            std::vector<int> ranks;
+            /// Number of ranks
+            int size;
+
+            /**
+             * The rank a domain is assigned to
+             * @throws std::out_of_range if the domain is not part of the partition
+             */
+            int get_rank(std::shared_ptr<Domain> domain) const;
+
+            /**
+             * Number of cells that are assigned to every rank
+             */
+            std::vector<long> get_loads() const;
+
+            /**
+             * Total length in grid cells of the interfaces between domains that are assigned to different ranks
+             */
+            int get_interface_length() const;
+        };
+
+        /**
+         * Assigns the domains to the ranks. The domains are grown into connected groups of about the same number of
+         * cells, after which domains are moved to neighbouring ranks as long as this shortens the interfaces and the
+         * largest group does not grow beyond the imbalance. The result only depends on the location of the domains.
+         * @param domains: all the domains of the scene, including the PML domains
+         * @param size: number of ranks, a rank can be left without domains if there are less domains than ranks
+         * @param imbalance: allowed fraction of cells that a rank has more than the average
+         * @throws std::runtime_error if the number of ranks is smaller than 1
+         */
+        std::shared_ptr<Partition> partition_domains(const std::vector<std::shared_ptr<Domain>> &domains, int size,
+                                                     float imbalance = 0.1f);
+    }
+}
+
+#endif //OPENPSTD_PARTITIONER_H
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Profiler.h"
+#include "Domain.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std::chrono;
+
+        Profiler::Profiler(const std::vector<std::shared_ptr<Domain>> &domains) : Profiler(0) {
+            for (auto domain: domains) {
+                if (domain->id >= (int) this->profile.DomainSeconds.size()) {
+                    this->profile.DomainSeconds.resize(domain->id + 1, std::vector<double>(PROFILEPHASE_COUNT, 0));
+                }
+                if (domain->is_pml) {
+                    this->profile.PMLDomains.push_back(domain->id);
+                }
+            }
+        }
+
+        Profiler::Profiler(int domain_count) {
+            this->profile.DomainSeconds.resize(domain_count, std::vector<double>(PROFILEPHASE_COUNT, 0));
+            this->start = steady_clock::now();
+        }
+
+        void Profiler::start_frame() {
+            this->profile.FrameSeconds.push_back(std::vector<double>(PROFILEPHASE_COUNT, 0));
+        }
+
+        void Profiler::add(PROFILEPHASE phase, int domain, double seconds) {
+            if (domain >= (int) this->profile.DomainSeconds.size()) {
+                this->profile.DomainSeconds.resize(domain + 1, std::vector<double>(PROFILEPHASE_COUNT, 0));
+            }
+            this->profile.DomainSeconds[domain][(int) phase] += seconds;
+            if (!this->profile.FrameSeconds.empty()) {
+                this->profile.FrameSeconds.back()[(int) phase] += seconds;
+            }
+        }
+
+        KernelProfile Profiler::get_profile() {
+            this->profile.TotalSeconds = duration<double>(steady_clock::now() - this->start).count();
+            return this->profile;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Collects the time that is spent in the phases of the calculation,
+//      the timers do nothing when profiling is disabled.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_PROFILER_H
+#define OPENPSTD_PROFILER_H
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "../KernelInterface.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+        class Domain;
+
+        /**
+         * Aggregates the timings of the phases per domain and per frame
+         */
+        class Profiler {
+        private:
+            KernelProfile profile;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            /**
+             * Creates a profiler for the domains of a scene, the timer of the complete run starts here
+             */
+            Profiler(const std::vector<std::shared_ptr<Domain>> &domains);
+
+            /**
+             * Creates a profiler for a number of domains without PML domains
+             */
+            Profiler(int domain_count);
+
+            /**
+             * Starts a new frame, the following timings are added to this frame
+             */
+            void start_frame();
+
+            /**
+             * Adds time to a phase of a domain and of the current frame
+             */
+            void add(PROFILEPHASE phase, int domain, double seconds);
+
+            /**
+             * The profile of the run so far
+             */
+            KernelProfile get_profile();
+        };
+
+        /**
+         * Times a phase from the construction until the destruction of the timer, does nothing if the profiler is
+         * a nullptr.
+         */
+        class ProfileTimer {
+        private:
+            Profiler *profiler;
+            PROFILEPHASE phase;
+            int domain;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            ProfileTimer(Profiler *profiler, PROFILEPHASE phase, int domain) : profiler(profiler), phase(phase),
+                                                                                domain(domain) {
+                if (profiler != nullptr) {
+                    start = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~ProfileTimer() {
+                stop();
+            }
+
+            /**
+             * Stops timing the current phase and starts timing the next phase
+             */
+            void next(PROFILEPHASE next_phase) {
+                if (profiler != nullptr) {
+                    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                    profiler->add(phase, domain, std::chrono::duration<double>(now - start).count());
+                    start = now;
+                }
+                phase = next_phase;
+            }
+
+            /**
+             * Stops timing, the destructor does not add the time again
+             */
+            void stop() {
+                if (profiler != nullptr) {
+                    profiler->add(phase, domain,
+                                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                    profiler = nullptr;
+                }
+            }
+        };
+    }
+}
+
+#endif //OPENPSTD_PROFILER_H
@@ -79,7 +79,8 @@ namespace OpenPSTD {
 
         float Receiver::compute_with_nn() {
             Point rel_location = grid_location - container_domain->top_left;
-            return container_domain->current_values.p0(rel_location.x, rel_location.y);
+            //the rows of the pressure are the y coordinates
+            return container_domain->current_values.p0(rel_location.y, rel_location.x);
         }
 
         float Receiver::compute_with_si() {
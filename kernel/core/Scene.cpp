@@ -35,219 +35,65 @@ namespace OpenPSTD {
             this->top_left = Point(0, 0);
             this->bottom_right = Point(0, 0);
             this->size = Point(0, 0);
-            number_of_domains = 0;
         }
 
         void Scene::add_pml_domains() {
-            int number_of_cells = settings->GetPMLCells();
-            vector<Direction> directions{Direction::LEFT, Direction::TOP, Direction::RIGHT, Direction::BOTTOM};
-            vector<string> dir_strings{"left", "top", "right", "bottom"};
-
-            vector<shared_ptr<Domain>> first_order_pmls;
-            map<shared_ptr<Domain>, Direction> second_order_pml_map;
-
-            for (shared_ptr<Domain> domain:domain_list) {
-                if (domain->is_pml) {
-                    continue;
+            unsigned long first_pml = layout.domains.size();
+            layout.add_pml_domains(settings->GetPMLCells());
+            for (unsigned long i = first_pml; i < layout.domains.size(); i++) {
+                //the layout is not changed anymore, so the reference stays valid
+                const LayoutDomain &rectangle = layout.domains[i];
+                shared_ptr<Domain> parent = get_domain(rectangle.pml_for.at(0));
+                float pml_alpha;
+                if (rectangle.is_secondary_pml) {
+                    float other_pml_alpha = parent->pml_for_domain_list.at(0)->edge_param_map[rectangle.side].alpha;
+                    /* TK: An attempt to prevent refraction on the secondary PML corner.
+                     * This is especially effective in the case of a fully absorbent domain
+                     * connecting to a fully reflective edge.
+                     * For arbitrary combinations, this is an approximation
+                     */
+                    pml_alpha = min(max(EPSILON, other_pml_alpha), max(EPSILON, parent->alpha));
                 }
-                for (unsigned long i = 0; i < directions.size(); i++) {
-                    Direction direction = directions.at(i);
-                    Eigen::ArrayXXi vacant_range = domain->get_vacant_range(direction); // todo: Test vacant range.
-                    for (unsigned long j = 0; j < vacant_range.rows(); j++) {
-                        int pml_id = get_new_id();
-                        float alpha = domain->edge_param_map[direction].alpha;
-                        float pml_alpha = max(alpha, EPSILON);
-                        int x_offset, y_offset, z_offset;
-                        int x_size, y_size, z_size;
-                        switch (direction) {
-                            case Direction::LEFT:
-                                x_offset = -number_of_cells;
-                                y_offset = vacant_range(j, 0) - domain->top_left.y;
-                                x_size = number_of_cells;
-                                y_size = vacant_range(j, 1) - vacant_range(j, 0);
-                                break;
-                            case Direction::RIGHT:
-                                x_offset = domain->size.x;
-                                y_offset = vacant_range(j, 0) - domain->top_left.y;
-                                x_size = number_of_cells;
-                                y_size = vacant_range(j, 1) - vacant_range(j, 0);
-                                break;
-                            case Direction::TOP:
-                                x_offset = vacant_range(j, 0) - domain->top_left.x;
-                                y_offset = -number_of_cells;
-                                x_size = vacant_range(j, 1) - vacant_range(j, 0);
-                                y_size = number_of_cells;
-                                break;
-                            case Direction::BOTTOM:
-                                x_offset = vacant_range(j, 0) - domain->top_left.x;
-                                y_offset = domain->size.y;
-                                x_size = vacant_range(j, 1) - vacant_range(j, 0);
-                                y_size = number_of_cells;
-                                break;
-                        }
-                        Point pml_offset(x_offset, y_offset);
-                        Point pml_top_left = pml_offset + domain->top_left;
-                        Point pml_size(x_size, y_size);
-                        Point pml_size_pointer = pml_size;
-                        //We only add secondary PML domains for primary PML domains that fully cover their air domain.
-                        //If primary PML domain does not, it's set to locally reacting.
-                        CalcDirection calcDirection = direction_to_calc_direction(direction);
-                        bool full_overlap;
-                        switch (calcDirection) {
-                            case CalcDirection::X:
-                                full_overlap = (vacant_range(j, 0) == domain->top_left.y &&
-                                                vacant_range(j, 1) == domain->bottom_right.y);
-                                break;
-                            case CalcDirection::Y:
-                                full_overlap = (vacant_range(j, 0) == domain->top_left.x &&
-                                                vacant_range(j, 1) == domain->bottom_right.x);
-                                break;
-                        }
-
-                        shared_ptr<Domain> pml_domain_ptr = make_shared<Domain>(
-                                settings, pml_id, pml_alpha, pml_top_left, pml_size_pointer, true,
-                                domain->wnd, default_edge_parameters, domain);
-                        //cout << *pml_domain_ptr << endl;
-                        first_order_pmls.push_back(pml_domain_ptr);
-                        if (!full_overlap) {
-                            pml_domain_ptr->local = true;
-                        }
-                        if (alpha > 0 and full_overlap) {
-                            vector<unsigned long> second_dir_its;
-                            // Find directions of the orthogonal calculation direction
-                            unsigned long dir_1 = (i + 1) % 4;
-                            unsigned long dir_2 = (i + 3) % 4;
-                            second_dir_its.push_back(dir_1);
-                            second_dir_its.push_back(dir_2);
-                            for (unsigned long second_dir_it: second_dir_its) {
-                                Direction second_dir = directions.at(second_dir_it);
-                                int second_pml_id = get_new_id();
-                                float other_pml_alpha = domain->edge_param_map[second_dir].alpha;
-                                /* TK: An attempt to prevent refraction on the secondary PML corner.
-                                 * This is especially effective in the case of a fully absorbent domain
-                                 * connecting to a fully reflective edge.
-                                 * For arbitrary combinations, this is an approximation
-                                 */
-                                float second_pml_alpha = min(max(EPSILON, other_pml_alpha),
-                                                             max(EPSILON, pml_alpha));
-                                //Todo: This expression can be shortened.
-                                int sec_x_offset, sec_y_offset, sec_z_offset;
-
-                                switch (second_dir) {
-                                    case Direction::LEFT:
-                                        sec_x_offset = -number_of_cells;
-                                        sec_y_offset = 0;
-                                        break;
-                                    case Direction::RIGHT:
-                                        sec_x_offset = pml_domain_ptr->size.x;
-                                        sec_y_offset = 0;
-                                        break;
-                                    case Direction::TOP:
-                                        sec_x_offset = 0;
-                                        sec_y_offset = -number_of_cells;
-                                        break;
-                                    case Direction::BOTTOM:
-                                        sec_x_offset = 0;
-                                        sec_y_offset = pml_domain_ptr->size.y;
-                                        break;
-                                }
-                                Point sec_pml_offset(sec_x_offset, sec_y_offset);
-                                Point sec_pml_top_left = domain->top_left + pml_offset + sec_pml_offset;
-                                Point sec_pml_size(number_of_cells, number_of_cells);
-                                shared_ptr<Domain> sec_pml_domain = make_shared<Domain>(settings, second_pml_id, second_pml_alpha, sec_pml_top_left,
-                                                   sec_pml_size, true, domain->wnd, default_edge_parameters, pml_domain_ptr);
-                                second_order_pml_map[sec_pml_domain] = second_dir;
-                                //cout << *sec_pml_domain << endl;
-                            }
-                        }
-                    }
+                else {
+                    pml_alpha = max(parent->edge_param_map[rectangle.side].alpha, EPSILON);
                 }
-            }
-            for (shared_ptr<Domain> domain:first_order_pmls) {
-                add_domain(domain);
-            }
-
-            //Collect the domains with the same top and size.
-            map<vector<int>, vector<shared_ptr<Domain>>> domains_by_cornerpoints;
-
-            for (auto &entry: second_order_pml_map) {
-                shared_ptr<Domain> parent_domain = entry.first->pml_for_domain_list.at(0);
-                Direction second_dir = entry.second;
-                if (!parent_domain->get_neighbours_at(second_dir).empty()) {
-                    continue;
+                shared_ptr<Domain> pml_domain = make_shared<Domain>(
+                        settings, rectangle.id, pml_alpha, rectangle.top_left, rectangle.size, true, parent->wnd,
+                        default_edge_parameters, parent);
+                //merged secondary PML domains are in the corner of several primary PML domains
+                for (unsigned long j = 1; j < rectangle.pml_for.size(); j++) {
+                    pml_domain->pml_for_domain_list.push_back(get_domain(rectangle.pml_for.at(j)));
                 }
-                auto corner_points = get_corner_points(entry.first);
-                domains_by_cornerpoints[corner_points].push_back(entry.first);
-
+                pml_domain->local = rectangle.local;
+                link_domain(pml_domain, rectangle);
             }
-            vector<shared_ptr<Domain>> second_order_pml_list;
-            for (auto &entry: domains_by_cornerpoints) {
-                if (entry.second.size() == 1) {
-                    for (auto sec_pml_domain:entry.second) {
-                        second_order_pml_list.push_back(sec_pml_domain);
-                    }
-                    continue;
-                }
-                vector<shared_ptr<Domain>> processed_domains;
-                for (unsigned long i = 0; i < entry.second.size(); i++) {
-                    for (unsigned long j = i + 1; j < entry.second.size(); j++) {
-                        shared_ptr<Domain> domain_i = entry.second.at(i);
-                        shared_ptr<Domain> domain_j = entry.second.at(j);
-                        bool processed_i =
-                                find(processed_domains.begin(), processed_domains.end(), domain_i) !=
-                                processed_domains.end();
-                        bool processed_j =
-                                find(processed_domains.begin(), processed_domains.end(), domain_j) !=
-                                processed_domains.end();
-                        if (processed_i or processed_j) {
-                            continue;
-                        }
-                        if (should_merge_domains(domain_i, domain_j)) {
-                            processed_domains.push_back(domain_i);
-                            processed_domains.push_back(domain_j);
-                            for (auto pml_for_domain: domain_j->pml_for_domain_list) {
-                                domain_i->pml_for_domain_list.push_back(pml_for_domain);
-                            }
-                            second_order_pml_list.push_back(domain_i);
-                        }
-                    }
-                }
-                for (unsigned long i = 0; i < entry.second.size(); i++) {
-                    if (find(processed_domains.begin(), processed_domains.end(), entry.second.at(i)) ==
-                        processed_domains.end()) {
-                        second_order_pml_list.push_back(entry.second.at(i));
-                    }
-                }
-            }
-            for (auto sec_order_pml_domain: second_order_pml_list) {
-                add_domain(sec_order_pml_domain);
-            }
-        }
-
-
-        vector<int> Scene::get_corner_points(shared_ptr<Domain> domain) {
-            vector<int> corner_points;
-            corner_points.push_back(domain->top_left.x);
-            corner_points.push_back(domain->top_left.y);
-            corner_points.push_back(domain->bottom_right.x);
-            corner_points.push_back(domain->bottom_right.y);
-            return corner_points;
         }
 
-
-        bool Scene::should_merge_domains(shared_ptr<Domain> domain1, shared_ptr<Domain> domain2) {
-            shared_ptr<Domain> parent_domain1 = get_singular_parent_domain(get_singular_parent_domain(domain1));
-            shared_ptr<Domain> parent_domain2 = get_singular_parent_domain(get_singular_parent_domain(domain2));
-            return ((parent_domain1 != nullptr) and (parent_domain1->id == parent_domain2->id));
+        shared_ptr<Domain> Scene::get_domain(int id) {
+            for (auto domain: domain_list) {
+                if (domain->id == id) {
+                    return domain;
+                }
+            }
+            return nullptr;
         }
 
-        shared_ptr<Domain> Scene::get_singular_parent_domain(shared_ptr<Domain> domain) {
-            if (domain != nullptr) {
-                if (domain->is_pml && domain->pml_for_domain_list.size() == 1) {
-                    return domain->pml_for_domain_list.at(0);
+        void Scene::link_domain(shared_ptr<Domain> domain, const LayoutDomain &rectangle) {
+            //the neighbours that are not created yet are linked when they are added
+            for (auto &entry: rectangle.neighbours) {
+                for (int id: entry.second) {
+                    shared_ptr<Domain> other_domain = get_domain(id);
+                    if (!other_domain) {
+                        continue;
+                    }
+                    shared_ptr<Boundary> boundary = make_shared<Boundary>(
+                            domain, other_domain, direction_to_calc_direction(entry.first));
+                    boundary_list.push_back(boundary);
+                    domain->add_neighbour_at(other_domain, entry.first);
+                    other_domain->add_neighbour_at(domain, get_opposite(entry.first));
                 }
             }
-            return nullptr;
+            domain_list.push_back(domain);
         }
 
 
@@ -303,80 +149,17 @@ namespace OpenPSTD {
                 size = Point(bottom_right.x - top_left.x, bottom_right.y - top_left.y);
                 // Todo: Topleft, bottom right and size are never read from
             }
-            for (unsigned long i = 0; i < domain_list.size(); i++) {
-                shared_ptr<Domain> other_domain = domain_list.at(i);
-                if (domain->is_secondary_pml && other_domain->is_secondary_pml) {
-                    // Cannot interact, since no secondary PML domains are adjacent
-                    continue;
-                }
-                else if (domain->is_secondary_pml && !other_domain->is_pml ||
-                         other_domain->is_secondary_pml && !domain->is_pml) {
-                    // Cannot interact, since a regular domain does not touch a secondary PML domain
-                    continue;
-                }
-                if (domain->is_pml && other_domain->is_pml) {
-                    bool pml_for_domain = other_domain->is_pml_for(domain);
-                    bool pml_for_other_domain = domain->is_pml_for(other_domain);
-                    if ((domain->is_secondary_pml && pml_for_other_domain) ||
-                        (other_domain->is_secondary_pml && pml_for_domain)) {
-                        // Important case: Domain is pml for second domain. Pass
-                    }
-                    else if (other_domain->pml_for_domain_list.size() != 1 || domain->pml_for_domain_list.size() != 1) {
-                        // One is PML for multiple domains. Continue? Todo: check algorithm
-                        continue;
-                    }
-                    else if (!other_domain->pml_for_domain_list.at(0)->is_neighbour_of(
-                            domain->pml_for_domain_list.at(0))) {
-                        continue;
-                    }
-                    else if (!domain->pml_for_domain_list.at(0)->is_neighbour_of(
-                            other_domain->pml_for_domain_list.at(0))) {
-                        //Same
-                        continue;
-                    }
-                    if (domain->is_secondary_pml != other_domain->is_secondary_pml) {
-                        //
-                        //continue; //TODO: Something is missing here
-                    }
-                }
-                CalcDirection bt;
-                Direction orientation;
-                vector<int> intersection;
-                bool is_neighbour = true;
-                if (domain->bottom_right.x == other_domain->top_left.x) {
-                    orientation = Direction::RIGHT;
-                    bt = CalcDirection::X;
-                }
-                else if (domain->top_left.x == other_domain->bottom_right.x) {
-                    orientation = Direction::LEFT;
-                    bt = CalcDirection::X;
-                }
-                else if (domain->bottom_right.y == other_domain->top_left.y) {
-                    orientation = Direction::BOTTOM;
-                    bt = CalcDirection::Y;
-                }
-                else if (domain->top_left.y == other_domain->bottom_right.y) {
-                    orientation = Direction::TOP;
-                    bt = CalcDirection::Y;
-                }
-                else {
-                    is_neighbour = false;
-                }
-                bool other_domain_pml_for_different_domain =
-                        other_domain->is_pml && !domain->is_pml && !other_domain->is_pml_for(domain);
-                bool domain_pml_for_different_domain =
-                        domain->is_pml && !other_domain->is_pml && !domain->is_pml_for(other_domain);
-                if (is_neighbour && !other_domain_pml_for_different_domain && !domain_pml_for_different_domain) {
-                    intersection = domain->get_intersection_with(other_domain, orientation);
-                    if (intersection.size()) {
-                        shared_ptr<Boundary> boundary = make_shared<Boundary>(domain, other_domain, bt);
-                        boundary_list.push_back(boundary);
-                        domain->add_neighbour_at(other_domain, orientation);
-                        other_domain->add_neighbour_at(domain, get_opposite(orientation));
-                    }
-                }
+            vector<int> pml_for;
+            for (auto pml_for_domain: domain->pml_for_domain_list) {
+                pml_for.push_back(pml_for_domain->id);
             }
-            domain_list.push_back(domain);
+            LayoutDomain rectangle(domain->id, domain->top_left, domain->size, domain->is_pml,
+                                   domain->is_secondary_pml, pml_for);
+            for (Direction direction: all_directions) {
+                rectangle.alpha[direction] = domain->edge_param_map[direction].alpha;
+            }
+            layout.add_domain(rectangle);
+            link_domain(domain, layout.domains.back());
         }
 
         ostream &operator<<(ostream &str, Scene const &v) {
@@ -386,8 +169,84 @@ namespace OpenPSTD {
         }
 
         int Scene::get_new_id() {
-            number_of_domains++;
-            return number_of_domains - 1;
+            return layout.get_new_id();
+        }
+
+        shared_ptr<Scene> Scene::clone() const {
+            shared_ptr<Scene> copy = make_shared<Scene>(*this);
+            map<Domain *, shared_ptr<Domain>> copies;
+            for (auto &domain: copy->domain_list) {
+                shared_ptr<Domain> domain_copy = make_shared<Domain>(*domain);
+                copies[domain.get()] = domain_copy;
+                domain = domain_copy;
+            }
+            for (auto domain: copy->domain_list) {
+                domain->replace_domains(copies);
+            }
+            for (auto &boundary: copy->boundary_list) {
+                boundary = make_shared<Boundary>(copies.at(boundary->domain1.get()), copies.at(boundary->domain2.get()),
+                                                 boundary->type);
+            }
+            for (auto &receiver: copy->receiver_list) {
+                shared_ptr<Receiver> receiver_copy = make_shared<Receiver>(*receiver);
+                receiver_copy->container_domain = copies.at(receiver->container_domain.get());
+                receiver = receiver_copy;
+            }
+            return copy;
+        }
+
+        void Scene::reset() {
+            for (auto domain: domain_list) {
+                domain->clear_fields();
+                domain->clear_matrices();
+            }
+            speaker_list.clear();
+            receiver_list.clear();
+        }
+
+        Direction Scene::get_side_of(shared_ptr<Domain> domain, shared_ptr<Domain> neighbour) {
+            if (neighbour->bottom_right.x == domain->top_left.x) {
+                return Direction::LEFT;
+            } else if (neighbour->top_left.x == domain->bottom_right.x) {
+                return Direction::RIGHT;
+            } else if (neighbour->bottom_right.y == domain->top_left.y) {
+                return Direction::TOP;
+            } else {
+                return Direction::BOTTOM;
+            }
+        }
+
+        void Scene::set_edge_parameters(shared_ptr<Domain> domain, map<Direction, EdgeParameters> edge_param_map) {
+            //the same rules for the alpha as add_pml_domains
+            for (auto pml_domain: domain_list) {
+                if (!pml_domain->is_pml || pml_domain->is_secondary_pml ||
+                    pml_domain->pml_for_domain_list.at(0) != domain) {
+                    continue;
+                }
+                Direction direction = get_side_of(domain, pml_domain);
+                float alpha = edge_param_map[direction].alpha;
+                if ((alpha > 0) != (domain->edge_param_map[direction].alpha > 0)) {
+                    throw runtime_error("The edge of domain " + to_string(domain->id) + " can not change between "
+                            "reflecting and absorbing without recreating the PML domains");
+                }
+                pml_domain->set_alpha(max(alpha, EPSILON));
+
+                for (auto sec_pml_domain: domain_list) {
+                    if (!sec_pml_domain->is_secondary_pml || sec_pml_domain->pml_for_domain_list.at(0) != pml_domain) {
+                        continue;
+                    }
+                    Direction second_dir = get_side_of(pml_domain, sec_pml_domain);
+                    float other_pml_alpha = edge_param_map[second_dir].alpha;
+                    sec_pml_domain->set_alpha(min(max(EPSILON, other_pml_alpha), max(EPSILON, pml_domain->alpha)));
+                }
+            }
+            domain->edge_param_map = edge_param_map;
+            //the update directions of the PML domains depend on the locally reacting edges of their neighbours
+            for (auto other_domain: domain_list) {
+                if (other_domain->is_pml) {
+                    other_domain->post_initialization();
+                }
+            }
         }
     }
 }
@@ -42,6 +42,7 @@
 #include "Speaker.h"
 #include "Receiver.h"
 #include "Boundary.h"
+#include "Layout.h"
 #include "../KernelInterface.h"
 
 namespace OpenPSTD {
@@ -71,7 +72,8 @@ namespace OpenPSTD {
         private:
             /// Set with default parameters for domain separators
             std::map<Direction, EdgeParameters> default_edge_parameters; // Uninitialized
-            int number_of_domains;
+            /// Rectangles of the domains, decides which domains are neighbours and where the PML domains are
+            SceneLayout layout;
         public:
 
             /**
@@ -117,6 +119,7 @@ namespace OpenPSTD {
             /**
              * Add the necessary perfectly matched layer domain to the current scene,
              * checks which layers belong to which domains, and checks which layers can be merged.
+             * @see SceneLayout::add_pml_domains
              */
             void add_pml_domains();
 
@@ -130,26 +133,44 @@ namespace OpenPSTD {
             */
             int get_new_id();
 
-        private:
+            /**
+             * Copies the scene with new domains, boundaries and receivers, so that a simulation of the copy does not
+             * change this scene. The settings, the wisdom cache and the speakers are shared with the copy.
+             */
+            std::shared_ptr<Scene> clone() const;
+
+            /**
+             * Clears the fields of all domains and removes the speakers and receivers, so that the scene can be
+             * reused for a simulation with other speakers and receivers.
+             */
+            void reset();
 
             /**
-             * Helper function for add_pml_domains.
-             * Collects the topleft and bottom right points of a domain.
+             * Changes the edge parameters of a (non PML) domain and the alpha of the PML domains along its edges.
+             * The PML domains are not recreated, so an edge can not change between reflecting(alpha 0) and
+             * absorbing when the PML domains depend on it.
+             * @throws std::runtime_error if the changed edge needs other PML domains
              */
-            std::vector<int> get_corner_points(std::shared_ptr<Domain> domain);
+            void set_edge_parameters(std::shared_ptr<Domain> domain, std::map<Direction, EdgeParameters> edge_param_map);
+
+        private:
 
             /**
-             * Helper function for add_pml_domains
-             * Checks if two pml domains can (and should) be merged.
+             * The domain with the id, nullptr if it is not added yet
              */
+            std::shared_ptr<Domain> get_domain(int id);
 
-            bool should_merge_domains(std::shared_ptr<Domain> domain1, std::shared_ptr<Domain> domain2);
+            /**
+             * Helper function for add_domain and add_pml_domains.
+             * Links the domain with the neighbours of its rectangle that are already added and adds it to the list.
+             */
+            void link_domain(std::shared_ptr<Domain> domain, const LayoutDomain &rectangle);
 
             /**
-             * Helper function for add_pml_domains
-             * Finds the common parent of two pml domains.
+             * Helper function for set_edge_parameters.
+             * The side of a domain that touches a neighbouring domain.
              */
-            std::shared_ptr<Domain> get_singular_parent_domain(std::shared_ptr<Domain> domain);
+            Direction get_side_of(std::shared_ptr<Domain> domain, std::shared_ptr<Domain> neighbour);
         };
 
         std::ostream &operator<<(std::ostream &str, Scene const &v);
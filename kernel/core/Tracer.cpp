@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Tracer.h"
+#include <algorithm>
+#include <atomic>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        namespace {
+            std::atomic<unsigned long long> next_tracer_id(1);
+
+            /**
+             * The buffer of the last used tracer of a thread, so that adding an event does not need a lock
+             */
+            struct ThreadCache {
+                unsigned long long tracer_id = 0;
+                void *buffer = nullptr;
+            };
+
+            thread_local ThreadCache thread_cache;
+        }
+
+        Tracer::Tracer(unsigned int buffer_size) : buffer_size(std::max(1u, buffer_size)),
+                                                   tracer_id(next_tracer_id++),
+                                                   start(std::chrono::steady_clock::now()) {
+        }
+
+        Tracer::ThreadBuffer *Tracer::get_buffer() {
+            if (thread_cache.tracer_id == this->tracer_id) {
+                return (ThreadBuffer *) thread_cache.buffer;
+            }
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            std::unique_ptr<ThreadBuffer> &buffer = this->buffers[std::this_thread::get_id()];
+            if (!buffer) {
+                buffer = std::unique_ptr<ThreadBuffer>(new ThreadBuffer());
+                buffer->thread = (int) this->buffers.size() - 1;
+                buffer->events.reserve(std::min(this->buffer_size, 4096u));
+            }
+            thread_cache.tracer_id = this->tracer_id;
+            thread_cache.buffer = buffer.get();
+            return buffer.get();
+        }
+
+        void Tracer::add(TraceEvent event) {
+            ThreadBuffer *buffer = this->get_buffer();
+            event.Thread = buffer->thread;
+            if (buffer->events.size() < this->buffer_size) {
+                buffer->events.push_back(event);
+            }
+            else {
+                //the buffer is full, overwrite the oldest event
+                buffer->events[buffer->next] = event;
+                buffer->next = (buffer->next + 1) % this->buffer_size;
+                buffer->dropped++;
+            }
+        }
+
+        KernelTrace Tracer::get_trace() {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            KernelTrace result;
+            result.ThreadCount = (int) this->buffers.size();
+            for (auto &entry: this->buffers) {
+                ThreadBuffer *buffer = entry.second.get();
+                result.Events.insert(result.Events.end(), buffer->events.begin(), buffer->events.end());
+                result.DroppedEvents += buffer->dropped;
+            }
+            std::stable_sort(result.Events.begin(), result.Events.end(), [](const TraceEvent &a, const TraceEvent &b) {
+                return a.Start < b.Start;
+            });
+            return result;
+        }
+    }
+}
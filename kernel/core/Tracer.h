@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Records the tasks of the solver in a ring buffer per thread, so that
+//      the timeline of a run can be inspected in a trace viewer.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_TRACER_H
+#define OPENPSTD_TRACER_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../KernelInterface.h"
+
+namespace OpenPSTD {
+    namespace Kernel {
+
+        /**
+         * Collects the trace events of all threads. Every thread writes to its own ring buffer, only registering a new
+         * thread takes a lock.
+         */
+        class Tracer {
+        private:
+            /**
+             * The last events of a single thread
+             */
+            struct ThreadBuffer {
+                int thread;
+                std::vector<TraceEvent> events;
+                /// Position of the next event when the buffer is full
+                unsigned long next = 0;
+                unsigned long long dropped = 0;
+            };
+
+            unsigned int buffer_size;
+            /// Unique for every tracer, used to find the buffer of the tracer in the cache of a thread
+            unsigned long long tracer_id;
+            std::chrono::steady_clock::time_point start;
+            std::mutex mutex;
+            std::map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers;
+
+            ThreadBuffer *get_buffer();
+
+        public:
+            /**
+             * Creates a tracer, the time of the events is relative to the creation of the tracer
+             * @param buffer_size: number of events that are kept per thread, older events are overwritten
+             */
+            Tracer(unsigned int buffer_size);
+
+            /**
+             * Microseconds since the creation of the tracer
+             */
+            double now() const {
+                return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            /**
+             * Adds an event to the buffer of the current thread
+             */
+            void add(TraceEvent event);
+
+            /**
+             * The events of all threads, may not be called while other threads add events
+             */
+            KernelTrace get_trace();
+        };
+
+        /**
+         * Records a task from the construction until the destruction of the scope, does nothing if the tracer is a
+         * nullptr.
+         */
+        class TraceScope {
+        private:
+            Tracer *tracer;
+            TraceEvent event;
+
+        public:
+            TraceScope(Tracer *tracer, const char *name, const char *category, int frame = -1, int domain = -1,
+                       int stage = -1, const char *direction = nullptr, const char *field = nullptr) : tracer(tracer) {
+                if (tracer != nullptr) {
+                    event.Name = name;
+                    event.Category = category;
+                    event.Frame = frame;
+                    event.Domain = domain;
+                    event.Stage = stage;
+                    event.Direction = direction;
+                    event.Field = field;
+                    event.Start = tracer->now();
+                }
+            }
+
+            ~TraceScope() {
+                if (tracer != nullptr) {
+                    event.Duration = tracer->now() - event.Start;
+                    tracer->add(event);
+                }
+            }
+        };
+    }
+}
+
+#endif //OPENPSTD_TRACER_H
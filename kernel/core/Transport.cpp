@@ -0,0 +1,430 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Transport.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <boost/asio.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/interprocess/ipc/message_queue.hpp>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        using namespace std;
+        namespace ipc = boost::interprocess;
+        using boost::asio::ip::tcp;
+
+        /**
+         * Every message starts with its length in bytes
+         */
+        typedef uint64_t message_length;
+
+        /**
+         * Length of a message that closes the connection, it is followed by the reason
+         */
+        static const message_length close_marker = UINT64_MAX;
+
+        struct SharedMemoryTransport::Queues {
+            vector<unique_ptr<ipc::message_queue>> incoming;
+            vector<unique_ptr<ipc::message_queue>> outgoing;
+        };
+
+        struct TcpTransport::Connections {
+            boost::asio::io_service io_service;
+            vector<unique_ptr<tcp::socket>> sockets;
+        };
+
+        Transport::Transport(int rank, int size, double timeout) : rank(rank), size(size), timeout(timeout),
+                                                                   inbox((unsigned long) size),
+                                                                   errors((unsigned long) size) {
+            if (size < 1 or rank < 0 or rank >= size) {
+                throw runtime_error("Rank " + to_string(rank) + " is not one of the " + to_string(size) + " ranks");
+            }
+        }
+
+        Transport::~Transport() {
+        }
+
+        int Transport::get_rank() const {
+            return rank;
+        }
+
+        int Transport::get_size() const {
+            return size;
+        }
+
+        double Transport::get_timeout() const {
+            return timeout;
+        }
+
+        void Transport::check_peer(int peer) const {
+            if (peer < 0 or peer >= size or peer == rank) {
+                throw runtime_error("Rank " + to_string(peer) + " is not a peer of rank " + to_string(rank));
+            }
+        }
+
+        void Transport::deliver(int source, vector<char> message) {
+            {
+                lock_guard<std::mutex> lock(mutex);
+                inbox[source].push_back(std::move(message));
+            }
+            arrived.notify_all();
+        }
+
+        void Transport::close(int source, const string &error) {
+            {
+                lock_guard<std::mutex> lock(mutex);
+                errors[source] = error;
+            }
+            arrived.notify_all();
+        }
+
+        vector<char> Transport::receive(int source) {
+            check_peer(source);
+            unique_lock<std::mutex> lock(mutex);
+            if (not arrived.wait_for(lock, chrono::microseconds((long) (timeout * 1e6)), [&] {
+                return not inbox[source].empty() or not errors[source].empty();
+            })) {
+                throw runtime_error("Rank " + to_string(source) + " did not send a message within " +
+                                    to_string(timeout) + " seconds");
+            }
+            if (inbox[source].empty()) {
+                throw runtime_error("No more messages from rank " + to_string(source) + ": " + errors[source]);
+            }
+            vector<char> message = std::move(inbox[source].front());
+            inbox[source].pop_front();
+            return message;
+        }
+
+        void Transport::abort(const string &error) {
+            for (int peer = 0; peer < size; peer++) {
+                if (peer != rank) {
+                    try {
+                        send_close(peer, "rank " + to_string(rank) + " failed: " + error);
+                    }
+                    catch (exception &) {
+                    }
+                }
+            }
+        }
+
+        void Transport::barrier() {
+            if (rank == 0) {
+                for (int peer = 1; peer < size; peer++) {
+                    receive(peer);
+                }
+                for (int peer = 1; peer < size; peer++) {
+                    send(peer, vector<char>());
+                }
+            }
+            else {
+                send(0, vector<char>());
+                receive(0);
+            }
+        }
+
+        static boost::posix_time::ptime deadline_after(double seconds) {
+            return boost::posix_time::microsec_clock::universal_time() +
+                   boost::posix_time::microseconds((long) (seconds * 1e6));
+        }
+
+        SharedMemoryTransport::SharedMemoryTransport(const string &name, int rank, int size, double timeout) :
+                Transport(rank, size, timeout), name(name), queues(new Queues()), stopping(false) {
+            queues->incoming.resize((unsigned long) size);
+            queues->outgoing.resize((unsigned long) size);
+            try {
+                for (int source = 0; source < size; source++) {
+                    if (source != rank) {
+                        queues->incoming[source].reset(new ipc::message_queue(ipc::create_only,
+                                                                      get_queue_name(source, rank).c_str(),
+                                                                      queue_length, chunk_size));
+                    }
+                }
+            }
+            catch (ipc::interprocess_exception &e) {
+                remove_queues();
+                throw runtime_error("The shared memory queues of run " + name + " can not be created, another run " +
+                                    "uses the name or a previous run did not finish: " + e.what());
+            }
+            auto deadline = chrono::steady_clock::now() + chrono::microseconds((long) (timeout * 1e6));
+            for (int destination = 0; destination < size; destination++) {
+                while (destination != rank and not queues->outgoing[destination]) {
+                    try {
+                        queues->outgoing[destination].reset(new ipc::message_queue(
+                                ipc::open_only, get_queue_name(rank, destination).c_str()));
+                    }
+                    catch (ipc::interprocess_exception &e) {
+                        if (chrono::steady_clock::now() > deadline) {
+                            remove_queues();
+                            throw runtime_error("Rank " + to_string(destination) + " of run " + name +
+                                                " did not start in time");
+                        }
+                        this_thread::sleep_for(chrono::milliseconds(10));
+                    }
+                }
+            }
+            for (int source = 0; source < size; source++) {
+                if (source != rank) {
+                    readers.push_back(thread(&SharedMemoryTransport::read, this, source));
+                }
+            }
+        }
+
+        SharedMemoryTransport::~SharedMemoryTransport() {
+            //the queues of the others stay open after a rank stops, so it tells them
+            for (int destination = 0; destination < get_size(); destination++) {
+                if (destination != get_rank()) {
+                    try {
+                        send_close(destination, "rank " + to_string(get_rank()) + " closed the transport");
+                    }
+                    catch (exception &) {
+                    }
+                }
+            }
+            stopping = true;
+            for (auto &reader: readers) {
+                reader.join();
+            }
+            remove_queues();
+        }
+
+        string SharedMemoryTransport::get_queue_name(int source, int destination) const {
+            return name + "-" + to_string(source) + "-" + to_string(destination);
+        }
+
+        void SharedMemoryTransport::remove_queues() {
+            for (int source = 0; source < get_size(); source++) {
+                if (queues->incoming[source]) {
+                    queues->incoming[source].reset();
+                    ipc::message_queue::remove(get_queue_name(source, get_rank()).c_str());
+                }
+            }
+        }
+
+        void SharedMemoryTransport::send(int destination, const vector<char> &message) {
+            check_peer(destination);
+            //the first chunk starts with the length of the message, a message can be empty
+            vector<char> chunk(chunk_size);
+            message_length length = message.size();
+            memcpy(chunk.data(), &length, sizeof(length));
+            unsigned long chunk_used = sizeof(length);
+            unsigned long sent = 0;
+            do {
+                unsigned long part = min(chunk_size - chunk_used, (unsigned long) message.size() - sent);
+                memcpy(chunk.data() + chunk_used, message.data() + sent, part);
+                sent += part;
+                if (not queues->outgoing[destination]->timed_send(chunk.data(), chunk_used + part, 0,
+                                                          deadline_after(get_timeout()))) {
+                    throw runtime_error("Rank " + to_string(destination) + " does not receive messages");
+                }
+                chunk_used = 0;
+            } while (sent < message.size());
+        }
+
+        void SharedMemoryTransport::send_close(int destination, const string &reason) {
+            //the reason fits in a single chunk with the marker, a rank that stopped reading does not get a full timeout
+            check_peer(destination);
+            vector<char> chunk(sizeof(close_marker));
+            memcpy(chunk.data(), &close_marker, sizeof(close_marker));
+            chunk.insert(chunk.end(), reason.begin(),
+                         reason.begin() + min((unsigned long) reason.size(), chunk_size - sizeof(close_marker)));
+            if (not queues->outgoing[destination]->timed_send(chunk.data(), chunk.size(), 0,
+                                                      deadline_after(min(get_timeout(), 1.0)))) {
+                throw runtime_error("Rank " + to_string(destination) + " does not receive messages");
+            }
+        }
+
+        void SharedMemoryTransport::read(int source) {
+            ipc::message_queue &queue = *queues->incoming[source];
+            vector<char> chunk(chunk_size);
+            vector<char> message;
+            message_length length = 0;
+            bool in_message = false;
+            string error = "the transport is closed";
+            while (not stopping) {
+                ipc::message_queue::size_type received;
+                unsigned int priority;
+                try {
+                    if (not queue.timed_receive(chunk.data(), chunk.size(), received, priority,
+                                                deadline_after(0.05))) {
+                        continue;
+                    }
+                }
+                catch (ipc::interprocess_exception &e) {
+                    error = e.what();
+                    break;
+                }
+                unsigned long offset = 0;
+                if (not in_message) {
+                    memcpy(&length, chunk.data(), sizeof(length));
+                    if (length == close_marker) {
+                        error = string(chunk.begin() + sizeof(length), chunk.begin() + received);
+                        break;
+                    }
+                    offset = sizeof(length);
+                    message.clear();
+                    message.reserve(length);
+                    in_message = true;
+                }
+                message.insert(message.end(), chunk.begin() + offset, chunk.begin() + received);
+                if (message.size() == length) {
+                    deliver(source, std::move(message));
+                    message = vector<char>();
+                    in_message = false;
+                }
+            }
+            close(source, error);
+        }
+
+        TcpTransport::TcpTransport(int rank, const vector<string> &endpoints, double timeout) :
+                Transport(rank, (int) endpoints.size(), timeout), connections(new Connections()),
+                send_mutexes(endpoints.size()) {
+            vector<unique_ptr<tcp::socket>> &sockets = connections->sockets;
+            boost::asio::io_service &io_service = connections->io_service;
+            sockets.resize(endpoints.size());
+            vector<string> hosts, ports;
+            for (auto endpoint: endpoints) {
+                unsigned long separator = endpoint.rfind(':');
+                if (separator == string::npos or separator == 0 or separator + 1 == endpoint.size()) {
+                    throw runtime_error("The endpoint " + endpoint + " is not of the form host:port");
+                }
+                hosts.push_back(endpoint.substr(0, separator));
+                ports.push_back(endpoint.substr(separator + 1));
+            }
+            tcp::resolver resolver(io_service);
+            //listen before connecting, the higher ranks connect while this rank connects to the lower ranks
+            tcp::endpoint own_endpoint = *resolver.resolve(tcp::resolver::query(hosts[rank], ports[rank]));
+            tcp::acceptor acceptor(io_service);
+            acceptor.open(own_endpoint.protocol());
+            acceptor.set_option(tcp::acceptor::reuse_address(true));
+            acceptor.bind(tcp::endpoint(own_endpoint.protocol(), own_endpoint.port()));
+            acceptor.listen();
+
+            auto deadline = chrono::steady_clock::now() + chrono::microseconds((long) (timeout * 1e6));
+            for (int destination = 0; destination < rank; destination++) {
+                unique_ptr<tcp::socket> socket(new tcp::socket(io_service));
+                boost::system::error_code error;
+                do {
+                    if (chrono::steady_clock::now() > deadline) {
+                        throw runtime_error("Rank " + to_string(destination) + " does not listen on " +
+                                            endpoints[destination] + ": " + error.message());
+                    }
+                    if (error) {
+                        socket->close();
+                        this_thread::sleep_for(chrono::milliseconds(10));
+                    }
+                    boost::asio::connect(*socket, resolver.resolve(
+                            tcp::resolver::query(hosts[destination], ports[destination])), error);
+                } while (error);
+                int32_t own_rank = rank;
+                boost::asio::write(*socket, boost::asio::buffer(&own_rank, sizeof(own_rank)));
+                sockets[destination] = std::move(socket);
+            }
+            for (int accepted = rank + 1; accepted < get_size(); accepted++) {
+                unique_ptr<tcp::socket> socket(new tcp::socket(io_service));
+                acceptor.accept(*socket);
+                int32_t source;
+                boost::asio::read(*socket, boost::asio::buffer(&source, sizeof(source)));
+                if (source <= rank or source >= get_size() or sockets[source]) {
+                    throw runtime_error("Rank " + to_string(source) + " is not expected to connect to rank " +
+                                        to_string(rank));
+                }
+                sockets[source] = std::move(socket);
+            }
+            for (int peer = 0; peer < get_size(); peer++) {
+                if (peer != rank) {
+                    sockets[peer]->set_option(tcp::no_delay(true));
+                    send_mutexes[peer].reset(new std::mutex());
+                    readers.push_back(thread(&TcpTransport::read, this, peer));
+                }
+            }
+        }
+
+        TcpTransport::~TcpTransport() {
+            boost::system::error_code error;
+            //shutting down also stops the readers that wait for data
+            for (auto &socket: connections->sockets) {
+                if (socket) {
+                    socket->shutdown(tcp::socket::shutdown_both, error);
+                }
+            }
+            for (auto &reader: readers) {
+                reader.join();
+            }
+            for (auto &socket: connections->sockets) {
+                if (socket) {
+                    socket->close(error);
+                }
+            }
+        }
+
+        void TcpTransport::send(int destination, const vector<char> &message) {
+            check_peer(destination);
+            message_length length = message.size();
+            vector<boost::asio::const_buffer> buffers{boost::asio::buffer(&length, sizeof(length)),
+                                                      boost::asio::buffer(message)};
+            lock_guard<std::mutex> lock(*send_mutexes[destination]);
+            try {
+                boost::asio::write(*connections->sockets[destination], buffers);
+            }
+            catch (boost::system::system_error &e) {
+                throw runtime_error("Sending to rank " + to_string(destination) + " failed: " + e.what());
+            }
+        }
+
+        void TcpTransport::send_close(int destination, const string &reason) {
+            check_peer(destination);
+            message_length length = reason.size();
+            vector<boost::asio::const_buffer> buffers{boost::asio::buffer(&close_marker, sizeof(close_marker)),
+                                                      boost::asio::buffer(&length, sizeof(length)),
+                                                      boost::asio::buffer(reason)};
+            lock_guard<std::mutex> lock(*send_mutexes[destination]);
+            try {
+                boost::asio::write(*connections->sockets[destination], buffers);
+            }
+            catch (boost::system::system_error &e) {
+                throw runtime_error("Sending to rank " + to_string(destination) + " failed: " + e.what());
+            }
+        }
+
+        void TcpTransport::read(int source) {
+            tcp::socket &socket = *connections->sockets[source];
+            try {
+                while (true) {
+                    message_length length;
+                    boost::asio::read(socket, boost::asio::buffer(&length, sizeof(length)));
+                    if (length == close_marker) {
+                        boost::asio::read(socket, boost::asio::buffer(&length, sizeof(length)));
+                        string reason(length, ' ');
+                        boost::asio::read(socket, boost::asio::buffer(&reason[0], length));
+                        close(source, reason);
+                        return;
+                    }
+                    vector<char> message(length);
+                    boost::asio::read(socket, boost::asio::buffer(message));
+                    deliver(source, std::move(message));
+                }
+            }
+            catch (boost::system::system_error &e) {
+                close(source, e.what());
+            }
+        }
+    }
+}
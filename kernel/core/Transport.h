@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Transports for the messages between the processes of a distributed
+//      simulation, over shared memory or over TCP sockets.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_TRANSPORT_H
+#define OPENPSTD_TRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OpenPSTD {
+    namespace Kernel {
+        /**
+         * Sends messages between the ranks of a distributed simulation.
+         *
+         * The messages between two ranks arrive in the order they were sent. Messages are received by reader
+         * threads of the implementations, so a send never waits on a receive of the other rank.
+         */
+        class Transport {
+        private:
+            int rank;
+            int size;
+            /// Seconds to wait for a message
+            double timeout;
+            std::mutex mutex;
+            std::condition_variable arrived;
+            /// Messages that arrived from every rank and are not received yet
+            std::vector<std::deque<std::vector<char>>> inbox;
+            /// Error of every rank that can not send any more messages, empty if the connection is open
+            std::vector<std::string> errors;
+
+        protected:
+            Transport(int rank, int size, double timeout);
+
+            /**
+             * Adds a message that arrived from a rank to the inbox
+             */
+            void deliver(int source, std::vector<char> message);
+
+            /**
+             * Marks that no more messages arrive from a rank, waiting receives of that rank fail
+             */
+            void close(int source, const std::string &error);
+
+            /**
+             * @throws std::runtime_error if the rank is outside the ranks or equals the own rank
+             */
+            void check_peer(int peer) const;
+
+            /**
+             * Tells a rank that no more messages are sent to it
+             * @param reason: the error of the waiting receives of the rank
+             */
+            virtual void send_close(int destination, const std::string &reason) = 0;
+
+        public:
+            virtual ~Transport();
+
+            int get_rank() const;
+
+            int get_size() const;
+
+            /**
+             * Seconds to wait for a message, or for the other ranks to connect
+             */
+            double get_timeout() const;
+
+            /**
+             * Sends a message to a rank
+             * @throws std::runtime_error if the message can not be sent
+             */
+            virtual void send(int destination, const std::vector<char> &message) = 0;
+
+            /**
+             * Waits for the next message of a rank
+             * @throws std::runtime_error if the connection with the rank is closed or no message arrives in time
+             */
+            std::vector<char> receive(int source);
+
+            /**
+             * Tells all the ranks that this rank failed, so that they stop waiting for its messages. Errors of the
+             * connections are ignored, the other ranks may have failed already.
+             * @param error: the error of this rank, it is part of the errors of the waiting receives of the others
+             */
+            void abort(const std::string &error);
+
+            /**
+             * Waits until all the ranks reached the barrier
+             */
+            void barrier();
+        };
+
+        /**
+         * Transport over shared memory message queues, for the processes on a single machine.
+         * Every pair of ranks has a queue in each direction, named <name>-<from>-<to>.
+         */
+        class SharedMemoryTransport : public Transport {
+        private:
+            /// The queues of boost::interprocess, they are only known to the implementation
+            struct Queues;
+
+            std::string name;
+            std::unique_ptr<Queues> queues;
+            std::vector<std::thread> readers;
+            std::atomic<bool> stopping;
+
+            std::string get_queue_name(int source, int destination) const;
+
+            void remove_queues();
+
+            void read(int source);
+
+        protected:
+            void send_close(int destination, const std::string &reason) override;
+
+        public:
+            /// Size of the chunks that a message is split in
+            static const unsigned long chunk_size = 64 * 1024;
+            /// Number of chunks that fit in a queue
+            static const unsigned long queue_length = 16;
+
+            /**
+             * Creates the queues to this rank and opens the queues to the other ranks
+             * @param name: name of the run, the same for all ranks and unique on the machine
+             * @param timeout: seconds to wait for the other ranks to create their queues and to receive a message
+             * @throws std::runtime_error if a queue exists already or the other ranks do not start in time
+             */
+            SharedMemoryTransport(const std::string &name, int rank, int size, double timeout = 60);
+
+            /**
+             * Tells the other ranks that the transport is closed, stops the readers and removes the queues to this rank
+             */
+            ~SharedMemoryTransport();
+
+            void send(int destination, const std::vector<char> &message) override;
+        };
+
+        /**
+         * Transport over TCP connections, every rank listens on its own endpoint. A rank connects to the lower ranks
+         * and accepts the connections of the higher ranks.
+         */
+        class TcpTransport : public Transport {
+        private:
+            /// The sockets of boost::asio, they are only known to the implementation
+            struct Connections;
+
+            std::unique_ptr<Connections> connections;
+            std::vector<std::unique_ptr<std::mutex>> send_mutexes;
+            std::vector<std::thread> readers;
+
+            void read(int source);
+
+        protected:
+            void send_close(int destination, const std::string &reason) override;
+
+        public:
+            /**
+             * Connects all the ranks
+             * @param endpoints: host:port of every rank, the same for all ranks
+             * @param timeout: seconds to wait for the other ranks to listen and to receive a message
+             * @throws std::runtime_error if an endpoint is invalid or a rank can not be connected in time
+             */
+            TcpTransport(int rank, const std::vector<std::string> &endpoints, double timeout = 60);
+
+            /**
+             * Closes the connections and stops the readers
+             */
+            ~TcpTransport();
+
+            void send(int destination, const std::vector<char> &message) override;
+        };
+    }
+}
+
+#endif //OPENPSTD_TRANSPORT_H
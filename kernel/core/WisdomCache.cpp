@@ -26,6 +26,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "WisdomCache.h"
+#include "kernel_functions.h"
 
 using namespace std;
 
@@ -35,8 +36,15 @@ namespace OpenPSTD {
 
         WisdomCache::WisdomCache() { };
 
+        WisdomCache::WisdomCache(const WisdomCache &other) {
+            std::lock_guard<std::mutex> lock(other.mutex);
+            this->computed_discretization = other.computed_discretization;
+            this->cached_fftw_plans = other.cached_fftw_plans;
+        }
+
         WisdomCache::Discretization WisdomCache::get_discretization(float dx, int N) {
             int matched_int = this->match_number(N);
+            std::lock_guard<std::mutex> lock(this->mutex);
             auto search = this->computed_discretization.find(matched_int); // Crashes here
             if (search != this->computed_discretization.end()) {
                 return search->second;
@@ -75,6 +83,7 @@ namespace OpenPSTD {
 
         WisdomCache::Planset_FFTW WisdomCache::get_fftw_planset(int fft_length, int fft_batch_size) {
             std::string plan_key = std::to_string(fft_length).append(",").append(std::to_string(fft_batch_size));
+            std::lock_guard<std::mutex> lock(this->mutex);
             auto search = this->cached_fftw_plans.find(plan_key);
             if (search != this->cached_fftw_plans.end()) {
                 return search->second;
@@ -91,17 +100,21 @@ namespace OpenPSTD {
             int istride = 1; //distance between two elements in one fft-able array
             int ostride = istride;
             int idist = fft_length; //distance between first element of different arrays
-            int odist = idist;
-            fftwf_plan plan = fftwf_plan_many_dft_r2c(1, shape, fft_batch_size, NULL, NULL, istride, idist,
-                                                      NULL, NULL, ostride, odist, FFTW_ESTIMATE);
-            idist = (fft_length / 2) + 1;
-            odist = idist;
-            int ishape[] = {fft_length / 2 + 1};
-            fftwf_plan plan_inv = fftwf_plan_many_dft_c2r(1, ishape, fft_batch_size, NULL, NULL, ostride, odist,
-                                                          NULL, NULL, istride, idist, FFTW_ESTIMATE);
+            int odist = (fft_length / 2) + 1;
+            //the plans are made for separate buffers with the alignment of fftwf_malloc, spatderp3 executes them on
+            //its own buffers of the same size and alignment. FFTW_ESTIMATE does not write to these buffers.
+            float *in_buffer = (float *) fftwf_malloc(sizeof(float) * idist * fft_batch_size);
+            fftwf_complex *out_buffer = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * odist * fft_batch_size);
             Planset_FFTW result;
-            result.plan = plan;
-            result.plan_inv = plan_inv;
+            {
+                std::lock_guard<std::mutex> lock(fftw_planner_mutex());
+                result.plan = fftwf_plan_many_dft_r2c(1, shape, fft_batch_size, in_buffer, NULL, istride, idist,
+                                                      out_buffer, NULL, ostride, odist, FFTW_ESTIMATE);
+                result.plan_inv = fftwf_plan_many_dft_c2r(1, shape, fft_batch_size, out_buffer, NULL, ostride, odist,
+                                                          in_buffer, NULL, istride, idist, FFTW_ESTIMATE);
+            }
+            fftwf_free(in_buffer);
+            fftwf_free(out_buffer);
             return result;
         }
 
@@ -33,6 +33,7 @@
 #include <fftw3.h>
 #include <complex>
 #include <memory>
+#include <mutex>
 #include <iostream>
 #include <Eigen/Dense>
 
@@ -79,6 +80,7 @@ namespace OpenPSTD {
             /**
              * Obtain an FFTW plan for the given fft length and batch size.
              * If the plan does not exist yet, it is created and cached.
+             * The plans transform out of place, with the layout and buffers of spatderp3.
              * @param fft_length: Length of the planned FFT
              * @param fft_batch_size: Batch size of the planned FFT
              */
@@ -86,13 +88,21 @@ namespace OpenPSTD {
 
             /**
              * Initializer for the cache. Initialize only a single instance to optimize computations.
+             * The cache can be shared by solvers that run concurrently(see SweepRunner).
              */
             WisdomCache();
 
+            /**
+             * Copies the discretizations and plans, the plans are not owned by the cache so they are shared.
+             */
+            WisdomCache(const WisdomCache &other);
+
             std::map<int, Discretization> computed_discretization; // Should be private! public for debugging purposes
             std::map<std::string, Planset_FFTW> cached_fftw_plans; // Should be private! public for debugging purposes
 
         private:
+            /// Protects the cached discretizations and plans
+            mutable std::mutex mutex;
 
             /**
              * Compute discretization for the given grid size and number of grid points.
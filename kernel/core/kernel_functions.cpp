@@ -28,6 +28,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "kernel_functions.h"
+#include "Logger.h"
 #include <iostream>
 #include <fstream>
 
@@ -120,11 +121,17 @@ namespace OpenPSTD {
             }
         }
 
+        std::mutex &fftw_planner_mutex() {
+            static std::mutex planner_mutex;
+            return planner_mutex;
+        }
+
         ArrayXXf spatderp3(ArrayXXf p1, ArrayXXf p2,
                            ArrayXXf p3, ArrayXcf derfact,
                            RhoArray rho_array, ArrayXf window, int wlen,
                            CalculationType ct, CalcDirection direct,
-                           fftwf_plan plan, fftwf_plan plan_inv) {
+                           fftwf_plan plan, fftwf_plan plan_inv,
+                           Profiler *profiler, int profile_domain) {
 
             /*//debug stuff
             int writenum;
@@ -151,6 +158,8 @@ namespace OpenPSTD {
             } // end debug stuff */
 
 
+            ProfileTimer timer(profiler, PROFILEPHASE::WINDOWING, profile_domain);
+
             //if direct == Y, transpose p1, p2 and p3
             if (direct == CalcDirection::Y) {
                 p1.transposeInPlace();
@@ -171,19 +180,23 @@ namespace OpenPSTD {
             fftwf_complex *out_buffer;
             out_buffer = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * ((fft_length / 2) + 1) * fft_batch);
 
-            //non-domains don't have a wisdomcache, so this is needed. TODO Perhaps put it in the Scene itself.
-            if (plan == NULL || true) { //always use this one for now, mainly debugging purposes TODO change that
+            //non-domains don't have a wisdomcache, so the plans are created for this transform only
+            timer.next(PROFILEPHASE::PLANNING);
+            bool local_plans = plan == NULL || plan_inv == NULL;
+            if (local_plans) {
                 int shape[] = {fft_length};
                 int istride = 1; //distance between two elements in one fft-able array
                 int ostride = istride;
                 int idist = fft_length; //distance between first element of different arrays
                 int odist = (fft_length / 2) + 1;
+                std::lock_guard<std::mutex> lock(fftw_planner_mutex());
                 plan = fftwf_plan_many_dft_r2c(1, shape, fft_batch, in_buffer, NULL, istride, idist,
                                                out_buffer, NULL, ostride, odist, FFTW_ESTIMATE);
 
                 plan_inv = fftwf_plan_many_dft_c2r(1, shape, fft_batch, out_buffer, NULL, ostride, odist,
                                                    in_buffer, NULL, istride, idist, FFTW_ESTIMATE);
             }
+            timer.next(PROFILEPHASE::WINDOWING);
 
             //the pressure is calculated for len(p2)+1, velocity for len(p2)-1
             //slicing and the values pulled from the Rmatrix is slightly different for the two branches
@@ -195,7 +208,7 @@ namespace OpenPSTD {
                 ArrayXf window_right = window.tail(wlen);
 
                 if (wlen > p1.cols() || wlen > p3.cols()) {
-                    std::cout << "CAREFUL: WINDOW IS BIGGER THAN SIDES" << std::endl;
+                    OPENPSTD_LOG(LogLevel::WARNING, "CAREFUL: WINDOW IS BIGGER THAN SIDES");
                 }
 
                 ArrayXXf dom1(fft_batch, wlen);
@@ -223,7 +236,9 @@ namespace OpenPSTD {
 
                 //perform the fft
                 memcpy(in_buffer, fft_input_data.data(), sizeof(float) * fft_batch * fft_length);
+                timer.next(PROFILEPHASE::FFT);
                 fftwf_execute_dft_r2c(plan, in_buffer, out_buffer);
+                timer.next(PROFILEPHASE::SPECTRAL_MULTIPLY);
 
                 //map the results back into an eigen array
                 typedef Matrix<std::complex<float>, Dynamic, Dynamic, RowMajor> ArrayXXcfrm;
@@ -231,7 +246,9 @@ namespace OpenPSTD {
 
                 //apply the spectral derivative
                 spectrum_array = spectrum_array.array().rowwise() * derfact.topRows(fft_length / 2 + 1).transpose();
+                timer.next(PROFILEPHASE::INVERSE_FFT);
                 fftwf_execute_dft_c2r(plan_inv, out_buffer, in_buffer);
+                timer.next(PROFILEPHASE::WINDOWING);
 
 
                 Matrix<float, Dynamic, Dynamic, RowMajor> derived_array =
@@ -279,7 +296,9 @@ namespace OpenPSTD {
 
                 //perform the fft
                 memcpy(in_buffer, fft_input_data.data(), sizeof(float) * fft_batch * fft_length);
+                timer.next(PROFILEPHASE::FFT);
                 fftwf_execute_dft_r2c(plan, in_buffer, out_buffer);
+                timer.next(PROFILEPHASE::SPECTRAL_MULTIPLY);
 
                 //map the results back into an eigen array
                 typedef Matrix<std::complex<float>, Dynamic, Dynamic, RowMajor> ArrayXXcfrm;
@@ -292,7 +311,9 @@ namespace OpenPSTD {
                 //apply the spectral derivative
                 spectrum_array = spectrum_array.array().rowwise() * derfact.topRows(fft_length / 2 + 1).transpose();
 
+                timer.next(PROFILEPHASE::INVERSE_FFT);
                 fftwf_execute_dft_c2r(plan_inv, out_buffer, in_buffer);
+                timer.next(PROFILEPHASE::WINDOWING);
 
                 Matrix<float, Dynamic, Dynamic, RowMajor> derived_array =
                         Map<Matrix<float, Dynamic, Dynamic, RowMajor>>(in_buffer, fft_batch, fft_length).array();
@@ -309,7 +330,9 @@ namespace OpenPSTD {
             }
             fftwf_free(in_buffer);
             fftwf_free(out_buffer);
-            if (plan == NULL || true) { //always use local plan for now, mainly debugging purposes TODO change that
+            timer.next(PROFILEPHASE::PLANNING);
+            if (local_plans) {
+                std::lock_guard<std::mutex> lock(fftw_planner_mutex());
                 fftwf_destroy_plan(plan);
                 fftwf_destroy_plan(plan_inv);
             }
@@ -332,9 +355,7 @@ namespace OpenPSTD {
         }
 
         void debug(std::string msg) {
-#if 1
-            std::cout << msg << std::endl;
-#endif
+            OPENPSTD_LOG(LogLevel::DEBUG, msg);
         }
 
         bool is_approx(float a, float b) {
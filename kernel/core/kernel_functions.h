@@ -42,12 +42,20 @@
 #include <map>
 #include <math.h>
 #include <algorithm>
+#include <mutex>
 #include "../KernelInterface.h"
 #include "Geometry.h"
+#include "Profiler.h"
 
 namespace OpenPSTD {
     namespace Kernel {
 
+        /**
+         * The planner of FFTW is not thread safe, plans have to be created and destroyed while holding this mutex.
+         * Executing a plan does not need the mutex.
+         */
+        std::mutex &fftw_planner_mutex();
+
         /**
          * Helper function equivalent to numpy.arange()
          */
@@ -160,13 +168,19 @@ namespace OpenPSTD {
 
         /**
          * Version of spatderp3 that takes cached plans as input.
+         * The plans must be made by WisdomCache::get_fftw_planset for the length of the transform and a batch of
+         * p2.rows()(X) or p2.cols()(Y) transforms, they are executed on the buffers of this call.
+         * Without plans(NULL) the plans are created and destroyed for this call.
          * @see spatderp3(9)
+         * @param profiler the phases are timed for this profiler if it is not a nullptr
+         * @param profile_domain the id of the domain the phases are added to
          */
         Eigen::ArrayXXf spatderp3(Eigen::ArrayXXf p1, Eigen::ArrayXXf p2,
                                   Eigen::ArrayXXf p3, Eigen::ArrayXcf derfact,
                                   RhoArray rho_array, Eigen::ArrayXf window, int wlen,
                                   CalculationType ct, CalcDirection direct,
-                                  fftwf_plan plan, fftwf_plan plan_inv);
+                                  fftwf_plan plan, fftwf_plan plan_inv,
+                                  Profiler *profiler = nullptr, int profile_domain = 0);
 
         /**
          * Computes and return reflection and transmission matrices for pressure and velocity
@@ -4,7 +4,10 @@
 SET(SOURCE_FILES_LIB kernel/PSTDKernel.cpp
         kernel/core/kernel_functions.cpp kernel/core/Domain.cpp kernel/core/Speaker.cpp kernel/core/Scene.cpp
         kernel/core/Receiver.cpp kernel/core/Boundary.cpp kernel/Solver.cpp kernel/core/Geometry.cpp
-        kernel/core/WisdomCache.cpp kernel/KernelInterface.cpp kernel/MockKernel.cpp)
+        kernel/core/WisdomCache.cpp kernel/KernelInterface.cpp kernel/MockKernel.cpp kernel/core/Profiler.cpp
+        kernel/core/Tracer.cpp kernel/core/Estimator.cpp kernel/core/Logger.cpp
+        kernel/core/Checkpoint.cpp kernel/SweepRunner.cpp kernel/core/Partitioner.cpp
+        kernel/core/Transport.cpp kernel/core/Layout.cpp)
 add_library(OpenPSTD SHARED ${SOURCE_FILES_LIB})
 
 target_include_directories(OpenPSTD PUBLIC ${Qt5_INCLUDE_DIRS})
@@ -14,4 +17,11 @@ target_include_directories(OpenPSTD PUBLIC ${FFTWF_INCLUDE_DIR})
 
 target_link_libraries(OpenPSTD ${Boost_LIBRARIES})
 target_link_libraries(OpenPSTD ${Qt5_LIBRARIES})
-target_link_libraries(OpenPSTD ${FFTWF_LIBRARY})
\ No newline at end of file
+target_link_libraries(OpenPSTD ${FFTWF_LIBRARY})
+
+# the transports of distributed simulations use sockets and shared memory
+if(WIN32)
+    target_link_libraries(OpenPSTD ws2_32 mswsock)
+elseif(UNIX AND NOT APPLE)
+    target_link_libraries(OpenPSTD rt)
+endif()
\ No newline at end of file
@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      A blocking queue with a maximum size that connects the stages of
+//      a pipeline running on different threads.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_BOUNDEDQUEUE_H
+#define OPENPSTD_BOUNDEDQUEUE_H
+
+#include <boost/thread.hpp>
+#include <deque>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * A thread safe FIFO queue. Push blocks while the queue is full and Pop blocks while the queue is empty, so a
+         * fast producer can never run ahead of the consumers. After Close is called no new items are accepted and Pop
+         * returns false as soon as the queue is empty.
+         */
+        template<typename T>
+        class BoundedQueue
+        {
+        private:
+            boost::mutex mutex;
+            boost::condition_variable notFull;
+            boost::condition_variable notEmpty;
+            std::deque<T> items;
+            size_t capacity;
+            bool closed;
+
+        public:
+            BoundedQueue(size_t capacity): capacity(capacity > 0 ? capacity : 1), closed(false)
+            {
+            }
+
+            /**
+             * Adds an item to the queue, blocks while the queue is full.
+             * @return false if the queue is closed and the item is not added
+             */
+            bool Push(T item)
+            {
+                boost::unique_lock<boost::mutex> lock(this->mutex);
+                while(!this->closed && this->items.size() >= this->capacity)
+                    this->notFull.wait(lock);
+
+                if(this->closed)
+                    return false;
+
+                this->items.push_back(std::move(item));
+                this->notEmpty.notify_one();
+                return true;
+            }
+
+            /**
+             * Removes the first item of the queue, blocks while the queue is empty and not closed.
+             * @return false if the queue is closed and empty
+             */
+            bool Pop(T &item)
+            {
+                boost::unique_lock<boost::mutex> lock(this->mutex);
+                while(!this->closed && this->items.empty())
+                    this->notEmpty.wait(lock);
+
+                if(this->items.empty())
+                    return false;
+
+                item = std::move(this->items.front());
+                this->items.pop_front();
+                this->notFull.notify_one();
+                return true;
+            }
+
+            /**
+             * No new items are accepted, the items that are already in the queue can still be removed.
+             */
+            void Close()
+            {
+                boost::unique_lock<boost::mutex> lock(this->mutex);
+                this->closed = true;
+                this->notFull.notify_all();
+                this->notEmpty.notify_all();
+            }
+
+            /**
+             * Closes the queue and removes all the items that are in the queue.
+             */
+            void Abort()
+            {
+                boost::unique_lock<boost::mutex> lock(this->mutex);
+                this->closed = true;
+                this->items.clear();
+                this->notFull.notify_all();
+                this->notEmpty.notify_all();
+            }
+        };
+    }
+}
+
+#endif //OPENPSTD_BOUNDEDQUEUE_H
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "ColorLUT.h"
+#include <algorithm>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        //values are converted in blocks, so that the indices stay in the L1 cache before the lookup
+        static const size_t COLOR_LUT_BLOCK = 256;
+
+        /**
+         * Converts values to indices into a table with size colors, this loop does not have branches so that it can
+         * be vectorized. NaN is mapped to 0 by the order of min and max.
+         */
+        static inline void ComputeIndices(const float *values, size_t count, float min, float max, unsigned int size,
+                                          int *output)
+        {
+            float last = (float)(size - 1);
+            float scale = max > min ? last / (max - min) : 0;
+            //0.5 is added so that the truncation rounds to the nearest index
+            float offset = 0.5f - min * scale;
+            float upper = last + 0.5f;
+            for (size_t i = 0; i < count; i++)
+            {
+                float x = values[i] * scale + offset;
+                x = std::max(0.0f, std::min(x, upper));
+                output[i] = std::min((int)x, (int)(size - 1));
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT ColorLUT::ColorLUT(BaseColorGradient &gradient, unsigned int size):
+                colors(*gradient.CreateColorRGBMap(0, 1, std::max(2u, size)))
+        {
+        }
+
+        OPENPSTD_SHARED_EXPORT const std::vector<QRgb> &ColorLUT::GetColors() const
+        {
+            return this->colors;
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned int ColorLUT::GetSize() const
+        {
+            return (unsigned int)this->colors.size();
+        }
+
+        OPENPSTD_SHARED_EXPORT void ColorLUT::MapIndices(const float *values, size_t count, float min, float max,
+                                                         unsigned char *output) const
+        {
+            unsigned int size = std::min(this->GetSize(), 256u);
+            int indices[COLOR_LUT_BLOCK];
+            for (size_t start = 0; start < count; start += COLOR_LUT_BLOCK)
+            {
+                size_t n = std::min(COLOR_LUT_BLOCK, count - start);
+                ComputeIndices(values + start, n, min, max, size, indices);
+                for (size_t i = 0; i < n; i++)
+                {
+                    output[start + i] = (unsigned char)indices[i];
+                }
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT void ColorLUT::MapColors(const float *values, size_t count, float min, float max,
+                                                        QRgb *output) const
+        {
+            const QRgb *table = this->colors.data();
+            int indices[COLOR_LUT_BLOCK];
+            for (size_t start = 0; start < count; start += COLOR_LUT_BLOCK)
+            {
+                size_t n = std::min(COLOR_LUT_BLOCK, count - start);
+                ComputeIndices(values + start, n, min, max, this->GetSize(), indices);
+                for (size_t i = 0; i < n; i++)
+                {
+                    output[start + i] = table[indices[i]];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Converts frames of the results to colors with a precomputed
+//      lookup table, used by the exporters.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_COLORLUT_H
+#define OPENPSTD_COLORLUT_H
+
+#include "openpstd-shared_export.h"
+#include <shared/Colors.h>
+#include <cstddef>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * A color gradient that is sampled once into a table with a fixed number of colors. Mapping a value to a color
+         * is a multiply, a clamp and a table lookup, the loops are written so that the compiler can vectorize them.
+         */
+        class OPENPSTD_SHARED_EXPORT ColorLUT
+        {
+        private:
+            std::vector<QRgb> colors;
+
+        public:
+            /**
+             * Samples the gradient between 0 and 1(both included)
+             * @param size the number of colors in the table
+             */
+            OPENPSTD_SHARED_EXPORT ColorLUT(BaseColorGradient &gradient, unsigned int size);
+
+            /**
+             * The colors of the table, can be used as color table of an indexed image
+             */
+            OPENPSTD_SHARED_EXPORT const std::vector<QRgb> &GetColors() const;
+
+            OPENPSTD_SHARED_EXPORT unsigned int GetSize() const;
+
+            /**
+             * Maps values to indices of the table, min is mapped to the first and max to the last color. Values outside
+             * the range are clamped, values that are not a number are mapped to the first color. The table can have
+             * at most 256 colors.
+             */
+            OPENPSTD_SHARED_EXPORT void MapIndices(const float *values, size_t count, float min, float max,
+                                                   unsigned char *output) const;
+
+            /**
+             * Maps values to colors of the table, with the same mapping as MapIndices
+             */
+            OPENPSTD_SHARED_EXPORT void MapColors(const float *values, size_t count, float min, float max,
+                                                  QRgb *output) const;
+        };
+    }
+}
+
+#endif //OPENPSTD_COLORLUT_H
@@ -153,6 +153,9 @@ namespace OpenPSTD
         OPENPSTD_SHARED_EXPORT QColor BaseColorScheme::EditorReceiverColor()
         { return COLOR_WHITE; }
 
+        OPENPSTD_SHARED_EXPORT std::unique_ptr<BaseColorGradient> BaseColorScheme::ResultsColorGradient()
+        { return COLOR_GRADIENT_WHITE; }
+
 
         OPENPSTD_SHARED_EXPORT QColor StandardColorScheme::EditorBackgroundColor()
         {
@@ -201,5 +204,14 @@ namespace OpenPSTD
         {
             return COLOR_GREEN;
         }
+
+        OPENPSTD_SHARED_EXPORT std::unique_ptr<BaseColorGradient> StandardColorScheme::ResultsColorGradient()
+        {
+            std::unique_ptr<MultiColorGradient> result(new MultiColorGradient());
+            result->AddColor(0, COLOR_BLUE);
+            result->AddColor(0.5f, COLOR_BLACK);
+            result->AddColor(1, COLOR_RED);
+            return std::move(result);
+        }
     }
 }
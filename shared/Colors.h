@@ -155,6 +155,11 @@ namespace OpenPSTD
 
             OPENPSTD_SHARED_EXPORT virtual QColor EditorReceiverColor();
 
+            /**
+             * The gradient of the results, 0 is the most negative value, 0.5 is zero and 1 is the most positive value
+             */
+            OPENPSTD_SHARED_EXPORT virtual std::unique_ptr<BaseColorGradient> ResultsColorGradient();
+
         };
 
 /**
@@ -181,6 +186,11 @@ namespace OpenPSTD
 
             OPENPSTD_SHARED_EXPORT virtual QColor EditorReceiverColor();
 
+            /**
+             * The gradient of the results, 0 is the most negative value, 0.5 is zero and 1 is the most positive value
+             */
+            OPENPSTD_SHARED_EXPORT virtual std::unique_ptr<BaseColorGradient> ResultsColorGradient();
+
         };
     }
 }
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "CommitPolicy.h"
+#include "PSTDFile.h"
+#include <algorithm>
+#include <sstream>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        using namespace std::chrono;
+
+        OPENPSTD_SHARED_EXPORT bool CommitPolicy::IsEnabled() const
+        {
+            return this->Frames > 0 || this->Megabytes > 0 || this->Seconds > 0;
+        }
+
+        OPENPSTD_SHARED_EXPORT CommitPolicy CommitPolicy::Default()
+        {
+            CommitPolicy policy;
+            policy.Megabytes = 256;
+            policy.Seconds = 30;
+            return policy;
+        }
+
+        OPENPSTD_SHARED_EXPORT double CommitMetrics::AverageSeconds() const
+        {
+            if(this->Count == 0)
+                return 0;
+            return this->TotalSeconds / this->Count;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::string CommitMetrics::ToString() const
+        {
+            std::ostringstream ss;
+            ss << "commits: " << this->Count
+               << ", committed: " << this->BytesCommitted / (1024.0 * 1024.0) << " MB"
+               << ", latency avg: " << this->AverageSeconds() * 1000 << " ms"
+               << ", max: " << this->MaxSeconds * 1000 << " ms"
+               << ", total: " << this->TotalSeconds << " s";
+            return ss.str();
+        }
+
+        OPENPSTD_SHARED_EXPORT PeriodicCommitter::PeriodicCommitter(CommitPolicy policy):
+                policy(policy),
+                pendingFrames(0),
+                pendingBytes(0),
+                lastCommit(steady_clock::now())
+        {
+        }
+
+        OPENPSTD_SHARED_EXPORT bool PeriodicCommitter::FrameWritten(PSTDFile *file, unsigned long long bytes)
+        {
+            this->pendingFrames++;
+            return this->DataWritten(file, bytes);
+        }
+
+        OPENPSTD_SHARED_EXPORT bool PeriodicCommitter::DataWritten(PSTDFile *file, unsigned long long bytes)
+        {
+            this->pendingBytes += bytes;
+            if(!this->ShouldCommit())
+                return false;
+
+            this->Commit(file);
+            return true;
+        }
+
+        OPENPSTD_SHARED_EXPORT bool PeriodicCommitter::ShouldCommit() const
+        {
+            if(this->pendingBytes == 0)
+                return false;
+
+            if(this->policy.Frames > 0 && this->pendingFrames >= this->policy.Frames)
+                return true;
+
+            if(this->policy.Megabytes > 0 && this->pendingBytes >= this->policy.Megabytes * 1024 * 1024)
+                return true;
+
+            if(this->policy.Seconds > 0)
+            {
+                duration<double> elapsed = steady_clock::now() - this->lastCommit;
+                if(elapsed.count() >= this->policy.Seconds)
+                    return true;
+            }
+
+            return false;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PeriodicCommitter::Commit(PSTDFile *file)
+        {
+            steady_clock::time_point start = steady_clock::now();
+            file->Commit();
+            steady_clock::time_point end = steady_clock::now();
+
+            double latency = duration<double>(end - start).count();
+            this->metrics.Count++;
+            this->metrics.LastSeconds = latency;
+            this->metrics.TotalSeconds += latency;
+            this->metrics.MaxSeconds = std::max(this->metrics.MaxSeconds, latency);
+            this->metrics.BytesCommitted += this->pendingBytes;
+
+            this->pendingFrames = 0;
+            this->pendingBytes = 0;
+            this->lastCommit = end;
+        }
+
+        OPENPSTD_SHARED_EXPORT CommitMetrics PeriodicCommitter::GetMetrics() const
+        {
+            return this->metrics;
+        }
+
+        OPENPSTD_SHARED_EXPORT CommitPolicy PeriodicCommitter::GetPolicy() const
+        {
+            return this->policy;
+        }
+    }
+}
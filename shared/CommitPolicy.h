@@ -0,0 +1,146 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Decides when the results of a running simulation are committed to
+//      the PSTD file, so that the journal of the file does not grow with
+//      the size of the results.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_COMMITPOLICY_H
+#define OPENPSTD_COMMITPOLICY_H
+
+#include "openpstd-shared_export.h"
+#include <chrono>
+#include <string>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        class PSTDFile;
+
+        /**
+         * The thresholds of the commit policy, a value of 0 disables that threshold.
+         */
+        class OPENPSTD_SHARED_EXPORT CommitPolicy
+        {
+        public:
+            /**
+             * Commit after this number of frames are written
+             */
+            unsigned int Frames = 0;
+
+            /**
+             * Commit after this number of megabytes are written, counted as they are stored in the file(e.g. after
+             * the compression of the frames)
+             */
+            double Megabytes = 0;
+
+            /**
+             * Commit after this number of seconds after the last commit
+             */
+            double Seconds = 0;
+
+            /**
+             * True if at least one of the thresholds is set
+             */
+            OPENPSTD_SHARED_EXPORT bool IsEnabled() const;
+
+            /**
+             * The thresholds that the CLI uses if they are not configured: every 256 megabytes or every 30 seconds, so
+             * that an interrupted simulation keeps most of its results. The GUI does not commit periodically by
+             * default, a commit also saves the unsaved changes of the document.
+             */
+            OPENPSTD_SHARED_EXPORT static CommitPolicy Default();
+        };
+
+        /**
+         * Statistics about the commits that are done
+         */
+        class OPENPSTD_SHARED_EXPORT CommitMetrics
+        {
+        public:
+            unsigned int Count = 0;
+            double TotalSeconds = 0;
+            double MaxSeconds = 0;
+            double LastSeconds = 0;
+            unsigned long long BytesCommitted = 0;
+
+            /**
+             * Average latency of a single commit in seconds
+             */
+            OPENPSTD_SHARED_EXPORT double AverageSeconds() const;
+
+            /**
+             * Human readable summary of the metrics
+             */
+            OPENPSTD_SHARED_EXPORT std::string ToString() const;
+        };
+
+        /**
+         * Keeps track of the data that is written to a file and commits the file when one of the thresholds of the
+         * policy is reached.
+         */
+        class OPENPSTD_SHARED_EXPORT PeriodicCommitter
+        {
+        private:
+            CommitPolicy policy;
+            CommitMetrics metrics;
+            unsigned int pendingFrames;
+            unsigned long long pendingBytes;
+            std::chrono::steady_clock::time_point lastCommit;
+
+        public:
+            OPENPSTD_SHARED_EXPORT PeriodicCommitter(CommitPolicy policy);
+
+            /**
+             * Registers a written frame, the file is committed if the policy requires this.
+             * @param bytes: the number of bytes that are stored for the frame(see PSTDFile::SaveNextResultsFrame)
+             * @return true if the file was committed
+             */
+            OPENPSTD_SHARED_EXPORT bool FrameWritten(PSTDFile *file, unsigned long long bytes);
+
+            /**
+             * Registers written data that is not a frame(e.g. receiver samples), the file is committed if the policy
+             * requires this.
+             * @return true if the file was committed
+             */
+            OPENPSTD_SHARED_EXPORT bool DataWritten(PSTDFile *file, unsigned long long bytes);
+
+            /**
+             * True if the pending data should be committed according to the policy
+             */
+            OPENPSTD_SHARED_EXPORT bool ShouldCommit() const;
+
+            /**
+             * Commits the file unconditionally and measures the latency
+             */
+            OPENPSTD_SHARED_EXPORT void Commit(PSTDFile *file);
+
+            OPENPSTD_SHARED_EXPORT CommitMetrics GetMetrics() const;
+
+            OPENPSTD_SHARED_EXPORT CommitPolicy GetPolicy() const;
+        };
+    }
+}
+
+#endif //OPENPSTD_COMMITPOLICY_H
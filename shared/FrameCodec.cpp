@@ -0,0 +1,292 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "FrameCodec.h"
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/copy.hpp>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        namespace io = boost::iostreams;
+
+        OPENPSTD_SHARED_EXPORT const char *FrameCodecException::what() const noexcept
+        {
+            return "The stored frame can not be decoded";
+        }
+
+        /**
+         * Header of a frame in the visualization storage, followed by the quantized values
+         */
+        struct VisualizationHeader
+        {
+            uint32_t count;
+            //0 for floats, 8 or 16
+            uint32_t bits;
+            float offset;
+            float scale;
+        };
+
+        OPENPSTD_SHARED_EXPORT FrameCodec::FrameCodec(Kernel::FRAMESTORAGE storage, float errorBound):
+                storage(storage),
+                errorBound(errorBound)
+        {
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameCodec FrameCodec::FromSettings(Kernel::PSTDSettings settings)
+        {
+            return FrameCodec(settings.GetFrameStorage(), settings.GetVisualizationErrorBound());
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::FRAMESTORAGE FrameCodec::GetStorage() const
+        {
+            return this->storage;
+        }
+
+        OPENPSTD_SHARED_EXPORT float FrameCodec::GetErrorBound() const
+        {
+            return this->errorBound;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<char> FrameCodec::Encode(const Kernel::PSTD_FRAME &frame) const
+        {
+            if(this->storage == Kernel::FRAMESTORAGE::LOSSLESS)
+            {
+                return this->EncodeLossless(frame);
+            }
+            else if(this->storage == Kernel::FRAMESTORAGE::VISUALIZATION)
+            {
+                return this->EncodeVisualization(frame);
+            }
+
+            const char *data = (const char *) frame.data();
+            return std::vector<char>(data, data + frame.size() * sizeof(Kernel::PSTD_FRAME_UNIT));
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR FrameCodec::Decode(const char *data, unsigned long long length) const
+        {
+            if(this->storage == Kernel::FRAMESTORAGE::LOSSLESS)
+            {
+                return this->DecodeLossless(data, length);
+            }
+            else if(this->storage == Kernel::FRAMESTORAGE::VISUALIZATION)
+            {
+                return this->DecodeVisualization(data, length);
+            }
+
+            const Kernel::PSTD_FRAME_UNIT *values = (const Kernel::PSTD_FRAME_UNIT *) data;
+            return std::make_shared<Kernel::PSTD_FRAME>(values, values + length / sizeof(Kernel::PSTD_FRAME_UNIT));
+        }
+
+        std::vector<char> FrameCodec::EncodeLossless(const Kernel::PSTD_FRAME &frame) const
+        {
+            uint32_t n = frame.size();
+
+            //xor with the previous value and shuffle the bytes
+            std::vector<char> shuffled(n * sizeof(uint32_t));
+            uint32_t previous = 0;
+            for(uint32_t i = 0; i < n; i++)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, &frame[i], sizeof(uint32_t));
+                uint32_t delta = bits ^ previous;
+                previous = bits;
+
+                for(unsigned int b = 0; b < sizeof(uint32_t); b++)
+                {
+                    shuffled[b * n + i] = (char) ((delta >> (8 * b)) & 0xFF);
+                }
+            }
+
+            //header with the number of values, followed by the compressed data
+            std::vector<char> result(sizeof(uint32_t));
+            std::memcpy(result.data(), &n, sizeof(uint32_t));
+            {
+                io::filtering_ostream output;
+                output.push(io::zlib_compressor(io::zlib_params(io::zlib::best_speed)));
+                output.push(io::back_inserter(result));
+                output.write(shuffled.data(), shuffled.size());
+            }//the compressor is flushed when the stream is destroyed
+
+            return result;
+        }
+
+        Kernel::PSTD_FRAME_PTR FrameCodec::DecodeLossless(const char *data, unsigned long long length) const
+        {
+            if(length < sizeof(uint32_t))
+                throw FrameCodecException();
+
+            uint32_t n;
+            std::memcpy(&n, data, sizeof(uint32_t));
+
+            //deflate compresses at most 1032:1, a larger number of values can only come from a corrupt header and
+            //is not allocated
+            unsigned long long compressedLength = length - sizeof(uint32_t);
+            if((unsigned long long)n * sizeof(uint32_t) > compressedLength * 1032)
+                throw FrameCodecException();
+
+            std::vector<char> shuffled((size_t)n * sizeof(uint32_t));
+            try
+            {
+                io::filtering_istream input;
+                input.push(io::zlib_decompressor());
+                input.push(io::array_source(data + sizeof(uint32_t), compressedLength));
+                input.read(shuffled.data(), shuffled.size());
+                if(input.gcount() != (std::streamsize)shuffled.size())
+                    throw FrameCodecException();
+            }
+            catch(const io::zlib_error &)
+            {
+                throw FrameCodecException();
+            }
+            catch(const std::ios_base::failure &)
+            {
+                throw FrameCodecException();
+            }
+
+            Kernel::PSTD_FRAME_PTR result = std::make_shared<Kernel::PSTD_FRAME>(n);
+            uint32_t previous = 0;
+            for(uint32_t i = 0; i < n; i++)
+            {
+                uint32_t delta = 0;
+                for(unsigned int b = 0; b < sizeof(uint32_t); b++)
+                {
+                    delta |= ((uint32_t) (unsigned char) shuffled[b * n + i]) << (8 * b);
+                }
+                previous ^= delta;
+                std::memcpy(&(*result)[i], &previous, sizeof(uint32_t));
+            }
+
+            return result;
+        }
+
+        std::vector<char> FrameCodec::EncodeVisualization(const Kernel::PSTD_FRAME &frame) const
+        {
+            VisualizationHeader header;
+            header.count = frame.size();
+            header.bits = 0;
+            header.offset = 0;
+            header.scale = 0;
+
+            float min = 0, max = 0;
+            if(!frame.empty())
+            {
+                auto minmax = std::minmax_element(frame.begin(), frame.end());
+                min = *minmax.first;
+                max = *minmax.second;
+            }
+
+            //the allowed absolute error, half a quantization step is the maximum error of rounding
+            float peak = std::max(std::abs(min), std::abs(max));
+            double allowedError = peak * std::pow(10.0, this->errorBound / 20.0);
+            double range = (double)max - (double)min;
+
+            bool finite = std::all_of(frame.begin(), frame.end(), [](float v) { return std::isfinite(v); });
+            if(finite && std::isfinite(range))
+            {
+                if(range / 255.0 / 2.0 <= allowedError)
+                    header.bits = 8;
+                else if(range / 65535.0 / 2.0 <= allowedError)
+                    header.bits = 16;
+            }
+
+            unsigned int valueSize = header.bits == 0 ? sizeof(Kernel::PSTD_FRAME_UNIT) : header.bits / 8;
+            std::vector<char> result(sizeof(VisualizationHeader) + header.count * valueSize);
+            char *values = result.data() + sizeof(VisualizationHeader);
+
+            if(header.bits == 0)
+            {
+                std::memcpy(values, frame.data(), header.count * sizeof(Kernel::PSTD_FRAME_UNIT));
+            }
+            else
+            {
+                double levels = header.bits == 8 ? 255.0 : 65535.0;
+                header.offset = min;
+                header.scale = (float)(range / levels);
+                double invScale = header.scale > 0 ? 1.0 / header.scale : 0;
+
+                for(uint32_t i = 0; i < header.count; i++)
+                {
+                    double q = std::round((frame[i] - min) * invScale);
+                    q = std::min(std::max(q, 0.0), levels);
+                    if(header.bits == 8)
+                    {
+                        ((uint8_t *)values)[i] = (uint8_t)q;
+                    }
+                    else
+                    {
+                        uint16_t q16 = (uint16_t)q;
+                        std::memcpy(values + i * sizeof(uint16_t), &q16, sizeof(uint16_t));
+                    }
+                }
+            }
+
+            std::memcpy(result.data(), &header, sizeof(VisualizationHeader));
+            return result;
+        }
+
+        Kernel::PSTD_FRAME_PTR FrameCodec::DecodeVisualization(const char *data, unsigned long long length) const
+        {
+            if(length < sizeof(VisualizationHeader))
+                throw FrameCodecException();
+
+            VisualizationHeader header;
+            std::memcpy(&header, data, sizeof(VisualizationHeader));
+            const char *values = data + sizeof(VisualizationHeader);
+
+            if(header.bits != 0 && header.bits != 8 && header.bits != 16)
+                throw FrameCodecException();
+
+            unsigned int valueSize = header.bits == 0 ? sizeof(Kernel::PSTD_FRAME_UNIT) : header.bits / 8;
+            if(length < sizeof(VisualizationHeader) + (unsigned long long)header.count * valueSize)
+                throw FrameCodecException();
+
+            Kernel::PSTD_FRAME_PTR result = std::make_shared<Kernel::PSTD_FRAME>(header.count);
+            if(header.bits == 0)
+            {
+                std::memcpy(result->data(), values, header.count * sizeof(Kernel::PSTD_FRAME_UNIT));
+            }
+            else if(header.bits == 8)
+            {
+                for(uint32_t i = 0; i < header.count; i++)
+                {
+                    (*result)[i] = header.offset + ((const uint8_t *)values)[i] * header.scale;
+                }
+            }
+            else
+            {
+                for(uint32_t i = 0; i < header.count; i++)
+                {
+                    uint16_t q;
+                    std::memcpy(&q, values + i * sizeof(uint16_t), sizeof(uint16_t));
+                    (*result)[i] = header.offset + q * header.scale;
+                }
+            }
+
+            return result;
+        }
+    }
+}
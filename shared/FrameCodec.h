@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Encoding and decoding of the frames of the results as they are
+//      stored in the PSTD file.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_FRAMECODEC_H
+#define OPENPSTD_FRAMECODEC_H
+
+#include "openpstd-shared_export.h"
+#include <kernel/GeneralTypes.h>
+#include <kernel/KernelInterface.h>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Error while decoding a stored frame
+         */
+        class OPENPSTD_SHARED_EXPORT FrameCodecException : public std::exception
+        {
+        public:
+            OPENPSTD_SHARED_EXPORT const char *what() const noexcept override;
+        };
+
+        /**
+         * Converts frames to the stored representation and back.
+         *
+         * The lossless codec XORs every value with its predecessor, so that the sign and exponent bits of correlated
+         * neighbours become zero, shuffles the bytes so that equal byte positions are next to each other and compresses
+         * the result with deflate.
+         *
+         * The visualization codec quantizes every frame to 8 or 16 bits with a scale and offset per frame. The smallest
+         * number of bits is chosen for which the error stays below the error bound(in dB relative to the peak of the
+         * frame). Frames that can not meet the bound with 16 bits are stored as floats.
+         */
+        class OPENPSTD_SHARED_EXPORT FrameCodec
+        {
+        private:
+            Kernel::FRAMESTORAGE storage;
+            float errorBound;
+
+            std::vector<char> EncodeLossless(const Kernel::PSTD_FRAME &frame) const;
+
+            Kernel::PSTD_FRAME_PTR DecodeLossless(const char *data, unsigned long long length) const;
+
+            std::vector<char> EncodeVisualization(const Kernel::PSTD_FRAME &frame) const;
+
+            Kernel::PSTD_FRAME_PTR DecodeVisualization(const char *data, unsigned long long length) const;
+
+        public:
+            /**
+             * @param storage the storage of the frames
+             * @param errorBound the maximum error of the visualization storage in dB relative to the peak of the frame
+             */
+            OPENPSTD_SHARED_EXPORT FrameCodec(Kernel::FRAMESTORAGE storage = Kernel::FRAMESTORAGE::RAW,
+                                              float errorBound = -60);
+
+            /**
+             * Creates the codec that is selected in the settings of a document
+             */
+            static OPENPSTD_SHARED_EXPORT FrameCodec FromSettings(Kernel::PSTDSettings settings);
+
+            OPENPSTD_SHARED_EXPORT Kernel::FRAMESTORAGE GetStorage() const;
+
+            OPENPSTD_SHARED_EXPORT float GetErrorBound() const;
+
+            /**
+             * Encodes a frame to the representation that is stored
+             */
+            OPENPSTD_SHARED_EXPORT std::vector<char> Encode(const Kernel::PSTD_FRAME &frame) const;
+
+            /**
+             * Decodes a stored frame
+             */
+            OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR Decode(const char *data, unsigned long long length) const;
+        };
+    }
+}
+
+#endif //OPENPSTD_FRAMECODEC_H
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "FramePyramid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        static inline float MaxAbs(float a, float b)
+        {
+            return std::abs(b) > std::abs(a) ? b : a;
+        }
+
+        OPENPSTD_SHARED_EXPORT int FramePyramid::LevelSize(int size, unsigned int level)
+        {
+            int factor = 1 << level;
+            return (size + factor - 1) / factor;
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR FramePyramid::Downsample(const Kernel::PSTD_FRAME &frame,
+                                                                               int width, int height)
+        {
+            int levelWidth = LevelSize(width, 1);
+            int levelHeight = LevelSize(height, 1);
+            Kernel::PSTD_FRAME_PTR result = std::make_shared<Kernel::PSTD_FRAME>(levelWidth * levelHeight);
+
+            for (int j = 0; j < levelHeight; ++j)
+            {
+                //the last row or column is used twice when the size is odd
+                const float *row0 = frame.data() + (2 * j) * width;
+                const float *row1 = frame.data() + std::min(2 * j + 1, height - 1) * width;
+                float *out = result->data() + j * levelWidth;
+                for (int i = 0; i < levelWidth; ++i)
+                {
+                    int i0 = 2 * i;
+                    int i1 = std::min(2 * i + 1, width - 1);
+                    out[i] = MaxAbs(MaxAbs(row0[i0], row0[i1]), MaxAbs(row1[i0], row1[i1]));
+                }
+            }
+
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<Kernel::PSTD_FRAME_PTR> FramePyramid::Build(const Kernel::PSTD_FRAME &frame,
+                                                                                       int width, int height,
+                                                                                       unsigned int levels)
+        {
+            std::vector<Kernel::PSTD_FRAME_PTR> result;
+            if(frame.size() < (size_t)width * height)
+                return result;
+
+            const Kernel::PSTD_FRAME *previous = &frame;
+            for (unsigned int level = 1; level <= levels; ++level)
+            {
+                result.push_back(Downsample(*previous, width, height));
+                previous = result.back().get();
+                width = LevelSize(width, 1);
+                height = LevelSize(height, 1);
+            }
+            return result;
+        }
+    }
+}
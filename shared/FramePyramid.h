@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Decimated versions of the frames of the results, so that previews
+//      do not have to read the frames at full resolution.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_FRAMEPYRAMID_H
+#define OPENPSTD_FRAMEPYRAMID_H
+
+#include "openpstd-shared_export.h"
+#include <kernel/GeneralTypes.h>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Level n of the pyramid has 2^n times less cells in both directions than the frame, level 0 is the frame
+         * itself. Every cell of a level is the value with the largest magnitude of the 2x2 cells of the level below,
+         * so that peaks of the pressure stay visible in the preview.
+         */
+        class OPENPSTD_SHARED_EXPORT FramePyramid
+        {
+        public:
+            /**
+             * The number of cells of a level in a single direction
+             * @param size the number of cells of the frame in that direction
+             */
+            static OPENPSTD_SHARED_EXPORT int LevelSize(int size, unsigned int level);
+
+            /**
+             * Halves the resolution of a frame(row major with y as the outer dimension)
+             */
+            static OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR Downsample(const Kernel::PSTD_FRAME &frame, int width,
+                                                                            int height);
+
+            /**
+             * Creates the levels 1 up to and including levels of a frame
+             * @return the levels, the first element is level 1
+             */
+            static OPENPSTD_SHARED_EXPORT std::vector<Kernel::PSTD_FRAME_PTR> Build(const Kernel::PSTD_FRAME &frame,
+                                                                                    int width, int height,
+                                                                                    unsigned int levels);
+        };
+    }
+}
+
+#endif //OPENPSTD_FRAMEPYRAMID_H
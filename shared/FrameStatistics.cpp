@@ -0,0 +1,150 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "FrameStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Stored statistics, followed by the bins of the histogram
+         */
+        struct StatisticsHeader
+        {
+            float min;
+            float max;
+            float rms;
+            uint32_t bins;
+            uint64_t count;
+        };
+
+        OPENPSTD_SHARED_EXPORT bool FrameStatistics::IsEmpty() const
+        {
+            return this->Count == 0;
+        }
+
+        OPENPSTD_SHARED_EXPORT float FrameStatistics::GetPeak() const
+        {
+            if(this->IsEmpty())
+                return 0;
+            return std::max(std::abs(this->Min), std::abs(this->Max));
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics FrameStatistics::Compute(const Kernel::PSTD_FRAME &frame,
+                                                                        unsigned int histogramBins)
+        {
+            FrameStatistics result;
+            double sumSquares = 0;
+            for(float v : frame)
+            {
+                if(!std::isfinite(v))
+                    continue;
+                result.Min = std::min(result.Min, v);
+                result.Max = std::max(result.Max, v);
+                sumSquares += (double)v * v;
+                result.Count++;
+            }
+
+            if(result.IsEmpty())
+                return result;
+
+            result.RMS = (float)std::sqrt(sumSquares / result.Count);
+
+            if(histogramBins > 0)
+            {
+                result.Histogram = std::vector<unsigned int>(histogramBins, 0);
+                float range = result.Max - result.Min;
+                float scale = range > 0 ? histogramBins / range : 0;
+                for(float v : frame)
+                {
+                    if(!std::isfinite(v))
+                        continue;
+                    unsigned int bin = (unsigned int)((v - result.Min) * scale);
+                    result.Histogram[std::min(bin, histogramBins - 1)]++;
+                }
+            }
+
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics FrameStatistics::Combine(const FrameStatistics &first,
+                                                                        const FrameStatistics &second)
+        {
+            FrameStatistics result;
+            result.Min = std::min(first.Min, second.Min);
+            result.Max = std::max(first.Max, second.Max);
+            result.Count = first.Count + second.Count;
+            if(result.Count > 0)
+            {
+                double sumSquares = (double)first.RMS * first.RMS * first.Count +
+                                    (double)second.RMS * second.RMS * second.Count;
+                result.RMS = (float)std::sqrt(sumSquares / result.Count);
+            }
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<char> FrameStatistics::Encode() const
+        {
+            StatisticsHeader header;
+            header.min = this->Min;
+            header.max = this->Max;
+            header.rms = this->RMS;
+            header.bins = (uint32_t)this->Histogram.size();
+            header.count = this->Count;
+
+            std::vector<char> result(sizeof(header) + this->Histogram.size() * sizeof(uint32_t));
+            std::memcpy(result.data(), &header, sizeof(header));
+            for(size_t i = 0; i < this->Histogram.size(); i++)
+            {
+                uint32_t bin = this->Histogram[i];
+                std::memcpy(result.data() + sizeof(header) + i * sizeof(uint32_t), &bin, sizeof(uint32_t));
+            }
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics FrameStatistics::Decode(const char *data, unsigned long long length)
+        {
+            FrameStatistics result;
+            StatisticsHeader header;
+            if(length < sizeof(header))
+                return result;
+
+            std::memcpy(&header, data, sizeof(header));
+            if(length < sizeof(header) + (unsigned long long)header.bins * sizeof(uint32_t))
+                return result;
+
+            result.Min = header.min;
+            result.Max = header.max;
+            result.RMS = header.rms;
+            result.Count = header.count;
+            result.Histogram.resize(header.bins);
+            for(size_t i = 0; i < header.bins; i++)
+            {
+                uint32_t bin;
+                std::memcpy(&bin, data + sizeof(header) + i * sizeof(uint32_t), sizeof(uint32_t));
+                result.Histogram[i] = bin;
+            }
+            return result;
+        }
+    }
+}
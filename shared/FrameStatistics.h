@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Statistics of the frames of the results, computed when a frame is
+//      written so that readers do not have to touch the frame data.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_FRAMESTATISTICS_H
+#define OPENPSTD_FRAMESTATISTICS_H
+
+#include "openpstd-shared_export.h"
+#include <kernel/GeneralTypes.h>
+#include <limits>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Minimum, maximum and RMS of a frame or of a number of frames. Values that are not finite are skipped.
+         */
+        class OPENPSTD_SHARED_EXPORT FrameStatistics
+        {
+        public:
+            float Min = std::numeric_limits<float>::infinity();
+            float Max = -std::numeric_limits<float>::infinity();
+            float RMS = 0;
+
+            /**
+             * The number of values that are part of the statistics
+             */
+            unsigned long long Count = 0;
+
+            /**
+             * Number of values per bin, the bins are divided equally between Min and Max.
+             * Empty if no histogram is computed.
+             */
+            std::vector<unsigned int> Histogram;
+
+            /**
+             * True if there are no values in the statistics
+             */
+            OPENPSTD_SHARED_EXPORT bool IsEmpty() const;
+
+            /**
+             * The largest absolute value
+             */
+            OPENPSTD_SHARED_EXPORT float GetPeak() const;
+
+            /**
+             * Computes the statistics of a single frame
+             * @param histogramBins the number of bins of the histogram, 0 for no histogram
+             */
+            static OPENPSTD_SHARED_EXPORT FrameStatistics Compute(const Kernel::PSTD_FRAME &frame,
+                                                                  unsigned int histogramBins);
+
+            /**
+             * Statistics of the values of both statistics. The histograms have different bins, so the result has no
+             * histogram.
+             */
+            static OPENPSTD_SHARED_EXPORT FrameStatistics Combine(const FrameStatistics &first,
+                                                                  const FrameStatistics &second);
+
+            /**
+             * The representation that is stored in the PSTD file
+             */
+            OPENPSTD_SHARED_EXPORT std::vector<char> Encode() const;
+
+            /**
+             * Reads the stored representation, data that is too short results in empty statistics
+             */
+            static OPENPSTD_SHARED_EXPORT FrameStatistics Decode(const char *data, unsigned long long length);
+        };
+    }
+}
+
+#endif //OPENPSTD_FRAMESTATISTICS_H
@@ -68,7 +68,7 @@ namespace OpenPSTD
 
         OPENPSTD_SHARED_EXPORT void InvalidationData::Reset()
         {
-            changed = false;
+            changed.exchange(false);
 
             auto i = std::begin(items);
 
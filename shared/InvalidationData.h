@@ -37,6 +37,7 @@
 #define OPENPSTD_INVALIDATIONDATA_H
 
 #include "openpstd-shared_export.h"
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -47,22 +48,40 @@ namespace OpenPSTD
 /**
  * A class that keeps track if something has changed. If it changes than Change has to be called. To check call
  * IsChanged. To reset the change, Reset has to be called. It also keeps children that individually can be changed.
+ *
+ * Change can be called from any thread(e.g. the thread that writes the results of a simulation), the children are
+ * only registered, checked and reset from the GUI thread.
  */
         class OPENPSTD_SHARED_EXPORT InvalidationData
         {
         private:
             std::vector<std::weak_ptr<InvalidationData>> items;
-            bool changed;
+            std::atomic<bool> changed;
 
         public:
             /**
              * Creates a the invalidation class. This initilizes the class that the value has changed.
              */
-            InvalidationData() : changed(true), items()
+            InvalidationData() : items(), changed(true)
             {
 
             }
 
+            /**
+             * Copies the children and the change of another object.
+             */
+            InvalidationData(const InvalidationData &other) : items(other.items), changed(other.changed.load())
+            {
+
+            }
+
+            InvalidationData &operator=(const InvalidationData &other)
+            {
+                this->items = other.items;
+                this->changed = other.changed.load();
+                return *this;
+            }
+
             /**
              * Registers a child that is checked when calling IsChanged. This is a weak_ptr, so that if the object is destroyed,
              * then it will deregister.
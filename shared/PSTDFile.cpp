@@ -27,6 +27,9 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "PSTDFile.h"
+#include "FramePyramid.h"
+#include "TimeSeriesIndex.h"
+#include <kernel/MockKernel.h>
 
 extern "C"
 {
@@ -40,6 +43,8 @@ extern "C"
 #include <boost/iostreams/stream.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/serialization/vector.hpp>
+#include <cstring>
+#include <stdexcept>
 
 namespace OpenPSTD
 {
@@ -47,7 +52,7 @@ namespace OpenPSTD
     {
         using namespace std;
 
-#define PSTD_FILE_VERSION 3
+#define PSTD_FILE_VERSION 4
 
 #define PSTD_FILE_PREFIX_SCENE 1
 
@@ -56,8 +61,42 @@ namespace OpenPSTD
 #define PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT 102
 #define PSTD_FILE_PREFIX_RESULTS_FRAMEDATA 103
 #define PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA 104
+#define PSTD_FILE_PREFIX_RESULTS_FRAME_STATISTICS 105
+#define PSTD_FILE_PREFIX_RESULTS_STATISTICS 106
+#define PSTD_FILE_PREFIX_RESULTS_FRAME_LEVEL 107
+#define PSTD_FILE_PREFIX_RESULTS_TIME_INDEX 108
+#define PSTD_FILE_PREFIX_RESULTS_TIME_INDEX_LAYOUT 109
+#define PSTD_FILE_PREFIX_RESULTS_METADATA 110
+#define PSTD_FILE_PREFIX_RESULTS_PROFILE 111
+
+// all the keys with a prefix in this range have the run as first value, only the records of the current run are used
+#define PSTD_FILE_PREFIX_RESULTS_RUN_SCOPED_BEGIN 102
+#define PSTD_FILE_PREFIX_RESULTS_RUN_SCOPED_END 200
 
 #define PSTD_FILE_PREFIX_VERSION 10000
+#define PSTD_FILE_PREFIX_RESULTS_RUN 10001
+
+// records are committed after this amount of data during compaction
+#define PSTD_FILE_COMPACT_COMMIT_SIZE (64 * 1024 * 1024)
+
+#define PSTD_FILE_DEFAULT_FRAME_CACHE_SIZE (64 * 1024 * 1024)
+
+// the previews are opt-in, levels that are not stored are created from the frame when they are read
+#define PSTD_FILE_DEFAULT_PREVIEW_LEVELS 0
+
+// maximum size of the tiles that are in memory while the time index is build
+#define PSTD_FILE_TIME_INDEX_BUFFER_SIZE (256 * 1024 * 1024)
+
+        /**
+         * The metadata of the results of a scene, the mock kernel derives this from the configuration with the same
+         * discretization as the scene of the kernel(see Kernel::discretize_domain), without creating the scene
+         */
+        static Kernel::SimulationMetadata CreateMetadata(shared_ptr<Kernel::PSTDConfiguration> conf)
+        {
+            Kernel::MockKernel k;
+            k.initialize_kernel(conf);
+            return k.get_metadata();
+        }
 
         std::string PSTDFileKeyToString(PSTDFile_Key_t key)
         {
@@ -80,12 +119,17 @@ namespace OpenPSTD
         OPENPSTD_SHARED_EXPORT PSTDFileVersionException::PSTDFileVersionException(int fileVersion)
         {
             this->FileVersion = fileVersion;
+            this->Message = "Wrong version: " + boost::lexical_cast<std::string>(FileVersion) + "(expected: " +
+                            boost::lexical_cast<std::string>(PSTD_FILE_VERSION) + ")";
+            if(fileVersion == 3)
+            {
+                this->Message += ", the file can be converted with OpenPSTD-cli upgrade";
+            }
         }
 
         OPENPSTD_SHARED_EXPORT const char *PSTDFileVersionException::what() const noexcept
         {
-            return ("Wrong version: " + boost::lexical_cast<std::string>(FileVersion) + "(expected: " +
-                    boost::lexical_cast<std::string>(PSTD_FILE_VERSION) + ")").c_str();
+            return this->Message.c_str();
         }
 
         OPENPSTD_SHARED_EXPORT PSTDFileIOException::PSTDFileIOException(int unqlite_error, PSTDFile_Key_t key, std::string action)
@@ -158,7 +202,7 @@ namespace OpenPSTD
             }
         }
 
-        OPENPSTD_SHARED_EXPORT std::unique_ptr<PSTDFile> PSTDFile::Open(const boost::filesystem::path &path)
+        std::unique_ptr<PSTDFile> PSTDFile::OpenBackend(const boost::filesystem::path &path)
         {
             std::string filename = path.string();
             std::unique_ptr<PSTDFile> result = std::unique_ptr<PSTDFile>(new PSTDFile());
@@ -166,14 +210,38 @@ namespace OpenPSTD
             unqlite_open(&backend, filename.c_str(), UNQLITE_OPEN_CREATE);
             unqlite_config(backend, UNQLITE_CONFIG_DISABLE_AUTO_COMMIT);//commits are done by the save function
             result->backend = std::unique_ptr<unqlite, int (*)(unqlite *)>(backend, unqlite_close);
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::unique_ptr<PSTDFile> PSTDFile::Open(const boost::filesystem::path &path)
+        {
+            //files of older versions are not changed here, they are converted by Upgrade
+            std::unique_ptr<PSTDFile> result = OpenBackend(path);
             int version = result->GetValue<int>(PSTDFile::CreateKey(PSTD_FILE_PREFIX_VERSION, {}));
             if (version != PSTD_FILE_VERSION)
             {
                 throw PSTDFileVersionException(version);
             }
+            result->resultsRun = result->GetValue<unsigned int>(PSTDFile::CreateKey(PSTD_FILE_PREFIX_RESULTS_RUN, {}));
             return result;
         }
 
+        OPENPSTD_SHARED_EXPORT bool PSTDFile::Upgrade(const boost::filesystem::path &path)
+        {
+            std::unique_ptr<PSTDFile> file = OpenBackend(path);
+            int version = file->GetValue<int>(PSTDFile::CreateKey(PSTD_FILE_PREFIX_VERSION, {}));
+            if (version == PSTD_FILE_VERSION)
+            {
+                return false;
+            }
+            else if (version != 3)
+            {
+                throw PSTDFileVersionException(version);
+            }
+            file->UpgradeFromVersion3();
+            return true;
+        }
+
         OPENPSTD_SHARED_EXPORT std::unique_ptr<PSTDFile> PSTDFile::New(const boost::filesystem::path &path)
         {
             std::string filename = path.string();
@@ -187,6 +255,7 @@ namespace OpenPSTD
 
             //add version
             result->SetValue<int>(result->CreateKey(PSTD_FILE_PREFIX_VERSION, {}), PSTD_FILE_VERSION);
+            result->SetValue<unsigned int>(result->CreateKey(PSTD_FILE_PREFIX_RESULTS_RUN, {}), result->resultsRun);
 
             //create basic geometry with default options
             result->SetSceneConf(Kernel::PSTDConfiguration::CreateDefaultConf());
@@ -198,7 +267,12 @@ namespace OpenPSTD
             return result;
         }
 
-        OPENPSTD_SHARED_EXPORT PSTDFile::PSTDFile() : backend(nullptr, unqlite_close)
+        OPENPSTD_SHARED_EXPORT PSTDFile::PSTDFile() : backend(nullptr, unqlite_close),
+                                                      resultsRun(0),
+                                                      resultsGeneration(0),
+                                                      statisticsHistogramBins(0),
+                                                      previewLevels(PSTD_FILE_DEFAULT_PREVIEW_LEVELS),
+                                                      frameCache(PSTD_FILE_DEFAULT_FRAME_CACHE_SIZE)
         {
 
         }
@@ -221,54 +295,461 @@ namespace OpenPSTD
 
         OPENPSTD_SHARED_EXPORT int PSTDFile::GetResultsFrameCount(unsigned int domain)
         {
-            return GetValue<int>(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {domain}));
+            return GetValue<int>(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {domain}));
         }
 
         OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR PSTDFile::GetResultsFrame(unsigned int frame, unsigned int domain)
         {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            auto cached = this->frameCache.Get(this->resultsGeneration, frame, domain);
+            if(cached)
+            {
+                return make_shared<Kernel::PSTD_FRAME>(*cached);
+            }
+
+            return this->ReadResultsFrame(frame, domain);
+        }
+
+        Kernel::PSTD_FRAME_PTR PSTDFile::ReadResultsFrame(unsigned int frame, unsigned int domain, unsigned int level)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame});
+            if(level > 0)
+            {
+                key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_LEVEL, {domain, frame, level});
+
+                //the level is not stored(e.g. written with less levels), it is created from the frame
+                unqlite_int64 nBytes = 0;
+                if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+                {
+                    if(domain >= this->resultsMetadata.DomainMetadata.size())
+                        return nullptr;
+                    auto levels = FramePyramid::Build(*this->ReadResultsFrame(frame, domain, 0),
+                                                      this->resultsMetadata.DomainMetadata[domain][0],
+                                                      this->resultsMetadata.DomainMetadata[domain][1], level);
+                    return levels.empty() ? nullptr : levels.back();
+                }
+            }
+
             unqlite_int64 size;
-            float *result = (float *) this->GetRawValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame}), &size);
-            return make_shared<Kernel::PSTD_FRAME>(result, result + (size / 4));
+            char *data = this->GetRawValue(key, &size);
+            try
+            {
+                Kernel::PSTD_FRAME_PTR result = this->resultsCodec.Decode(data, size);
+                delete[] data;
+                return result;
+            }
+            catch(...)
+            {
+                delete[] data;
+                throw;
+            }
+        }
+
+        static int ConsumeFrameData(const void *data, unsigned int length, void *userData)
+        {
+            auto consumer = (std::function<void(const char *, size_t)> *) userData;
+            (*consumer)((const char *) data, length);
+            return UNQLITE_OK;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::ReadResultsFrameData(unsigned int frame, unsigned int domain,
+                                                                   std::function<void(const char *, size_t)> consumer)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+
+            if(this->resultsCodec.GetStorage() != Kernel::FRAMESTORAGE::RAW)
+            {
+                Kernel::PSTD_FRAME_PTR data = this->GetResultsFrame(frame, domain);
+                consumer((const char *) data->data(), data->size() * sizeof(Kernel::PSTD_FRAME_UNIT));
+                return;
+            }
+
+            //the stored bytes are the values of the frame, unqlite passes them in blocks
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame});
+            int rc = unqlite_kv_fetch_callback(this->backend.get(), key->data(), key->size(),
+                                               &ConsumeFrameData, &consumer);
+            if (rc != UNQLITE_OK)
+            {
+                throw PSTDFileIOException(rc, key, "fetch data");
+            }
         }
 
-        OPENPSTD_SHARED_EXPORT void PSTDFile::SaveNextResultsFrame(unsigned int domain, Kernel::PSTD_FRAME_PTR frameData)
+        OPENPSTD_SHARED_EXPORT unsigned long long PSTDFile::SaveNextResultsFrame(unsigned int domain,
+                                                                                 Kernel::PSTD_FRAME_PTR frameData)
         {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            //the readers use the sizes of the metadata, a frame of another size would be read past its end
+            this->LoadResultsState();
+            if(domain < this->resultsMetadata.DomainMetadata.size())
+            {
+                unsigned long cells = (unsigned long) this->resultsMetadata.DomainMetadata[domain][0] *
+                                      this->resultsMetadata.DomainMetadata[domain][1];
+                if(frameData->size() != cells)
+                {
+                    throw std::invalid_argument("The frame of domain " + std::to_string(domain) + " has " +
+                                                std::to_string(frameData->size()) + " cells, the metadata of the "
+                                                        "results has " + std::to_string(cells) + " cells");
+                }
+            }
             unsigned int frame = IncrementFrameCount(domain);
-            this->SetRawValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame}),
-                              frameData->size() * sizeof(Kernel::PSTD_FRAME_UNIT), frameData->data());
+            std::vector<char> encoded = this->resultsCodec.Encode(*frameData);
+            this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame}),
+                              encoded.size(), encoded.data());
+            unsigned long long written = encoded.size();
+            //frames are immutable after they are written, the caller does not change the data anymore
+            this->frameCache.Put(this->resultsGeneration, frame, domain, frameData);
+
+            if(this->previewLevels > 0 && domain < this->resultsMetadata.DomainMetadata.size())
+            {
+                auto levels = FramePyramid::Build(*frameData, this->resultsMetadata.DomainMetadata[domain][0],
+                                                  this->resultsMetadata.DomainMetadata[domain][1], this->previewLevels);
+                for (unsigned int level = 1; level <= levels.size(); level++)
+                {
+                    encoded = this->resultsCodec.Encode(*levels[level - 1]);
+                    this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_LEVEL, {domain, frame, level}),
+                                      encoded.size(), encoded.data());
+                    written += encoded.size();
+                }
+            }
+
+            FrameStatistics statistics = FrameStatistics::Compute(*frameData, this->statisticsHistogramBins);
+            std::vector<char> encodedStatistics = statistics.Encode();
+            this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_STATISTICS, {domain, frame}),
+                              encodedStatistics.size(), encodedStatistics.data());
+            written += encodedStatistics.size();
+
+            if(domain < this->resultsStatistics.size())
+            {
+                this->resultsStatistics[domain] = FrameStatistics::Combine(this->resultsStatistics[domain], statistics);
+                encodedStatistics = this->resultsStatistics[domain].Encode();
+                this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_STATISTICS, {domain}),
+                                  encodedStatistics.size(), encodedStatistics.data());
+                written += encodedStatistics.size();
+            }
+            return written;
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR PSTDFile::GetResultsFrameLevel(unsigned int frame,
+                                                                                     unsigned int domain,
+                                                                                     unsigned int level)
+        {
+            if(level == 0)
+                return this->GetResultsFrame(frame, domain);
+
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            auto cached = this->frameCache.Get(this->resultsGeneration, frame, domain, level);
+            if(cached)
+            {
+                return make_shared<Kernel::PSTD_FRAME>(*cached);
+            }
+
+            Kernel::PSTD_FRAME_PTR result = this->ReadResultsFrame(frame, domain, level);
+            if(!result)
+                return nullptr;
+
+            this->frameCache.Put(this->resultsGeneration, frame, domain, result, level);
+            return make_shared<Kernel::PSTD_FRAME>(*result);
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<int> PSTDFile::GetResultsFrameLevelSize(unsigned int domain,
+                                                                                   unsigned int level)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+            if(domain >= this->resultsMetadata.DomainMetadata.size())
+                return {0, 0};
+            return {FramePyramid::LevelSize(this->resultsMetadata.DomainMetadata[domain][0], level),
+                    FramePyramid::LevelSize(this->resultsMetadata.DomainMetadata[domain][1], level)};
+        }
+
+        OPENPSTD_SHARED_EXPORT bool PSTDFile::IsResultsFrameLevelStored(unsigned int frame, unsigned int domain,
+                                                                        unsigned int level)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {domain, frame});
+            if(level > 0)
+            {
+                key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_LEVEL, {domain, frame, level});
+            }
+            unqlite_int64 nBytes = 0;
+            return unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) == UNQLITE_OK;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::SetPreviewLevels(unsigned int levels)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->previewLevels = levels;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::BuildTimeSeriesIndex(unsigned int tileSize, unsigned int blockFrames,
+                                                                   std::function<void(float)> progress)
+        {
+            std::vector<TimeSeriesLayout> layouts;
+            std::vector<unsigned int> firstBlocks;
+            unsigned int generation;
+            unsigned long long totalBlocks = 0;
+            {
+                //the lock is only held for the reads and writes, so that snapshot readers are not blocked
+                boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+                this->LoadResultsState();
+                generation = this->resultsGeneration;
+                for(unsigned int d = 0; d < this->writtenFrameCounts.size(); d++)
+                {
+                    TimeSeriesLayout layout;
+                    layout.TileSize = tileSize;
+                    layout.BlockFrames = blockFrames;
+                    layout.Width = this->resultsMetadata.DomainMetadata[d][0];
+                    layout.Height = this->resultsMetadata.DomainMetadata[d][1];
+                    layout.Frames = (unsigned int)this->writtenFrameCounts[d];
+
+                    //only the blocks after the existing index are created, the last block of it can be incomplete
+                    TimeSeriesLayout existing = this->GetTimeSeriesLayout(d);
+                    unsigned int firstBlock = 0;
+                    if(existing.IsCompatible(layout) && existing.Frames <= layout.Frames)
+                        firstBlock = existing.Frames / blockFrames;
+
+                    layouts.push_back(layout);
+                    firstBlocks.push_back(firstBlock);
+                    totalBlocks += layout.GetBlockCount() - std::min(firstBlock, layout.GetBlockCount());
+                }
+            }
+
+            unsigned long long doneBlocks = 0;
+            for(unsigned int d = 0; d < layouts.size(); d++)
+            {
+                const TimeSeriesLayout &layout = layouts[d];
+                for(unsigned int block = firstBlocks[d]; block < layout.GetBlockCount(); block++)
+                {
+                    unsigned int length = layout.GetBlockLength(block);
+                    unsigned long long tileRowBytes = (unsigned long long)layout.Width * layout.TileSize * length *
+                                                      sizeof(Kernel::PSTD_FRAME_UNIT);
+                    int tileRowsPerPass = (int)std::max(1ull, PSTD_FILE_TIME_INDEX_BUFFER_SIZE / tileRowBytes);
+
+                    for(int firstTileY = 0; firstTileY < layout.GetTilesY(); firstTileY += tileRowsPerPass)
+                    {
+                        int lastTileY = std::min(firstTileY + tileRowsPerPass, layout.GetTilesY());
+                        std::vector<Kernel::PSTD_FRAME> tiles;
+                        for(int tileY = firstTileY; tileY < lastTileY; tileY++)
+                        {
+                            for(int tileX = 0; tileX < layout.GetTilesX(); tileX++)
+                            {
+                                tiles.emplace_back((size_t)layout.GetTileWidth(tileX) * layout.GetTileHeight(tileY) *
+                                                   length);
+                            }
+                        }
+
+                        for(unsigned int i = 0; i < length; i++)
+                        {
+                            Kernel::PSTD_FRAME_PTR frame;
+                            {
+                                boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+                                if(generation != this->resultsGeneration)
+                                    return;
+                                frame = this->ReadResultsFrame(block * layout.BlockFrames + i, d);
+                            }
+
+                            int firstY = firstTileY * layout.TileSize;
+                            int lastY = std::min(lastTileY * (int)layout.TileSize, layout.Height);
+                            for(int y = firstY; y < lastY; y++)
+                            {
+                                const float *row = frame->data() + (size_t)y * layout.Width;
+                                for(int x = 0; x < layout.Width; x++)
+                                {
+                                    int tile = (y / layout.TileSize - firstTileY) * layout.GetTilesX() +
+                                               x / layout.TileSize;
+                                    tiles[tile][layout.GetCellOffset(x, y, block) + i] = row[x];
+                                }
+                            }
+                        }
+
+                        boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+                        if(generation != this->resultsGeneration)
+                            return;
+                        for(int tileY = firstTileY; tileY < lastTileY; tileY++)
+                        {
+                            for(int tileX = 0; tileX < layout.GetTilesX(); tileX++)
+                            {
+                                auto &tile = tiles[(tileY - firstTileY) * layout.GetTilesX() + tileX];
+                                std::vector<char> encoded = this->resultsCodec.Encode(tile);
+                                this->SetRawValue(CreateTimeSeriesKey(d, layout, block, tileY, tileX),
+                                                  encoded.size(), encoded.data());
+                            }
+                        }
+                    }
+
+                    doneBlocks++;
+                    if(progress)
+                        progress(doneBlocks / (float)totalBlocks);
+                }
+
+                //the layout is written last and the tiles of the blocks of the existing index are never written with
+                //another length(see CreateTimeSeriesKey), so an interrupted build leaves the existing index valid
+                boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+                if(generation != this->resultsGeneration)
+                    return;
+                std::vector<char> encodedLayout = layout.Encode();
+                this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_TIME_INDEX_LAYOUT, {d}),
+                                  encodedLayout.size(), encodedLayout.data());
+            }
+        }
+
+        PSTDFile_Key_t PSTDFile::CreateTimeSeriesKey(unsigned int domain, const TimeSeriesLayout &layout,
+                                                     unsigned int block, unsigned int tileY, unsigned int tileX)
+        {
+            //the tile size and the length of the block are part of the key, an extended block is written as a new
+            //record instead of overwriting the record of the incomplete block
+            return CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_TIME_INDEX,
+                                    {domain, layout.TileSize, layout.BlockFrames, block, layout.GetBlockLength(block),
+                                     tileY, tileX});
+        }
+
+        OPENPSTD_SHARED_EXPORT TimeSeriesLayout PSTDFile::GetTimeSeriesLayout(unsigned int domain)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_TIME_INDEX_LAYOUT, {domain});
+            unqlite_int64 nBytes = 0;
+            if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+                return TimeSeriesLayout();
+
+            char *data = this->GetRawValue(key, &nBytes);
+            TimeSeriesLayout result = TimeSeriesLayout::Decode(data, nBytes);
+            delete[] data;
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_RECEIVER_DATA_PTR PSTDFile::GetResultsTimeSeries(unsigned int domain, int x,
+                                                                                             int y)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+            if(domain >= this->resultsMetadata.DomainMetadata.size() || x < 0 || y < 0 ||
+               x >= this->resultsMetadata.DomainMetadata[domain][0] || y >= this->resultsMetadata.DomainMetadata[domain][1])
+            {
+                throw std::out_of_range("cell is not part of the domain");
+            }
+
+            Kernel::PSTD_RECEIVER_DATA_PTR result = make_shared<Kernel::PSTD_RECEIVER_DATA>();
+            TimeSeriesLayout layout = this->GetTimeSeriesLayout(domain);
+            const std::vector<int> &size = this->resultsMetadata.DomainMetadata[domain];
+            if(layout.Width != size[0] || layout.Height != size[1])
+                layout = TimeSeriesLayout();
+
+            for(unsigned int block = 0; block < layout.GetBlockCount(); block++)
+            {
+                unqlite_int64 size;
+                char *data = this->GetRawValue(CreateTimeSeriesKey(domain, layout, block, y / layout.TileSize,
+                                                                   x / layout.TileSize), &size);
+                Kernel::PSTD_FRAME_PTR tile;
+                try
+                {
+                    tile = this->resultsCodec.Decode(data, size);
+                    delete[] data;
+                }
+                catch(...)
+                {
+                    delete[] data;
+                    throw;
+                }
+
+                auto begin = tile->begin() + layout.GetCellOffset(x, y, block);
+                result->insert(result->end(), begin, begin + layout.GetBlockLength(block));
+            }
+
+            //the frames that are written after the index was build are read one by one
+            size_t cell = (size_t)y * size[0] + x;
+            for(int frame = layout.Frames; frame < this->writtenFrameCounts[domain]; frame++)
+            {
+                result->push_back((*this->GetResultsFrame(frame, domain))[cell]);
+            }
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics PSTDFile::GetResultsFrameStatistics(unsigned int frame, unsigned int domain)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            FrameStatistics result = this->ReadStatistics(
+                    CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_STATISTICS, {domain, frame}));
+            if(result.IsEmpty())
+            {
+                result = FrameStatistics::Compute(*this->GetResultsFrame(frame, domain), this->statisticsHistogramBins);
+            }
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics PSTDFile::GetResultsStatistics(unsigned int domain)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+            if(domain >= this->resultsStatistics.size())
+                return FrameStatistics();
+            return this->resultsStatistics[domain];
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::SetStatisticsHistogramBins(unsigned int bins)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->statisticsHistogramBins = bins;
+        }
+
+        FrameStatistics PSTDFile::ReadStatistics(PSTDFile_Key_t key)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            unqlite_int64 nBytes = 0;
+            if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+                return FrameStatistics();
+
+            char *data = this->GetRawValue(key, &nBytes);
+            FrameStatistics result = FrameStatistics::Decode(data, nBytes);
+            delete[] data;
+            return result;
         }
 
         OPENPSTD_SHARED_EXPORT void PSTDFile::InitializeResults()
         {
-            auto conf = GetSceneConf();
+            this->InitializeResults(GetSceneConf());
+        }
+
+        void PSTDFile::InitializeResults(std::shared_ptr<Kernel::PSTDConfiguration> conf)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
             SetSceneConf(CreateKey(PSTD_FILE_PREFIX_RESULTS_SCENE, {}), conf);
             for (unsigned int i = 0; i < conf->Domains.size(); i++)
             {
-                SetValue<int>(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {i}), 0);
+                SetValue<int>(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {i}), 0);
             }
 
             for(unsigned int i = 0; i < conf->Receivers.size(); i++)
             {
                 //create empty records for the receivers
-                SetRawValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {i}), 0, nullptr);
+                SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {i}), 0, nullptr);
             }
+
+            this->ResetResultsState();
+            this->resultsConf = conf;
+            this->resultsCodec = FrameCodec::FromSettings(conf->Settings);
+            this->writtenFrameCounts = std::vector<int>(conf->Domains.size(), 0);
+            this->resultsStatistics = std::vector<FrameStatistics>(conf->Domains.size());
+            this->resultsMetadata = CreateMetadata(conf);
+            this->SetMetadata(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_METADATA, {}), this->resultsMetadata);
+            this->PublishResults();
         }
 
         OPENPSTD_SHARED_EXPORT void PSTDFile::DeleteResults()
         {
-            int rc;
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
 
-            int domainCount = this->GetResultsDomainCount();
-            for (unsigned int d = 0; d < domainCount; d++)
-            {
-                int frameCount = this->GetResultsFrameCount(d);
-                for (unsigned int f = 0; f < frameCount; f++)
-                {
-                    this->DeleteValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {d, f}));
-                }
-                this->DeleteValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {d}));
-            }
+            //start a new run, the records of the old run are not used anymore and are removed by Compact
+            this->resultsRun++;
+            this->SetValue<unsigned int>(CreateKey(PSTD_FILE_PREFIX_RESULTS_RUN, {}), this->resultsRun);
             this->SetSceneConf(CreateKey(PSTD_FILE_PREFIX_RESULTS_SCENE, {}), Kernel::PSTDConfiguration::CreateEmptyConf());
+
+            this->ResetResultsState();
+            this->PublishResults();
         }
 
         OPENPSTD_SHARED_EXPORT void PSTDFile::OutputDebugInfo()
@@ -426,6 +907,102 @@ namespace OpenPSTD
             }
         }
 
+        OPENPSTD_SHARED_EXPORT Kernel::SimulationMetadata PSTDFile::GetResultsMetadata()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+            return this->resultsMetadata;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::SaveResultsProfile(const Kernel::KernelProfile &profile)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            namespace io = boost::iostreams;
+            typedef std::vector<char> buffer_type;
+            buffer_type buffer;
+
+            io::stream<io::back_insert_device<buffer_type> > output_stream(buffer);
+            boost::archive::text_oarchive oa(output_stream);
+
+            oa << profile;
+            output_stream.flush();
+            this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_PROFILE, {}), buffer.size(), buffer.data());
+        }
+
+        OPENPSTD_SHARED_EXPORT std::shared_ptr<Kernel::KernelProfile> PSTDFile::GetResultsProfile()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_PROFILE, {});
+            unqlite_int64 nBytes = 0;
+            if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+            {
+                //the run was not profiled
+                return nullptr;
+            }
+
+            namespace io = boost::iostreams;
+            char *data = this->GetRawValue(key, &nBytes);
+            try
+            {
+                auto result = make_shared<Kernel::KernelProfile>();
+                io::basic_array_source<char> source(data, nBytes);
+                io::stream<io::basic_array_source<char> > input_stream(source);
+                boost::archive::text_iarchive ia(input_stream);
+                ia >> (*result);
+                delete[] data;
+                return result;
+            }
+            catch(...)
+            {
+                delete[] data;
+                throw;
+            }
+        }
+
+        Kernel::SimulationMetadata PSTDFile::ReadMetadata(shared_ptr<Kernel::PSTDConfiguration> conf)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_METADATA, {});
+            unqlite_int64 nBytes = 0;
+            if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+            {
+                //results that are written before the metadata was stored
+                return CreateMetadata(conf);
+            }
+
+            namespace io = boost::iostreams;
+            char *data = this->GetRawValue(key, &nBytes);
+            try
+            {
+                Kernel::SimulationMetadata result;
+                io::basic_array_source<char> source(data, nBytes);
+                io::stream<io::basic_array_source<char> > input_stream(source);
+                boost::archive::text_iarchive ia(input_stream);
+                ia >> result;
+                delete[] data;
+                return result;
+            }
+            catch(...)
+            {
+                delete[] data;
+                throw;
+            }
+        }
+
+        void PSTDFile::SetMetadata(PSTDFile_Key_t key, const Kernel::SimulationMetadata &metadata)
+        {
+            namespace io = boost::iostreams;
+            typedef std::vector<char> buffer_type;
+            buffer_type buffer;
+
+            io::stream<io::back_insert_device<buffer_type> > output_stream(buffer);
+            boost::archive::text_oarchive oa(output_stream);
+
+            oa << metadata;
+            output_stream.flush();
+            this->SetRawValue(key, buffer.size(), buffer.data());
+        }
+
         OPENPSTD_SHARED_EXPORT void PSTDFile::SetSceneConf(PSTDFile_Key_t key, std::shared_ptr<Kernel::PSTDConfiguration> scene)
         {
             try
@@ -450,9 +1027,16 @@ namespace OpenPSTD
 
         unsigned int PSTDFile::IncrementFrameCount(unsigned int domain)
         {
-            auto key = CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {domain});
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            auto key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {domain});
             int frame = GetValue<int>(key);
             SetValue<int>(key, frame + 1);
+
+            this->LoadResultsState();
+            if(domain < this->writtenFrameCounts.size())
+            {
+                this->writtenFrameCounts[domain] = frame + 1;
+            }
             return frame;
         }
 
@@ -474,19 +1058,146 @@ namespace OpenPSTD
             return this->GetSceneConf(CreateKey(PSTD_FILE_PREFIX_RESULTS_SCENE, {}));
         }
 
+        OPENPSTD_SHARED_EXPORT void PSTDFile::TruncateResults(unsigned int frames)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            auto conf = this->GetResultsSceneConf();
+            unsigned int saveNth = std::max(conf->Settings.GetSaveNth(), 1);
+            unsigned int savedFrames = (frames + saveNth - 1) / saveNth;
+
+            for (unsigned int d = 0; d < conf->Domains.size(); d++)
+            {
+                if(this->GetResultsFrameCount(d) < (int)savedFrames)
+                    throw std::runtime_error("The results of domain " + std::to_string(d) + " contain less than " +
+                                             std::to_string(savedFrames) + " frames");
+            }
+            for(unsigned int r = 0; r < conf->Receivers.size(); r++)
+            {
+                if(this->GetReceiverSampleCount(r) < savedFrames)
+                    throw std::runtime_error("The results of receiver " + std::to_string(r) + " contain less than " +
+                                             std::to_string(savedFrames) + " samples");
+            }
+
+            for (unsigned int d = 0; d < conf->Domains.size(); d++)
+            {
+                SetValue<int>(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {d}), savedFrames);
+
+                //the statistics of the removed frames are part of the statistics of the domain
+                FrameStatistics statistics;
+                for (unsigned int frame = 0; frame < savedFrames; frame++)
+                {
+                    statistics = FrameStatistics::Combine(statistics, this->GetResultsFrameStatistics(frame, d));
+                }
+                std::vector<char> encodedStatistics = statistics.Encode();
+                this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_STATISTICS, {d}),
+                                  encodedStatistics.size(), encodedStatistics.data());
+
+                //the index only keeps the complete blocks of the remaining frames, a shorter block would not match
+                //the key of its tiles(see CreateTimeSeriesKey), the other frames are read from the frames
+                TimeSeriesLayout layout = this->GetTimeSeriesLayout(d);
+                if(layout.Frames > savedFrames)
+                {
+                    layout.Frames = savedFrames / layout.BlockFrames * layout.BlockFrames;
+                    std::vector<char> encodedLayout = layout.Encode();
+                    this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_TIME_INDEX_LAYOUT, {d}),
+                                      encodedLayout.size(), encodedLayout.data());
+                }
+            }
+
+            for(unsigned int r = 0; r < conf->Receivers.size(); r++)
+            {
+                Kernel::PSTD_RECEIVER_DATA_PTR data = this->GetReceiverData(r);
+                this->SetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {r}),
+                                  savedFrames * sizeof(Kernel::PSTD_FRAME_UNIT), data->data());
+            }
+
+            this->ResetResultsState();
+            this->PublishResults();
+        }
+
         OPENPSTD_SHARED_EXPORT void PSTDFile::SaveReceiverData(unsigned int receiver, Kernel::PSTD_RECEIVER_DATA_PTR data)
         {
-            this->AppendRawValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver}),
+            this->AppendRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver}),
                                  data->size() * sizeof(Kernel::PSTD_FRAME_UNIT), data->data());
         }
 
         OPENPSTD_SHARED_EXPORT Kernel::PSTD_RECEIVER_DATA_PTR PSTDFile::GetReceiverData(unsigned int receiver)
         {
             unqlite_int64 size;
-            float *result = (float *) this->GetRawValue(CreateKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver}), &size);
+            float *result = (float *) this->GetRawValue(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver}), &size);
             return make_shared<Kernel::PSTD_RECEIVER_DATA>(result, result + (size / 4));
         }
 
+        /**
+         * Passes the data of a record to a consumer in whole samples, unqlite gives the data in blocks of bytes
+         */
+        struct ReceiverDataReader
+        {
+            std::function<void(const float *, size_t)> consumer;
+            std::vector<float> samples;
+            char partial[sizeof(float)];
+            size_t partialSize = 0;
+
+            static int Consume(const void *data, unsigned int length, void *userData)
+            {
+                ReceiverDataReader *reader = (ReceiverDataReader *) userData;
+                const char *bytes = (const char *) data;
+
+                //a sample that is split over two blocks
+                while(reader->partialSize > 0 && length > 0)
+                {
+                    reader->partial[reader->partialSize++] = *bytes++;
+                    length--;
+                    if(reader->partialSize == sizeof(float))
+                    {
+                        float sample;
+                        std::memcpy(&sample, reader->partial, sizeof(float));
+                        reader->consumer(&sample, 1);
+                        reader->partialSize = 0;
+                    }
+                }
+
+                size_t count = length / sizeof(float);
+                reader->samples.resize(count);
+                std::memcpy(reader->samples.data(), bytes, count * sizeof(float));
+                if(count > 0)
+                    reader->consumer(reader->samples.data(), count);
+
+                reader->partialSize = length - count * sizeof(float);
+                std::memcpy(reader->partial, bytes + count * sizeof(float), reader->partialSize);
+                return UNQLITE_OK;
+            }
+        };
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::ReadReceiverData(unsigned int receiver,
+                                                               std::function<void(const float *, size_t)> consumer)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver});
+
+            ReceiverDataReader reader;
+            reader.consumer = consumer;
+            int rc = unqlite_kv_fetch_callback(this->backend.get(), key->data(), key->size(),
+                                               &ReceiverDataReader::Consume, &reader);
+            if (rc != UNQLITE_OK)
+            {
+                throw PSTDFileIOException(rc, key, "fetch data");
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned long long PSTDFile::GetReceiverSampleCount(unsigned int receiver)
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            PSTDFile_Key_t key = CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {receiver});
+            unqlite_int64 nBytes = 0;
+            int rc = unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes);
+            if (rc != UNQLITE_OK)
+            {
+                throw PSTDFileIOException(rc, key, "fetch size");
+            }
+            return nBytes / sizeof(Kernel::PSTD_FRAME_UNIT);
+        }
+
         int PSTDFile::GetResultsReceiverCount()
         {
             std::shared_ptr<Kernel::PSTDConfiguration> conf = this->GetResultsSceneConf();
@@ -500,6 +1211,8 @@ namespace OpenPSTD
 
             if(rc != UNQLITE_OK)
                 throw PSTDFileIOException(rc, nullptr, "Commit");
+
+            this->PublishResults();
         }
 
         void PSTDFile::Rollback()
@@ -509,6 +1222,297 @@ namespace OpenPSTD
 
             if(rc != UNQLITE_OK)
                 throw PSTDFileIOException(rc, nullptr, "Commit");
+
+            //the results can be different after a rollback, so the state has to be reloaded
+            this->ResetResultsState();
+            this->PublishResults();
+        }
+
+        void PSTDFile::UpgradeFromVersion3()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+
+            //version 3 stored the results without a run, they are moved to run 0 and written again, so that the
+            //statistics and the preview levels that version 3 did not have are created as well
+            std::shared_ptr<Kernel::PSTDConfiguration> conf = this->GetResultsSceneConf();
+            this->resultsRun = 0;
+
+            //the run is created by the first commit, an interrupted upgrade continues with the records that are left
+            auto runKey = CreateKey(PSTD_FILE_PREFIX_RESULTS_RUN, {});
+            unqlite_int64 nBytes = 0;
+            if(unqlite_kv_fetch(this->backend.get(), runKey->data(), runKey->size(), NULL, &nBytes) != UNQLITE_OK)
+            {
+                this->SetValue<unsigned int>(runKey, this->resultsRun);
+                this->InitializeResults(conf);
+                this->Commit();
+            }
+
+            //a moved record and the deletion of the old record are committed together
+            unsigned long long uncommitted = 0;
+            for (unsigned int d = 0; d < conf->Domains.size(); d++)
+            {
+                auto countKey = CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAME_COUNT, {d});
+                if(unqlite_kv_fetch(this->backend.get(), countKey->data(), countKey->size(), NULL, &nBytes) != UNQLITE_OK)
+                    continue;
+
+                unsigned int frameCount = GetValue<int>(countKey);
+                for (unsigned int f = (unsigned int) this->GetResultsFrameCount(d); f < frameCount; f++)
+                {
+                    auto frameKey = CreateKey(PSTD_FILE_PREFIX_RESULTS_FRAMEDATA, {d, f});
+                    unqlite_int64 size;
+                    float *data = (float *) this->GetRawValue(frameKey, &size);
+                    auto frame = make_shared<Kernel::PSTD_FRAME>(data, data + (size / 4));
+                    delete[] data;
+
+                    this->SaveNextResultsFrame(d, frame);
+                    this->DeleteValue(frameKey);
+
+                    uncommitted += size;
+                    if(uncommitted > PSTD_FILE_COMPACT_COMMIT_SIZE)
+                    {
+                        this->Commit();
+                        uncommitted = 0;
+                    }
+                }
+                this->DeleteValue(countKey);
+            }
+            for (unsigned int r = 0; r < conf->Receivers.size(); r++)
+            {
+                auto key = CreateKey(PSTD_FILE_PREFIX_RESULTS_RECEIVERDATA, {r});
+                unqlite_int64 nBytes = 0;
+                if(unqlite_kv_fetch(this->backend.get(), key->data(), key->size(), NULL, &nBytes) != UNQLITE_OK)
+                    continue;
+
+                unqlite_int64 size;
+                float *data = (float *) this->GetRawValue(key, &size);
+                auto samples = make_shared<Kernel::PSTD_RECEIVER_DATA>(data, data + (size / 4));
+                delete[] data;
+
+                this->SaveReceiverData(r, samples);
+                this->DeleteValue(key);
+
+                uncommitted += size;
+                if(uncommitted > PSTD_FILE_COMPACT_COMMIT_SIZE)
+                {
+                    this->Commit();
+                    uncommitted = 0;
+                }
+            }
+
+            this->SetValue<int>(CreateKey(PSTD_FILE_PREFIX_VERSION, {}), PSTD_FILE_VERSION);
+            this->Commit();
+        }
+
+        PSTDFile_Key_t PSTDFile::CreateResultsKey(unsigned int prefix, std::initializer_list<unsigned int> list)
+        {
+            std::vector<unsigned int> values;
+            values.push_back(prefix);
+            values.push_back(this->resultsRun);
+            values.insert(values.end(), list.begin(), list.end());
+
+            char *data = (char *) values.data();
+            return make_shared<std::vector<char>>(data, data + values.size() * sizeof(unsigned int));
+        }
+
+        bool PSTDFile::IsUsedKey(const char *key, int length, unsigned int currentRun)
+        {
+            if(length < sizeof(unsigned int))
+                return true;
+
+            const unsigned int *values = (const unsigned int *) key;
+            if(values[0] < PSTD_FILE_PREFIX_RESULTS_RUN_SCOPED_BEGIN || values[0] >= PSTD_FILE_PREFIX_RESULTS_RUN_SCOPED_END)
+                return true;
+
+            return length >= 2 * sizeof(unsigned int) && values[1] == currentRun;
+        }
+
+        /**
+         * Releases a cursor of a backend, also when the loop over the records fails
+         */
+        struct CursorGuard
+        {
+            unqlite *backend;
+            unqlite_kv_cursor *cursor = nullptr;
+
+            CursorGuard(unqlite *backend) : backend(backend)
+            {
+            }
+
+            ~CursorGuard()
+            {
+                if(cursor)
+                {
+                    unqlite_kv_cursor_release(backend, cursor);
+                }
+            }
+        };
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::Compact(const boost::filesystem::path &path)
+        {
+            boost::filesystem::path compactPath = path;
+            compactPath += ".compact";
+            if(boost::filesystem::exists(compactPath))
+            {
+                boost::filesystem::remove(compactPath);
+            }
+
+            try
+            {
+                {
+                    std::unique_ptr<PSTDFile> source = PSTDFile::Open(path);
+                    std::unique_ptr<PSTDFile> destination(new PSTDFile());
+
+                    unqlite *backend;
+                    int rc = unqlite_open(&backend, compactPath.string().c_str(), UNQLITE_OPEN_CREATE);
+                    if(rc != UNQLITE_OK)
+                        throw PSTDFileIOException(rc, nullptr, "open compacted file");
+                    unqlite_config(backend, UNQLITE_CONFIG_DISABLE_AUTO_COMMIT);
+                    destination->backend = std::unique_ptr<unqlite, int (*)(unqlite *)>(backend, unqlite_close);
+
+                    CursorGuard cursorGuard(source->backend.get());
+                    rc = unqlite_kv_cursor_init(source->backend.get(), &cursorGuard.cursor);
+                    if(rc != UNQLITE_OK)
+                        throw PSTDFileIOException(rc, nullptr, "create cursor");
+                    unqlite_kv_cursor *cursor = cursorGuard.cursor;
+
+                    std::vector<char> keyBuffer;
+                    std::vector<char> dataBuffer;
+                    unsigned long long uncommitted = 0;
+                    for(unqlite_kv_cursor_first_entry(cursor); unqlite_kv_cursor_valid_entry(cursor);
+                        unqlite_kv_cursor_next_entry(cursor))
+                    {
+                        int nKey;
+                        unqlite_kv_cursor_key(cursor, NULL, &nKey);
+                        keyBuffer.resize(nKey);
+                        unqlite_kv_cursor_key(cursor, keyBuffer.data(), &nKey);
+
+                        if(!IsUsedKey(keyBuffer.data(), nKey, source->resultsRun))
+                            continue;
+
+                        unqlite_int64 nData;
+                        unqlite_kv_cursor_data(cursor, NULL, &nData);
+                        dataBuffer.resize(nData);
+                        unqlite_kv_cursor_data(cursor, dataBuffer.data(), &nData);
+
+                        destination->SetRawValue(CreateKeyFromData(keyBuffer.data(), nKey), nData, dataBuffer.data());
+
+                        //commit regularly, so that the journal does not contain the complete file
+                        uncommitted += nData;
+                        if(uncommitted > PSTD_FILE_COMPACT_COMMIT_SIZE)
+                        {
+                            rc = unqlite_commit(destination->backend.get());
+                            if(rc != UNQLITE_OK)
+                                throw PSTDFileIOException(rc, nullptr, "Commit");
+                            uncommitted = 0;
+                        }
+                    }
+
+                    //not the Commit of PSTDFile, the destination has no published results
+                    rc = unqlite_commit(destination->backend.get());
+                    if(rc != UNQLITE_OK)
+                        throw PSTDFileIOException(rc, nullptr, "Commit");
+                }//both files are closed here
+            }
+            catch(...)
+            {
+                //the partial copy is removed, the file itself is not changed
+                boost::system::error_code ec;
+                boost::filesystem::remove(compactPath, ec);
+                boost::filesystem::remove(compactPath.string() + "_unqlite_journal", ec);
+                throw;
+            }
+
+            boost::filesystem::rename(compactPath, path);
+        }
+
+        void PSTDFile::LoadResultsState()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            if(this->resultsConf)
+                return;
+
+            auto conf = this->GetResultsSceneConf();
+            this->resultsConf = conf;
+            this->resultsCodec = FrameCodec::FromSettings(conf->Settings);
+            this->resultsMetadata = this->ReadMetadata(conf);
+            this->writtenFrameCounts.clear();
+            this->resultsStatistics.clear();
+            for(unsigned int d = 0; d < this->resultsConf->Domains.size(); d++)
+            {
+                this->writtenFrameCounts.push_back(this->GetResultsFrameCount(d));
+                this->resultsStatistics.push_back(
+                        this->ReadStatistics(CreateResultsKey(PSTD_FILE_PREFIX_RESULTS_STATISTICS, {d})));
+            }
+        }
+
+        void PSTDFile::ResetResultsState()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->resultsConf = nullptr;
+            this->writtenFrameCounts.clear();
+            this->resultsStatistics.clear();
+            this->resultsMetadata = Kernel::SimulationMetadata();
+            this->resultsGeneration++;
+            this->frameCache.Clear();
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::PublishResults()
+        {
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex);
+            this->LoadResultsState();
+
+            auto snapshot = make_shared<const ResultsSnapshot>(this->resultsConf, this->resultsMetadata,
+                                                               this->writtenFrameCounts, this->resultsStatistics,
+                                                               this->resultsGeneration);
+
+            {
+                boost::unique_lock<boost::mutex> snapshotLock(this->snapshotMutex);
+                this->publishedSnapshot = snapshot;
+            }
+            this->Change();
+        }
+
+        OPENPSTD_SHARED_EXPORT std::shared_ptr<const ResultsSnapshot> PSTDFile::GetResultsSnapshot()
+        {
+            {
+                boost::unique_lock<boost::mutex> snapshotLock(this->snapshotMutex);
+                if(this->publishedSnapshot)
+                    return this->publishedSnapshot;
+            }
+
+            //nothing is published yet(the file is just opened), publish the state that is in the file
+            this->PublishResults();
+
+            boost::unique_lock<boost::mutex> snapshotLock(this->snapshotMutex);
+            return this->publishedSnapshot;
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_CONST_PTR PSTDFile::GetSnapshotFrame(const ResultsSnapshot &snapshot,
+                                                                                     unsigned int frame,
+                                                                                     unsigned int domain,
+                                                                                     unsigned int level)
+        {
+            if(frame >= snapshot.GetResultsFrameCount(domain))
+                return nullptr;
+
+            Kernel::PSTD_FRAME_CONST_PTR result = this->frameCache.Get(snapshot.GetGeneration(), frame, domain, level);
+            if(result)
+                return result;
+
+            //only go to the backend if the writer is not using it
+            boost::unique_lock<boost::recursive_mutex> lock(this->backendMutex, boost::try_to_lock);
+            if(!lock.owns_lock() || snapshot.GetGeneration() != this->resultsGeneration)
+                return nullptr;
+
+            result = this->ReadResultsFrame(frame, domain, level);
+
+            this->frameCache.Put(snapshot.GetGeneration(), frame, domain, result, level);
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT void PSTDFile::SetFrameCacheSize(unsigned long long bytes)
+        {
+            this->frameCache.SetMaxBytes(bytes);
         }
 
 
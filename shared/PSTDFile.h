@@ -47,10 +47,14 @@ extern "C"
 }
 
 #include <memory>
+#include <functional>
 #include <vector>
 #include <kernel/GeneralTypes.h>
 #include <kernel/KernelInterface.h>
 #include <shared/InvalidationData.h>
+#include <shared/ResultsSnapshot.h>
+#include <shared/FrameCodec.h>
+#include <shared/TimeSeriesIndex.h>
 #include <QVector2D>
 #include <QVector3D>
 #include <boost/serialization/split_free.hpp>
@@ -135,6 +139,7 @@ namespace OpenPSTD
         {
         private:
             int FileVersion;
+            std::string Message;
 
         public:
             OPENPSTD_SHARED_EXPORT PSTDFileVersionException(int fileVersion);
@@ -168,6 +173,66 @@ namespace OpenPSTD
             bool changed;
             boost::recursive_mutex backendMutex;
 
+            /**
+             * The current run, the results of all other runs are deleted. Deleting the results is starting a new run.
+             */
+            unsigned int resultsRun;
+
+            /**
+             * State of the results as known by the writer, protected by the backendMutex
+             */
+            std::shared_ptr<const Kernel::PSTDConfiguration> resultsConf;
+            std::vector<int> writtenFrameCounts;
+            unsigned int resultsGeneration;
+            FrameCodec resultsCodec;
+            std::vector<FrameStatistics> resultsStatistics;
+
+            /**
+             * Number of bins of the histogram that is computed for every written frame, 0 for no histogram
+             */
+            unsigned int statisticsHistogramBins;
+
+            /**
+             * Number of downsampled preview levels that are stored for every written frame
+             */
+            unsigned int previewLevels;
+
+            /**
+             * Sizes and positions of the domains of the results, stored when the results are initialized
+             */
+            Kernel::SimulationMetadata resultsMetadata;
+
+            /**
+             * The last published snapshot, protected by the snapshotMutex (not the backendMutex)
+             */
+            std::shared_ptr<const ResultsSnapshot> publishedSnapshot;
+            boost::mutex snapshotMutex;
+
+            /**
+             * Recently written or read frames, so that readers do not have to go to the backend
+             */
+            ResultsFrameCache frameCache;
+
+            /**
+             * Loads the results state of the writer from the backend if that is not yet done
+             */
+            void LoadResultsState();
+
+            /**
+             * Forgets the results state, all snapshot readers will see a new generation
+             */
+            void ResetResultsState();
+
+            /**
+             * Reads and decodes a frame from the backend, a level that is not stored is created from the frame
+             */
+            Kernel::PSTD_FRAME_PTR ReadResultsFrame(unsigned int frame, unsigned int domain, unsigned int level = 0);
+
+            /**
+             * Reads statistics from the backend, empty statistics if the record does not exist
+             */
+            FrameStatistics ReadStatistics(PSTDFile_Key_t key);
+
             /**
              * Get a value by key as a string
              */
@@ -208,6 +273,38 @@ namespace OpenPSTD
              */
             static PSTDFile_Key_t CreateKey(unsigned int prefix, std::initializer_list<unsigned int> list);
 
+            /**
+             * Create key for a record of the results of the current run
+             */
+            PSTDFile_Key_t CreateResultsKey(unsigned int prefix, std::initializer_list<unsigned int> list);
+
+            /**
+             * Create key for a tile of a block of the time-major index of a domain
+             */
+            PSTDFile_Key_t CreateTimeSeriesKey(unsigned int domain, const TimeSeriesLayout &layout, unsigned int block,
+                                               unsigned int tileY, unsigned int tileX);
+
+            /**
+             * True if the record belongs to the scene or to the results of the current run
+             */
+            static bool IsUsedKey(const char *key, int length, unsigned int currentRun);
+
+            /**
+             * Opens the backend of a file without checking the version
+             */
+            static std::unique_ptr<PSTDFile> OpenBackend(const boost::filesystem::path &filename);
+
+            /**
+             * Converts the file of version 3 (results without a run) to the current version, the results are moved
+             * to run 0 in batches that are committed
+             */
+            void UpgradeFromVersion3();
+
+            /**
+             * Initializes the results with a certain scene config
+             */
+            void InitializeResults(std::shared_ptr<Kernel::PSTDConfiguration> conf);
+
             /**
              * Create key based on raw data
              */
@@ -310,14 +407,35 @@ namespace OpenPSTD
              */
             void SetSceneConf(PSTDFile_Key_t key, std::shared_ptr<Kernel::PSTDConfiguration> scene);
 
+            /**
+             * Reads the metadata of the results, results without stored metadata use the metadata of the configuration
+             */
+            Kernel::SimulationMetadata ReadMetadata(std::shared_ptr<Kernel::PSTDConfiguration> conf);
+
+            /**
+             * Writes the metadata of the results to the file
+             */
+            void SetMetadata(PSTDFile_Key_t key, const Kernel::SimulationMetadata &metadata);
+
         public:
             /**
-             * Opens a file
+             * Opens a file, the file is not changed until it is committed
              * @param filename the filename that has to be opened
              * @return a unique ptr to the PSTD file
+             * @throws PSTDFileVersionException if the file has another version(see Upgrade)
              */
             static OPENPSTD_SHARED_EXPORT std::unique_ptr<PSTDFile> Open(const boost::filesystem::path &filename);
 
+            /**
+             * Converts a file of an older version to the current version. The results are moved in batches that are
+             * committed, so that the journal stays small, an interrupted upgrade can be continued by upgrading again.
+             * The file may not be opened by anyone else during the upgrade.
+             * @param filename the file that has to be upgraded
+             * @return false if the file has the current version already
+             * @throws PSTDFileVersionException if the version can not be upgraded
+             */
+            static OPENPSTD_SHARED_EXPORT bool Upgrade(const boost::filesystem::path &filename);
+
             /**
              * Opens a file
              * @param filename the filename that has to be opened
@@ -331,10 +449,11 @@ namespace OpenPSTD
             OPENPSTD_SHARED_EXPORT PSTDFile();
 
             /**
-             * Compresses the file that so that the file is smaller. This also deletes the data results.
+             * Rewrites the file so that the file is smaller. The records of deleted results are not copied.
+             * The file may not be opened by anyone else during the compaction.
+             * @param filename the file that has to be compacted
              */
-            //todo implement
-            //void Compress();
+            static OPENPSTD_SHARED_EXPORT void Compact(const boost::filesystem::path &filename);
 
 
             OPENPSTD_SHARED_EXPORT void Commit();
@@ -367,6 +486,32 @@ namespace OpenPSTD
              */
             OPENPSTD_SHARED_EXPORT std::shared_ptr<Kernel::PSTDConfiguration> GetResultsSceneConf();
 
+            /**
+             * Removes the results after a number of simulated frames, so that a resumed simulation continues writing
+             * after the frames of its checkpoint(see OpenPSTD-cli run --resume). Results are only written for every
+             * SaveNth frame, so the number of remaining frames and samples is rounded up.
+             * @param frames the number of simulated frames that are kept
+             * @throws std::runtime_error if the results contain less frames
+             */
+            OPENPSTD_SHARED_EXPORT void TruncateResults(unsigned int frames);
+
+            /**
+             * Gets the sizes and positions of the domains, the number of frames, grid spacing and time step of the
+             * results. This is stored with the results, so no kernel has to be initialized to get it.
+             */
+            OPENPSTD_SHARED_EXPORT Kernel::SimulationMetadata GetResultsMetadata();
+
+            /**
+             * Stores the profile of the run with the results(see OpenPSTD-cli run --profile)
+             */
+            OPENPSTD_SHARED_EXPORT void SaveResultsProfile(const Kernel::KernelProfile &profile);
+
+            /**
+             * Reads the profile of the run
+             * @return the profile, or a nullptr if the run was not profiled
+             */
+            OPENPSTD_SHARED_EXPORT std::shared_ptr<Kernel::KernelProfile> GetResultsProfile();
+
             /**
              * Get the number of domains
              */
@@ -383,10 +528,84 @@ namespace OpenPSTD
              */
             OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR GetResultsFrame(unsigned int frame, unsigned int domain);
 
+            /**
+             * Reads the values of a frame as bytes(native floats in row major order) without creating a frame. When
+             * the frames are stored raw, the stored bytes are passed directly in blocks, otherwise the frame is decoded.
+             * @param consumer called for every block with the bytes and the number of bytes
+             */
+            OPENPSTD_SHARED_EXPORT void ReadResultsFrameData(unsigned int frame, unsigned int domain,
+                                                             std::function<void(const char *, size_t)> consumer);
+
             /**
              * Saves the next frame for a certain domain in the file
+             * @return the number of bytes that are stored, after the encoding of the frame storage and including the
+             * previews and statistics of the frame
+             * @throws std::invalid_argument if the size of the frame is not the size of the domain in the metadata
+             */
+            OPENPSTD_SHARED_EXPORT unsigned long long SaveNextResultsFrame(unsigned int domain, Kernel::PSTD_FRAME_PTR frame);
+
+            /**
+             * Gets a downsampled preview of a frame, every level halves the size of the frame(see FramePyramid).
+             * Level 0 is the frame itself.
+             */
+            OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_PTR GetResultsFrameLevel(unsigned int frame, unsigned int domain,
+                                                                               unsigned int level);
+
+            /**
+             * Gets the size(x, y) of the frames of a domain at a preview level
+             */
+            OPENPSTD_SHARED_EXPORT std::vector<int> GetResultsFrameLevelSize(unsigned int domain, unsigned int level);
+
+            /**
+             * Checks if a preview level of a frame is stored with the results, levels that are not stored are created
+             * from the frame when they are read
+             */
+            OPENPSTD_SHARED_EXPORT bool IsResultsFrameLevelStored(unsigned int frame, unsigned int domain,
+                                                                  unsigned int level);
+
+            /**
+             * Sets the number of preview levels that are stored for every frame that is written, 0 for no previews(the
+             * default). Levels that are not stored are created from the frame when they are read.
+             */
+            OPENPSTD_SHARED_EXPORT void SetPreviewLevels(unsigned int levels);
+
+            /**
+             * Writes the time-major index of the results(see TimeSeriesLayout), an existing index with the same layout
+             * is extended with the frames that are written after it was build. The backend is only locked for single
+             * reads and writes, so this can run in the background. Stops when the results are deleted. The index is
+             * not committed.
+             * @param progress called after every block with the fraction of the blocks that is done
+             */
+            OPENPSTD_SHARED_EXPORT void BuildTimeSeriesIndex(unsigned int tileSize = 32, unsigned int blockFrames = 64,
+                                                             std::function<void(float)> progress = nullptr);
+
+            /**
+             * Gets the layout of the time-major index of a domain, the layout is empty if there is no index
+             */
+            OPENPSTD_SHARED_EXPORT TimeSeriesLayout GetTimeSeriesLayout(unsigned int domain);
+
+            /**
+             * Gets the values of a single cell of all the frames of a domain. The time-major index is used for the frames
+             * that are part of it, the other frames are read completely.
+             * @param x, y the cell in the domain
+             */
+            OPENPSTD_SHARED_EXPORT Kernel::PSTD_RECEIVER_DATA_PTR GetResultsTimeSeries(unsigned int domain, int x, int y);
+
+            /**
+             * Gets the statistics of a frame that are computed when the frame was written. Frames that are written
+             * without statistics are read once to compute them.
+             */
+            OPENPSTD_SHARED_EXPORT FrameStatistics GetResultsFrameStatistics(unsigned int frame, unsigned int domain);
+
+            /**
+             * Gets the statistics of all the frames of a domain
+             */
+            OPENPSTD_SHARED_EXPORT FrameStatistics GetResultsStatistics(unsigned int domain);
+
+            /**
+             * Sets the number of histogram bins that are computed for every frame that is written, 0 for no histogram
              */
-            OPENPSTD_SHARED_EXPORT void SaveNextResultsFrame(unsigned int domain, Kernel::PSTD_FRAME_PTR frame);
+            OPENPSTD_SHARED_EXPORT void SetStatisticsHistogramBins(unsigned int bins);
 
             /**
              * Delete all the simulation results
@@ -403,11 +622,50 @@ namespace OpenPSTD
              */
             OPENPSTD_SHARED_EXPORT Kernel::PSTD_RECEIVER_DATA_PTR GetReceiverData(unsigned int receiver);
 
+            /**
+             * Reads the data of a receiver in blocks, without reading all the data in memory
+             * @param consumer called for every block with the samples and the number of samples
+             */
+            OPENPSTD_SHARED_EXPORT void ReadReceiverData(unsigned int receiver,
+                                                         std::function<void(const float *, size_t)> consumer);
+
+            /**
+             * Gets the number of samples of a receiver
+             */
+            OPENPSTD_SHARED_EXPORT unsigned long long GetReceiverSampleCount(unsigned int receiver);
+
             /**
              * Gets the number of receivers in the results
              */
             OPENPSTD_SHARED_EXPORT int GetResultsReceiverCount();
 
+            /**
+             * Publishes the frames that are written up to now to the snapshot readers. Commit publishes automatically.
+             */
+            OPENPSTD_SHARED_EXPORT void PublishResults();
+
+            /**
+             * Gets the last published snapshot of the results. This does not wait for the writer, except for the
+             * first call after opening the file.
+             */
+            OPENPSTD_SHARED_EXPORT std::shared_ptr<const ResultsSnapshot> GetResultsSnapshot();
+
+            /**
+             * Gets a frame that is part of a snapshot without waiting for the writer.
+             * @param level the preview level of the frame(see GetResultsFrameLevel)
+             * @return the frame, or nullptr if the frame is not in the snapshot, the snapshot is outdated or the
+             * backend is in use by the writer(try again later)
+             */
+            OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_CONST_PTR GetSnapshotFrame(const ResultsSnapshot &snapshot,
+                                                                                   unsigned int frame,
+                                                                                   unsigned int domain,
+                                                                                   unsigned int level = 0);
+
+            /**
+             * Sets the maximum amount of memory used for caching frames for the readers
+             */
+            OPENPSTD_SHARED_EXPORT void SetFrameCacheSize(unsigned long long bytes);
+
 
             /**
              * outputs debug info, only for debug purposes.
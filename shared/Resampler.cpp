@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        OPENPSTD_SHARED_EXPORT Resampler::Resampler(double inputRate, double outputRate, int zeroCrossings,
+                                                    int phases):
+                step(inputRate / outputRate),
+                cutoff(std::min(1.0, outputRate / inputRate) * 0.95),
+                phases(phases),
+                buffer(),
+                bufferStart(0),
+                inputCount(0),
+                outputCount(0)
+        {
+            //the distance is in input samples, the sinc is stretched when the cutoff is lowered
+            this->halfWidth = zeroCrossings / this->cutoff;
+            int size = (int)std::ceil(this->halfWidth * phases) + 2;
+            this->table.resize(size);
+            for (int i = 0; i < size; i++)
+            {
+                double t = i / (double)phases;
+                double x = M_PI * this->cutoff * t;
+                double sinc = i == 0 ? 1.0 : std::sin(x) / x;
+                //Blackman window
+                double w = t >= this->halfWidth ? 0 : 0.42 + 0.5 * std::cos(M_PI * t / this->halfWidth) +
+                                                      0.08 * std::cos(2 * M_PI * t / this->halfWidth);
+                this->table[i] = (float)(this->cutoff * sinc * w);
+            }
+        }
+
+        float Resampler::Kernel(double distance) const
+        {
+            double position = std::abs(distance) * this->phases;
+            size_t index = (size_t)position;
+            if(index + 1 >= this->table.size())
+                return 0;
+            float fraction = (float)(position - index);
+            return this->table[index] + fraction * (this->table[index + 1] - this->table[index]);
+        }
+
+        void Resampler::Produce(std::vector<float> &output, unsigned long long available, unsigned long long limit)
+        {
+            while (this->outputCount < limit)
+            {
+                double t = this->outputCount * this->step;
+                long long last = (long long)std::floor(t + this->halfWidth);
+                if(last >= (long long)available)
+                    break;
+
+                long long first = std::max(0ll, (long long)std::ceil(t - this->halfWidth));
+                double sum = 0;
+                for (long long j = first; j <= last; j++)
+                {
+                    sum += this->buffer[j - this->bufferStart] * this->Kernel(t - j);
+                }
+                output.push_back((float)sum);
+                this->outputCount++;
+            }
+
+            //drop the input samples that are not needed anymore
+            double t = this->outputCount * this->step;
+            long long needed = std::max(0ll, (long long)std::ceil(t - this->halfWidth));
+            if(needed > (long long)this->bufferStart)
+            {
+                size_t drop = std::min((size_t)(needed - this->bufferStart), this->buffer.size());
+                this->buffer.erase(this->buffer.begin(), this->buffer.begin() + drop);
+                this->bufferStart += drop;
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT void Resampler::Process(const float *input, size_t count, std::vector<float> &output)
+        {
+            this->buffer.insert(this->buffer.end(), input, input + count);
+            this->inputCount += count;
+            this->Produce(output, this->inputCount, this->GetOutputLength(this->inputCount));
+        }
+
+        OPENPSTD_SHARED_EXPORT void Resampler::Flush(std::vector<float> &output)
+        {
+            std::vector<float> zeros((size_t)std::ceil(this->halfWidth) + 1, 0.0f);
+            this->buffer.insert(this->buffer.end(), zeros.begin(), zeros.end());
+            this->Produce(output, this->bufferStart + this->buffer.size(), this->GetOutputLength(this->inputCount));
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned long long Resampler::GetOutputLength(unsigned long long count) const
+        {
+            return (unsigned long long)std::ceil(count / this->step);
+        }
+    }
+}
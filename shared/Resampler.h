@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Streaming sample rate conversion of the receiver data, so that the
+//      receivers can be exported at an audio sample rate.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_RESAMPLER_H
+#define OPENPSTD_RESAMPLER_H
+
+#include "openpstd-shared_export.h"
+#include <cstddef>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Converts a signal to another sample rate with a windowed sinc filter. The filter is stored as a polyphase
+         * table with a number of phases per input sample, the phases in between are interpolated linearly, so any ratio
+         * of the sample rates is supported. When the rate is lowered the cutoff of the filter is lowered as well, so
+         * that there is no aliasing.
+         *
+         * The input can be given in blocks of any size, only the samples that are needed for the next output samples
+         * are kept.
+         */
+        class OPENPSTD_SHARED_EXPORT Resampler
+        {
+        private:
+            double step;
+            double cutoff;
+            int phases;
+            double halfWidth;
+            std::vector<float> table;
+
+            /**
+             * Input samples starting at the input sample bufferStart
+             */
+            std::vector<float> buffer;
+            unsigned long long bufferStart;
+            unsigned long long inputCount;
+            unsigned long long outputCount;
+
+            float Kernel(double distance) const;
+            void Produce(std::vector<float> &output, unsigned long long available, unsigned long long limit);
+
+        public:
+            /**
+             * @param zeroCrossings the number of zero crossings of the sinc on both sides, more is a sharper filter
+             * @param phases the number of phases of the table per input sample
+             */
+            OPENPSTD_SHARED_EXPORT Resampler(double inputRate, double outputRate, int zeroCrossings = 16,
+                                             int phases = 256);
+
+            /**
+             * Adds input samples and appends the output samples that can be computed to output
+             */
+            OPENPSTD_SHARED_EXPORT void Process(const float *input, size_t count, std::vector<float> &output);
+
+            /**
+             * Ends the input and appends the remaining output samples to output, the input is assumed to be 0 after
+             * the last sample
+             */
+            OPENPSTD_SHARED_EXPORT void Flush(std::vector<float> &output);
+
+            /**
+             * The number of output samples of an input with count samples
+             */
+            OPENPSTD_SHARED_EXPORT unsigned long long GetOutputLength(unsigned long long count) const;
+        };
+    }
+}
+
+#endif //OPENPSTD_RESAMPLER_H
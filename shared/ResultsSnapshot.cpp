@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "ResultsSnapshot.h"
+#include <algorithm>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        OPENPSTD_SHARED_EXPORT ResultsSnapshot::ResultsSnapshot(std::shared_ptr<const Kernel::PSTDConfiguration> conf,
+                                                                Kernel::SimulationMetadata metadata,
+                                                                std::vector<int> frameCounts,
+                                                                std::vector<FrameStatistics> statistics,
+                                                                unsigned int generation):
+                conf(conf),
+                metadata(metadata),
+                frameCounts(frameCounts),
+                statistics(statistics),
+                generation(generation)
+        {
+        }
+
+        OPENPSTD_SHARED_EXPORT std::shared_ptr<Kernel::PSTDConfiguration> ResultsSnapshot::GetResultsSceneConf() const
+        {
+            return std::make_shared<Kernel::PSTDConfiguration>(*this->conf);
+        }
+
+        OPENPSTD_SHARED_EXPORT const Kernel::SimulationMetadata &ResultsSnapshot::GetResultsMetadata() const
+        {
+            return this->metadata;
+        }
+
+        OPENPSTD_SHARED_EXPORT int ResultsSnapshot::GetResultsDomainCount() const
+        {
+            return this->frameCounts.size();
+        }
+
+        OPENPSTD_SHARED_EXPORT int ResultsSnapshot::GetResultsFrameCount(unsigned int domain) const
+        {
+            if(domain >= this->frameCounts.size())
+                return 0;
+            return this->frameCounts[domain];
+        }
+
+        OPENPSTD_SHARED_EXPORT int ResultsSnapshot::GetMaxFrameCount() const
+        {
+            if(this->frameCounts.empty())
+                return 0;
+            return *std::max_element(this->frameCounts.begin(), this->frameCounts.end());
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics ResultsSnapshot::GetResultsStatistics(unsigned int domain) const
+        {
+            if(domain >= this->statistics.size())
+                return FrameStatistics();
+            return this->statistics[domain];
+        }
+
+        OPENPSTD_SHARED_EXPORT FrameStatistics ResultsSnapshot::GetResultsStatistics() const
+        {
+            FrameStatistics result;
+            for(const FrameStatistics &s : this->statistics)
+            {
+                result = FrameStatistics::Combine(result, s);
+            }
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned int ResultsSnapshot::GetGeneration() const
+        {
+            return this->generation;
+        }
+
+        OPENPSTD_SHARED_EXPORT ResultsFrameCache::ResultsFrameCache(unsigned long long maxBytes):
+                maxBytes(maxBytes),
+                bytes(0)
+        {
+        }
+
+        OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_CONST_PTR ResultsFrameCache::Get(unsigned int generation,
+                                                                                unsigned int frame,
+                                                                                unsigned int domain,
+                                                                                unsigned int level)
+        {
+            boost::unique_lock<boost::mutex> lock(this->mutex);
+            auto it = this->index.find(Key(generation, domain, frame, level));
+            if(it == this->index.end())
+                return nullptr;
+
+            //move to the front, it is the most recently used now
+            this->entries.splice(this->entries.begin(), this->entries, it->second);
+            return it->second->second;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ResultsFrameCache::Put(unsigned int generation, unsigned int frame,
+                                                           unsigned int domain, Kernel::PSTD_FRAME_CONST_PTR data,
+                                                           unsigned int level)
+        {
+            unsigned long long size = data->size() * sizeof(Kernel::PSTD_FRAME_UNIT);
+
+            boost::unique_lock<boost::mutex> lock(this->mutex);
+            if(size > this->maxBytes)
+                return;
+
+            Key key(generation, domain, frame, level);
+            if(this->index.count(key) > 0)
+                return;
+
+            this->entries.push_front(Entry(key, data));
+            this->index[key] = this->entries.begin();
+            this->bytes += size;
+            this->Evict();
+        }
+
+        OPENPSTD_SHARED_EXPORT void ResultsFrameCache::Clear()
+        {
+            boost::unique_lock<boost::mutex> lock(this->mutex);
+            this->entries.clear();
+            this->index.clear();
+            this->bytes = 0;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ResultsFrameCache::SetMaxBytes(unsigned long long maxBytes)
+        {
+            boost::unique_lock<boost::mutex> lock(this->mutex);
+            this->maxBytes = maxBytes;
+            this->Evict();
+        }
+
+        void ResultsFrameCache::Evict()
+        {
+            while(this->bytes > this->maxBytes && !this->entries.empty())
+            {
+                Entry &last = this->entries.back();
+                this->bytes -= last.second->size() * sizeof(Kernel::PSTD_FRAME_UNIT);
+                this->index.erase(last.first);
+                this->entries.pop_back();
+            }
+        }
+    }
+}
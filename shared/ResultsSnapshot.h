@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Immutable view on the results of a PSTD file, so that readers
+//      (e.g. the GUI) can show results while a simulation is writing.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_RESULTSSNAPSHOT_H
+#define OPENPSTD_RESULTSSNAPSHOT_H
+
+#include "openpstd-shared_export.h"
+#include <shared/FrameStatistics.h>
+#include <kernel/GeneralTypes.h>
+#include <kernel/KernelInterface.h>
+#include <boost/thread.hpp>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * A published state of the results. Frames are never changed after they are written, so every frame with an
+         * index below the frame count of the snapshot can be read without synchronizing with the writer.
+         */
+        class OPENPSTD_SHARED_EXPORT ResultsSnapshot
+        {
+        private:
+            std::shared_ptr<const Kernel::PSTDConfiguration> conf;
+            Kernel::SimulationMetadata metadata;
+            std::vector<int> frameCounts;
+            std::vector<FrameStatistics> statistics;
+            unsigned int generation;
+
+        public:
+            OPENPSTD_SHARED_EXPORT ResultsSnapshot(std::shared_ptr<const Kernel::PSTDConfiguration> conf,
+                                                   Kernel::SimulationMetadata metadata, std::vector<int> frameCounts,
+                                                   std::vector<FrameStatistics> statistics, unsigned int generation);
+
+            /**
+             * The scene configuration of the results
+             * @return a copy of the configuration, so that the caller can change it
+             */
+            OPENPSTD_SHARED_EXPORT std::shared_ptr<Kernel::PSTDConfiguration> GetResultsSceneConf() const;
+
+            /**
+             * The sizes and positions of the domains of the results(see PSTDFile::GetResultsMetadata)
+             */
+            OPENPSTD_SHARED_EXPORT const Kernel::SimulationMetadata &GetResultsMetadata() const;
+
+            OPENPSTD_SHARED_EXPORT int GetResultsDomainCount() const;
+
+            /**
+             * The number of frames of a domain that is visible in this snapshot(the watermark)
+             */
+            OPENPSTD_SHARED_EXPORT int GetResultsFrameCount(unsigned int domain) const;
+
+            /**
+             * The maximum frame count of all domains
+             */
+            OPENPSTD_SHARED_EXPORT int GetMaxFrameCount() const;
+
+            /**
+             * The statistics of all the frames of a domain that are visible in this snapshot
+             */
+            OPENPSTD_SHARED_EXPORT FrameStatistics GetResultsStatistics(unsigned int domain) const;
+
+            /**
+             * The statistics of all the frames of all domains that are visible in this snapshot
+             */
+            OPENPSTD_SHARED_EXPORT FrameStatistics GetResultsStatistics() const;
+
+            /**
+             * Every time the results are deleted or initialized the generation is increased, frames of an older
+             * generation are not valid anymore.
+             */
+            OPENPSTD_SHARED_EXPORT unsigned int GetGeneration() const;
+        };
+
+        /**
+         * Thread-safe cache of immutable frames with a limited size, the least recently used frames are dropped first.
+         * The level is the level of the preview pyramid, 0 is the frame itself.
+         */
+        class OPENPSTD_SHARED_EXPORT ResultsFrameCache
+        {
+        private:
+            using Key = std::tuple<unsigned int, unsigned int, unsigned int, unsigned int>;
+            using Entry = std::pair<Key, Kernel::PSTD_FRAME_CONST_PTR>;
+
+            boost::mutex mutex;
+            std::list<Entry> entries;
+            std::map<Key, std::list<Entry>::iterator> index;
+            unsigned long long maxBytes;
+            unsigned long long bytes;
+
+            void Evict();
+
+        public:
+            OPENPSTD_SHARED_EXPORT ResultsFrameCache(unsigned long long maxBytes);
+
+            OPENPSTD_SHARED_EXPORT Kernel::PSTD_FRAME_CONST_PTR Get(unsigned int generation, unsigned int frame,
+                                                                     unsigned int domain, unsigned int level = 0);
+
+            OPENPSTD_SHARED_EXPORT void Put(unsigned int generation, unsigned int frame, unsigned int domain,
+                                            Kernel::PSTD_FRAME_CONST_PTR data, unsigned int level = 0);
+
+            OPENPSTD_SHARED_EXPORT void Clear();
+
+            OPENPSTD_SHARED_EXPORT void SetMaxBytes(unsigned long long maxBytes);
+        };
+    }
+}
+
+#endif //OPENPSTD_RESULTSSNAPSHOT_H
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TimeSeriesIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Stored layout of the index
+         */
+        struct TimeSeriesLayoutHeader
+        {
+            uint32_t tileSize;
+            uint32_t blockFrames;
+            int32_t width;
+            int32_t height;
+            uint32_t frames;
+        };
+
+        OPENPSTD_SHARED_EXPORT bool TimeSeriesLayout::IsEmpty() const
+        {
+            return this->Frames == 0;
+        }
+
+        OPENPSTD_SHARED_EXPORT int TimeSeriesLayout::GetTilesX() const
+        {
+            return (this->Width + this->TileSize - 1) / this->TileSize;
+        }
+
+        OPENPSTD_SHARED_EXPORT int TimeSeriesLayout::GetTilesY() const
+        {
+            return (this->Height + this->TileSize - 1) / this->TileSize;
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned int TimeSeriesLayout::GetBlockCount() const
+        {
+            return (this->Frames + this->BlockFrames - 1) / this->BlockFrames;
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned int TimeSeriesLayout::GetBlockLength(unsigned int block) const
+        {
+            unsigned int first = block * this->BlockFrames;
+            if(first >= this->Frames)
+                return 0;
+            return std::min(this->BlockFrames, this->Frames - first);
+        }
+
+        OPENPSTD_SHARED_EXPORT int TimeSeriesLayout::GetTileWidth(int tileX) const
+        {
+            return std::min((int)this->TileSize, this->Width - tileX * (int)this->TileSize);
+        }
+
+        OPENPSTD_SHARED_EXPORT int TimeSeriesLayout::GetTileHeight(int tileY) const
+        {
+            return std::min((int)this->TileSize, this->Height - tileY * (int)this->TileSize);
+        }
+
+        OPENPSTD_SHARED_EXPORT size_t TimeSeriesLayout::GetCellOffset(int x, int y, unsigned int block) const
+        {
+            int localX = x % this->TileSize;
+            int localY = y % this->TileSize;
+            int tileWidth = this->GetTileWidth(x / this->TileSize);
+            return ((size_t)localY * tileWidth + localX) * this->GetBlockLength(block);
+        }
+
+        OPENPSTD_SHARED_EXPORT bool TimeSeriesLayout::IsCompatible(const TimeSeriesLayout &other) const
+        {
+            return this->TileSize == other.TileSize && this->BlockFrames == other.BlockFrames &&
+                   this->Width == other.Width && this->Height == other.Height;
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<char> TimeSeriesLayout::Encode() const
+        {
+            TimeSeriesLayoutHeader header;
+            header.tileSize = this->TileSize;
+            header.blockFrames = this->BlockFrames;
+            header.width = this->Width;
+            header.height = this->Height;
+            header.frames = this->Frames;
+
+            std::vector<char> result(sizeof(header));
+            std::memcpy(result.data(), &header, sizeof(header));
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT TimeSeriesLayout TimeSeriesLayout::Decode(const char *data, unsigned long long length)
+        {
+            TimeSeriesLayout result;
+            TimeSeriesLayoutHeader header;
+            if(length < sizeof(header))
+                return result;
+
+            std::memcpy(&header, data, sizeof(header));
+            if(header.tileSize == 0 || header.blockFrames == 0)
+                return result;
+
+            result.TileSize = header.tileSize;
+            result.BlockFrames = header.blockFrames;
+            result.Width = header.width;
+            result.Height = header.height;
+            result.Frames = header.frames;
+            return result;
+        }
+    }
+}
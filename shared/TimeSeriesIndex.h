@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose:
+//      Layout of the time-major index of the results, that stores the
+//      frames as tiles of cells with a block of frames per cell, so that
+//      the time series of a single cell can be read without reading all
+//      the frames.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_TIMESERIESINDEX_H
+#define OPENPSTD_TIMESERIESINDEX_H
+
+#include "openpstd-shared_export.h"
+#include <cstddef>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * The layout of the index of a single domain. The domain is divided in tiles of TileSize x TileSize cells
+         * (smaller at the right and bottom edges) and the frames in blocks of BlockFrames frames(the last block can be
+         * shorter). A record of the index is a single tile of a single block, with the frames of a cell stored
+         * consecutive and the cells stored row major.
+         */
+        class OPENPSTD_SHARED_EXPORT TimeSeriesLayout
+        {
+        public:
+            unsigned int TileSize = 32;
+            unsigned int BlockFrames = 64;
+
+            /**
+             * The size of the domain in cells
+             */
+            int Width = 0;
+            int Height = 0;
+
+            /**
+             * The number of frames that are part of the index
+             */
+            unsigned int Frames = 0;
+
+            /**
+             * True if there are no frames in the index
+             */
+            OPENPSTD_SHARED_EXPORT bool IsEmpty() const;
+
+            /**
+             * The number of tiles in the x and y direction
+             */
+            OPENPSTD_SHARED_EXPORT int GetTilesX() const;
+            OPENPSTD_SHARED_EXPORT int GetTilesY() const;
+
+            /**
+             * The number of blocks of frames
+             */
+            OPENPSTD_SHARED_EXPORT unsigned int GetBlockCount() const;
+
+            /**
+             * The number of frames in a block, only the last block can be shorter than BlockFrames
+             */
+            OPENPSTD_SHARED_EXPORT unsigned int GetBlockLength(unsigned int block) const;
+
+            /**
+             * The number of cells of a tile in the x direction
+             */
+            OPENPSTD_SHARED_EXPORT int GetTileWidth(int tileX) const;
+
+            /**
+             * The number of cells of a tile in the y direction
+             */
+            OPENPSTD_SHARED_EXPORT int GetTileHeight(int tileY) const;
+
+            /**
+             * The position of the first frame of a cell in a record of a block
+             */
+            OPENPSTD_SHARED_EXPORT size_t GetCellOffset(int x, int y, unsigned int block) const;
+
+            /**
+             * True if the layout of the tiles and blocks of both layouts is the same, so that an index can be extended
+             */
+            OPENPSTD_SHARED_EXPORT bool IsCompatible(const TimeSeriesLayout &other) const;
+
+            /**
+             * The representation that is stored in the PSTD file
+             */
+            OPENPSTD_SHARED_EXPORT std::vector<char> Encode() const;
+
+            /**
+             * Reads the stored representation, data that is too short results in an empty layout
+             */
+            static OPENPSTD_SHARED_EXPORT TimeSeriesLayout Decode(const char *data, unsigned long long length);
+        };
+    }
+}
+
+#endif //OPENPSTD_TIMESERIESINDEX_H
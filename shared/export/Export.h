@@ -17,8 +17,10 @@ namespace OpenPSTD
         /**
         * Possible export implementations:
         * Images (image/png, image/bmp, image/jpg)
+        * Video streams (video/x-yuv4mpeg, video/x-raw-rgb)
         * HDF5 (application/x-hdf)
         * Wav (audio/wav)
+        * NumPy arrays (application/x-npy, application/octet-stream)
         */
 
         class OPENPSTD_SHARED_EXPORT ExportFormatNotSupported : public std::exception
@@ -3,30 +3,126 @@
 //
 
 #include "HDF5Export.h"
-#include "kernel/MockKernel.h"
 
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include <boost/lexical_cast.hpp>
 
 namespace OpenPSTD
 {
     namespace Shared
     {
+        namespace
+        {
+            /**
+             * An identifier of HDF5 that is closed when it goes out of scope, so that a failed export closes all the
+             * objects that are still open
+             */
+            class H5Handle
+            {
+            private:
+                hid_t _id;
+                herr_t (*_close)(hid_t);
+
+            public:
+                H5Handle(hid_t id, herr_t (*close)(hid_t), const std::string &what) : _id(id), _close(close)
+                {
+                    if(id < 0)
+                        throw std::runtime_error("Could not " + what);
+                }
+
+                H5Handle(const H5Handle &) = delete;
+                H5Handle &operator=(const H5Handle &) = delete;
+
+                ~H5Handle()
+                {
+                    this->_close(this->_id);
+                }
+
+                operator hid_t() const
+                {
+                    return this->_id;
+                }
+            };
+
+            void Check(herr_t status, const std::string &what)
+            {
+                if(status < 0)
+                    throw std::runtime_error("Could not " + what);
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT int HDF5::GetChunkFrames()
+        {
+            return this->_chunkFrames;
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::SetChunkFrames(int value)
+        {
+            this->_chunkFrames = std::max(1, value);
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::GetChunkSize(int &height, int &width)
+        {
+            height = this->_chunkHeight;
+            width = this->_chunkWidth;
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::SetChunkSize(int height, int width)
+        {
+            this->_chunkHeight = std::max(0, height);
+            this->_chunkWidth = std::max(0, width);
+        }
+
+        OPENPSTD_SHARED_EXPORT int HDF5::GetDeflateLevel()
+        {
+            return this->_deflateLevel;
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::SetDeflateLevel(int value)
+        {
+            this->_deflateLevel = std::min(9, std::max(0, value));
+        }
+
+        OPENPSTD_SHARED_EXPORT bool HDF5::GetShuffle()
+        {
+            return this->_shuffle;
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::SetShuffle(bool value)
+        {
+            this->_shuffle = value;
+        }
+
+        OPENPSTD_SHARED_EXPORT int HDF5::GetBatchFrames()
+        {
+            return this->_batchFrames;
+        }
+
+        OPENPSTD_SHARED_EXPORT void HDF5::SetBatchFrames(int value)
+        {
+            this->_batchFrames = std::max(1, value);
+        }
+
         OPENPSTD_SHARED_EXPORT void HDF5::ExportData(std::string format, std::shared_ptr <PSTDFile> file, std::string output,
                               std::vector<int> domains, int startFrame, int endFrame)
         {
-            hid_t file_id;
-            Kernel::MockKernel k;
+            H5Handle file_id(H5Fcreate(output.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT), H5Fclose,
+                             "create " + output);
 
-            file_id = H5Fcreate(output.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+            H5Handle frame_dir_id(H5Gcreate2(file_id, "/frame", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                                  "create /frame in " + output);
 
-            hid_t frame_dir_id = H5Gcreate2(file_id, "/frame", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-            hid_t receiver_dir_id = H5Gcreate2(file_id, "/receiver", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            auto metadata = file->GetResultsMetadata();
 
-            k.initialize_kernel(file->GetSceneConf());
-            auto metadata = k.get_metadata();
+            float gridSpacing = metadata.GridSpacing;
+            float timeStep = metadata.TimeStep;
+            Check(H5LTset_attribute_float(file_id, "/", "grid_spacing", &gridSpacing, 1), "write the grid spacing to " + output);
+            Check(H5LTset_attribute_float(file_id, "/", "time_step", &timeStep, 1), "write the time step to " + output);
 
             if (domains.size() == 0)
             {
@@ -41,42 +137,130 @@ namespace OpenPSTD
             for(int d : domains)
             {
                 std::string domainLoc = "/frame/" + boost::lexical_cast<std::string>(d);
-                hid_t frame_index_id = H5Gcreate2(file_id, domainLoc.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
-                if (startFrame == -1) startFrame = 0;
-                if (endFrame == -1) endFrame = file->GetResultsFrameCount(d) - 1;
-                for (int f = startFrame; f <= endFrame; ++f)
+                int first = startFrame == -1 ? 0 : startFrame;
+                int last = endFrame == -1 ? file->GetResultsFrameCount(d) - 1 : endFrame;
+                last = std::min(last, file->GetResultsFrameCount(d) - 1);
+                hsize_t frameCount = (hsize_t)std::max(0, last - first + 1);
+
+                // the frames are stored row major with y as the outer dimension
+                hsize_t width = (hsize_t)metadata.DomainMetadata[d][0];
+                hsize_t height = (hsize_t)metadata.DomainMetadata[d][1];
+                hsize_t frameSize = width * height;
+
+                hsize_t dims[3] = {0, height, width};
+                hsize_t maxDims[3] = {H5S_UNLIMITED, height, width};
+
+                H5Handle plist_id(H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "create the properties of " + domainLoc);
+                if(frameSize == 0)
                 {
-                    std::string location = domainLoc + "/" + boost::lexical_cast<std::string>(f);
+                    // an empty domain can not be chunked, the dataset gets its final size without any data
+                    dims[0] = maxDims[0] = frameCount;
+                }
+                else
+                {
+                    hsize_t chunk[3] = {
+                            std::min((hsize_t)this->_chunkFrames, std::max((hsize_t)1, frameCount)),
+                            this->_chunkHeight > 0 ? std::min((hsize_t)this->_chunkHeight, height) : height,
+                            this->_chunkWidth > 0 ? std::min((hsize_t)this->_chunkWidth, width) : width
+                    };
+                    // a chunk of HDF5 is limited to 4 GiB, so the full size of the domain is only used when it fits
+                    // in the budget, otherwise the default is reduced to less rows(and columns)
+                    hsize_t budget = HDF5_EXPORT_CHUNK_BYTES / sizeof(float);
+                    if(this->_chunkHeight == 0)
+                        chunk[1] = std::max((hsize_t)1, std::min(height, budget / (chunk[0] * chunk[2])));
+                    if(this->_chunkWidth == 0)
+                        chunk[2] = std::max((hsize_t)1, std::min(width, budget / (chunk[0] * chunk[1])));
+
+                    Check(H5Pset_chunk(plist_id, 3, chunk), "set the chunks of " + domainLoc);
+                    if(this->_deflateLevel > 0)
+                    {
+                        if(this->_shuffle)
+                            Check(H5Pset_shuffle(plist_id), "set the shuffle filter of " + domainLoc);
+                        Check(H5Pset_deflate(plist_id, (unsigned int)this->_deflateLevel),
+                              "set the deflate filter of " + domainLoc);
+                    }
+                }
+
+                H5Handle space_id(H5Screate_simple(3, dims, maxDims), H5Sclose, "create the space of " + domainLoc);
+                H5Handle dataset_id(H5Dcreate2(file_id, domainLoc.c_str(), H5T_NATIVE_FLOAT, space_id, H5P_DEFAULT,
+                                               plist_id, H5P_DEFAULT), H5Dclose, "create " + domainLoc + " in " + output);
 
-                    std::vector<hsize_t> size;
-                    size.push_back(metadata.DomainMetadata[d][0]);
-                    size.push_back(metadata.DomainMetadata[d][1]);
+                int position[2] = {metadata.DomainPositions[d][0], metadata.DomainPositions[d][1]};
+                int size[2] = {metadata.DomainMetadata[d][0], metadata.DomainMetadata[d][1]};
+                Check(H5LTset_attribute_int(file_id, domainLoc.c_str(), "position", position, 2),
+                      "write the position of " + domainLoc);
+                Check(H5LTset_attribute_int(file_id, domainLoc.c_str(), "size", size, 2),
+                      "write the size of " + domainLoc);
+                Check(H5LTset_attribute_int(file_id, domainLoc.c_str(), "start_frame", &first, 1),
+                      "write the start frame of " + domainLoc);
 
-                    //get data and write to file
+                if(frameSize == 0)
+                    continue;
+
+                // collect a number of frames and write them with a single hyperslab, a large domain collects less frames
+                hsize_t batchFrames = std::max((hsize_t)1, std::min((hsize_t)this->_batchFrames,
+                                                                    HDF5_EXPORT_BATCH_BYTES / (frameSize * sizeof(float))));
+                std::vector<float> batch;
+                batch.reserve((size_t)(std::min(batchFrames, frameCount) * frameSize));
+                hsize_t written = 0;
+                for (int f = first; f <= last; ++f)
+                {
                     auto data = file->GetResultsFrame(f, d);
-                    H5LTmake_dataset(file_id, location.c_str(), 2, size.data(), H5T_NATIVE_FLOAT, data->data());
-                }
+                    size_t offset = batch.size();
+                    batch.resize(offset + frameSize, 0);
+                    std::copy_n(data->data(), std::min((size_t)data->size(), (size_t)frameSize), batch.begin() + offset);
+
+                    hsize_t batchCount = batch.size() / frameSize;
+                    if(batchCount < batchFrames && f != last)
+                        continue;
 
-                H5Gclose(frame_index_id);
+                    dims[0] = written + batchCount;
+                    Check(H5Dset_extent(dataset_id, dims), "extend " + domainLoc);
+
+                    hsize_t start[3] = {written, 0, 0};
+                    hsize_t count[3] = {batchCount, height, width};
+                    H5Handle filespace_id(H5Dget_space(dataset_id), H5Sclose, "get the space of " + domainLoc);
+                    Check(H5Sselect_hyperslab(filespace_id, H5S_SELECT_SET, start, nullptr, count, nullptr),
+                          "select the frames of " + domainLoc);
+                    H5Handle memspace_id(H5Screate_simple(3, count, nullptr), H5Sclose, "create the space of the frames");
+
+                    Check(H5Dwrite(dataset_id, H5T_NATIVE_FLOAT, memspace_id, filespace_id, H5P_DEFAULT, batch.data()),
+                          "write the frames of " + domainLoc + " to " + output);
+
+                    written += batchCount;
+                    batch.clear();
+                }
             }
 
+            // receivers are padded with NaN when they do not have the same number of samples
             int receiverCount = file->GetResultsReceiverCount();
+            std::vector<Kernel::PSTD_RECEIVER_DATA_PTR> receivers;
+            std::vector<int> lengths;
+            size_t sampleCount = 0;
             for(int r = 0; r < receiverCount; r++)
             {
-                std::string receiverLoc = "/receiver/" + boost::lexical_cast<std::string>(r);
-                auto data = file->GetReceiverData(r);
+                receivers.push_back(file->GetReceiverData(r));
+                lengths.push_back((int)receivers.back()->size());
+                sampleCount = std::max(sampleCount, receivers.back()->size());
+            }
 
-                std::vector<hsize_t> size;
-                size.push_back(data->size());
+            if(receiverCount > 0)
+            {
+                std::vector<float> samples(receiverCount * sampleCount, std::numeric_limits<float>::quiet_NaN());
+                for(int r = 0; r < receiverCount; r++)
+                {
+                    std::copy(receivers[r]->begin(), receivers[r]->end(), samples.begin() + r * sampleCount);
+                }
 
-                H5LTmake_dataset(file_id, receiverLoc.c_str(), 1, size.data(), H5T_NATIVE_FLOAT, data->data());
+                hsize_t size[2] = {(hsize_t)receiverCount, (hsize_t)sampleCount};
+                Check(H5LTmake_dataset(file_id, "/receivers", 2, size, H5T_NATIVE_FLOAT, samples.data()),
+                      "write the receivers to " + output);
+                Check(H5LTset_attribute_int(file_id, "/receivers", "length", lengths.data(), lengths.size()),
+                      "write the lengths of the receivers to " + output);
             }
 
-            /* close file */
-            H5Gclose(frame_dir_id);
-            H5Gclose(receiver_dir_id);
-            H5Fclose (file_id);
+            // the group and the file are closed by their handles
         }
     }
-}
\ No newline at end of file
+}
@@ -8,13 +8,72 @@
 #include "openpstd-shared_export.h"
 #include <shared/PSTDFile.h>
 
+/**
+ * The size of a chunk when the chunk size is not set, a chunk of HDF5 can not be larger than 4 GiB
+ */
+#define HDF5_EXPORT_CHUNK_BYTES (1024 * 1024)
+
+/**
+ * The maximum size of the frames that are written with a single write
+ */
+#define HDF5_EXPORT_BATCH_BYTES (64 * 1024 * 1024)
+
 namespace OpenPSTD
 {
     namespace Shared
     {
+        /**
+         * Exports the results to a HDF5 file.
+         *
+         * Every domain is written as a single extendible dataset /frame/<domain> with the shape frame x y x, chunked
+         * along the time axis. The receivers are written as a single dataset /receivers with the shape receiver x sample.
+         * The grid spacing, time step and positions of the domains are written as attributes.
+         */
         class OPENPSTD_SHARED_EXPORT HDF5
         {
+        private:
+            int _chunkFrames = 16;
+            int _chunkHeight = 0;
+            int _chunkWidth = 0;
+            int _deflateLevel = 0;
+            bool _shuffle = false;
+            int _batchFrames = 64;
+
         public:
+            /**
+             * The number of frames in a single chunk
+             */
+            OPENPSTD_SHARED_EXPORT int GetChunkFrames();
+            OPENPSTD_SHARED_EXPORT void SetChunkFrames(int value);
+
+            /**
+             * The number of rows(y) and columns(x) in a single chunk, 0 uses the full size of the domain as long as the
+             * chunk fits in HDF5_EXPORT_CHUNK_BYTES
+             */
+            OPENPSTD_SHARED_EXPORT void GetChunkSize(int &height, int &width);
+            OPENPSTD_SHARED_EXPORT void SetChunkSize(int height, int width);
+
+            /**
+             * The level of the deflate filter(1-9), 0 disables the filter
+             */
+            OPENPSTD_SHARED_EXPORT int GetDeflateLevel();
+            OPENPSTD_SHARED_EXPORT void SetDeflateLevel(int value);
+
+            /**
+             * Applies the shuffle filter before the deflate filter, this normally improves the compression of floats
+             */
+            OPENPSTD_SHARED_EXPORT bool GetShuffle();
+            OPENPSTD_SHARED_EXPORT void SetShuffle(bool value);
+
+            /**
+             * The number of frames that are written to the file with a single write, limited by HDF5_EXPORT_BATCH_BYTES
+             */
+            OPENPSTD_SHARED_EXPORT int GetBatchFrames();
+            OPENPSTD_SHARED_EXPORT void SetBatchFrames(int value);
+
+            /**
+             * @throws std::runtime_error when the file can not be created or written
+             */
             OPENPSTD_SHARED_EXPORT virtual void ExportData(std::string format, std::shared_ptr<PSTDFile> file, std::string output,
                                     std::vector<int> domains, int startFrame, int endFrame);
         };
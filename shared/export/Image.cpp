@@ -4,13 +4,119 @@
 
 #include "Image.h"
 #include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <shared/BoundedQueue.h>
 #include <shared/Colors.h>
-#include "kernel/MockKernel.h"
+#include <shared/ColorLUT.h>
+#include <shared/FramePyramid.h>
 
 namespace OpenPSTD
 {
     namespace Shared
     {
+        namespace
+        {
+            /**
+             * Describes which domains are drawn where on a single image
+             */
+            struct ImageLayout
+            {
+                int width;
+                int height;
+                bool background;
+                std::vector<int> domains;
+                std::vector<std::vector<int>> positions;
+                std::vector<std::vector<int>> sizes;
+            };
+
+            /**
+             * A frame that is read from the file and has to be colorized
+             */
+            struct ReadItem
+            {
+                std::string output;
+                int frame;
+                std::shared_ptr<const ImageLayout> layout;
+                std::vector<Kernel::PSTD_FRAME_PTR> data;
+                //the colors are scaled between -peak and peak
+                float peak;
+                //position in the export, video frames have to be written in this order
+                size_t index;
+            };
+
+            /**
+             * An image that is colorized and has to be encoded and saved
+             */
+            struct EncodeItem
+            {
+                std::string output;
+                std::shared_ptr<QImage> image;
+                size_t index;
+                //a converted video frame
+                std::vector<char> bytes;
+            };
+
+            const std::string FORMAT_Y4M = "video/x-yuv4mpeg";
+            const std::string FORMAT_RAW_RGB = "video/x-raw-rgb";
+
+            /**
+             * Converts an indexed image to a video frame, the colors of the color table are converted once
+             */
+            std::vector<char> ConvertVideoFrame(const QImage &image, const QVector<QRgb> &colorTable, bool yuv)
+            {
+                int width = image.width();
+                int height = image.height();
+                std::vector<char> result(width * height * 3);
+
+                if (yuv)
+                {
+                    //BT.601 with the limited range, which is the default of Y4M
+                    std::vector<unsigned char> y(colorTable.size()), u(colorTable.size()), v(colorTable.size());
+                    for (int i = 0; i < colorTable.size(); ++i)
+                    {
+                        int r = qRed(colorTable[i]), g = qGreen(colorTable[i]), b = qBlue(colorTable[i]);
+                        y[i] = (unsigned char) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                        u[i] = (unsigned char) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                        v[i] = (unsigned char) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+                    }
+
+                    //planar: all the y values, then all the u values and then all the v values
+                    char *planeY = result.data();
+                    char *planeU = planeY + width * height;
+                    char *planeV = planeU + width * height;
+                    for (int j = 0; j < height; ++j)
+                    {
+                        const uchar *line = image.constScanLine(j);
+                        for (int i = 0; i < width; ++i)
+                        {
+                            *planeY++ = y[line[i]];
+                            *planeU++ = u[line[i]];
+                            *planeV++ = v[line[i]];
+                        }
+                    }
+                }
+                else
+                {
+                    char *out = result.data();
+                    for (int j = 0; j < height; ++j)
+                    {
+                        const uchar *line = image.constScanLine(j);
+                        for (int i = 0; i < width; ++i)
+                        {
+                            QRgb c = colorTable[line[i]];
+                            *out++ = (char) qRed(c);
+                            *out++ = (char) qGreen(c);
+                            *out++ = (char) qBlue(c);
+                        }
+                    }
+                }
+
+                return result;
+            }
+        }
 
         OPENPSTD_SHARED_EXPORT std::vector<std::string> ExportImage::GetFormats()
         {
@@ -18,6 +124,8 @@ namespace OpenPSTD
             result.push_back("image/png");
             result.push_back("image/bmp");
             result.push_back("image/jpg");
+            result.push_back(FORMAT_Y4M);
+            result.push_back(FORMAT_RAW_RGB);
             return result;
         }
 
@@ -30,13 +138,61 @@ namespace OpenPSTD
             _fullView = value;
         }
 
+        OPENPSTD_SHARED_EXPORT bool ExportImage::GetFrameScale()
+        {
+            return _frameScale;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportImage::SetFrameScale(bool value)
+        {
+            _frameScale = value;
+        }
+
+        OPENPSTD_SHARED_EXPORT unsigned int ExportImage::GetLevel()
+        {
+            return _level;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportImage::SetLevel(unsigned int value)
+        {
+            _level = value;
+        }
+
+        OPENPSTD_SHARED_EXPORT int ExportImage::GetFrameRate()
+        {
+            return _frameRate;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportImage::SetFrameRate(int value)
+        {
+            _frameRate = std::max(1, value);
+        }
+
+        OPENPSTD_SHARED_EXPORT int ExportImage::GetJobs()
+        {
+            return _jobs;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportImage::SetJobs(int value)
+        {
+            _jobs = std::max(0, value);
+        }
+
         OPENPSTD_SHARED_EXPORT void ExportImage::ExportData(std::string format, std::shared_ptr<PSTDFile> file, std::string directory,
                                      std::string name, std::vector<int> domains, int startFrame,
                                      int endFrame)
         {
-            Kernel::MockKernel k;
-            k.initialize_kernel(file->GetResultsSceneConf());
-            auto metadata = k.get_metadata();
+            auto formats = this->GetFormats();
+            if(std::find(formats.begin(), formats.end(), format) == formats.end())
+            {
+                throw ExportFormatNotSupported(format, formats);
+            }
+
+            //a video is a single stream with all the domains in every frame
+            bool video = format == FORMAT_Y4M || format == FORMAT_RAW_RGB;
+            bool fullView = this->_fullView || video;
+
+            auto metadata = file->GetResultsMetadata();
 
             if (domains.size() == 0)
             {
@@ -47,203 +203,310 @@ namespace OpenPSTD
                     domains.push_back(d);
                 }
             }
-            float min = std::numeric_limits<float>::infinity();
-            float max = -std::numeric_limits<float>::infinity();
 
-            for (int d = 0; d < domains.size(); ++d)
+            int firstFrame = startFrame == -1 ? 0 : startFrame;
+            auto lastFrame = [endFrame, &file](int d) { return endFrame == -1 ? file->GetResultsFrameCount(d) - 1 : endFrame; };
+
+            //the scale of the colors is based on the statistics that are stored with the frames
+            FrameStatistics statistics;
+            for (int d : domains)
             {
-                if (startFrame == -1) startFrame = 0;
-                if (endFrame == -1) endFrame = file->GetResultsFrameCount(domains[d]) - 1;
-                for (int f = startFrame; f <= endFrame; ++f)
+                FrameStatistics domainStatistics = file->GetResultsStatistics(d);
+                if (firstFrame == 0 && lastFrame(d) == file->GetResultsFrameCount(d) - 1 && !domainStatistics.IsEmpty())
                 {
-                    Kernel::PSTD_FRAME_PTR frame = file->GetResultsFrame(f, domains[d]);
-                    for (int i = 0; i < frame->size(); ++i)
-                    {
-                        min = std::min((*frame)[i], min);
-                        max = std::max((*frame)[i], max);
-                    }
+                    statistics = FrameStatistics::Combine(statistics, domainStatistics);
+                    continue;
+                }
+
+                for (int f = firstFrame; f <= lastFrame(d); ++f)
+                {
+                    statistics = FrameStatistics::Combine(statistics, file->GetResultsFrameStatistics(f, d));
                 }
             }
+            float globalPeak = statistics.GetPeak();
 
-            if(this->_fullView)
+            //the gradient is sampled once, with the full view the last color is used for the parts of the image
+            //that are not covered by a domain
+            StandardColorScheme colorScheme;
+            ColorLUT lut(*colorScheme.ResultsColorGradient(), fullView ? 255 : 256);
+            int background = lut.GetSize();
+            QVector<QRgb> colorTable = QVector<QRgb>::fromStdVector(lut.GetColors());
+            if(fullView)
             {
-                if (startFrame == -1) startFrame = 0;
-                if (endFrame == -1) endFrame = file->GetResultsFrameCount(domains[0]) - 1;
-                for (int f = startFrame; f <= endFrame; ++f)
+                colorTable.push_back(QColor(127, 127, 127).rgb());
+            }
+
+            //layouts of the images and the frames that are shown on them
+            auto levelSize = [this, &metadata](int d) -> std::vector<int>
+            {
+                return {FramePyramid::LevelSize(metadata.DomainMetadata[d][0], this->_level),
+                        FramePyramid::LevelSize(metadata.DomainMetadata[d][1], this->_level)};
+            };
+
+            std::vector<ReadItem> images;
+            if(fullView)
+            {
+                auto layout = std::make_shared<ImageLayout>();
+                int minX = std::numeric_limits<int>::max(), minY = std::numeric_limits<int>::max();
+                for (int d : domains)
+                {
+                    minX = std::min(metadata.DomainPositions[d][0], minX);
+                    minY = std::min(metadata.DomainPositions[d][1], minY);
+                }
+                layout->width = 0;
+                layout->height = 0;
+                layout->background = true;
+                layout->domains = domains;
+                for (int d : domains)
                 {
-                    this->saveFullImage(format, file, directory + "/" + name + "-" + boost::lexical_cast<std::string>(f),
-                                        domains, f, metadata.DomainPositions, metadata.DomainMetadata, min, max);
+                    //the sizes of the levels are rounded up, so neighbouring domains can overlap with a single pixel
+                    std::vector<int> position = {(metadata.DomainPositions[d][0] - minX) >> this->_level,
+                                                 (metadata.DomainPositions[d][1] - minY) >> this->_level};
+                    std::vector<int> size = levelSize(d);
+                    layout->width = std::max(layout->width, position[0] + size[0]);
+                    layout->height = std::max(layout->height, position[1] + size[1]);
+                    layout->positions.push_back(position);
+                    layout->sizes.push_back(size);
+                }
+
+                for (int f = firstFrame; f <= lastFrame(domains[0]); ++f)
+                {
+                    images.push_back({directory + "/" + name + "-" + boost::lexical_cast<std::string>(f), f, layout, {},
+                                      globalPeak, images.size()});
                 }
             }
             else
             {
                 for(int d : domains)
                 {
-                    if (startFrame == -1) startFrame = 0;
-                    if (endFrame == -1) endFrame = file->GetResultsFrameCount(d) - 1;
-                    for (int f = startFrame; f <= endFrame; ++f)
+                    auto layout = std::make_shared<ImageLayout>();
+                    layout->sizes.push_back(levelSize(d));
+                    layout->width = layout->sizes[0][0];
+                    layout->height = layout->sizes[0][1];
+                    layout->background = false;
+                    layout->domains.push_back(d);
+                    layout->positions.push_back({0, 0});
+
+                    for (int f = firstFrame; f <= lastFrame(d); ++f)
                     {
-                        this->saveImage(format, file,
-                                        directory + "/" + name + "-" + boost::lexical_cast<std::string>(d) + "-" +
-                                        boost::lexical_cast<std::string>(f),
-                                        d, f, metadata.DomainMetadata[d], min, max);
+                        images.push_back({directory + "/" + name + "-" + boost::lexical_cast<std::string>(d) + "-" +
+                                          boost::lexical_cast<std::string>(f), f, layout, {}, globalPeak,
+                                          images.size()});
                     }
                 }
             }
 
-        }
-
-        OPENPSTD_SHARED_NO_EXPORT void ExportImage::drawData(std::shared_ptr<QImage> image, Kernel::PSTD_FRAME_PTR frame, float min, float max,
-                                   int colormapSize, std::vector<int> position, std::vector<int> size)
-        {
-            //draw on image
-            auto it = frame->begin();
-            for (int i = 0; i < size[0]; ++i)
+            //a video is written by a single thread in the order of the frames, the file is opened before any
+            //thread of the pipeline is started, so that a failure can be thrown without stopping the threads
+            std::ofstream videoFile;
+            std::ostream *videoStream = nullptr;
+            if(video && !images.empty())
             {
-                for (int j = 0; j < size[1]; ++j)
+                const ImageLayout &layout = *images[0].layout;
+                if(name == "-")
+                {
+                    videoStream = &std::cout;
+                }
+                else
                 {
-                    int color = (int) roundf(((*it) - min) / (max - min) * (colormapSize - 1));
-                    image->setPixel(position[0] + i, position[1] + j, color);
-                    it++;
+                    std::string extension = format == FORMAT_Y4M ? ".y4m" : "-" +
+                            boost::lexical_cast<std::string>(layout.width) + "x" +
+                            boost::lexical_cast<std::string>(layout.height) + ".rgb";
+                    videoFile.open(directory + "/" + name + extension, std::ios::binary | std::ios::trunc);
+                    if(!videoFile)
+                        throw std::runtime_error("Can not open " + directory + "/" + name + extension);
+                    videoStream = &videoFile;
+                }
+
+                if(format == FORMAT_Y4M)
+                {
+                    *videoStream << "YUV4MPEG2 W" << layout.width << " H" << layout.height << " F" << this->_frameRate
+                                 << ":1 Ip A1:1 C444\n";
                 }
             }
-        }
 
-        OPENPSTD_SHARED_NO_EXPORT void ExportImage::saveImage(std::string format, std::shared_ptr<PSTDFile> file, std::string output, int domain,
-                                    int frame, std::vector<int> size, float min, float max)
-        {
-            //create image
-            std::shared_ptr<QImage> result = std::make_shared<QImage>(size[0], size[1], QImage::Format_Indexed8);
+            //the pipeline: the file is read by this thread, colorizing and encoding is done by pools of threads
+            int jobs = this->_jobs > 0 ? this->_jobs : std::max(1u, boost::thread::hardware_concurrency());
+            BoundedQueue<ReadItem> readQueue(2 * jobs);
+            BoundedQueue<EncodeItem> encodeQueue(2 * jobs);
 
-            //create colormap
-            MultiColorGradient colorScheme;
-            if (min < 0)
+            boost::mutex errorMutex;
+            std::exception_ptr error;
+            auto fail = [&]()
             {
-                colorScheme.AddColor(min, QColor(0, 0, 255, 255));
-                colorScheme.AddColor(0, QColor(0, 0, 0, 255));
-                colorScheme.AddColor(max, QColor(255, 0, 0, 255));
-            }
-            else
-            {
-                colorScheme.AddColor(min, QColor(0, 0, 0, 255));
-                colorScheme.AddColor(max, QColor(255, 0, 0, 255));
-            }
+                boost::unique_lock<boost::mutex> lock(errorMutex);
+                if(!error) error = std::current_exception();
+                readQueue.Abort();
+                encodeQueue.Abort();
+            };
 
-            std::vector<QRgb> colorMap = *colorScheme.CreateColorRGBMap(min, max, 256);
-            for (int i = 0; i < colorMap.size(); ++i)
+            boost::thread_group colorizers;
+            for (int i = 0; i < jobs; ++i)
             {
-                result->setColor(i, colorMap[i]);
-            }
-
-            //get data
-            auto data = file->GetResultsFrame(frame, domain);
+                colorizers.create_thread([&]()
+                {
+                    try
+                    {
+                        ReadItem item;
+                        while(readQueue.Pop(item))
+                        {
+                            const ImageLayout &layout = *item.layout;
+                            auto image = std::make_shared<QImage>(layout.width, layout.height, QImage::Format_Indexed8);
+                            image->setColorTable(colorTable);
+                            if(layout.background)
+                            {
+                                image->fill((uint) background);
+                            }
 
-            //position
-            std::vector<int> position = {0, 0};
+                            //a peak of 0 has no scale, the values are all shown as 0
+                            float peak = item.peak > 0 ? item.peak : 1;
+                            for (size_t n = 0; n < layout.domains.size(); ++n)
+                            {
+                                this->drawData(*image, *item.data[n], lut, -peak, peak, layout.positions[n],
+                                               layout.sizes[n]);
+                            }
 
-            //draw on image
-            drawData(result, data, min, max, colorMap.size(), position, size);
+                            EncodeItem encodeItem = {item.output, image, item.index, {}};
+                            if(video)
+                            {
+                                encodeItem.bytes = ConvertVideoFrame(*image, colorTable, format == FORMAT_Y4M);
+                                encodeItem.image = nullptr;
+                            }
 
-            //save image
-            if (format == "image/png")
-            {
-                result->save(QString::fromStdString(output + ".png"));
-            }
-            else if (format == "image/bmp")
-            {
-                result->save(QString::fromStdString(output + ".bmp"));
+                            if(!encodeQueue.Push(std::move(encodeItem)))
+                                break;
+                        }
+                    }
+                    catch (...)
+                    {
+                        fail();
+                    }
+                });
             }
-            else if (format == "image/jpg")
+
+            boost::thread_group encoders;
+            if(video)
             {
-                result->save(QString::fromStdString(output + ".jpg"));
+                encoders.create_thread([&]()
+                {
+                    try
+                    {
+                        //the colorizers finish frames out of order, frames wait until their predecessors are written
+                        std::map<size_t, std::vector<char>> pending;
+                        size_t next = 0;
+                        EncodeItem item;
+                        while(encodeQueue.Pop(item))
+                        {
+                            pending[item.index] = std::move(item.bytes);
+                            while(!pending.empty() && pending.begin()->first == next)
+                            {
+                                if(format == FORMAT_Y4M)
+                                {
+                                    *videoStream << "FRAME\n";
+                                }
+                                videoStream->write(pending.begin()->second.data(), pending.begin()->second.size());
+                                if(!*videoStream)
+                                    throw std::runtime_error("Can not write the video stream");
+                                pending.erase(pending.begin());
+                                next++;
+                            }
+                        }
+                    }
+                    catch (...)
+                    {
+                        fail();
+                    }
+                });
             }
             else
             {
-                throw ExportFormatNotSupported(format, this->GetFormats());
+                for (int i = 0; i < jobs; ++i)
+                {
+                    encoders.create_thread([&]()
+                    {
+                        try
+                        {
+                            EncodeItem item;
+                            while(encodeQueue.Pop(item))
+                            {
+                                this->saveImage(format, *item.image, item.output);
+                            }
+                        }
+                        catch (...)
+                        {
+                            fail();
+                        }
+                    });
+                }
             }
-        }
 
-        OPENPSTD_SHARED_NO_EXPORT void ExportImage::saveFullImage(std::string format, std::shared_ptr<PSTDFile> file, std::string output,
-                                        std::vector<int> domains, int frame, std::vector<std::vector<int>> positions,
-                                        std::vector<std::vector<int>> sizes, float min, float max)
-        {
-            //gets the maximal values of the frame
-            int minX = std::numeric_limits<int>::max(), minY = std::numeric_limits<int>::max();
-            int maxX = std::numeric_limits<int>::min(), maxY = std::numeric_limits<int>::min();
-
-            for (int d : domains)
+            try
             {
-                int x = positions[d][0];
-                minX = std::min(x, minX);
-                maxX = std::max(positions[d][0] + sizes[d][0], maxX);
+                for (ReadItem &item : images)
+                {
+                    if(this->_frameScale)
+                    {
+                        item.peak = 0;
+                    }
+                    for (int d : item.layout->domains)
+                    {
+                        item.data.push_back(file->GetResultsFrameLevel(item.frame, d, this->_level));
+                        if(this->_frameScale)
+                        {
+                            item.peak = std::max(item.peak, file->GetResultsFrameStatistics(item.frame, d).GetPeak());
+                        }
+                    }
 
-                minY = std::min(positions[d][1], minY);
-                maxY = std::max(positions[d][1] + sizes[d][1], maxY);
+                    if(!readQueue.Push(std::move(item)))
+                        break;
+                }
             }
-
-            maxX = maxX - minX;
-            maxY = maxY - minY;
-
-            for (int i = 0; i < positions.size(); ++i)
+            catch (...)
             {
-                positions[i][0] = positions[i][0] - minX;
-                positions[i][1] = positions[i][1] - minY;
+                fail();
             }
 
-            //create image
-            std::shared_ptr<QImage> result = std::make_shared<QImage>(maxX, maxY, QImage::Format_Indexed8);
-
-            //create colormap
-            MultiColorGradient colorScheme;
-            if (min < 0)
-            {
-                colorScheme.AddColor(min, QColor(0, 0, 255, 255));
-                colorScheme.AddColor(0, QColor(0, 0, 0, 255));
-                colorScheme.AddColor(max, QColor(255, 0, 0, 255));
-            }
-            else
-            {
-                colorScheme.AddColor(min, QColor(0, 0, 0, 255));
-                colorScheme.AddColor(max, QColor(255, 0, 0, 255));
-            }
+            readQueue.Close();
+            colorizers.join_all();
+            encodeQueue.Close();
+            encoders.join_all();
 
-            std::vector<QRgb> colorMap = *colorScheme.CreateColorRGBMap(min, max, 255);
-            for (int i = 0; i < colorMap.size(); ++i)
+            if(videoStream)
             {
-                result->setColor(i, colorMap[i]);
+                videoStream->flush();
             }
-            //back color
-            result->setColor(255, QColor(127, 127, 127).rgb());
 
-            for (int i = 0; i < maxX; ++i)
+            if(error)
             {
-                for (int j = 0; j < maxY; ++j)
-                {
-                    result->setPixel(i, j, 255);
-                }
+                std::rethrow_exception(error);
             }
+        }
 
-            for (int d : domains)
+        OPENPSTD_SHARED_EXPORT void ExportImage::drawData(QImage &image, const Kernel::PSTD_FRAME &frame, const ColorLUT &lut,
+                                   float min, float max, std::vector<int> position, std::vector<int> size)
+        {
+            //the frame is row major with y as the outer dimension, so every row is converted into a single scanline
+            const float *row = frame.data();
+            for (int j = 0; j < size[1]; ++j)
             {
-                //get data
-                auto data = file->GetResultsFrame(frame, d);
-
-                //draw on image
-                drawData(result, data, min, max, colorMap.size(), positions[d], sizes[d]);
+                lut.MapIndices(row, (size_t)size[0], min, max, image.scanLine(position[1] + j) + position[0]);
+                row += size[0];
             }
+        }
 
-            //save image
+        OPENPSTD_SHARED_NO_EXPORT void ExportImage::saveImage(std::string format, const QImage &image, std::string output)
+        {
             if (format == "image/png")
             {
-                result->save(QString::fromStdString(output + ".png"));
+                image.save(QString::fromStdString(output + ".png"));
             }
             else if (format == "image/bmp")
             {
-                result->save(QString::fromStdString(output + ".bmp"));
+                image.save(QString::fromStdString(output + ".bmp"));
             }
             else if (format == "image/jpg")
             {
-                result->save(QString::fromStdString(output + ".jpg"));
+                image.save(QString::fromStdString(output + ".jpg"));
             }
             else
             {
@@ -7,6 +7,7 @@
 
 #include "openpstd-shared_export.h"
 #include "Export.h"
+#include <shared/ColorLUT.h>
 #include <shared/PSTDFile.h>
 #include <string>
 #include <vector>
@@ -20,24 +21,32 @@ namespace OpenPSTD
         {
         private:
             bool _fullView;
+            bool _frameScale = false;
+            int _frameRate = 25;
+            unsigned int _level = 0;
+            int _jobs = 0;
 
-            OPENPSTD_SHARED_NO_EXPORT void saveImage(std::string format, std::shared_ptr<PSTDFile> file, std::string output,
-                           int domain, int frame, std::vector<int> size, float min, float max);
-
-            OPENPSTD_SHARED_NO_EXPORT void saveFullImage(std::string format, std::shared_ptr<PSTDFile> file, std::string output,
-                               std::vector<int> domains, int frame, std::vector<std::vector<int>> positions,
-                               std::vector<std::vector<int>> sizes, float min, float max);
-
-            OPENPSTD_SHARED_NO_EXPORT void drawData(std::shared_ptr<QImage> image, Kernel::PSTD_FRAME_PTR frame, float min, float max,
-                          int colormapSize, std::vector<int> position, std::vector<int> size);
+            OPENPSTD_SHARED_NO_EXPORT void saveImage(std::string format, const QImage &image, std::string output);
 
         public:
             /**
              * Creates a vector with strings that describes the formats that are supported. Every element should be in the
              * mime type format, for example the png format uses image/png.
+             *
+             * The video formats write all frames with the full view in a single uncompressed stream, that can be read
+             * by an external encoder: video/x-yuv4mpeg(<name>.y4m, YUV 4:4:4) and video/x-raw-rgb
+             * (<name>-<width>x<height>.rgb, 24 bits RGB). With the name - the stream is written to the standard output.
              */
             OPENPSTD_SHARED_EXPORT virtual std::vector<std::string> GetFormats();
 
+            /**
+             * Draws a frame into an indexed image, the values from min to max are mapped to the colors of the LUT.
+             * @param position: The position of the frame in the image.
+             * @param size: The width and height of the frame.
+             */
+            OPENPSTD_SHARED_EXPORT void drawData(QImage &image, const Kernel::PSTD_FRAME &frame, const ColorLUT &lut,
+                                                 float min, float max, std::vector<int> position, std::vector<int> size);
+
 
             /**
              * This is where every domain is written to a single frame.
@@ -51,6 +60,52 @@ namespace OpenPSTD
              */
             OPENPSTD_SHARED_EXPORT void SetFullView(bool value);
 
+            /**
+             * Scales the colors of every frame with the peak of that frame instead of the peak of all the exported
+             * frames. The peaks are taken from the statistics that are stored with the results.
+             */
+            OPENPSTD_SHARED_EXPORT bool GetFrameScale();
+
+            /**
+             * Scales the colors of every frame with the peak of that frame instead of the peak of all the exported
+             * frames. The peaks are taken from the statistics that are stored with the results.
+             */
+            OPENPSTD_SHARED_EXPORT void SetFrameScale(bool value);
+
+            /**
+             * The preview level of the frames that are exported, every level halves the size of the images(see
+             * FramePyramid). Level 0 exports the frames at full resolution.
+             */
+            OPENPSTD_SHARED_EXPORT unsigned int GetLevel();
+
+            /**
+             * The preview level of the frames that are exported, every level halves the size of the images(see
+             * FramePyramid). Level 0 exports the frames at full resolution.
+             */
+            OPENPSTD_SHARED_EXPORT void SetLevel(unsigned int value);
+
+            /**
+             * The number of frames per second of the video formats
+             */
+            OPENPSTD_SHARED_EXPORT int GetFrameRate();
+
+            /**
+             * The number of frames per second of the video formats
+             */
+            OPENPSTD_SHARED_EXPORT void SetFrameRate(int value);
+
+            /**
+             * The number of threads that colorize and the number of threads that encode the images.
+             * 0 uses the number of cores of the machine.
+             */
+            OPENPSTD_SHARED_EXPORT int GetJobs();
+
+            /**
+             * The number of threads that colorize and the number of threads that encode the images.
+             * 0 uses the number of cores of the machine.
+             */
+            OPENPSTD_SHARED_EXPORT void SetJobs(int value);
+
             /**
              * Exports a number of frames.
              * @param format: The format that has to be exported, this has to be one of the formats that is returned by GetFormats.
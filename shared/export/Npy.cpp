@@ -0,0 +1,157 @@
+//
+// Created by michiel on 19-10-2026.
+//
+
+#include "Npy.h"
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        namespace
+        {
+            const std::string FORMAT_NPY = "application/x-npy";
+            const std::string FORMAT_RAW = "application/octet-stream";
+
+            /**
+             * The data of a NPY file is aligned on this number of bytes
+             */
+            const size_t NPY_ALIGNMENT = 64;
+
+            /**
+             * The numpy type of the frame values, the values are written in the byte order of the machine
+             */
+            std::string FrameDtype()
+            {
+                const uint16_t value = 1;
+                return *((const char *) &value) == 1 ? "<f4" : ">f4";
+            }
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<std::string> ExportNpy::GetFormats()
+        {
+            std::vector<std::string> result;
+            result.push_back(FORMAT_NPY);
+            result.push_back(FORMAT_RAW);
+            return result;
+        }
+
+        std::string ExportNpy::createHeader(unsigned long long frames, unsigned long long height,
+                                            unsigned long long width)
+        {
+            std::ostringstream dict;
+            dict << "{'descr': '" << FrameDtype() << "', 'fortran_order': False, 'shape': ("
+                 << frames << ", " << height << ", " << width << "), }";
+
+            //magic, version and length of the header(10 bytes) followed by the padded header ending with a newline
+            std::string header = dict.str();
+            size_t total = 10 + header.size() + 1;
+            header.append((NPY_ALIGNMENT - total % NPY_ALIGNMENT) % NPY_ALIGNMENT, ' ');
+            header.push_back('\n');
+
+            std::string result("\x93NUMPY\x01\x00", 8);
+            result.push_back((char) (header.size() & 0xFF));
+            result.push_back((char) ((header.size() >> 8) & 0xFF));
+            return result + header;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportNpy::ExportData(std::string format, std::shared_ptr<PSTDFile> file,
+                                                          std::string directory, std::string name,
+                                                          std::vector<int> domains, int startFrame, int endFrame)
+        {
+            std::vector<std::string> formats = this->GetFormats();
+            if (std::find(formats.begin(), formats.end(), format) == formats.end())
+            {
+                throw ExportFormatNotSupported(format, formats);
+            }
+            bool npy = format == FORMAT_NPY;
+
+            auto metadata = file->GetResultsMetadata();
+
+            if (domains.size() == 0)
+            {
+                int domainCount = file->GetResultsDomainCount();
+
+                for (int d = 0; d < domainCount; ++d)
+                {
+                    domains.push_back(d);
+                }
+            }
+
+            int saveNth = file->GetResultsSceneConf()->Settings.GetSaveNth();
+
+            std::ostringstream json;
+            json.precision(7);
+            json << "{\n";
+            json << "  \"format\": \"" << (npy ? "npy" : "raw") << "\",\n";
+            json << "  \"dtype\": \"" << FrameDtype() << "\",\n";
+            json << "  \"order\": \"C\",\n";
+            json << "  \"grid_spacing\": " << metadata.GridSpacing << ",\n";
+            json << "  \"time_step\": " << metadata.TimeStep << ",\n";
+            json << "  \"save_nth\": " << saveNth << ",\n";
+            json << "  \"frame_time\": " << metadata.TimeStep * saveNth << ",\n";
+            json << "  \"domains\": [";
+
+            for (unsigned int i = 0; i < domains.size(); i++)
+            {
+                int d = domains[i];
+
+                int first = startFrame == -1 ? 0 : startFrame;
+                int last = endFrame == -1 ? file->GetResultsFrameCount(d) - 1 : endFrame;
+                last = std::min(last, file->GetResultsFrameCount(d) - 1);
+                unsigned long long frameCount = (unsigned long long) std::max(0, last - first + 1);
+
+                // the frames are stored row major with y as the outer dimension
+                unsigned long long width = (unsigned long long) metadata.DomainMetadata[d][0];
+                unsigned long long height = (unsigned long long) metadata.DomainMetadata[d][1];
+
+                std::string filename = name + "-" + boost::lexical_cast<std::string>(d) + (npy ? ".npy" : ".raw");
+                std::ofstream out(directory + "/" + filename, std::ios::binary | std::ios::trunc);
+                if (!out)
+                {
+                    throw std::runtime_error("Could not create " + directory + "/" + filename);
+                }
+
+                std::string header = npy ? this->createHeader(frameCount, height, width) : "";
+                out.write(header.data(), header.size());
+
+                for (int frame = first; frame <= last; frame++)
+                {
+                    file->ReadResultsFrameData((unsigned int) frame, (unsigned int) d,
+                                               [&out](const char *data, size_t length)
+                                               {
+                                                   out.write(data, length);
+                                               });
+                }
+
+                if (!out)
+                {
+                    throw std::runtime_error("Could not write " + directory + "/" + filename);
+                }
+
+                json << (i == 0 ? "\n" : ",\n");
+                json << "    {\n";
+                json << "      \"domain\": " << d << ",\n";
+                json << "      \"file\": \"" << filename << "\",\n";
+                json << "      \"offset\": " << header.size() << ",\n";
+                json << "      \"shape\": [" << frameCount << ", " << height << ", " << width << "],\n";
+                json << "      \"position\": [" << metadata.DomainPositions[d][0] << ", "
+                     << metadata.DomainPositions[d][1] << "],\n";
+                json << "      \"start_frame\": " << first << "\n";
+                json << "    }";
+            }
+
+            json << (domains.empty() ? "]\n" : "\n  ]\n");
+            json << "}\n";
+
+            std::ofstream sidecar(directory + "/" + name + ".json", std::ios::trunc);
+            sidecar << json.str();
+        }
+    }
+}
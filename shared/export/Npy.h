@@ -0,0 +1,54 @@
+//
+// Created by michiel on 19-10-2026.
+//
+
+#ifndef OPENPSTD_NPY_H
+#define OPENPSTD_NPY_H
+
+#include "openpstd-shared_export.h"
+#include "Export.h"
+#include <shared/PSTDFile.h>
+#include <string>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Exports the frames of every domain as a single contiguous array of 32 bits floats in C order with the shape
+         * (frames, height, width), so that it can be memory mapped(e.g. numpy.load with mmap_mode).
+         *
+         * application/x-npy writes <name>-<domain>.npy with a NPY 1.0 header, application/octet-stream writes
+         * <name>-<domain>.raw without a header. Both write <name>.json with the metadata of the simulation and for
+         * every domain the file, the shape and the offset of the data in the file.
+         *
+         * When the frames are stored raw, the stored bytes are copied directly to the file.
+         */
+        class OPENPSTD_SHARED_EXPORT ExportNpy
+        {
+        private:
+            OPENPSTD_SHARED_NO_EXPORT std::string createHeader(unsigned long long frames, unsigned long long height,
+                                                               unsigned long long width);
+
+        public:
+            OPENPSTD_SHARED_EXPORT virtual std::vector<std::string> GetFormats();
+
+            /**
+             * Exports a number of frames.
+             * @param format: The format that has to be exported, this has to be one of the formats that is returned by GetFormats.
+             * @param file: The file from where the export must be done.
+             * @param directory: The directory where the output must be written too.
+             * @param name: The name that must be used for the output files, without extension.
+             * @param domains: A list of domains that has to be exported. With an empty list, all the domains are exported.
+             * @param startFrame: The first frame that must be exported (included). -1 when it should start with the first frame.
+             * @param endFrame: The last frame that must be exported (included). -1 when it should should finish with the last frame.
+             */
+            OPENPSTD_SHARED_EXPORT virtual void ExportData(std::string format, std::shared_ptr<PSTDFile> file,
+                                                           std::string directory, std::string name,
+                                                           std::vector<int> domains, int startFrame, int endFrame);
+        };
+    }
+}
+
+#endif //OPENPSTD_NPY_H
@@ -0,0 +1,295 @@
+//
+// Created by michiel on 19-10-2026.
+//
+
+#include "Wav.h"
+#include <shared/Resampler.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        namespace
+        {
+            const std::string FORMAT_WAV = "audio/wav";
+
+            /**
+             * The number of samples of a single channel that is converted at once
+             */
+            const size_t BLOCK_SAMPLES = 64 * 1024;
+
+            const uint16_t WAVE_FORMAT_PCM = 1;
+            const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+
+            /**
+             * Stores the lowest bytes of a value little endian, independent of the byte order of the host
+             * @return the position after the stored bytes
+             */
+            char *PutLE(char *p, uint32_t value, int bytes)
+            {
+                for (int i = 0; i < bytes; i++)
+                {
+                    *p++ = (char) ((value >> (8 * i)) & 0xFF);
+                }
+                return p;
+            }
+
+            void WriteLE(std::ostream &out, uint32_t value, int bytes)
+            {
+                char buffer[4];
+                out.write(buffer, PutLE(buffer, value, bytes) - buffer);
+            }
+
+            /**
+             * The size of the data chunk, the sizes of a WAV file are 32 bits, so longer files can not be written
+             */
+            uint32_t DataBytes(int channels, bool floatSamples, unsigned long long frames)
+            {
+                unsigned long long sampleBytes = floatSamples ? 4 : 2;
+                unsigned long long dataBytes = frames * channels * sampleBytes;
+                //the RIFF chunk contains the other chunks(at most 4 + 24 + 12 + 8 bytes) and the data
+                if (dataBytes + 48 > UINT32_MAX)
+                {
+                    throw std::runtime_error("the receivers are too long for a WAV file(" +
+                                             std::to_string(dataBytes) + " bytes of samples, at most 4 GiB), "
+                                                     "use less receivers or a lower sample rate");
+                }
+                return (uint32_t) dataBytes;
+            }
+
+            void WriteHeader(std::ostream &out, int channels, int sampleRate, bool floatSamples,
+                             unsigned long long frames)
+            {
+                int sampleBytes = floatSamples ? 4 : 2;
+                uint32_t dataBytes = DataBytes(channels, floatSamples, frames);
+                //float data has a fact chunk with the number of frames
+                uint32_t factBytes = floatSamples ? 12 : 0;
+
+                out.write("RIFF", 4);
+                WriteLE(out, 4 + 24 + factBytes + 8 + dataBytes, 4);
+                out.write("WAVE", 4);
+
+                out.write("fmt ", 4);
+                WriteLE(out, 16, 4);
+                WriteLE(out, floatSamples ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM, 2);
+                WriteLE(out, (uint32_t) channels, 2);
+                WriteLE(out, (uint32_t) sampleRate, 4);
+                WriteLE(out, (uint32_t) (sampleRate * channels * sampleBytes), 4);
+                WriteLE(out, (uint32_t) (channels * sampleBytes), 2);
+                WriteLE(out, (uint32_t) (8 * sampleBytes), 2);
+
+                if (floatSamples)
+                {
+                    out.write("fact", 4);
+                    WriteLE(out, 4, 4);
+                    WriteLE(out, (uint32_t) frames, 4);
+                }
+
+                out.write("data", 4);
+                WriteLE(out, dataBytes, 4);
+            }
+
+            /**
+             * Removes the temporary files of the resampled channels, also when the export fails
+             */
+            struct TemporaryFiles
+            {
+                std::vector<boost::filesystem::path> paths;
+
+                ~TemporaryFiles()
+                {
+                    for (auto &path : paths)
+                    {
+                        boost::system::error_code ec;
+                        boost::filesystem::remove(path, ec);
+                    }
+                }
+            };
+        }
+
+        OPENPSTD_SHARED_EXPORT std::vector<std::string> ExportWav::GetFormats()
+        {
+            auto result = std::vector<std::string>();
+            result.push_back(FORMAT_WAV);
+            return result;
+        }
+
+        OPENPSTD_SHARED_EXPORT int ExportWav::GetSampleRate()
+        {
+            return _sampleRate;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportWav::SetSampleRate(int value)
+        {
+            _sampleRate = std::max(1, value);
+        }
+
+        OPENPSTD_SHARED_EXPORT bool ExportWav::GetNormalize()
+        {
+            return _normalize;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportWav::SetNormalize(bool value)
+        {
+            _normalize = value;
+        }
+
+        OPENPSTD_SHARED_EXPORT bool ExportWav::GetFloatSamples()
+        {
+            return _floatSamples;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportWav::SetFloatSamples(bool value)
+        {
+            _floatSamples = value;
+        }
+
+        OPENPSTD_SHARED_EXPORT void ExportWav::ExportData(std::string format, std::shared_ptr<PSTDFile> file,
+                                                          std::string output, std::vector<int> receivers)
+        {
+            auto formats = this->GetFormats();
+            if(std::find(formats.begin(), formats.end(), format) == formats.end())
+            {
+                throw ExportFormatNotSupported(format, formats);
+            }
+
+            if (receivers.size() == 0)
+            {
+                for (int r = 0; r < file->GetResultsReceiverCount(); ++r)
+                {
+                    receivers.push_back(r);
+                }
+            }
+
+            //the receivers are written every SaveNth time step
+            auto metadata = file->GetResultsMetadata();
+            double inputRate = 1.0 / (metadata.TimeStep * file->GetResultsSceneConf()->Settings.GetSaveNth());
+
+            //first every channel is resampled to a temporary file, the peak of all channels is needed for the
+            //normalization and the WAV file is interleaved
+            TemporaryFiles channels;
+            std::vector<unsigned long long> lengths;
+            float peak = 0;
+            for (int r : receivers)
+            {
+                channels.paths.push_back(boost::filesystem::temp_directory_path() /
+                                         boost::filesystem::unique_path("openpstd-wav-%%%%%%%%.raw"));
+                std::string channelPath = channels.paths.back().string();
+                std::ofstream channel(channelPath, std::ios::binary);
+                if (!channel)
+                {
+                    throw std::runtime_error("can not write the temporary file " + channelPath);
+                }
+
+                Resampler resampler(inputRate, this->_sampleRate);
+                std::vector<float> resampled;
+                unsigned long long length = 0;
+                auto write = [&]()
+                {
+                    for (float v : resampled)
+                    {
+                        peak = std::max(peak, std::abs(v));
+                    }
+                    channel.write((const char *) resampled.data(), resampled.size() * sizeof(float));
+                    if (!channel)
+                    {
+                        throw std::runtime_error("can not write the temporary file " + channelPath);
+                    }
+                    length += resampled.size();
+                    resampled.clear();
+                };
+
+                file->ReadReceiverData(r, [&](const float *data, size_t count)
+                {
+                    //the blocks of the file can be large, the output is written in smaller blocks
+                    for (size_t i = 0; i < count; i += BLOCK_SAMPLES)
+                    {
+                        resampler.Process(data + i, std::min(BLOCK_SAMPLES, count - i), resampled);
+                        write();
+                    }
+                });
+                resampler.Flush(resampled);
+                write();
+                channel.close();
+                if (!channel)
+                {
+                    throw std::runtime_error("can not write the temporary file " + channelPath);
+                }
+                lengths.push_back(length);
+            }
+
+            unsigned long long frames = lengths.empty() ? 0 : *std::max_element(lengths.begin(), lengths.end());
+            float scale = this->_normalize && peak > 0 ? 1 / peak : 1;
+            //fails before the output is created when the file is too long
+            DataBytes((int) receivers.size(), this->_floatSamples, frames);
+
+            std::ofstream out(output, std::ios::binary);
+            if (!out)
+            {
+                throw std::runtime_error("can not write " + output);
+            }
+            WriteHeader(out, (int) receivers.size(), this->_sampleRate, this->_floatSamples, frames);
+
+            std::vector<std::unique_ptr<std::ifstream>> inputs;
+            for (auto &path : channels.paths)
+            {
+                inputs.push_back(std::unique_ptr<std::ifstream>(new std::ifstream(path.string(), std::ios::binary)));
+            }
+
+            //interleave the channels, channels that are shorter are padded with zeros
+            std::vector<std::vector<float>> blocks(receivers.size(), std::vector<float>(BLOCK_SAMPLES));
+            std::vector<char> interleaved;
+            for (unsigned long long first = 0; first < frames; first += BLOCK_SAMPLES)
+            {
+                size_t count = (size_t) std::min<unsigned long long>(BLOCK_SAMPLES, frames - first);
+                for (size_t c = 0; c < receivers.size(); c++)
+                {
+                    size_t available = (size_t) std::min<unsigned long long>(count, lengths[c] > first ?
+                                                                                    lengths[c] - first : 0);
+                    inputs[c]->read((char *) blocks[c].data(), available * sizeof(float));
+                    if (!*inputs[c])
+                    {
+                        throw std::runtime_error("can not read the temporary file " + channels.paths[c].string());
+                    }
+                    std::fill(blocks[c].begin() + available, blocks[c].begin() + count, 0.0f);
+                }
+
+                interleaved.resize(count * receivers.size() * (this->_floatSamples ? 4 : 2));
+                char *p = interleaved.data();
+                for (size_t i = 0; i < count; i++)
+                {
+                    for (size_t c = 0; c < receivers.size(); c++)
+                    {
+                        float v = blocks[c][i] * scale;
+                        if (this->_floatSamples)
+                        {
+                            uint32_t bits;
+                            std::memcpy(&bits, &v, 4);
+                            p = PutLE(p, bits, 4);
+                        }
+                        else
+                        {
+                            int16_t s = (int16_t) std::lrint(std::max(-1.0f, std::min(1.0f, v)) * 32767);
+                            p = PutLE(p, (uint16_t) s, 2);
+                        }
+                    }
+                }
+                out.write(interleaved.data(), interleaved.size());
+            }
+
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("can not write " + output);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+//
+// Created by michiel on 19-10-2026.
+//
+
+#ifndef OPENPSTD_WAV_H
+#define OPENPSTD_WAV_H
+
+#include "openpstd-shared_export.h"
+#include "Export.h"
+#include <shared/PSTDFile.h>
+#include <string>
+#include <vector>
+
+namespace OpenPSTD
+{
+    namespace Shared
+    {
+        /**
+         * Exports the receivers to a single WAV file with a channel per receiver.
+         *
+         * The receivers are sampled at the frame rate of the simulation, they are resampled to the sample rate of the
+         * WAV file(see Resampler). The data of the receivers is read and converted in blocks, so the memory does not
+         * depend on the length of the simulation. The sizes in a WAV file are 32 bits, an export of more than 4 GiB
+         * of samples fails.
+         */
+        class OPENPSTD_SHARED_EXPORT ExportWav
+        {
+        private:
+            int _sampleRate = 44100;
+            bool _normalize = true;
+            bool _floatSamples = false;
+
+        public:
+            OPENPSTD_SHARED_EXPORT virtual std::vector<std::string> GetFormats();
+
+            /**
+             * The sample rate of the WAV file
+             */
+            OPENPSTD_SHARED_EXPORT int GetSampleRate();
+            OPENPSTD_SHARED_EXPORT void SetSampleRate(int value);
+
+            /**
+             * Scales the receivers so that the peak of all the receivers is 1(full scale), otherwise the pressure is
+             * written directly and values outside -1 to 1 are clipped for 16 bits samples
+             */
+            OPENPSTD_SHARED_EXPORT bool GetNormalize();
+            OPENPSTD_SHARED_EXPORT void SetNormalize(bool value);
+
+            /**
+             * Writes 32 bits floating point samples instead of 16 bits integer samples
+             */
+            OPENPSTD_SHARED_EXPORT bool GetFloatSamples();
+            OPENPSTD_SHARED_EXPORT void SetFloatSamples(bool value);
+
+            /**
+             * Exports the receivers.
+             * @param format: The format that has to be exported, this has to be one of the formats that is returned by GetFormats.
+             * @param file: The file from where the export must be done.
+             * @param output: The filename of the WAV file.
+             * @param receivers: The receivers that are exported, in the order of the channels. With an empty list all
+             *                   the receivers are exported.
+             */
+            OPENPSTD_SHARED_EXPORT virtual void ExportData(std::string format, std::shared_ptr<PSTDFile> file,
+                                                           std::string output, std::vector<int> receivers);
+        };
+    }
+}
+
+#endif //OPENPSTD_WAV_H
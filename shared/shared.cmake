@@ -2,11 +2,13 @@
 # Kernel library
 
 #general
-SET(SOURCE_FILES_SHARED_LIB shared/PSTDFile.cpp shared/InvalidationData.cpp shared/Colors.cpp shared/PSTDFileAccess.cpp)
+SET(SOURCE_FILES_SHARED_LIB shared/PSTDFile.cpp shared/InvalidationData.cpp shared/Colors.cpp shared/PSTDFileAccess.cpp
+        shared/CommitPolicy.cpp shared/ResultsSnapshot.cpp shared/FrameCodec.cpp shared/FrameStatistics.cpp
+        shared/ColorLUT.cpp shared/FramePyramid.cpp shared/TimeSeriesIndex.cpp shared/Resampler.cpp)
 #export
 SET(SOURCE_FILES_SHARED_LIB ${SOURCE_FILES_SHARED_LIB}
         shared/export/Export.cpp shared/export/Image.cpp
-        shared/export/HDF5Export.cpp)
+        shared/export/HDF5Export.cpp shared/export/Wav.cpp shared/export/Npy.cpp)
 
 add_library(OpenPSTD-shared SHARED ${SOURCE_FILES_SHARED_LIB})
 
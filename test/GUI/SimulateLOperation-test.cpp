@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test cases for the simulate operation of the GUI
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <GUI/operations/long/SimulateLOperation.h>
+#include <GUI/Model.h>
+#include <GUI/mouse/MouseStrategy.h>
+
+using namespace OpenPSTD::GUI;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(GUI_Simulate_Operation)
+
+    BOOST_AUTO_TEST_CASE(TestStoresPreviewLevels)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("simulate-%%%%%%%%.pstd");
+
+        Reciever reciever;
+        reciever.model = std::make_shared<Model>();
+        reciever.model->settings->UseMockKernel = true;
+        reciever.model->settings->PreviewLevels = 2;
+        reciever.model->documentAccess->New(path);
+        {
+            auto doc = reciever.model->documentAccess->GetDocument();
+            auto conf = doc->GetSceneConf();
+            conf->Settings.SetRenderTime(2.5f * conf->Settings.GetTimeStep());
+            doc->SetSceneConf(conf);
+        }
+
+        SimulateLOperation operation;
+        operation.Run(reciever);
+        BOOST_CHECK(operation.Finished());
+
+        {
+            auto doc = reciever.model->documentAccess->GetDocument();
+            BOOST_REQUIRE_EQUAL(doc->GetResultsFrameCount(0), 2);
+            BOOST_CHECK(doc->IsResultsFrameLevelStored(1, 0, 1));
+            BOOST_CHECK(doc->IsResultsFrameLevelStored(1, 0, 2));
+            BOOST_CHECK(!doc->IsResultsFrameLevelStored(1, 0, 3));
+        }
+
+        reciever.model->documentAccess->Close();
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
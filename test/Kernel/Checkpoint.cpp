@@ -0,0 +1,262 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the checkpoints of the solver
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <kernel/core/Checkpoint.h>
+#include <kernel/PSTDKernel.h>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include "RecordingCallback.h"
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(checkpoint)
+
+    class CheckpointCallback : public RecordingCallback {
+    public:
+        /// Throws when this frame is written, to simulate a crash
+        int fail_frame = -1;
+        std::vector<int> checkpoints;
+
+        void WriteFrame(int frame, int domain, PSTD_FRAME_PTR data) override {
+            if (frame == this->fail_frame) {
+                throw std::runtime_error("simulated crash");
+            }
+            RecordingCallback::WriteFrame(frame, domain, data);
+        }
+
+        void WriteSample(int startSample, int receiver, std::vector<float> data) override {
+            BOOST_REQUIRE_EQUAL(this->samples[receiver].size(), startSample);
+            RecordingCallback::WriteSample(startSample, receiver, data);
+        }
+
+        void Checkpoint(int frame) override {
+            this->checkpoints.push_back(frame);
+        }
+    };
+
+    void run(std::shared_ptr<PSTDConfiguration> conf, CheckpointCallback &callback,
+             const KernelRunOptions &options = KernelRunOptions()) {
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        kernel.run(&callback, options);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_write_read) {
+        auto conf = create_short_conf(3);
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        CheckpointCallback callback;
+        kernel.run(&callback);
+        auto scene = kernel.get_scene();
+
+        std::string filename = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path()).string();
+        auto checkpoint = Checkpoint::capture(scene, 2);
+        checkpoint->write(filename);
+        BOOST_CHECK(!boost::filesystem::exists(filename + ".tmp"));
+        BOOST_CHECK_EQUAL(Checkpoint::read_frame(filename), 2);
+
+        auto read = Checkpoint::read(filename);
+        BOOST_CHECK_EQUAL(read->frame, 2);
+        BOOST_REQUIRE_EQUAL(read->domains.size(), scene->domain_list.size());
+        for (unsigned long i = 0; i < read->domains.size(); i++) {
+            auto domain = scene->domain_list.at(i);
+            BOOST_CHECK_EQUAL(read->domains[i].id, domain->id);
+            BOOST_CHECK(read->domains[i].current_values.p0.isApprox(domain->current_values.p0));
+            BOOST_CHECK(read->domains[i].previous_values.vy0.isApprox(domain->previous_values.vy0));
+            BOOST_CHECK_EQUAL(read->domains[i].pml_arrays.vx.cols(), checkpoint->domains[i].pml_arrays.vx.cols());
+        }
+        BOOST_REQUIRE_EQUAL(read->receivers.size(), 1);
+        BOOST_CHECK(read->receivers[0] == scene->receiver_list[0]->received_values);
+
+        //a checkpoint of another scene is rejected
+        auto other = PSTDConfiguration::CreateDefaultConf();
+        other->Domains.pop_back();
+        PSTDKernel other_kernel;
+        other_kernel.initialize_kernel(other);
+        BOOST_CHECK_THROW(read->restore(other_kernel.get_scene()), std::runtime_error);
+
+        boost::filesystem::remove(filename);
+        BOOST_CHECK_THROW(Checkpoint::read(filename), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_resume) {
+        const int frames = 8;
+        CheckpointCallback reference;
+        run(create_short_conf(frames), reference);
+
+        std::string filename = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path()).string();
+        auto conf = create_short_conf(frames);
+        KernelRunOptions options;
+        options.CheckpointFile = filename;
+        options.CheckpointInterval = 3;
+
+        CheckpointCallback crashed;
+        crashed.fail_frame = 5;
+        BOOST_CHECK_THROW(run(conf, crashed, options), std::runtime_error);
+        BOOST_REQUIRE_EQUAL(crashed.checkpoints.size(), 1);
+        BOOST_CHECK_EQUAL(crashed.checkpoints[0], 2);
+        BOOST_REQUIRE_EQUAL(Checkpoint::read_frame(filename), 2);
+
+        options.Resume = true;
+        CheckpointCallback resumed;
+        //the results before the checkpoint are already stored
+        resumed.samples[0] = std::vector<float>(crashed.samples[0].begin(), crashed.samples[0].begin() + 3);
+        run(conf, resumed, options);
+        BOOST_CHECK_EQUAL(resumed.frames.begin()->first, 3);
+        BOOST_CHECK_EQUAL(resumed.frames.size(), frames - 3);
+        RecordingCallback expected = reference;
+        expected.frames.erase(expected.frames.begin(), expected.frames.find(3));
+        check_close_results(resumed, expected, 1e-5f);
+        BOOST_CHECK_EQUAL(resumed.samples[0].size(), frames);
+        //a checkpoint at frame 5 is taken, but removed after the simulation is finished
+        BOOST_CHECK_EQUAL(resumed.checkpoints.size(), 1);
+        BOOST_CHECK(!boost::filesystem::exists(filename));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_writer) {
+        std::string filename = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path()).string();
+        auto checkpoint = std::make_shared<Checkpoint>();
+        checkpoint->receivers.push_back(std::vector<float>(1000000, 1.0f));
+        {
+            CheckpointWriter writer(filename);
+            BOOST_CHECK(writer.is_idle());
+            BOOST_CHECK(writer.submit(checkpoint));
+            writer.wait();
+            BOOST_CHECK(writer.is_idle());
+            BOOST_CHECK_EQUAL(writer.get_written_count(), 1);
+
+            checkpoint->frame = 4;
+            BOOST_CHECK(writer.submit(checkpoint));
+            //the destructor waits for the checkpoint that is written
+        }
+        BOOST_CHECK_EQUAL(Checkpoint::read_frame(filename), 4);
+        boost::filesystem::remove(filename);
+
+        //a checkpoint that can not be written is only reported, until a later checkpoint is written
+        boost::filesystem::path missing = boost::filesystem::path(filename) / "missing";
+        CheckpointWriter writer((missing / "checkpoint").string());
+        BOOST_CHECK(writer.submit(checkpoint));
+        writer.wait();
+        BOOST_CHECK(!writer.get_error().empty());
+        BOOST_CHECK_EQUAL(writer.get_written_count(), 0);
+
+        boost::filesystem::create_directories(missing);
+        BOOST_CHECK(writer.submit(checkpoint));
+        writer.wait();
+        BOOST_CHECK(writer.get_error().empty());
+        BOOST_CHECK_EQUAL(writer.get_written_count(), 1);
+        boost::filesystem::remove_all(filename);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_failed_checkpoint) {
+        const int frames = 6;
+        auto conf = create_short_conf(frames);
+        KernelRunOptions options;
+        options.CheckpointFile = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path() /
+                                  "checkpoint").string();
+        options.CheckpointInterval = 2;
+
+        //the checkpoints can not be written, but the simulation is finished
+        CheckpointCallback callback;
+        BOOST_CHECK_NO_THROW(run(conf, callback, options));
+        BOOST_CHECK_EQUAL(callback.frames.size(), frames);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_resume_without_checkpoints) {
+        std::string filename = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path()).string();
+        auto conf = create_short_conf(8);
+        KernelRunOptions options;
+        options.CheckpointFile = filename;
+        options.CheckpointInterval = 3;
+
+        CheckpointCallback crashed;
+        crashed.fail_frame = 5;
+        BOOST_CHECK_THROW(run(conf, crashed, options), std::runtime_error);
+        BOOST_REQUIRE(boost::filesystem::exists(filename));
+
+        //the checkpoint that is resumed is removed after the simulation, also when no new checkpoints are written
+        options.Resume = true;
+        options.CheckpointInterval = 0;
+        CheckpointCallback resumed;
+        resumed.samples[0] = std::vector<float>(crashed.samples[0].begin(), crashed.samples[0].begin() + 3);
+        run(conf, resumed, options);
+        BOOST_CHECK_EQUAL(resumed.frames.begin()->first, 3);
+        BOOST_CHECK(!boost::filesystem::exists(filename));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_corrupt_checkpoint) {
+        auto conf = create_short_conf(3);
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        CheckpointCallback callback;
+        kernel.run(&callback);
+        auto scene = kernel.get_scene();
+
+        std::string filename = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path()).string();
+        Checkpoint::capture(scene, 2)->write(filename);
+        auto size = boost::filesystem::file_size(filename);
+
+        //the size of the first array is after the header and the place of the first domain, a corrupt size is not
+        //allocated
+        {
+            std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(8 + 4 + 4 + 4 + 2 * 8 + 1);
+            int rows = 1 << 30;
+            file.write((const char *) &rows, sizeof(rows));
+            file.write((const char *) &rows, sizeof(rows));
+        }
+        BOOST_CHECK_THROW(Checkpoint::read(filename), std::runtime_error);
+
+        //a truncated file is incomplete
+        Checkpoint::capture(scene, 2)->write(filename);
+        boost::filesystem::resize_file(filename, size / 2);
+        BOOST_CHECK_THROW(Checkpoint::read(filename), std::runtime_error);
+        boost::filesystem::resize_file(filename, size - 2);
+        BOOST_CHECK_THROW(Checkpoint::read(filename), std::runtime_error);
+
+        //an array with another size than the field of its domain is not restored
+        auto checkpoint = Checkpoint::capture(scene, 2);
+        checkpoint->domains[0].current_values.p0 = Eigen::ArrayXXf::Zero(1, 1);
+        BOOST_CHECK_THROW(checkpoint->restore(scene), std::runtime_error);
+        checkpoint = Checkpoint::capture(scene, 2);
+        checkpoint->domains[0].pml_arrays.vx = Eigen::ArrayXXf::Zero(1, 1);
+        BOOST_CHECK_THROW(checkpoint->restore(scene), std::runtime_error);
+
+        boost::filesystem::remove(filename);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
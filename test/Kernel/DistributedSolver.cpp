@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the simulations that are distributed over several ranks
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/PSTDKernel.h>
+#include <kernel/core/Transport.h>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "RecordingCallback.h"
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(distributed_solver)
+
+    typedef std::function<std::shared_ptr<Transport>(int rank)> TransportFactory;
+
+    TransportFactory tcp_factory(int size) {
+        std::random_device random;
+        int port = 20000 + (int) (random() % 40000);
+        std::vector<std::string> endpoints;
+        for (int rank = 0; rank < size; rank++) {
+            endpoints.push_back("localhost:" + std::to_string(port + rank));
+        }
+        return [endpoints](int rank) { return std::make_shared<TcpTransport>(rank, endpoints, 10); };
+    }
+
+    TransportFactory shared_memory_factory(int size) {
+        std::random_device random;
+        std::string name = "openpstd-test-" + std::to_string(random());
+        return [name, size](int rank) { return std::make_shared<SharedMemoryTransport>(name, rank, size, 10); };
+    }
+
+    /**
+     * Default scene with more domains and a receiver in every domain
+     */
+    std::shared_ptr<PSTDConfiguration> create_conf() {
+        auto conf = create_short_conf();
+        DomainConf domain = conf->Domains.at(1);
+        domain.TopLeft = QVector2D(30, 4);
+        domain.Size = QVector2D(10, 15);
+        conf->Domains.push_back(domain);
+        conf->Speakers.push_back(QVector3D(31, 16, 0));
+        conf->Receivers.push_back(QVector3D(11, 6, 0));
+        conf->Receivers.push_back(QVector3D(35, 6, 0));
+        return conf;
+    }
+
+    /**
+     * Callback that fails when a frame is written
+     */
+    class FailingCallback : public RecordingCallback {
+    public:
+        int failing_frame;
+
+        FailingCallback(int failing_frame) : failing_frame(failing_frame) {
+        }
+
+        void WriteFrame(int frame, int domain, PSTD_FRAME_PTR data) override {
+            if (frame == this->failing_frame) {
+                throw std::runtime_error("The frame can not be written");
+            }
+            RecordingCallback::WriteFrame(frame, domain, data);
+        }
+    };
+
+    /**
+     * Runs the configuration with every rank in its own thread and returns the results of rank 0. A rank that fails
+     * aborts the others, the error of the first rank that failed is rethrown.
+     */
+    std::shared_ptr<RecordingCallback> run_distributed(std::shared_ptr<PSTDConfiguration> conf, int size,
+                                                    TransportFactory factory,
+                                                    std::shared_ptr<RecordingCallback> result = nullptr,
+                                                    const KernelRunOptions &options = KernelRunOptions()) {
+        if (not result) {
+            result = std::make_shared<RecordingCallback>();
+        }
+        std::vector<std::exception_ptr> errors((unsigned long) size);
+        std::vector<std::thread> threads;
+        for (int rank = 0; rank < size; rank++) {
+            threads.push_back(std::thread([&, rank]() {
+                std::shared_ptr<Transport> transport;
+                try {
+                    transport = factory(rank);
+                    PSTDKernel kernel;
+                    kernel.initialize_kernel(conf);
+                    kernel.run_distributed(rank == 0 ? result.get() : nullptr, transport, options);
+                }
+                catch (std::exception &e) {
+                    errors[rank] = std::current_exception();
+                    if (transport) {
+                        transport->abort(e.what());
+                    }
+                }
+                catch (...) {
+                    errors[rank] = std::current_exception();
+                    if (transport) {
+                        transport->abort("exception of unknown type");
+                    }
+                }
+            }));
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (auto error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * The domains are computed in the same way as in a single process, so the results are exactly the same
+     */
+    void check_identical(std::shared_ptr<RecordingCallback> result, std::shared_ptr<PSTDConfiguration> conf) {
+        RecordingCallback expected;
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        kernel.run(&expected);
+
+        BOOST_CHECK_EQUAL(result->finished, 1);
+        check_same_results(*result, expected);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_tcp_identical_to_single_process) {
+        auto conf = create_conf();
+        check_identical(run_distributed(conf, 2, tcp_factory(2)), conf);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_shared_memory_identical_to_single_process) {
+        auto conf = create_conf();
+        check_identical(run_distributed(conf, 3, shared_memory_factory(3)), conf);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_default_scene) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Settings.SetRenderTime(4.5f * conf->Settings.GetTimeStep());
+        check_identical(run_distributed(conf, 4, shared_memory_factory(4)), conf);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_resume_unsupported) {
+        auto conf = create_conf();
+        KernelRunOptions options;
+        options.CheckpointFile = "distributed.checkpoint";
+        options.Resume = true;
+        BOOST_CHECK_THROW(run_distributed(conf, 2, shared_memory_factory(2), nullptr, options), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_failing_rank) {
+        //the other ranks stop waiting for rank 0 long before the timeout of the transports
+        auto conf = create_conf();
+        auto start = std::chrono::steady_clock::now();
+        BOOST_CHECK_THROW(run_distributed(conf, 3, shared_memory_factory(3), std::make_shared<FailingCallback>(2)),
+                          std::runtime_error);
+        BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+        start = std::chrono::steady_clock::now();
+        BOOST_CHECK_THROW(run_distributed(conf, 2, tcp_factory(2), std::make_shared<FailingCallback>(2)),
+                          std::runtime_error);
+        BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,210 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the estimator of scenes
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <kernel/core/Estimator.h>
+#include <kernel/PSTDKernel.h>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(estimator)
+
+    std::string get_rectangle(Point top_left, Point size, bool is_pml, bool is_secondary_pml) {
+        std::ostringstream ss;
+        ss << top_left << " " << size << (is_pml ? " pml" : "") << (is_secondary_pml ? " secondary" : "");
+        return ss.str();
+    }
+
+    std::vector<std::string> get_rectangles(std::vector<std::shared_ptr<Domain>> domains) {
+        std::vector<std::string> result;
+        for (auto domain: domains) {
+            result.push_back(get_rectangle(domain->top_left, domain->size, domain->is_pml, domain->is_secondary_pml));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::string> get_rectangles(std::vector<DomainEstimate> domains) {
+        std::vector<std::string> result;
+        for (auto domain: domains) {
+            result.push_back(get_rectangle(domain.top_left, domain.size, domain.is_pml, domain.is_secondary_pml));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void check_against_kernel(std::shared_ptr<PSTDConfiguration> conf) {
+        SceneEstimate estimate = estimate_scene(conf);
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        auto domains = kernel.get_scene()->domain_list;
+
+        auto expected = get_rectangles(domains);
+        auto actual = get_rectangles(estimate.domains);
+        BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+
+        long long cells = 0;
+        for (auto domain: domains) {
+            cells += domain->size.x * domain->size.y;
+        }
+        BOOST_CHECK_EQUAL(estimate.cells, cells);
+        BOOST_CHECK_EQUAL(estimate.frame_count, kernel.get_metadata().Framecount);
+
+        //the scene is created from the same layout, so also the ids and the merged PML domains are the same
+        BOOST_REQUIRE_EQUAL(estimate.domains.size(), domains.size());
+        for (unsigned long i = 0; i < domains.size(); i++) {
+            BOOST_CHECK_EQUAL(estimate.domains[i].id, domains[i]->id);
+            std::vector<int> pml_for;
+            for (auto pml_for_domain: domains[i]->pml_for_domain_list) {
+                pml_for.push_back(pml_for_domain->id);
+            }
+            BOOST_CHECK_EQUAL_COLLECTIONS(estimate.domains[i].pml_for.begin(), estimate.domains[i].pml_for.end(),
+                                          pml_for.begin(), pml_for.end());
+        }
+    }
+
+    std::shared_ptr<PSTDConfiguration> create_split_side_conf() {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Domains.clear();
+        conf->Speakers = {QVector3D(15, 15, 0)};
+        conf->Receivers = {QVector3D(12, 15, 0)};
+
+        DomainConf bottom;
+        bottom.TopLeft = QVector2D(0, 10);
+        bottom.Size = QVector2D(30, 10);
+        bottom.SetAbsorption(PSTD_DOMAIN_SIDE_ALL, 0.2f);
+        bottom.SetLR(PSTD_DOMAIN_SIDE_ALL, false);
+        conf->Domains.push_back(bottom);
+
+        //a narrow room in the middle of the top side of the bottom room
+        DomainConf top = bottom;
+        top.TopLeft = QVector2D(10, 0);
+        top.Size = QVector2D(10, 10);
+        conf->Domains.push_back(top);
+        return conf;
+    }
+
+    BOOST_AUTO_TEST_CASE(test_default_scene) {
+        check_against_kernel(PSTDConfiguration::CreateDefaultConf());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_vacant_ranges) {
+        auto conf = create_split_side_conf();
+        check_against_kernel(conf);
+
+        //both vacant parts of the top side get their own PML domain
+        SceneEstimate estimate = estimate_scene(conf);
+        int side_pmls = 0;
+        for (auto &domain: estimate.domains) {
+            if (domain.is_pml && domain.pml_for.at(0) == 0 && domain.top_left.y == 0) {
+                BOOST_CHECK(domain.top_left.x == 0 || domain.top_left.x == 100);
+                BOOST_CHECK_EQUAL(domain.size.x, 50);
+                side_pmls++;
+            }
+        }
+        BOOST_CHECK_EQUAL(side_pmls, 2);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_fft_sizes) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Domains.resize(1);
+
+        SceneEstimate estimate = estimate_scene(conf);
+        BOOST_CHECK_CLOSE(estimate.grid_spacing, 0.2f, 1e-4);
+        const DomainEstimate &domain = estimate.domains.at(0);
+        BOOST_CHECK(!domain.is_pml);
+        BOOST_CHECK_EQUAL(domain.size.x, 50);
+        BOOST_CHECK_EQUAL(domain.size.y, 75);
+        BOOST_CHECK_EQUAL(domain.state_bytes, 4 * (18 * 50 * 75 + 4 * (50 + 75)));
+        BOOST_REQUIRE_EQUAL(domain.ffts.size(), 4);
+        for (auto &fft: domain.ffts) {
+            BOOST_CHECK_EQUAL(fft.window, 32);
+            if (fft.direction == CalcDirection::X) {
+                BOOST_CHECK_EQUAL(fft.length, 128);
+                BOOST_CHECK_EQUAL(fft.batch, 75);
+            }
+            else {
+                BOOST_CHECK_EQUAL(fft.length, 256);
+                BOOST_CHECK_EQUAL(fft.batch, 50);
+            }
+        }
+
+        //the window is reduced for small PML domains
+        for (auto &pml: estimate.domains) {
+            if (pml.is_pml && pml.size.x < 32) {
+                BOOST_CHECK_EQUAL(pml.ffts.at(0).window, 16);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_output_and_runtime) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Settings.SetRenderTime(3.5f * conf->Settings.GetTimeStep());
+        conf->Settings.SetSaveNth(2);
+
+        SceneEstimate estimate = estimate_scene(conf, 1e6);
+        BOOST_CHECK_EQUAL(estimate.frame_count, 3);
+        BOOST_CHECK_EQUAL(estimate.saved_frame_count, 2);
+        BOOST_CHECK_EQUAL(estimate.receiver_count, 1);
+
+        long long frame_cells = 0;
+        for (auto &domain: estimate.domains) {
+            if (!domain.is_pml) {
+                frame_cells += domain.cells;
+            }
+        }
+        BOOST_CHECK_EQUAL(estimate.output_bytes, 4 * (2 * frame_cells + 2));
+        BOOST_CHECK_CLOSE(estimate.seconds, 3.0 * estimate.cells / 1e6, 1e-6);
+        BOOST_CHECK_EQUAL(estimate.get_memory_bytes(), estimate.state_bytes + estimate.workspace_bytes);
+        BOOST_CHECK(estimate.get_pml_domain_count() > 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_calibration) {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("%%%%-%%%%.json");
+        {
+            std::ofstream out(path.string());
+            out << "{\"results\": ["
+                << "{\"mode\": \"strong\", \"threads\": 1, \"cell_updates_per_second\": 100},"
+                << "{\"mode\": \"strong\", \"threads\": 1, \"cell_updates_per_second\": 300},"
+                << "{\"mode\": \"weak\", \"threads\": 1, \"cell_updates_per_second\": 1000},"
+                << "{\"mode\": \"strong\", \"threads\": 2, \"cell_updates_per_second\": 500}"
+                << "]}";
+        }
+        BOOST_CHECK_CLOSE(read_cell_updates_per_second(path.string(), 1), 200, 1e-6);
+        BOOST_CHECK_CLOSE(read_cell_updates_per_second(path.string(), 2), 500, 1e-6);
+        BOOST_CHECK_THROW(read_cell_updates_per_second(path.string(), 4), std::runtime_error);
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the logger and the progress throttle of the kernel
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/core/Logger.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(logger)
+
+    /**
+     * Stream buffer that blocks the background thread of the logger until it is released
+     */
+    class BlockingBuffer : public std::stringbuf {
+    public:
+        std::atomic<bool> writing{false};
+        std::atomic<bool> released{false};
+
+    protected:
+        std::streamsize xsputn(const char *s, std::streamsize n) override {
+            writing = true;
+            while (!released) {
+                std::this_thread::yield();
+            }
+            return std::stringbuf::xsputn(s, n);
+        }
+    };
+
+    int count_lines(const std::string &text) {
+        return (int) std::count(text.begin(), text.end(), '\n');
+    }
+
+    BOOST_AUTO_TEST_CASE(test_levels) {
+        std::ostringstream out;
+        Logger logger(16, &out);
+        BOOST_CHECK(logger.get_level() == LogLevel::INFO);
+
+        logger.set_level(LogLevel::WARNING);
+        BOOST_CHECK(!logger.log(LogLevel::DEBUG, "hidden"));
+        BOOST_CHECK(!logger.log(LogLevel::INFO, "hidden"));
+        BOOST_CHECK(logger.log(LogLevel::WARNING, "shown"));
+        BOOST_CHECK(logger.log(LogLevel::ERROR, "also shown"));
+        logger.flush();
+
+        BOOST_CHECK_EQUAL(out.str(), "warning: shown\nerror: also shown\n");
+    }
+
+    BOOST_AUTO_TEST_CASE(test_threads) {
+        std::ostringstream out;
+        Logger logger(1 << 14, &out);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.push_back(std::thread([&logger, t]() {
+                for (int i = 0; i < 1000; i++) {
+                    logger.log(LogLevel::INFO, std::to_string(t) + " " + std::to_string(i));
+                }
+            }));
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        logger.flush();
+
+        BOOST_CHECK_EQUAL(logger.get_dropped(), 0);
+        BOOST_CHECK_EQUAL(count_lines(out.str()), 4000);
+
+        //the messages of a single thread keep their order
+        std::istringstream in(out.str());
+        std::string level;
+        int t, i;
+        std::vector<int> last(4, -1);
+        while (in >> level >> t >> i) {
+            BOOST_CHECK_EQUAL(i, last[t] + 1);
+            last[t] = i;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_full_buffer) {
+        BlockingBuffer buffer;
+        std::ostream out(&buffer);
+        {
+            Logger logger(2, &out);
+            BOOST_CHECK(logger.log(LogLevel::INFO, "first"));
+            while (!buffer.writing) {
+                std::this_thread::yield();
+            }
+            //the first slot is only free after the first message is written
+            BOOST_CHECK(logger.log(LogLevel::INFO, "second"));
+            BOOST_CHECK(!logger.log(LogLevel::INFO, "dropped"));
+            BOOST_CHECK(!logger.log(LogLevel::INFO, "dropped"));
+            BOOST_CHECK_EQUAL(logger.get_dropped(), 2);
+
+            buffer.released = true;
+            logger.flush();
+        }
+        BOOST_CHECK_EQUAL(buffer.str(), "info: first\ninfo: second\n");
+    }
+
+    BOOST_AUTO_TEST_CASE(test_compiled_out) {
+        Logger &logger = Logger::get_instance();
+        LogLevel level = logger.get_level();
+        logger.set_level(LogLevel::TRACE);
+
+        int evaluated = 0;
+        OPENPSTD_LOG(LogLevel::TRACE, std::to_string(++evaluated));
+        BOOST_CHECK_EQUAL(evaluated, 0);
+
+        //runtime disabled levels are not evaluated either
+        logger.set_level(LogLevel::OFF);
+        OPENPSTD_LOG(LogLevel::ERROR, std::to_string(++evaluated));
+        BOOST_CHECK_EQUAL(evaluated, 0);
+
+        logger.set_level(level);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_parse_level) {
+        BOOST_CHECK(Logger::parse_level("trace") == LogLevel::TRACE);
+        BOOST_CHECK(Logger::parse_level("warning") == LogLevel::WARNING);
+        BOOST_CHECK(Logger::parse_level("off") == LogLevel::OFF);
+        BOOST_CHECK_THROW(Logger::parse_level("loud"), std::invalid_argument);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_progress_throttle) {
+        ProgressThrottle throttle(1000);
+        std::vector<int> reported;
+        for (int frame = 0; frame < 10; frame++) {
+            if (throttle.should_report(frame, 10)) {
+                reported.push_back(frame);
+            }
+        }
+        std::vector<int> expected{0, 9};
+        BOOST_CHECK_EQUAL_COLLECTIONS(reported.begin(), reported.end(), expected.begin(), expected.end());
+
+        ProgressThrottle every_frame(0);
+        for (int frame = 0; frame < 10; frame++) {
+            BOOST_CHECK(every_frame.should_report(frame, 10));
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the partition of the domains over ranks
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/core/Partitioner.h>
+#include <kernel/PSTDKernel.h>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(partitioner)
+
+    /**
+     * Scene of four domains in a row, the second and third are twice as high
+     */
+    std::shared_ptr<Scene> create_row_scene() {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Domains.clear();
+        for (int i = 0; i < 4; i++) {
+            DomainConf domain;
+            domain.TopLeft = QVector2D(10 * i, i == 1 || i == 2 ? 0 : 5);
+            domain.Size = QVector2D(10, i == 1 || i == 2 ? 20 : 10);
+            domain.T.Absorption = domain.B.Absorption = domain.L.Absorption = domain.R.Absorption = 1;
+            domain.T.LR = domain.B.LR = domain.L.LR = domain.R.LR = false;
+            conf->Domains.push_back(domain);
+        }
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        return kernel.get_scene();
+    }
+
+    /**
+     * Interface length when the domains are assigned to the ranks in turn
+     */
+    int get_round_robin_length(std::shared_ptr<Partition> partition) {
+        Partition round_robin = *partition;
+        for (unsigned long i = 0; i < round_robin.ranks.size(); i++) {
+            round_robin.ranks[i] = (int) (i % round_robin.size);
+        }
+        return round_robin.get_interface_length();
+    }
+
+    BOOST_AUTO_TEST_CASE(test_single_rank) {
+        auto scene = create_row_scene();
+        auto partition = partition_domains(scene->domain_list, 1);
+        BOOST_CHECK_EQUAL(partition->domains.size(), scene->domain_list.size());
+        for (int rank: partition->ranks) {
+            BOOST_CHECK_EQUAL(rank, 0);
+        }
+        BOOST_CHECK_EQUAL(partition->get_interface_length(), 0);
+        long cells = 0;
+        for (auto domain: scene->domain_list) {
+            cells += domain->size.x * domain->size.y;
+        }
+        BOOST_CHECK_EQUAL(partition->get_loads().at(0), cells);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_balance_and_interfaces) {
+        auto scene = create_row_scene();
+        for (int size = 2; size <= 4; size++) {
+            auto partition = partition_domains(scene->domain_list, size);
+            std::vector<long> loads = partition->get_loads();
+            long total = 0;
+            for (long load: loads) {
+                BOOST_CHECK(load > 0);
+                total += load;
+            }
+            BOOST_CHECK(*std::max_element(loads.begin(), loads.end()) < 1.6 * total / size);
+            BOOST_CHECK(partition->get_interface_length() > 0);
+            BOOST_CHECK(partition->get_interface_length() < get_round_robin_length(partition));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_more_ranks_than_domains) {
+        auto scene = create_row_scene();
+        int size = (int) scene->domain_list.size() + 2;
+        auto partition = partition_domains(scene->domain_list, size);
+        std::vector<long> loads = partition->get_loads();
+        BOOST_CHECK_EQUAL(loads.size(), size);
+        BOOST_CHECK_EQUAL(std::count(loads.begin(), loads.end(), 0), 2);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_independent_of_order) {
+        auto scene = create_row_scene();
+        auto other_scene = create_row_scene();
+        auto partition = partition_domains(scene->domain_list, 3);
+
+        std::vector<std::shared_ptr<Domain>> reversed(other_scene->domain_list.rbegin(),
+                                                      other_scene->domain_list.rend());
+        auto other_partition = partition_domains(reversed, 3);
+        BOOST_REQUIRE_EQUAL(partition->domains.size(), other_partition->domains.size());
+        for (unsigned long i = 0; i < partition->domains.size(); i++) {
+            BOOST_CHECK_EQUAL(partition->domains[i]->top_left.x, other_partition->domains[i]->top_left.x);
+            BOOST_CHECK_EQUAL(partition->domains[i]->top_left.y, other_partition->domains[i]->top_left.y);
+            BOOST_CHECK_EQUAL(partition->domains[i]->size.x, other_partition->domains[i]->size.x);
+            BOOST_CHECK_EQUAL(partition->domains[i]->size.y, other_partition->domains[i]->size.y);
+            BOOST_CHECK_EQUAL(partition->ranks[i], other_partition->ranks[i]);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_errors) {
+        auto scene = create_row_scene();
+        BOOST_CHECK_THROW(partition_domains(scene->domain_list, 0), std::runtime_error);
+        auto partition = partition_domains(scene->domain_list, 2);
+        auto other_scene = create_row_scene();
+        BOOST_CHECK_THROW(partition->get_rank(other_scene->domain_list.at(0)), std::out_of_range);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the profiling of the kernel
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/core/Profiler.h>
+#include <kernel/PSTDKernel.h>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(profiler)
+
+    class ProfileCallback : public KernelCallback {
+    public:
+        int profiles = 0;
+        KernelProfile profile;
+
+        void Callback(CALLBACKSTATUS status, std::string message, int frame) override { }
+
+        void WriteFrame(int frame, int domain, PSTD_FRAME_PTR data) override { }
+
+        void WriteSample(int startSample, int receiver, std::vector<float> data) override { }
+
+        void WriteProfile(const KernelProfile &profile) override {
+            this->profiles++;
+            this->profile = profile;
+        }
+    };
+
+    BOOST_AUTO_TEST_CASE(test_aggregation) {
+        Profiler profiler(2);
+        profiler.add(PROFILEPHASE::PLANNING, 0, 1);
+        profiler.start_frame();
+        profiler.add(PROFILEPHASE::FFT, 0, 2);
+        profiler.add(PROFILEPHASE::FFT, 1, 3);
+        profiler.start_frame();
+        profiler.add(PROFILEPHASE::RK_UPDATE, 1, 4);
+        //unknown domains are added
+        profiler.add(PROFILEPHASE::PML, 3, 5);
+
+        KernelProfile profile = profiler.get_profile();
+        BOOST_CHECK_EQUAL(profile.DomainSeconds.size(), 4);
+        BOOST_CHECK_EQUAL(profile.FrameSeconds.size(), 2);
+        BOOST_CHECK_EQUAL(profile.GetPhaseSeconds(PROFILEPHASE::FFT), 5);
+        BOOST_CHECK_EQUAL(profile.GetPhaseSeconds(PROFILEPHASE::PLANNING), 1);
+        BOOST_CHECK_EQUAL(profile.GetDomainSeconds(1), 7);
+        BOOST_CHECK_EQUAL(profile.FrameSeconds[0][(int) PROFILEPHASE::FFT], 5);
+        BOOST_CHECK_EQUAL(profile.FrameSeconds[1][(int) PROFILEPHASE::PML], 5);
+        BOOST_CHECK(profile.TotalSeconds >= 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_timer) {
+        Profiler profiler(1);
+        profiler.start_frame();
+        {
+            ProfileTimer timer(&profiler, PROFILEPHASE::WINDOWING, 0);
+            timer.next(PROFILEPHASE::FFT);
+            timer.stop();
+            timer.next(PROFILEPHASE::INVERSE_FFT);
+        }
+        KernelProfile profile = profiler.get_profile();
+        BOOST_CHECK(profile.GetPhaseSeconds(PROFILEPHASE::WINDOWING) >= 0);
+        BOOST_CHECK(profile.GetPhaseSeconds(PROFILEPHASE::FFT) >= 0);
+        //after stop nothing is timed
+        BOOST_CHECK_EQUAL(profile.GetPhaseSeconds(PROFILEPHASE::INVERSE_FFT), 0);
+
+        //without a profiler the timer does nothing
+        ProfileTimer disabled(nullptr, PROFILEPHASE::FFT, 0);
+        disabled.next(PROFILEPHASE::PML);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_kernel_profile) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Settings.SetRenderTime(3.5f * conf->Settings.GetTimeStep());
+        KernelRunOptions options;
+        options.Profiling = true;
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        ProfileCallback callback;
+        kernel.run(&callback, options);
+
+        BOOST_REQUIRE_EQUAL(callback.profiles, 1);
+        KernelProfile &profile = callback.profile;
+        for (auto domain: kernel.get_scene()->domain_list) {
+            BOOST_CHECK(domain->id < profile.DomainSeconds.size());
+        }
+        BOOST_CHECK_EQUAL(profile.FrameSeconds.size(), 3);
+        BOOST_CHECK(!profile.PMLDomains.empty());
+        BOOST_CHECK(profile.GetPhaseSeconds(PROFILEPHASE::FFT) > 0);
+        BOOST_CHECK(profile.GetPhaseSeconds(PROFILEPHASE::RK_UPDATE) > 0);
+        BOOST_CHECK(profile.GetPhaseSeconds(PROFILEPHASE::PML) > 0);
+        BOOST_CHECK(profile.TotalSeconds > 0);
+
+        //the profiler is not kept by the domains after the run
+        for (auto domain: kernel.get_scene()->domain_list) {
+            BOOST_CHECK(!domain->profiler);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_kernel_profile_disabled) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Settings.SetRenderTime(1.5f * conf->Settings.GetTimeStep());
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        ProfileCallback callback;
+        kernel.run(&callback);
+
+        BOOST_CHECK_EQUAL(callback.profiles, 0);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the receivers
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/core/Receiver.h>
+#include <kernel/PSTDKernel.h>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(receiver)
+
+    BOOST_AUTO_TEST_CASE(test_nearest_neighbour_non_square) {
+        // A domain that is higher than wide, with the cell value encoding the row and the column
+        auto config = PSTDConfiguration::CreateDefaultConf();
+        config->Domains.clear();
+        DomainConf domain_conf;
+        domain_conf.TopLeft = QVector2D(0, 0);
+        domain_conf.Size = QVector2D(8, 18);
+        for (DomainConfEdge *edge: {&domain_conf.T, &domain_conf.B, &domain_conf.L, &domain_conf.R}) {
+            edge->Absorption = 1;
+            edge->LR = false;
+        }
+        config->Domains.push_back(domain_conf);
+        config->Receivers.clear();
+        PSTDKernel kernel;
+        kernel.initialize_kernel(config);
+        auto domain = kernel.get_scene()->domain_list.at(0);
+        BOOST_REQUIRE(domain->size.y > domain->size.x);
+
+        Eigen::ArrayXXf &p0 = domain->current_values.p0;
+        BOOST_REQUIRE_EQUAL(p0.rows(), domain->size.y);
+        for (int row = 0; row < p0.rows(); row++) {
+            for (int col = 0; col < p0.cols(); col++) {
+                p0(row, col) = row * 1000 + col;
+            }
+        }
+
+        // The receiver is beyond the width of the domain in y
+        Point relative(domain->size.x - 3, domain->size.y - 5);
+        std::vector<float> location = {domain->top_left.x + relative.x + 0.3f,
+                                       domain->top_left.y + relative.y + 0.4f, 0};
+        Receiver receiver(location, kernel.get_scene()->settings, 0, domain);
+        BOOST_CHECK_EQUAL(receiver.compute_local_pressure(), relative.y * 1000 + relative.x);
+        BOOST_CHECK_EQUAL(receiver.received_values.size(), 1);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Callback that records the results of a run and comparisons of the recorded results for the kernel tests
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_TEST_RECORDINGCALLBACK_H
+#define OPENPSTD_TEST_RECORDINGCALLBACK_H
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/KernelInterface.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Keeps all the frames and receiver samples that are written by a run
+ */
+class RecordingCallback : public OpenPSTD::Kernel::KernelCallback {
+public:
+    std::map<int, std::map<int, std::vector<float>>> frames;
+    std::map<int, std::vector<float>> samples;
+    int finished = 0;
+
+    void Callback(OpenPSTD::Kernel::CALLBACKSTATUS status, std::string message, int frame) override {
+        if (status == OpenPSTD::Kernel::CALLBACKSTATUS::FINISHED) {
+            this->finished++;
+        }
+    }
+
+    void WriteFrame(int frame, int domain, OpenPSTD::Kernel::PSTD_FRAME_PTR data) override {
+        this->frames[frame][domain] = *data;
+    }
+
+    void WriteSample(int startSample, int receiver, std::vector<float> data) override {
+        std::vector<float> &values = this->samples[receiver];
+        values.insert(values.end(), data.begin(), data.end());
+    }
+};
+
+/**
+ * The default scene with a short render time
+ */
+inline std::shared_ptr<OpenPSTD::Kernel::PSTDConfiguration> create_short_conf(int frames = 8) {
+    auto conf = OpenPSTD::Kernel::PSTDConfiguration::CreateDefaultConf();
+    conf->Settings.SetRenderTime((frames + 0.5f) * conf->Settings.GetTimeStep());
+    return conf;
+}
+
+/**
+ * Checks that two runs wrote the same frames and samples, the values are compared with a tolerance
+ */
+inline void check_close_results(RecordingCallback &result, RecordingCallback &expected, float tolerance) {
+    BOOST_REQUIRE_EQUAL(result.frames.size(), expected.frames.size());
+    for (auto &frame: expected.frames) {
+        BOOST_REQUIRE_EQUAL(result.frames[frame.first].size(), frame.second.size());
+        for (auto &domain: frame.second) {
+            std::vector<float> &values = result.frames[frame.first][domain.first];
+            BOOST_REQUIRE_EQUAL(values.size(), domain.second.size());
+            for (unsigned long i = 0; i < values.size(); i++) {
+                BOOST_CHECK_SMALL(values[i] - domain.second[i], tolerance);
+            }
+        }
+    }
+    BOOST_REQUIRE_EQUAL(result.samples.size(), expected.samples.size());
+    for (auto &receiver: expected.samples) {
+        std::vector<float> &values = result.samples[receiver.first];
+        BOOST_REQUIRE_EQUAL(values.size(), receiver.second.size());
+        for (unsigned long i = 0; i < values.size(); i++) {
+            BOOST_CHECK_SMALL(values[i] - receiver.second[i], tolerance);
+        }
+    }
+}
+
+/**
+ * Checks that two runs wrote exactly the same frames and samples
+ */
+inline void check_same_results(RecordingCallback &result, RecordingCallback &expected) {
+    BOOST_REQUIRE_EQUAL(result.frames.size(), expected.frames.size());
+    for (auto &frame: expected.frames) {
+        BOOST_REQUIRE_EQUAL(result.frames[frame.first].size(), frame.second.size());
+        for (auto &domain: frame.second) {
+            BOOST_CHECK(result.frames[frame.first][domain.first] == domain.second);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(result.samples.size(), expected.samples.size());
+    for (auto &receiver: expected.samples) {
+        BOOST_CHECK(result.samples[receiver.first] == receiver.second);
+    }
+}
+
+#endif //OPENPSTD_TEST_RECORDINGCALLBACK_H
@@ -0,0 +1,216 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the sweeps and batches of variants of a scene
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <kernel/SweepRunner.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include "RecordingCallback.h"
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(sweep_runner)
+
+    BOOST_AUTO_TEST_CASE(test_variants_match_separate_runs) {
+        auto base = create_short_conf();
+        std::vector<std::shared_ptr<PSTDConfiguration>> variants;
+        for (int i = 0; i < 4; i++) {
+            auto variant = create_short_conf();
+            //close to the left edge, so that the absorption of the edge changes the results
+            variant->Speakers[0] = QVector3D(0.4f + 0.2f * i, 5, 0);
+            variant->Domains[0].L.Absorption = 0.2f * (i + 1);
+            variant->Domains[1].R.Absorption = 1 - 0.1f * i;
+            if (i == 3) {
+                variant->Receivers.push_back(QVector3D(15, 8, 0));
+            }
+            variants.push_back(variant);
+        }
+
+        SweepRunner sweep(base);
+        std::vector<RecordingCallback> results(variants.size());
+        sweep.run(variants, [&results](unsigned long variant, PSTDKernel &kernel) {
+            kernel.run(&results[variant]);
+        }, 2);
+
+        for (unsigned long i = 0; i < variants.size(); i++) {
+            RecordingCallback expected;
+            PSTDKernel kernel;
+            kernel.initialize_kernel(variants[i]);
+            kernel.run(&expected);
+            check_close_results(results[i], expected, 1e-5f);
+        }
+        BOOST_CHECK_EQUAL(results[3].samples.size(), 2);
+        BOOST_CHECK(results[0].samples[0] != results[1].samples[0]);
+
+        //the variants run on copies, the scene of the sweep is not changed
+        for (auto domain: sweep.get_scene()->domain_list) {
+            BOOST_CHECK(domain->current_values.vx0.isZero() || !domain->is_pml);
+        }
+        BOOST_CHECK_EQUAL(sweep.get_scene()->receiver_list.at(0)->received_values.size(), 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_check_variant) {
+        auto base = create_short_conf();
+        SweepRunner sweep(base);
+
+        auto moved = create_short_conf();
+        moved->Domains[1].TopLeft = QVector2D(10, 5);
+        BOOST_CHECK_THROW(sweep.check_variant(moved), std::runtime_error);
+
+        auto reflecting = create_short_conf();
+        reflecting->Domains[0].L.Absorption = 0;
+        BOOST_CHECK_THROW(sweep.check_variant(reflecting), std::runtime_error);
+
+        auto absorbing = create_short_conf();
+        absorbing->Domains[0].L.Absorption = 0.9f;
+        sweep.check_variant(absorbing);
+
+        //no variant runs when one of them is not compatible
+        int runs = 0;
+        BOOST_CHECK_THROW(sweep.run({absorbing, moved}, [&runs](unsigned long variant, PSTDKernel &kernel) {
+            runs++;
+        }), std::runtime_error);
+        BOOST_CHECK_EQUAL(runs, 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_errors) {
+        SweepRunner sweep(create_short_conf());
+        std::vector<std::shared_ptr<PSTDConfiguration>> variants(6, create_short_conf());
+        std::mutex mutex;
+        int runs = 0;
+        BOOST_CHECK_THROW(sweep.run(variants, [&](unsigned long variant, PSTDKernel &kernel) {
+            std::lock_guard<std::mutex> lock(mutex);
+            runs++;
+            throw std::logic_error("variant failed");
+        }, 1), std::logic_error);
+        BOOST_CHECK_EQUAL(runs, 1);
+    }
+
+    std::vector<std::shared_ptr<PSTDConfiguration>> create_sources() {
+        std::vector<std::shared_ptr<PSTDConfiguration>> sources;
+        for (int i = 0; i < 3; i++) {
+            auto source = create_short_conf();
+            source->Speakers[0] = QVector3D(0.4f + 0.3f * i, 5 - i, 0);
+            if (i == 1) {
+                source->Speakers.push_back(QVector3D(15, 3, 0));
+                source->Receivers.push_back(QVector3D(12, 8, 0));
+            }
+            sources.push_back(source);
+        }
+        return sources;
+    }
+
+    BOOST_AUTO_TEST_CASE(test_batch_matches_separate_runs) {
+        auto sources = create_sources();
+        std::vector<RecordingCallback> results(sources.size());
+        std::vector<KernelCallback *> callbacks;
+        for (auto &result: results) {
+            callbacks.push_back(&result);
+        }
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(create_short_conf());
+        kernel.run_batch(sources, callbacks);
+
+        for (unsigned long i = 0; i < sources.size(); i++) {
+            RecordingCallback expected;
+            PSTDKernel separate;
+            separate.initialize_kernel(sources[i]);
+            separate.run(&expected);
+            check_close_results(results[i], expected, 1e-5f);
+        }
+        BOOST_CHECK_EQUAL(results[1].samples.size(), 2);
+        BOOST_CHECK(results[0].samples[0] != results[2].samples[0]);
+
+        //the scene of the kernel is not changed by the batch
+        BOOST_CHECK_EQUAL(kernel.get_scene()->receiver_list.at(0)->received_values.size(), 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_batch_errors) {
+        PSTDKernel kernel;
+        kernel.initialize_kernel(create_short_conf());
+        auto sources = create_sources();
+        std::vector<RecordingCallback> results(sources.size());
+        std::vector<KernelCallback *> callbacks = {&results[0], &results[1], &results[2]};
+
+        //the sources of a batch share the edges of the kernel
+        sources[2]->Domains[0].L.Absorption = 0.5f;
+        BOOST_CHECK_THROW(kernel.run_batch(sources, callbacks), std::runtime_error);
+        sources[2] = create_short_conf();
+        callbacks.pop_back();
+        BOOST_CHECK_THROW(kernel.run_batch(sources, callbacks), std::runtime_error);
+        BOOST_CHECK(results[0].frames.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_run_batches) {
+        auto sources = create_sources();
+        for (auto source: sources) {
+            source->Domains[1].R.Absorption = 0.6f;
+        }
+        SweepRunner sweep(create_short_conf());
+        std::vector<RecordingCallback> results(sources.size());
+        std::mutex mutex;
+        std::vector<std::vector<unsigned long>> batches;
+        sweep.run_batches(sources, [&](const std::vector<unsigned long> &batch, PSTDKernel &kernel) {
+            std::vector<std::shared_ptr<PSTDConfiguration>> configurations;
+            std::vector<KernelCallback *> callbacks;
+            for (unsigned long variant: batch) {
+                configurations.push_back(sources[variant]);
+                callbacks.push_back(&results[variant]);
+            }
+            kernel.run_batch(configurations, callbacks);
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(batch);
+        }, 2, 2);
+
+        BOOST_REQUIRE_EQUAL(batches.size(), 2);
+        std::sort(batches.begin(), batches.end());
+        BOOST_CHECK(batches[0] == std::vector<unsigned long>({0, 1}));
+        BOOST_CHECK(batches[1] == std::vector<unsigned long>({2}));
+        for (unsigned long i = 0; i < sources.size(); i++) {
+            RecordingCallback expected;
+            PSTDKernel separate;
+            separate.initialize_kernel(sources[i]);
+            separate.run(&expected);
+            check_close_results(results[i], expected, 1e-5f);
+        }
+
+        //the variants of a batch need the same edges
+        sources[1]->Domains[1].R.Absorption = 0.7f;
+        int runs = 0;
+        BOOST_CHECK_THROW(sweep.run_batches(sources, [&runs](const std::vector<unsigned long> &batch,
+                                                             PSTDKernel &kernel) {
+            runs++;
+        }, 2), std::runtime_error);
+        BOOST_CHECK_EQUAL(runs, 0);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
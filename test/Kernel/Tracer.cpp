@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the tracing of the solver
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <kernel/core/Tracer.h>
+#include <kernel/PSTDKernel.h>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(tracer)
+
+    class TraceCallback : public KernelCallback {
+    public:
+        int traces = 0;
+        KernelTrace trace;
+
+        void Callback(CALLBACKSTATUS status, std::string message, int frame) override { }
+
+        void WriteFrame(int frame, int domain, PSTD_FRAME_PTR data) override { }
+
+        void WriteSample(int startSample, int receiver, std::vector<float> data) override { }
+
+        void WriteTrace(const KernelTrace &trace) override {
+            this->traces++;
+            this->trace = trace;
+        }
+    };
+
+    BOOST_AUTO_TEST_CASE(test_ring_buffer) {
+        Tracer tracer(4);
+        for (int i = 0; i < 10; i++) {
+            TraceScope scope(&tracer, "task", "test", i);
+        }
+        KernelTrace trace = tracer.get_trace();
+        BOOST_CHECK_EQUAL(trace.ThreadCount, 1);
+        BOOST_REQUIRE_EQUAL(trace.Events.size(), 4);
+        BOOST_CHECK_EQUAL(trace.DroppedEvents, 6);
+        //only the last events are kept, in order
+        for (int i = 0; i < 4; i++) {
+            BOOST_CHECK_EQUAL(trace.Events[i].Frame, 6 + i);
+            BOOST_CHECK(trace.Events[i].Duration >= 0);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_threads) {
+        Tracer tracer(100);
+        {
+            TraceScope scope(&tracer, "main", "test");
+        }
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; t++) {
+            threads.push_back(std::thread([&tracer, t]() {
+                for (int i = 0; i < 10; i++) {
+                    TraceScope scope(&tracer, "worker", "test", i, t);
+                }
+            }));
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        KernelTrace trace = tracer.get_trace();
+        BOOST_CHECK_EQUAL(trace.ThreadCount, 4);
+        BOOST_CHECK_EQUAL(trace.Events.size(), 31);
+        BOOST_CHECK_EQUAL(trace.DroppedEvents, 0);
+        std::vector<int> counts(4, 0);
+        for (unsigned long i = 0; i < trace.Events.size(); i++) {
+            counts.at(trace.Events[i].Thread)++;
+            if (i > 0) {
+                BOOST_CHECK(trace.Events[i - 1].Start <= trace.Events[i].Start);
+            }
+        }
+        BOOST_CHECK_EQUAL(counts[0], 1);
+        BOOST_CHECK_EQUAL(counts[1] + counts[2] + counts[3], 30);
+
+        //without a tracer nothing is recorded
+        TraceScope disabled(nullptr, "disabled", "test");
+    }
+
+    BOOST_AUTO_TEST_CASE(test_chrome_trace) {
+        auto conf = PSTDConfiguration::CreateDefaultConf();
+        conf->Settings.SetRenderTime(2.5f * conf->Settings.GetTimeStep());
+        KernelRunOptions options;
+        options.TraceBufferSize = 100000;
+
+        PSTDKernel kernel;
+        kernel.initialize_kernel(conf);
+        TraceCallback callback;
+        kernel.run(&callback, options);
+        BOOST_REQUIRE_EQUAL(callback.traces, 1);
+
+        std::stringstream json;
+        callback.trace.WriteChromeTrace(json);
+        boost::property_tree::ptree root;
+        boost::property_tree::read_json(json, root);
+
+        int frames = 0, calcs = 0, threadNames = 0;
+        for (auto &entry: root.get_child("traceEvents")) {
+            std::string name = entry.second.get<std::string>("name");
+            std::string phase = entry.second.get<std::string>("ph");
+            if (phase == "M") {
+                threadNames++;
+                continue;
+            }
+            BOOST_CHECK_EQUAL(phase, "X");
+            BOOST_CHECK(entry.second.get<double>("dur") >= 0);
+            if (name == "frame") {
+                frames++;
+            }
+            else if (name == "calc") {
+                calcs++;
+                BOOST_CHECK(entry.second.get<int>("args.domain") >= 0);
+                BOOST_CHECK(entry.second.get<int>("args.rk_stage") < 6);
+                std::string field = entry.second.get<std::string>("args.field");
+                BOOST_CHECK(field == "pressure" || field == "velocity");
+            }
+        }
+        BOOST_CHECK_EQUAL(threadNames, 1);
+        BOOST_CHECK_EQUAL(frames, 2);
+        BOOST_CHECK(calcs > 0);
+        BOOST_CHECK_EQUAL(root.get<unsigned long long>("otherData.dropped_events"), 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_empty_chrome_trace) {
+        KernelTrace trace;
+        std::stringstream json;
+        trace.WriteChromeTrace(json);
+        boost::property_tree::ptree root;
+        boost::property_tree::read_json(json, root);
+        BOOST_CHECK_EQUAL(root.get_child("traceEvents").size(), 0);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
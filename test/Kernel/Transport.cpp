@@ -0,0 +1,259 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the transports between the ranks of a distributed simulation
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/interprocess/ipc/message_queue.hpp>
+#include <kernel/core/Transport.h>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(transport)
+
+    typedef std::function<std::shared_ptr<Transport>(int rank)> TransportFactory;
+
+    TransportFactory tcp_factory(int size) {
+        //a random range of ports, so that runs of the tests at the same time do not collide
+        std::random_device random;
+        int port = 20000 + (int) (random() % 40000);
+        std::vector<std::string> endpoints;
+        for (int rank = 0; rank < size; rank++) {
+            endpoints.push_back("localhost:" + std::to_string(port + rank));
+        }
+        return [endpoints](int rank) { return std::make_shared<TcpTransport>(rank, endpoints, 10); };
+    }
+
+    TransportFactory shared_memory_factory(int size) {
+        std::random_device random;
+        std::string name = "openpstd-test-" + std::to_string(random());
+        return [name, size](int rank) { return std::make_shared<SharedMemoryTransport>(name, rank, size, 10); };
+    }
+
+    /**
+     * Runs the function of every rank in its own thread, an exception of a rank is rethrown
+     */
+    void run_ranks(int size, std::function<void(int rank)> function) {
+        std::vector<std::exception_ptr> errors((unsigned long) size);
+        std::vector<std::thread> threads;
+        for (int rank = 0; rank < size; rank++) {
+            threads.push_back(std::thread([&, rank]() {
+                try {
+                    function(rank);
+                }
+                catch (...) {
+                    errors[rank] = std::current_exception();
+                }
+            }));
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (auto error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    /**
+     * Messages of different sizes from a rank to another rank, the largest is split in several chunks
+     */
+    std::vector<std::vector<char>> create_messages(int source, int destination) {
+        std::vector<std::vector<char>> messages;
+        for (unsigned long length: {0ul, 1ul, 1000ul, 3 * SharedMemoryTransport::chunk_size + 17}) {
+            std::vector<char> message(length);
+            for (unsigned long i = 0; i < length; i++) {
+                message[i] = (char) (i * 7 + source * 3 + destination);
+            }
+            messages.push_back(message);
+        }
+        return messages;
+    }
+
+    /**
+     * Sends the messages between all the ranks, the received messages are checked after the ranks are done
+     */
+    void check_messages(int size, TransportFactory factory) {
+        //messages[destination][source]
+        std::vector<std::vector<std::vector<std::vector<char>>>> received(
+                (unsigned long) size, std::vector<std::vector<std::vector<char>>>((unsigned long) size));
+        run_ranks(size, [&](int rank) {
+            std::shared_ptr<Transport> transport = factory(rank);
+            for (int peer = 0; peer < size; peer++) {
+                if (peer != rank) {
+                    for (auto &message: create_messages(rank, peer)) {
+                        transport->send(peer, message);
+                    }
+                }
+            }
+            for (int peer = 0; peer < size; peer++) {
+                if (peer != rank) {
+                    for (unsigned long i = 0; i < create_messages(peer, rank).size(); i++) {
+                        received[rank][peer].push_back(transport->receive(peer));
+                    }
+                }
+            }
+            transport->barrier();
+        });
+        for (int rank = 0; rank < size; rank++) {
+            for (int peer = 0; peer < size; peer++) {
+                if (peer != rank) {
+                    BOOST_CHECK(received[rank][peer] == create_messages(peer, rank));
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_tcp_messages) {
+        check_messages(3, tcp_factory(3));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_shared_memory_messages) {
+        check_messages(3, shared_memory_factory(3));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_single_rank) {
+        TcpTransport transport(0, {"localhost:0"});
+        BOOST_CHECK_EQUAL(transport.get_rank(), 0);
+        BOOST_CHECK_EQUAL(transport.get_size(), 1);
+        transport.barrier();
+        BOOST_CHECK_THROW(transport.send(0, std::vector<char>()), std::runtime_error);
+        BOOST_CHECK_THROW(transport.receive(1), std::runtime_error);
+    }
+
+    /**
+     * Rank 1 sends a message and stops, the next receive of rank 0 fails before the timeout of 10 seconds
+     */
+    void check_closed_connection(TransportFactory factory) {
+        bool closed = false;
+        run_ranks(2, [&](int rank) {
+            std::shared_ptr<Transport> transport = factory(rank);
+            //rank 1 does not remove its queues before rank 0 opened them
+            transport->barrier();
+            if (rank == 0) {
+                transport->receive(1);
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    transport->receive(1);
+                }
+                catch (std::runtime_error &) {
+                    closed = std::chrono::steady_clock::now() - start < std::chrono::seconds(5);
+                }
+            }
+            else {
+                transport->send(0, std::vector<char>(10));
+            }
+        });
+        BOOST_CHECK(closed);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_tcp_closed_connection) {
+        check_closed_connection(tcp_factory(2));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_shared_memory_closed_connection) {
+        check_closed_connection(shared_memory_factory(2));
+    }
+
+    /**
+     * Rank 2 fails, the waiting receives of the other ranks fail with its error
+     */
+    void check_abort(TransportFactory factory) {
+        std::vector<std::string> errors(3);
+        run_ranks(3, [&](int rank) {
+            std::shared_ptr<Transport> transport = factory(rank);
+            transport->barrier();
+            if (rank == 2) {
+                transport->abort("the disk is full");
+                return;
+            }
+            try {
+                transport->receive(2);
+            }
+            catch (std::runtime_error &e) {
+                errors[rank] = e.what();
+            }
+        });
+        for (int rank = 0; rank < 2; rank++) {
+            BOOST_CHECK_NE(errors[rank].find("rank 2 failed: the disk is full"), std::string::npos);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_tcp_abort) {
+        check_abort(tcp_factory(3));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_shared_memory_abort) {
+        check_abort(shared_memory_factory(3));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_receive_timeout) {
+        std::random_device random;
+        std::string name = "openpstd-test-" + std::to_string(random());
+        int timeouts = 0;
+        std::mutex mutex;
+        run_ranks(2, [&](int rank) {
+            SharedMemoryTransport transport(name, rank, 2, 0.2);
+            try {
+                transport.receive(1 - rank);
+            }
+            catch (std::runtime_error &) {
+                std::lock_guard<std::mutex> lock(mutex);
+                timeouts++;
+            }
+        });
+        BOOST_CHECK_EQUAL(timeouts, 2);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_errors) {
+        BOOST_CHECK_THROW(TcpTransport(0, {"localhost"}), std::runtime_error);
+        BOOST_CHECK_THROW(TcpTransport(2, {"localhost:0", "localhost:0"}), std::runtime_error);
+
+        //a queue that is left by another run is not reused
+        std::random_device random;
+        std::string name = "openpstd-test-" + std::to_string(random());
+        std::string queue_name = name + "-1-0";
+        {
+            boost::interprocess::message_queue stale(boost::interprocess::create_only, queue_name.c_str(), 1, 1);
+            BOOST_CHECK_THROW(SharedMemoryTransport(name, 0, 2, 0.1), std::runtime_error);
+        }
+        BOOST_CHECK(boost::interprocess::message_queue::remove(queue_name.c_str()));
+
+        //rank 1 never starts, the created queues are removed
+        BOOST_CHECK_THROW(SharedMemoryTransport(name, 0, 2, 0.1), std::runtime_error);
+        BOOST_CHECK(!boost::interprocess::message_queue::remove(queue_name.c_str()));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -37,6 +37,7 @@
 #include <boost/test/unit_test.hpp>
 #include "../../kernel/core/WisdomCache.h"
 #include <cmath>
+#include <thread>
 #include <kernel/core/kernel_functions.h>
 
 using namespace OpenPSTD::Kernel;
@@ -98,4 +99,48 @@ BOOST_AUTO_TEST_SUITE(wave_numbers)
     }
 
 
+    BOOST_AUTO_TEST_CASE(test_concurrent_planning) {
+        // Kernels in different threads plan their transforms at the same time, the planner of FFTW is not thread
+        // safe so the caches must serialize the planning
+        const int threads = 8;
+        vector<int> failures(threads, 0);
+        vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([t, &failures]() {
+                for (int round = 0; round < 10; round++) {
+                    WisdomCache wnd;
+                    for (int length: {32, 48, 64, 96, 128, 192, 256, 384, 512}) {
+                        int batch = t + 1;
+                        WisdomCache::Planset_FFTW planset = wnd.get_fftw_planset(length, batch);
+                        if (planset.plan == nullptr || planset.plan_inv == nullptr) {
+                            failures[t]++;
+                            continue;
+                        }
+                        // A constant signal only has a DC component, the inverse transform scales it with the length
+                        float *in = (float *) fftwf_malloc(sizeof(float) * length * batch);
+                        fftwf_complex *out = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) *
+                                                                            (length / 2 + 1) * batch);
+                        fill(in, in + length * batch, 1.0f);
+                        fftwf_execute_dft_r2c(planset.plan, in, out);
+                        fftwf_execute_dft_c2r(planset.plan_inv, out, in);
+                        for (int i = 0; i < length * batch; i++) {
+                            if (!is_approx(in[i], (float) length)) {
+                                failures[t]++;
+                                break;
+                            }
+                        }
+                        fftwf_free(in);
+                        fftwf_free(out);
+                    }
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        for (int t = 0; t < threads; t++) {
+            BOOST_CHECK_EQUAL(failures[t], 0);
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
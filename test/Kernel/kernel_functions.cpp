@@ -140,6 +140,18 @@ BOOST_AUTO_TEST_SUITE(kernel_functions)
         
         BOOST_CHECK(spatexpectation_pressin.isApprox(spatresult_pressin));
         BOOST_CHECK(spatexpectation_velosin.isApprox(spatresult_velosin));
+
+        //the cached plans of a transform of 128 values give the same derivatives, also in the y direction
+        WisdomCache::Planset_FFTW planset = wnd.get_fftw_planset(128, 1);
+        Eigen::ArrayXXf cached_pressin = spatderp3(d1p.sin(), d2p.sin(), d3p.sin(), derfact_p, rho_array, window, wlen,
+                                                   CalculationType::PRESSURE, CalcDirection::X, planset.plan,
+                                                   planset.plan_inv);
+        Eigen::ArrayXXf cached_velosin = spatderp3(d1v.sin().transpose(), d2v.sin().transpose(),
+                                                   d3v.sin().transpose(), derfact_v, rho_array, window, wlen,
+                                                   CalculationType::VELOCITY, CalcDirection::Y, planset.plan,
+                                                   planset.plan_inv);
+        BOOST_CHECK(cached_pressin.isApprox(spatresult_pressin));
+        BOOST_CHECK(cached_velosin.isApprox(spatresult_velosin.transpose()));
     }
 
     BOOST_AUTO_TEST_CASE(window_generator) {
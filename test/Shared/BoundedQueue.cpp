@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the bounded queue between pipeline stages
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <shared/BoundedQueue.h>
+
+using namespace OpenPSTD::Shared;
+
+BOOST_AUTO_TEST_SUITE(bounded_queue)
+
+    BOOST_AUTO_TEST_CASE(test_close_drains_queue)
+    {
+        BoundedQueue<int> queue(4);
+        BOOST_CHECK(queue.Push(1));
+        BOOST_CHECK(queue.Push(2));
+        queue.Close();
+        BOOST_CHECK(!queue.Push(3));
+
+        int value;
+        BOOST_CHECK(queue.Pop(value));
+        BOOST_CHECK_EQUAL(value, 1);
+        BOOST_CHECK(queue.Pop(value));
+        BOOST_CHECK_EQUAL(value, 2);
+        BOOST_CHECK(!queue.Pop(value));
+    }
+
+    BOOST_AUTO_TEST_CASE(test_producer_consumers)
+    {
+        BoundedQueue<int> queue(2);
+        boost::mutex mutex;
+        long long sum = 0;
+        int count = 0;
+
+        boost::thread_group consumers;
+        for (int i = 0; i < 4; ++i)
+        {
+            consumers.create_thread([&]()
+            {
+                int value;
+                while(queue.Pop(value))
+                {
+                    boost::unique_lock<boost::mutex> lock(mutex);
+                    sum += value;
+                    count++;
+                }
+            });
+        }
+
+        for (int i = 1; i <= 1000; ++i)
+        {
+            BOOST_REQUIRE(queue.Push(i));
+        }
+        queue.Close();
+        consumers.join_all();
+
+        BOOST_CHECK_EQUAL(count, 1000);
+        BOOST_CHECK_EQUAL(sum, 500500);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_abort_unblocks_producer)
+    {
+        BoundedQueue<int> queue(1);
+        BOOST_CHECK(queue.Push(1));
+
+        bool pushed = true;
+        boost::thread producer([&]() { pushed = queue.Push(2); });
+        queue.Abort();
+        producer.join();
+
+        BOOST_CHECK(!pushed);
+        int value;
+        BOOST_CHECK(!queue.Pop(value));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the color lookup table of the exporters
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <shared/ColorLUT.h>
+#include <cmath>
+
+using namespace OpenPSTD::Shared;
+
+BOOST_AUTO_TEST_SUITE(color_lut)
+
+    BOOST_AUTO_TEST_CASE(test_map_indices)
+    {
+        TwoColorGradient gradient(COLOR_BLACK, COLOR_WHITE);
+        ColorLUT lut(gradient, 256);
+        BOOST_CHECK_EQUAL(lut.GetSize(), 256);
+
+        std::vector<float> values = {-1, -2, 1, 5, 0, NAN, 0.5f};
+        std::vector<unsigned char> indices(values.size());
+        lut.MapIndices(values.data(), values.size(), -1, 1, indices.data());
+
+        BOOST_CHECK_EQUAL(indices[0], 0);
+        BOOST_CHECK_EQUAL(indices[1], 0);
+        BOOST_CHECK_EQUAL(indices[2], 255);
+        BOOST_CHECK_EQUAL(indices[3], 255);
+        BOOST_CHECK_EQUAL(indices[4], 128);
+        BOOST_CHECK_EQUAL(indices[5], 0);
+        BOOST_CHECK_EQUAL(indices[6], 191);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_map_colors)
+    {
+        TwoColorGradient gradient(COLOR_BLACK, COLOR_RED);
+        ColorLUT lut(gradient, 1024);
+
+        //more values than a single block
+        std::vector<float> values(1000);
+        for (int i = 0; i < values.size(); i++)
+        {
+            values[i] = i / 999.0f;
+        }
+        std::vector<QRgb> colors(values.size());
+        lut.MapColors(values.data(), values.size(), 0, 1, colors.data());
+
+        BOOST_CHECK_EQUAL(colors.front(), COLOR_BLACK.rgb());
+        BOOST_CHECK_EQUAL(colors.back(), COLOR_RED.rgb());
+        for (int i = 1; i < colors.size(); i++)
+        {
+            BOOST_CHECK(qRed(colors[i]) >= qRed(colors[i - 1]));
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
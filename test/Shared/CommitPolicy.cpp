@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the periodic commits of the results
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+#include <shared/CommitPolicy.h>
+
+using namespace OpenPSTD::Shared;
+
+BOOST_AUTO_TEST_SUITE(commit_policy)
+
+    BOOST_AUTO_TEST_CASE(test_disabled_policy)
+    {
+        CommitPolicy policy;
+        BOOST_CHECK(!policy.IsEnabled());
+
+        PeriodicCommitter committer(policy);
+        BOOST_CHECK(!committer.ShouldCommit());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_default_policy)
+    {
+        CommitPolicy policy = CommitPolicy::Default();
+        BOOST_CHECK(policy.IsEnabled());
+        BOOST_CHECK_EQUAL(policy.Frames, 0u);
+        BOOST_CHECK_EQUAL(policy.Megabytes, 256);
+        BOOST_CHECK_EQUAL(policy.Seconds, 30);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_frame_threshold)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("commit-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+
+            CommitPolicy policy;
+            policy.Frames = 3;
+            PeriodicCommitter committer(policy);
+
+            BOOST_CHECK(!committer.FrameWritten(file.get(), 100));
+            BOOST_CHECK(!committer.FrameWritten(file.get(), 100));
+            BOOST_CHECK(committer.FrameWritten(file.get(), 100));
+            BOOST_CHECK(!committer.ShouldCommit());
+
+            CommitMetrics metrics = committer.GetMetrics();
+            BOOST_CHECK_EQUAL(metrics.Count, 1);
+            BOOST_CHECK_EQUAL(metrics.BytesCommitted, 300);
+            BOOST_CHECK(metrics.MaxSeconds >= metrics.AverageSeconds());
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_size_threshold)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("commit-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+
+            CommitPolicy policy;
+            policy.Megabytes = 1;
+            PeriodicCommitter committer(policy);
+
+            BOOST_CHECK(!committer.DataWritten(file.get(), 512 * 1024));
+            BOOST_CHECK(committer.DataWritten(file.get(), 512 * 1024));
+            BOOST_CHECK_EQUAL(committer.GetMetrics().Count, 1);
+        }
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
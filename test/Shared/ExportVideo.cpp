@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the video formats of the image export
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <shared/PSTDFile.h>
+#include <shared/export/Image.h>
+#include "ResultsFixture.h"
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+/**
+ * Creates a results file with the given number of frames, the even frames are 0 and the odd frames are 1
+ */
+std::shared_ptr<PSTDFile> create_video_results(boost::filesystem::path path, int frames)
+{
+    return create_results(path, frames, [](int domain, int frame, size_t cell) { return (float) (frame % 2); });
+}
+
+std::vector<char> read_all(boost::filesystem::path path)
+{
+    std::ifstream stream(path.string(), std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+BOOST_AUTO_TEST_SUITE(export_video)
+
+    BOOST_AUTO_TEST_CASE(test_y4m_and_raw)
+    {
+        const int frames = 5;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("video-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_video_results(directory / "results.pstd", frames);
+
+        ExportImage exporter;
+        exporter.SetJobs(3);
+        exporter.SetFrameRate(25);
+        exporter.ExportData("video/x-yuv4mpeg", file, directory.string(), "video", {}, -1, -1);
+
+        std::vector<char> y4m = read_all(directory / "video.y4m");
+        std::string header(y4m.begin(), std::find(y4m.begin(), y4m.end(), '\n'));
+        int width, height;
+        std::string tag;
+        std::istringstream headerStream(header);
+        headerStream >> tag;
+        BOOST_CHECK_EQUAL(tag, "YUV4MPEG2");
+        headerStream >> tag;
+        width = std::stoi(tag.substr(1));
+        headerStream >> tag;
+        height = std::stoi(tag.substr(1));
+        headerStream >> tag;
+        BOOST_CHECK_EQUAL(tag, "F25:1");
+        BOOST_REQUIRE(width > 0 && height > 0);
+
+        size_t frameBytes = (size_t) width * height * 3;
+        BOOST_REQUIRE_EQUAL(y4m.size(), header.size() + 1 + frames * (6 + frameBytes));
+        for (int f = 0; f < frames; f++)
+        {
+            size_t offset = header.size() + 1 + f * (6 + frameBytes);
+            BOOST_CHECK_EQUAL(std::string(y4m.begin() + offset, y4m.begin() + offset + 6), "FRAME\n");
+        }
+
+        exporter.ExportData("video/x-raw-rgb", file, directory.string(), "video", {}, -1, -1);
+        std::vector<char> raw = read_all(directory / ("video-" + std::to_string(width) + "x" +
+                                                      std::to_string(height) + ".rgb"));
+        BOOST_REQUIRE_EQUAL(raw.size(), frames * frameBytes);
+
+        //the frames are written in order, even when they are colorized out of order
+        auto frame = [&](int f) { return std::vector<char>(raw.begin() + f * frameBytes,
+                                                           raw.begin() + (f + 1) * frameBytes); };
+        BOOST_CHECK(frame(0) != frame(1));
+        for (int f = 2; f < frames; f++)
+        {
+            BOOST_CHECK(frame(f) == frame(f % 2));
+        }
+
+        file.reset();
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_cannot_open)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("video-%%%%%%%%.pstd");
+        std::shared_ptr<PSTDFile> file = create_video_results(path, 3);
+        boost::filesystem::path missing = boost::filesystem::temp_directory_path() /
+                                          boost::filesystem::unique_path("missing-%%%%%%%%");
+
+        ExportImage exporter;
+        exporter.SetJobs(2);
+        BOOST_CHECK_THROW(exporter.ExportData("video/x-yuv4mpeg", file, missing.string(), "video", {}, -1, -1),
+                          std::runtime_error);
+        BOOST_CHECK_THROW(exporter.ExportData("video/x-raw-rgb", file, missing.string(), "video", {}, -1, -1),
+                          std::runtime_error);
+        BOOST_CHECK(!boost::filesystem::exists(missing));
+
+        file.reset();
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
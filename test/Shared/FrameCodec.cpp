@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the encoding of the stored frames
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <shared/FrameCodec.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(frame_codec)
+
+    BOOST_AUTO_TEST_CASE(test_lossless_bit_exact)
+    {
+        PSTD_FRAME frame;
+        for(int i = 0; i < 1000; i++)
+        {
+            frame.push_back(std::sin(i * 0.01f) * std::exp(-i * 0.001f));
+        }
+        frame.push_back(-0.0f);
+        frame.push_back(std::numeric_limits<float>::infinity());
+        frame.push_back(std::numeric_limits<float>::denorm_min());
+
+        FrameCodec codec(FRAMESTORAGE::LOSSLESS);
+        std::vector<char> encoded = codec.Encode(frame);
+        PSTD_FRAME_PTR decoded = codec.Decode(encoded.data(), encoded.size());
+
+        BOOST_REQUIRE_EQUAL(decoded->size(), frame.size());
+        BOOST_CHECK(std::memcmp(decoded->data(), frame.data(), frame.size() * sizeof(PSTD_FRAME_UNIT)) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_lossless_zero_frame)
+    {
+        PSTD_FRAME frame(100000, 0.0f);
+
+        FrameCodec codec(FRAMESTORAGE::LOSSLESS);
+        std::vector<char> encoded = codec.Encode(frame);
+        BOOST_CHECK(encoded.size() < frame.size() * sizeof(PSTD_FRAME_UNIT) / 100);
+
+        PSTD_FRAME_PTR decoded = codec.Decode(encoded.data(), encoded.size());
+        BOOST_CHECK(*decoded == frame);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_raw)
+    {
+        PSTD_FRAME frame = {1, 2, 3, 4};
+
+        FrameCodec codec(FRAMESTORAGE::RAW);
+        std::vector<char> encoded = codec.Encode(frame);
+        BOOST_CHECK_EQUAL(encoded.size(), frame.size() * sizeof(PSTD_FRAME_UNIT));
+        BOOST_CHECK(*codec.Decode(encoded.data(), encoded.size()) == frame);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_lossless_corrupt)
+    {
+        FrameCodec codec(FRAMESTORAGE::LOSSLESS);
+        std::vector<char> encoded = codec.Encode(PSTD_FRAME(100, 1.0f));
+        encoded.resize(encoded.size() / 2);
+        BOOST_CHECK_THROW(codec.Decode(encoded.data(), encoded.size()), FrameCodecException);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_lossless_invalid_data)
+    {
+        FrameCodec codec(FRAMESTORAGE::LOSSLESS);
+        std::vector<char> encoded = codec.Encode(PSTD_FRAME(100, 1.0f));
+
+        //data that is not a deflate stream
+        std::vector<char> garbage = encoded;
+        std::fill(garbage.begin() + sizeof(uint32_t), garbage.end(), (char) 0xAB);
+        BOOST_CHECK_THROW(codec.Decode(garbage.data(), garbage.size()), FrameCodecException);
+
+        //more values than the compressed data can contain
+        std::vector<char> large = encoded;
+        uint32_t n = 0xFFFFFFFF;
+        std::memcpy(large.data(), &n, sizeof(uint32_t));
+        BOOST_CHECK_THROW(codec.Decode(large.data(), large.size()), FrameCodecException);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_visualization_error_bound)
+    {
+        PSTD_FRAME frame;
+        for(int i = 0; i < 4000; i++)
+        {
+            frame.push_back(std::sin(i * 0.013f) * 3.0f);
+        }
+        float peak = 3.0f;
+
+        for(float bound : {-40.0f, -60.0f, -90.0f})
+        {
+            FrameCodec codec(FRAMESTORAGE::VISUALIZATION, bound);
+            std::vector<char> encoded = codec.Encode(frame);
+            PSTD_FRAME_PTR decoded = codec.Decode(encoded.data(), encoded.size());
+
+            BOOST_REQUIRE_EQUAL(decoded->size(), frame.size());
+            float maxError = 0;
+            for(int i = 0; i < frame.size(); i++)
+            {
+                maxError = std::max(maxError, std::abs((*decoded)[i] - frame[i]));
+            }
+            BOOST_CHECK(maxError <= peak * std::pow(10.0f, bound / 20.0f));
+            BOOST_CHECK(encoded.size() <= frame.size() * sizeof(PSTD_FRAME_UNIT) / 2 + 64);
+        }
+
+        //-40 dB fits in 8 bits
+        FrameCodec codec8(FRAMESTORAGE::VISUALIZATION, -40);
+        BOOST_CHECK(codec8.Encode(frame).size() <= frame.size() + 64);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_visualization_zero_frame)
+    {
+        PSTD_FRAME frame(100, 0.0f);
+
+        FrameCodec codec(FRAMESTORAGE::VISUALIZATION, -60);
+        std::vector<char> encoded = codec.Encode(frame);
+        BOOST_CHECK(*codec.Decode(encoded.data(), encoded.size()) == frame);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the preview levels of the frames
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+#include <shared/FramePyramid.h>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(frame_pyramid)
+
+    BOOST_AUTO_TEST_CASE(test_downsample)
+    {
+        //3x3 frame, the last row and column are used twice
+        PSTD_FRAME frame = {1, -4,  2,
+                            3,  0, -1,
+                            0,  5, -6};
+        PSTD_FRAME_PTR level = FramePyramid::Downsample(frame, 3, 3);
+        BOOST_REQUIRE_EQUAL(level->size(), 4);
+        BOOST_CHECK_EQUAL((*level)[0], -4);
+        BOOST_CHECK_EQUAL((*level)[1], 2);
+        BOOST_CHECK_EQUAL((*level)[2], 5);
+        BOOST_CHECK_EQUAL((*level)[3], -6);
+
+        BOOST_CHECK_EQUAL(FramePyramid::LevelSize(3, 0), 3);
+        BOOST_CHECK_EQUAL(FramePyramid::LevelSize(3, 1), 2);
+        BOOST_CHECK_EQUAL(FramePyramid::LevelSize(5, 2), 2);
+        BOOST_CHECK_EQUAL(FramePyramid::LevelSize(1, 3), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_build)
+    {
+        PSTD_FRAME frame(10 * 7, 0.0f);
+        frame[6 * 10 + 9] = 2.0f;
+        auto levels = FramePyramid::Build(frame, 10, 7, 3);
+        BOOST_REQUIRE_EQUAL(levels.size(), 3);
+        for(unsigned int l = 1; l <= 3; l++)
+        {
+            BOOST_CHECK_EQUAL(levels[l - 1]->size(), FramePyramid::LevelSize(10, l) * FramePyramid::LevelSize(7, l));
+            //the peak stays visible in the last cell of every level
+            BOOST_CHECK_EQUAL(levels[l - 1]->back(), 2.0f);
+        }
+
+        BOOST_CHECK(FramePyramid::Build(PSTD_FRAME(10), 10, 7, 3).empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_stored_with_results)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("pyramid-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->SetPreviewLevels(3);
+            file->InitializeResults();
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+            BOOST_REQUIRE(size[0] > 4 && size[1] > 4);
+
+            PSTD_FRAME_PTR frame = std::make_shared<PSTD_FRAME>(size[0] * size[1], 0.0f);
+            (*frame)[size[0] + 1] = -1.0f;
+            file->SaveNextResultsFrame(0, frame);
+            file->Commit();
+
+            PSTD_FRAME_PTR level = file->GetResultsFrameLevel(0, 0, 1);
+            std::vector<int> levelSize = file->GetResultsFrameLevelSize(0, 1);
+            BOOST_REQUIRE_EQUAL(level->size(), levelSize[0] * levelSize[1]);
+            BOOST_CHECK_EQUAL((*level)[0], -1.0f);
+        }
+
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            PSTD_FRAME_PTR level = file->GetResultsFrameLevel(0, 0, 2);
+            std::vector<int> levelSize = file->GetResultsFrameLevelSize(0, 2);
+            BOOST_REQUIRE_EQUAL(level->size(), levelSize[0] * levelSize[1]);
+            BOOST_CHECK_EQUAL((*level)[0], -1.0f);
+
+            //levels that are not stored are created from the frame
+            level = file->GetResultsFrameLevel(0, 0, 5);
+            levelSize = file->GetResultsFrameLevelSize(0, 5);
+            BOOST_REQUIRE_EQUAL(level->size(), levelSize[0] * levelSize[1]);
+            BOOST_CHECK_EQUAL((*level)[0], -1.0f);
+
+            auto snapshot = file->GetResultsSnapshot();
+            auto snapshotLevel = file->GetSnapshotFrame(*snapshot, 0, 0, 1);
+            BOOST_REQUIRE(snapshotLevel);
+            BOOST_CHECK_EQUAL(snapshotLevel->size(), file->GetResultsFrameLevelSize(0, 1)[0] *
+                                                     file->GetResultsFrameLevelSize(0, 1)[1]);
+        }
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the statistics of the frames
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+#include <shared/FrameStatistics.h>
+#include <cmath>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(frame_statistics)
+
+    BOOST_AUTO_TEST_CASE(test_compute_and_combine)
+    {
+        PSTD_FRAME frame = {-2, 1, 1, 2, NAN};
+        FrameStatistics statistics = FrameStatistics::Compute(frame, 4);
+        BOOST_CHECK_EQUAL(statistics.Count, 4);
+        BOOST_CHECK_EQUAL(statistics.Min, -2);
+        BOOST_CHECK_EQUAL(statistics.Max, 2);
+        BOOST_CHECK_CLOSE(statistics.RMS, std::sqrt(2.5f), 1e-4);
+        BOOST_REQUIRE_EQUAL(statistics.Histogram.size(), 4);
+        BOOST_CHECK_EQUAL(statistics.Histogram[0], 1);
+        BOOST_CHECK_EQUAL(statistics.Histogram[3], 3);
+
+        FrameStatistics other = FrameStatistics::Compute(PSTD_FRAME(4, 4.0f), 0);
+        FrameStatistics combined = FrameStatistics::Combine(statistics, other);
+        BOOST_CHECK_EQUAL(combined.Count, 8);
+        BOOST_CHECK_EQUAL(combined.Min, -2);
+        BOOST_CHECK_EQUAL(combined.GetPeak(), 4);
+        BOOST_CHECK_CLOSE(combined.RMS, std::sqrt((2.5f * 4 + 16 * 4) / 8), 1e-4);
+        BOOST_CHECK(combined.Histogram.empty());
+
+        BOOST_CHECK(FrameStatistics::Combine(FrameStatistics(), FrameStatistics()).IsEmpty());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_encode_decode)
+    {
+        FrameStatistics statistics = FrameStatistics::Compute({0.5f, -0.25f, 3}, 8);
+        std::vector<char> encoded = statistics.Encode();
+        FrameStatistics decoded = FrameStatistics::Decode(encoded.data(), encoded.size());
+        BOOST_CHECK_EQUAL(decoded.Min, statistics.Min);
+        BOOST_CHECK_EQUAL(decoded.Max, statistics.Max);
+        BOOST_CHECK_EQUAL(decoded.RMS, statistics.RMS);
+        BOOST_CHECK_EQUAL(decoded.Count, statistics.Count);
+        BOOST_CHECK(decoded.Histogram == statistics.Histogram);
+
+        BOOST_CHECK(FrameStatistics::Decode(encoded.data(), 3).IsEmpty());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_stored_with_results)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("statistics-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            file->SetStatisticsHistogramBins(16);
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+            unsigned long cells = size[0] * size[1];
+            for(int f = 0; f < 5; f++)
+            {
+                PSTD_FRAME_PTR frame = std::make_shared<PSTD_FRAME>(cells, 0.0f);
+                (*frame)[f] = (float)f;
+                (*frame)[cells - 1] = -1.0f;
+                file->SaveNextResultsFrame(0, frame);
+            }
+            file->Commit();
+
+            FrameStatistics statistics = file->GetResultsFrameStatistics(3, 0);
+            BOOST_CHECK_EQUAL(statistics.Max, 3);
+            BOOST_CHECK_EQUAL(statistics.Min, -1);
+            BOOST_CHECK_EQUAL(statistics.Histogram.size(), 16);
+
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsStatistics(0).Max, 4);
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsStatistics().Count, 5 * cells);
+        }
+
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_CHECK_EQUAL(file->GetResultsStatistics(0).Max, 4);
+            BOOST_CHECK_EQUAL(file->GetResultsStatistics(0).Min, -1);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameStatistics(2, 0).Max, 2);
+
+            file->DeleteResults();
+            file->InitializeResults();
+            BOOST_CHECK(file->GetResultsStatistics(0).IsEmpty());
+        }
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the HDF5 export
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <shared/PSTDFile.h>
+#include <shared/export/HDF5Export.h>
+#include "ResultsFixture.h"
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+/**
+ * Creates a results file with two receivers of a different length, every cell of every frame has its own value
+ */
+std::shared_ptr<PSTDFile> create_hdf5_results(boost::filesystem::path path, int frames)
+{
+    std::shared_ptr<PSTDFile> file = create_results(path, frames, results_cell_value, [](PSTDConfiguration &conf)
+    {
+        conf.Receivers.push_back(QVector3D(7, 6, 0));
+    });
+    file->SaveReceiverData(0, std::make_shared<PSTD_RECEIVER_DATA>(PSTD_RECEIVER_DATA{1, 2, 3, 4, 5}));
+    file->SaveReceiverData(1, std::make_shared<PSTD_RECEIVER_DATA>(PSTD_RECEIVER_DATA{6, 7, 8}));
+    file->Commit();
+    return file;
+}
+
+BOOST_AUTO_TEST_SUITE(export_hdf5)
+
+    BOOST_AUTO_TEST_CASE(test_round_trip)
+    {
+        const int frames = 7;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("hdf5-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_hdf5_results(directory / "results.pstd", frames);
+        auto metadata = file->GetResultsMetadata();
+        std::string output = (directory / "results.h5").string();
+
+        //the frames are written in batches that do not line up with the chunks
+        HDF5 exporter;
+        exporter.SetChunkFrames(2);
+        exporter.SetChunkSize(4, 5);
+        exporter.SetDeflateLevel(4);
+        exporter.SetShuffle(true);
+        exporter.SetBatchFrames(3);
+        exporter.ExportData("application/x-hdf", file, output, {}, -1, -1);
+
+        hid_t file_id = H5Fopen(output.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        BOOST_REQUIRE(file_id >= 0);
+
+        float gridSpacing, timeStep;
+        H5LTget_attribute_float(file_id, "/", "grid_spacing", &gridSpacing);
+        H5LTget_attribute_float(file_id, "/", "time_step", &timeStep);
+        BOOST_CHECK_EQUAL(gridSpacing, metadata.GridSpacing);
+        BOOST_CHECK_EQUAL(timeStep, metadata.TimeStep);
+
+        for (int d = 0; d < file->GetResultsDomainCount(); d++)
+        {
+            std::string domainLoc = "/frame/" + std::to_string(d);
+            int width = metadata.DomainMetadata[d][0];
+            int height = metadata.DomainMetadata[d][1];
+
+            hsize_t dims[3];
+            BOOST_REQUIRE(H5LTget_dataset_info(file_id, domainLoc.c_str(), dims, nullptr, nullptr) >= 0);
+            BOOST_CHECK_EQUAL(dims[0], (hsize_t) frames);
+            BOOST_CHECK_EQUAL(dims[1], (hsize_t) height);
+            BOOST_CHECK_EQUAL(dims[2], (hsize_t) width);
+
+            std::vector<float> data((size_t) frames * height * width);
+            H5LTread_dataset_float(file_id, domainLoc.c_str(), data.data());
+            bool same = true;
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                size_t f = i / (height * width);
+                same = same && data[i] == results_cell_value(d, (int) f, i % (height * width));
+            }
+            BOOST_CHECK(same);
+
+            int position[2], size[2], startFrame;
+            H5LTget_attribute_int(file_id, domainLoc.c_str(), "position", position);
+            H5LTget_attribute_int(file_id, domainLoc.c_str(), "size", size);
+            H5LTget_attribute_int(file_id, domainLoc.c_str(), "start_frame", &startFrame);
+            BOOST_CHECK_EQUAL(position[0], metadata.DomainPositions[d][0]);
+            BOOST_CHECK_EQUAL(position[1], metadata.DomainPositions[d][1]);
+            BOOST_CHECK_EQUAL(size[0], width);
+            BOOST_CHECK_EQUAL(size[1], height);
+            BOOST_CHECK_EQUAL(startFrame, 0);
+
+            //the chunks and the shuffle and deflate filters of the options
+            hid_t dataset_id = H5Dopen2(file_id, domainLoc.c_str(), H5P_DEFAULT);
+            hid_t plist_id = H5Dget_create_plist(dataset_id);
+            hsize_t chunk[3];
+            BOOST_CHECK_EQUAL(H5Pget_chunk(plist_id, 3, chunk), 3);
+            BOOST_CHECK_EQUAL(chunk[0], 2u);
+            BOOST_CHECK_EQUAL(chunk[1], (hsize_t) std::min(4, height));
+            BOOST_CHECK_EQUAL(chunk[2], (hsize_t) std::min(5, width));
+            BOOST_CHECK_EQUAL(H5Pget_nfilters(plist_id), 2);
+            H5Pclose(plist_id);
+            H5Dclose(dataset_id);
+        }
+
+        //the shorter receiver is padded with NaN
+        hsize_t receiverDims[2];
+        BOOST_REQUIRE(H5LTget_dataset_info(file_id, "/receivers", receiverDims, nullptr, nullptr) >= 0);
+        BOOST_CHECK_EQUAL(receiverDims[0], 2u);
+        BOOST_CHECK_EQUAL(receiverDims[1], 5u);
+        std::vector<float> samples(10);
+        H5LTread_dataset_float(file_id, "/receivers", samples.data());
+        for (int i = 0; i < 5; i++)
+        {
+            BOOST_CHECK_EQUAL(samples[i], i + 1);
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            BOOST_CHECK_EQUAL(samples[5 + i], i + 6);
+        }
+        BOOST_CHECK(std::isnan(samples[8]) && std::isnan(samples[9]));
+        int lengths[2];
+        H5LTget_attribute_int(file_id, "/receivers", "length", lengths);
+        BOOST_CHECK_EQUAL(lengths[0], 5);
+        BOOST_CHECK_EQUAL(lengths[1], 3);
+
+        H5Fclose(file_id);
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_frame_range)
+    {
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("hdf5-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_hdf5_results(directory / "results.pstd", 6);
+        auto metadata = file->GetResultsMetadata();
+        std::string output = (directory / "results.h5").string();
+
+        //the end frame is limited to the frames of the results, the first domain is not exported
+        HDF5 exporter;
+        exporter.SetDeflateLevel(0);
+        exporter.ExportData("application/x-hdf", file, output, {1}, 2, 10);
+
+        hid_t file_id = H5Fopen(output.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        BOOST_REQUIRE(file_id >= 0);
+        BOOST_CHECK(H5Lexists(file_id, "/frame/0", H5P_DEFAULT) <= 0);
+
+        int width = metadata.DomainMetadata[1][0];
+        int height = metadata.DomainMetadata[1][1];
+        hsize_t dims[3];
+        BOOST_REQUIRE(H5LTget_dataset_info(file_id, "/frame/1", dims, nullptr, nullptr) >= 0);
+        BOOST_CHECK_EQUAL(dims[0], 4u);
+        std::vector<float> data((size_t) 4 * height * width);
+        H5LTread_dataset_float(file_id, "/frame/1", data.data());
+        BOOST_CHECK_EQUAL(data[0], results_cell_value(1, 2, 0));
+        BOOST_CHECK_EQUAL(data.back(), results_cell_value(1, 5, height * width - 1));
+        int startFrame;
+        H5LTget_attribute_int(file_id, "/frame/1", "start_frame", &startFrame);
+        BOOST_CHECK_EQUAL(startFrame, 2);
+
+        H5Fclose(file_id);
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_large_domain)
+    {
+        const int frames = 3;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("hdf5-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        //a single domain of 400x400 cells, the default chunk of all the frames does not fit in the budget
+        std::shared_ptr<PSTDFile> file = create_results(directory / "results.pstd", frames, results_cell_value,
+                                                        [](PSTDConfiguration &conf)
+                                                        {
+                                                            conf.Domains.resize(1);
+                                                            conf.Domains[0].Size = QVector2D(80.1f, 80.1f);
+                                                        });
+        auto metadata = file->GetResultsMetadata();
+        int width = metadata.DomainMetadata[0][0];
+        int height = metadata.DomainMetadata[0][1];
+        BOOST_REQUIRE_GT((size_t) frames * width * height * sizeof(float), (size_t) HDF5_EXPORT_CHUNK_BYTES);
+        std::string output = (directory / "results.h5").string();
+
+        HDF5 exporter;
+        exporter.ExportData("application/x-hdf", file, output, {}, -1, -1);
+
+        hid_t file_id = H5Fopen(output.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        BOOST_REQUIRE(file_id >= 0);
+        hid_t dataset_id = H5Dopen2(file_id, "/frame/0", H5P_DEFAULT);
+        BOOST_REQUIRE(dataset_id >= 0);
+        hid_t plist_id = H5Dget_create_plist(dataset_id);
+        hsize_t chunk[3];
+        BOOST_REQUIRE_EQUAL(H5Pget_chunk(plist_id, 3, chunk), 3);
+        BOOST_CHECK_EQUAL(chunk[0], (hsize_t) frames);
+        BOOST_CHECK_LT(chunk[1], (hsize_t) height);
+        BOOST_CHECK_EQUAL(chunk[2], (hsize_t) width);
+        BOOST_CHECK_LE(chunk[0] * chunk[1] * chunk[2] * sizeof(float), (hsize_t) HDF5_EXPORT_CHUNK_BYTES);
+        H5Pclose(plist_id);
+        H5Dclose(dataset_id);
+
+        std::vector<float> data((size_t) frames * height * width);
+        BOOST_REQUIRE(H5LTread_dataset_float(file_id, "/frame/0", data.data()) >= 0);
+        bool same = true;
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            size_t f = i / (height * width);
+            same = same && data[i] == results_cell_value(0, (int) f, i % (height * width));
+        }
+        BOOST_CHECK(same);
+
+        H5Fclose(file_id);
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_empty_domain)
+    {
+        const int frames = 3;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("hdf5-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        //the second domain is thinner than a single cell
+        std::shared_ptr<PSTDFile> file = create_results(directory / "results.pstd", frames, results_cell_value,
+                                                        [](PSTDConfiguration &conf)
+                                                        {
+                                                            conf.Domains[1].Size = QVector2D(20, 0.1f);
+                                                        });
+        auto metadata = file->GetResultsMetadata();
+        BOOST_REQUIRE_EQUAL(metadata.DomainMetadata[1][1], 0);
+        std::string output = (directory / "results.h5").string();
+
+        HDF5 exporter;
+        exporter.ExportData("application/x-hdf", file, output, {}, -1, -1);
+
+        hid_t file_id = H5Fopen(output.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        BOOST_REQUIRE(file_id >= 0);
+        hsize_t dims[3];
+        BOOST_REQUIRE(H5LTget_dataset_info(file_id, "/frame/1", dims, nullptr, nullptr) >= 0);
+        BOOST_CHECK_EQUAL(dims[0], (hsize_t) frames);
+        BOOST_CHECK_EQUAL(dims[1], 0u);
+        BOOST_CHECK_EQUAL(dims[2], (hsize_t) metadata.DomainMetadata[1][0]);
+        int size[2];
+        H5LTget_attribute_int(file_id, "/frame/1", "size", size);
+        BOOST_CHECK_EQUAL(size[1], 0);
+
+        //the other domain is exported as usual
+        BOOST_REQUIRE(H5LTget_dataset_info(file_id, "/frame/0", dims, nullptr, nullptr) >= 0);
+        BOOST_CHECK_EQUAL(dims[0], (hsize_t) frames);
+
+        H5Fclose(file_id);
+        boost::filesystem::remove_all(directory);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the NPY and raw export
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <shared/PSTDFile.h>
+#include <shared/export/Npy.h>
+#include "ResultsFixture.h"
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+/**
+ * Reads a complete file
+ */
+std::string read_npy_file(boost::filesystem::path path)
+{
+    std::ifstream in(path.string(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/**
+ * The values of the frames of a domain as they are created by create_results
+ */
+bool check_npy_values(const std::string &data, size_t offset, int domain, int startFrame, int frames, int cells)
+{
+    if (data.size() != offset + (size_t) frames * cells * sizeof(float))
+    {
+        return false;
+    }
+    bool same = true;
+    for (size_t i = 0; i < (size_t) frames * cells; i++)
+    {
+        float value;
+        std::memcpy(&value, data.data() + offset + i * sizeof(float), sizeof(float));
+        size_t f = startFrame + i / cells;
+        same = same && value == results_cell_value(domain, (int) f, i % cells);
+    }
+    return same;
+}
+
+BOOST_AUTO_TEST_SUITE(export_npy)
+
+    BOOST_AUTO_TEST_CASE(test_npy)
+    {
+        const int frames = 5;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("npy-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_results(directory / "results.pstd", frames);
+        auto metadata = file->GetResultsMetadata();
+
+        ExportNpy exporter;
+        exporter.ExportData("application/x-npy", file, directory.string(), "results", {}, -1, -1);
+
+        boost::property_tree::ptree json;
+        boost::property_tree::read_json((directory / "results.json").string(), json);
+        BOOST_CHECK_EQUAL(json.get<std::string>("format"), "npy");
+        BOOST_CHECK_EQUAL(json.get<std::string>("order"), "C");
+        BOOST_CHECK_EQUAL(json.get<float>("grid_spacing"), metadata.GridSpacing);
+        auto domains = json.get_child("domains");
+        BOOST_REQUIRE_EQUAL(domains.size(), (size_t) file->GetResultsDomainCount());
+
+        int d = 0;
+        for (auto &entry: domains)
+        {
+            const boost::property_tree::ptree &domain = entry.second;
+            int width = metadata.DomainMetadata[d][0];
+            int height = metadata.DomainMetadata[d][1];
+            BOOST_CHECK_EQUAL(domain.get<int>("domain"), d);
+            BOOST_CHECK_EQUAL(domain.get<int>("start_frame"), 0);
+            std::vector<int> shape;
+            for (auto &value: domain.get_child("shape"))
+            {
+                shape.push_back(value.second.get_value<int>());
+            }
+            BOOST_REQUIRE_EQUAL(shape.size(), 3u);
+            BOOST_CHECK_EQUAL(shape[0], frames);
+            BOOST_CHECK_EQUAL(shape[1], height);
+            BOOST_CHECK_EQUAL(shape[2], width);
+
+            std::string data = read_npy_file(directory / domain.get<std::string>("file"));
+            BOOST_REQUIRE(data.size() > 10);
+            BOOST_CHECK_EQUAL(data.substr(0, 8), std::string("\x93NUMPY\x01\x00", 8));
+
+            //the header length is little endian, the data starts after the header and is aligned on 64 bytes
+            size_t headerLength = (unsigned char) data[8] | ((unsigned char) data[9] << 8);
+            size_t offset = 10 + headerLength;
+            BOOST_CHECK_EQUAL(offset % 64, 0u);
+            BOOST_CHECK_EQUAL(domain.get<size_t>("offset"), offset);
+            std::string header = data.substr(10, headerLength);
+            BOOST_CHECK_EQUAL(header.back(), '\n');
+            BOOST_CHECK(header.find("'descr': '" + json.get<std::string>("dtype") + "'") != std::string::npos);
+            BOOST_CHECK(header.find("'fortran_order': False") != std::string::npos);
+            std::string shapeText = "'shape': (" + std::to_string(frames) + ", " + std::to_string(height) + ", " +
+                                    std::to_string(width) + ")";
+            BOOST_CHECK(header.find(shapeText) != std::string::npos);
+
+            BOOST_CHECK(check_npy_values(data, offset, d, 0, frames, width * height));
+            d++;
+        }
+
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_raw_frame_range)
+    {
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("npy-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_results(directory / "results.pstd", 6);
+        auto metadata = file->GetResultsMetadata();
+
+        //the end frame is limited to the frames of the results, the first domain is not exported
+        ExportNpy exporter;
+        exporter.ExportData("application/octet-stream", file, directory.string(), "results", {1}, 2, 10);
+        BOOST_CHECK(!boost::filesystem::exists(directory / "results-0.raw"));
+
+        boost::property_tree::ptree json;
+        boost::property_tree::read_json((directory / "results.json").string(), json);
+        BOOST_CHECK_EQUAL(json.get<std::string>("format"), "raw");
+        auto domains = json.get_child("domains");
+        BOOST_REQUIRE_EQUAL(domains.size(), 1u);
+        const boost::property_tree::ptree &domain = domains.begin()->second;
+        BOOST_CHECK_EQUAL(domain.get<int>("domain"), 1);
+        BOOST_CHECK_EQUAL(domain.get<std::string>("file"), "results-1.raw");
+        BOOST_CHECK_EQUAL(domain.get<size_t>("offset"), 0u);
+        BOOST_CHECK_EQUAL(domain.get<int>("start_frame"), 2);
+        BOOST_CHECK_EQUAL(domain.get_child("shape").begin()->second.get_value<int>(), 4);
+
+        int cells = metadata.DomainMetadata[1][0] * metadata.DomainMetadata[1][1];
+        BOOST_CHECK(check_npy_values(read_npy_file(directory / "results-1.raw"), 0, 1, 2, 4, cells));
+
+        boost::filesystem::remove_all(directory);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
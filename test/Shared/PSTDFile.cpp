@@ -0,0 +1,376 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the storage of the results in the PSTD file
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+#include <kernel/core/Profiler.h>
+#include <kernel/core/Layout.h>
+#include <kernel/PSTDKernel.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+/**
+ * Writes a record with a key of version 3 files(the prefix and the values, without a run)
+ */
+void store_version3_record(unqlite *db, std::vector<unsigned int> key, const void *data, unqlite_int64 size)
+{
+    BOOST_REQUIRE_EQUAL(unqlite_kv_store(db, key.data(), key.size() * sizeof(unsigned int), data, size), UNQLITE_OK);
+}
+
+/**
+ * A frame with the size of the first domain of the results that starts with the values, the other cells are 0
+ */
+PSTD_FRAME create_domain_frame(std::shared_ptr<PSTDFile> file, PSTD_FRAME values)
+{
+    std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+    PSTD_FRAME frame(size[0] * size[1], 0.0f);
+    std::copy(values.begin(), values.end(), frame.begin());
+    return frame;
+}
+
+BOOST_AUTO_TEST_SUITE(pstd_file)
+
+    BOOST_AUTO_TEST_CASE(test_delete_and_compact)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("compact-%%%%%%%%.pstd");
+        unsigned long cells;
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+            cells = size[0] * size[1];
+            for(int f = 0; f < 20; f++)
+            {
+                file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(cells, (float)f));
+            }
+            file->Commit();
+
+            file->DeleteResults();
+            file->InitializeResults();
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 0);
+
+            file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(cells, 42.0f));
+            file->Commit();
+        }
+
+        uintmax_t before = boost::filesystem::file_size(path);
+        PSTDFile::Compact(path);
+        uintmax_t after = boost::filesystem::file_size(path);
+        BOOST_CHECK(after < before);
+
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 1);
+            BOOST_CHECK_EQUAL(file->GetResultsFrame(0, 0)->at(cells - 1), 42.0f);
+            BOOST_CHECK(file->GetSceneConf()->Domains.size() > 0);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_lossless_frame_storage)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("lossless-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            auto conf = file->GetSceneConf();
+            conf->Settings.SetFrameStorage(FRAMESTORAGE::LOSSLESS);
+            file->SetSceneConf(conf);
+            file->InitializeResults();
+
+            auto frame = std::make_shared<PSTD_FRAME>(create_domain_frame(file, {0, 0, 0.5f, -1.25f}));
+            //the compressed size is reported, not the size of the frame
+            unsigned long long bytes = file->SaveNextResultsFrame(0, frame);
+            BOOST_CHECK_GT(bytes, 0u);
+            BOOST_CHECK_LT(bytes, frame->size() * sizeof(PSTD_FRAME_UNIT));
+            file->Commit();
+        }
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_CHECK(file->GetResultsSceneConf()->Settings.GetFrameStorage() == FRAMESTORAGE::LOSSLESS);
+            BOOST_CHECK(*file->GetResultsFrame(0, 0) == create_domain_frame(file, {0, 0, 0.5f, -1.25f}));
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_results_metadata)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("metadata-%%%%%%%%.pstd");
+        SimulationMetadata expected;
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            expected = file->GetResultsMetadata();
+            BOOST_REQUIRE(expected.DomainMetadata.size() > 0);
+            BOOST_CHECK_EQUAL(expected.DomainPositions.size(), expected.DomainMetadata.size());
+            BOOST_CHECK_EQUAL(expected.GridSpacing, file->GetSceneConf()->Settings.GetGridSpacing());
+            BOOST_CHECK_EQUAL(expected.TimeStep, file->GetSceneConf()->Settings.GetTimeStep());
+
+            //the metadata belongs to the results, not to the scene that is edited after the run
+            auto conf = file->GetSceneConf();
+            conf->Settings.SetGridSpacing(expected.GridSpacing * 2);
+            file->SetSceneConf(conf);
+            file->Commit();
+        }
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            SimulationMetadata metadata = file->GetResultsMetadata();
+            BOOST_CHECK(metadata.DomainMetadata == expected.DomainMetadata);
+            BOOST_CHECK(metadata.DomainPositions == expected.DomainPositions);
+            BOOST_CHECK_EQUAL(metadata.Framecount, expected.Framecount);
+            BOOST_CHECK_EQUAL(metadata.GridSpacing, expected.GridSpacing);
+            BOOST_CHECK(file->GetResultsSnapshot()->GetResultsMetadata().DomainMetadata == expected.DomainMetadata);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_metadata_of_truncated_domain)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("truncated-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            //9.4 / 0.2 is just below 47 cells, the kernel truncates it to 46 cells
+            auto conf = file->GetSceneConf();
+            conf->Domains[0].Size = QVector2D(9.4f, 15);
+            file->SetSceneConf(conf);
+            file->InitializeResults();
+
+            PSTDKernel kernel;
+            kernel.initialize_kernel(file->GetResultsSceneConf());
+            SimulationMetadata metadata = file->GetResultsMetadata();
+            SimulationMetadata kernelMetadata = kernel.get_metadata();
+            for (unsigned long d = 0; d < conf->Domains.size(); d++)
+            {
+                BOOST_CHECK_EQUAL(metadata.DomainMetadata[d][0], kernelMetadata.DomainMetadata[d][0]);
+                BOOST_CHECK_EQUAL(metadata.DomainMetadata[d][1], kernelMetadata.DomainMetadata[d][1]);
+            }
+            BOOST_CHECK_EQUAL(metadata.DomainMetadata[0][0], 46);
+
+            //a frame that does not have the size of the metadata is not written
+            int height = metadata.DomainMetadata[0][1];
+            BOOST_CHECK_THROW(file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(47 * height)),
+                              std::invalid_argument);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 0);
+            file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(46 * height));
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 1);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_read_results_frame_data)
+    {
+        for (FRAMESTORAGE storage : {FRAMESTORAGE::RAW, FRAMESTORAGE::LOSSLESS})
+        {
+            PSTD_FRAME expected;
+            boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                           boost::filesystem::unique_path("framedata-%%%%%%%%.pstd");
+            {
+                std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+                auto conf = file->GetSceneConf();
+                conf->Settings.SetFrameStorage(storage);
+                file->SetSceneConf(conf);
+                file->InitializeResults();
+
+                expected = create_domain_frame(file, {0, 0, 0.5f, -1.25f});
+                file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(expected));
+                file->Commit();
+            }
+            {
+                std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+                std::vector<char> bytes;
+                file->ReadResultsFrameData(0, 0, [&bytes](const char *data, size_t length)
+                {
+                    bytes.insert(bytes.end(), data, data + length);
+                });
+                BOOST_REQUIRE_EQUAL(bytes.size(), expected.size() * sizeof(PSTD_FRAME_UNIT));
+                BOOST_CHECK(std::memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+            }
+            boost::filesystem::remove(path);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_results_profile)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("profile-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            BOOST_CHECK(!file->GetResultsProfile());
+
+            Profiler profiler(2);
+            profiler.start_frame();
+            profiler.add(PROFILEPHASE::FFT, 0, 0.25);
+            profiler.add(PROFILEPHASE::WRITE_FRAME, 1, 0.5);
+            file->SaveResultsProfile(profiler.get_profile());
+            file->Commit();
+        }
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            auto profile = file->GetResultsProfile();
+            BOOST_REQUIRE(profile);
+            BOOST_CHECK_EQUAL(profile->DomainSeconds.size(), 2);
+            BOOST_CHECK_EQUAL(profile->FrameSeconds.size(), 1);
+            BOOST_CHECK_CLOSE(profile->GetPhaseSeconds(PROFILEPHASE::FFT), 0.25, 1e-6);
+            BOOST_CHECK_CLOSE(profile->GetDomainSeconds(1), 0.5, 1e-6);
+
+            //the profile belongs to the run
+            file->DeleteResults();
+            BOOST_CHECK(!file->GetResultsProfile());
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_truncate_results)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("truncate-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            auto conf = file->GetSceneConf();
+            conf->Settings.SetSaveNth(2);
+            file->SetSceneConf(conf);
+            file->InitializeResults();
+            BOOST_REQUIRE_EQUAL(file->GetResultsReceiverCount(), 1);
+
+            for(int f = 0; f < 5; f++)
+            {
+                for(unsigned int d = 0; d < conf->Domains.size(); d++)
+                {
+                    std::vector<int> size = file->GetResultsFrameLevelSize(d, 0);
+                    file->SaveNextResultsFrame(d, std::make_shared<PSTD_FRAME>(size[0] * size[1], (float)f));
+                }
+                file->SaveReceiverData(0, std::make_shared<PSTD_RECEIVER_DATA>(1, (float)f));
+            }
+            file->Commit();
+
+            //7 simulated frames are saved as the frames 0, 2, 4 and 6
+            file->TruncateResults(7);
+            BOOST_CHECK_THROW(file->TruncateResults(20), std::runtime_error);
+            file->Commit();
+        }
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 4);
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsFrameCount(1), 4);
+            BOOST_CHECK_EQUAL(file->GetResultsStatistics(0).Max, 3.0f);
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+            BOOST_CHECK_EQUAL(file->GetResultsStatistics(0).Count, 4 * size[0] * size[1]);
+            BOOST_REQUIRE_EQUAL(file->GetReceiverSampleCount(0), 4);
+            BOOST_CHECK_EQUAL(file->GetReceiverData(0)->back(), 3.0f);
+
+            file->SaveNextResultsFrame(0, std::make_shared<PSTD_FRAME>(size[0] * size[1], 8.0f));
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 5);
+            BOOST_CHECK_EQUAL(file->GetResultsFrame(4, 0)->at(0), 8.0f);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_upgrade_from_version3)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("version3-%%%%%%%%.pstd");
+        unsigned long cells;
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            auto conf = file->GetSceneConf();
+            Point size = discretize_domain(conf->Domains[0], conf->Settings.GetGridSpacing()).second;
+            cells = (unsigned long) size.x * size.y;
+        }
+
+        //rewrite the file as a version 3 file with results of the scene: 3 frames of domain 0 and receiver data
+        {
+            unqlite *db;
+            BOOST_REQUIRE_EQUAL(unqlite_open(&db, path.string().c_str(), UNQLITE_OPEN_CREATE), UNQLITE_OK);
+
+            std::vector<unsigned int> sceneKey = {1};
+            unqlite_int64 sceneSize = 0;
+            BOOST_REQUIRE_EQUAL(unqlite_kv_fetch(db, sceneKey.data(), sizeof(unsigned int), NULL, &sceneSize),
+                                UNQLITE_OK);
+            std::vector<char> scene(sceneSize);
+            unqlite_kv_fetch(db, sceneKey.data(), sizeof(unsigned int), scene.data(), &sceneSize);
+            store_version3_record(db, {100}, scene.data(), sceneSize);
+
+            std::vector<unsigned int> runKey = {10001};
+            unqlite_kv_delete(db, runKey.data(), sizeof(unsigned int));
+            int version = 3;
+            store_version3_record(db, {10000}, &version, sizeof(int));
+
+            int frameCount = 3;
+            store_version3_record(db, {102, 0}, &frameCount, sizeof(int));
+            for (unsigned int f = 0; f < frameCount; f++)
+            {
+                std::vector<float> frame(cells, (float) f + 0.5f);
+                store_version3_record(db, {103, 0, f}, frame.data(), frame.size() * sizeof(float));
+            }
+            std::vector<float> samples = {1, -2, 3};
+            store_version3_record(db, {104, 0}, samples.data(), samples.size() * sizeof(float));
+
+            BOOST_REQUIRE_EQUAL(unqlite_close(db), UNQLITE_OK);
+        }
+
+        //opening does not change the file, the results are moved by an explicit upgrade
+        BOOST_CHECK_THROW(PSTDFile::Open(path), PSTDFileVersionException);
+        BOOST_CHECK_THROW(PSTDFile::Open(path), PSTDFileVersionException);
+        BOOST_CHECK(PSTDFile::Upgrade(path));
+        BOOST_CHECK(!PSTDFile::Upgrade(path));
+
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_REQUIRE_EQUAL(file->GetResultsDomainCount(), file->GetSceneConf()->Domains.size());
+            BOOST_REQUIRE_EQUAL(file->GetResultsFrameCount(0), 3);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(1), 0);
+            for (unsigned int f = 0; f < 3; f++)
+            {
+                BOOST_CHECK(*file->GetResultsFrame(f, 0) == PSTD_FRAME(cells, (float) f + 0.5f));
+            }
+            BOOST_CHECK_EQUAL(file->GetResultsStatistics(0).Max, 2.5f);
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsFrameCount(0), 3);
+            BOOST_CHECK(*file->GetReceiverData(0) == (PSTD_RECEIVER_DATA{1, -2, 3}));
+        }
+
+        //the upgraded records are used by compact
+        PSTDFile::Compact(path);
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::Open(path);
+            BOOST_CHECK_EQUAL(file->GetResultsFrameCount(0), 3);
+            BOOST_CHECK_EQUAL(file->GetResultsFrame(2, 0)->at(cells - 1), 2.5f);
+            BOOST_CHECK_EQUAL(file->GetReceiverData(0)->size(), 3);
+        }
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the resampling of the receiver data
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <shared/Resampler.h>
+#include <cmath>
+
+using namespace OpenPSTD::Shared;
+
+BOOST_AUTO_TEST_SUITE(resampler)
+
+    static std::vector<float> Sine(double frequency, double rate, size_t count)
+    {
+        std::vector<float> result(count);
+        for (size_t i = 0; i < count; i++)
+            result[i] = (float)std::sin(2 * M_PI * frequency * i / rate);
+        return result;
+    }
+
+    BOOST_AUTO_TEST_CASE(test_downsample_sine)
+    {
+        //a 1 kHz sine at a simulation rate to 44.1 kHz
+        double inputRate = 1 / 1.7e-5;
+        std::vector<float> input = Sine(1000, inputRate, 20000);
+
+        Resampler resampler(inputRate, 44100);
+        std::vector<float> output;
+        resampler.Process(input.data(), input.size(), output);
+        resampler.Flush(output);
+
+        BOOST_CHECK_EQUAL(output.size(), resampler.GetOutputLength(input.size()));
+        std::vector<float> expected = Sine(1000, 44100, output.size());
+        //skip the edges, where the input is assumed to be 0
+        for (size_t i = 100; i < output.size() - 100; i++)
+            BOOST_CHECK_SMALL(output[i] - expected[i], 1e-3f);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_removes_aliases)
+    {
+        //a 30 kHz sine can not be represented at 48 kHz and is filtered out
+        double inputRate = 192000;
+        std::vector<float> input = Sine(30000, inputRate, 20000);
+
+        Resampler resampler(inputRate, 48000);
+        std::vector<float> output;
+        resampler.Process(input.data(), input.size(), output);
+        resampler.Flush(output);
+
+        for (size_t i = 100; i < output.size() - 100; i++)
+            BOOST_CHECK_SMALL(output[i], 1e-2f);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_streaming)
+    {
+        std::vector<float> input = Sine(440, 8000, 5000);
+
+        Resampler whole(8000, 48000);
+        std::vector<float> expected;
+        whole.Process(input.data(), input.size(), expected);
+        whole.Flush(expected);
+
+        //blocks of a different size give the same output
+        Resampler blocks(8000, 48000);
+        std::vector<float> output;
+        for (size_t i = 0; i < input.size(); i += 7)
+            blocks.Process(input.data() + i, std::min<size_t>(7, input.size() - i), output);
+        blocks.Flush(output);
+
+        BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+        BOOST_CHECK_EQUAL(output.size(), 30000);
+        for (size_t i = 0; i < output.size(); i++)
+            BOOST_CHECK_EQUAL(output[i], expected[i]);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
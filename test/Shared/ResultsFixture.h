@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Results files with known frames for the test suites of the exports
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef OPENPSTD_TEST_RESULTSFIXTURE_H
+#define OPENPSTD_TEST_RESULTSFIXTURE_H
+
+#include <boost/filesystem.hpp>
+#include <functional>
+#include <memory>
+#include <shared/PSTDFile.h>
+
+/**
+ * The value of a cell of a frame of a domain, every cell of every frame has its own value
+ */
+inline float results_cell_value(int domain, int frame, size_t cell)
+{
+    return domain * 100000 + frame * 1000 + cell;
+}
+
+/**
+ * Creates a results file with the given number of frames for every domain of the default scene
+ * @param value: the value of a cell of a frame of a domain
+ * @param setup: changes the scene before the results are initialized(e.g. to add receivers)
+ */
+inline std::shared_ptr<OpenPSTD::Shared::PSTDFile> create_results(
+        boost::filesystem::path path, int frames,
+        std::function<float(int, int, size_t)> value = results_cell_value,
+        std::function<void(OpenPSTD::Kernel::PSTDConfiguration &)> setup = nullptr)
+{
+    std::shared_ptr<OpenPSTD::Shared::PSTDFile> file = OpenPSTD::Shared::PSTDFile::New(path);
+    if (setup)
+    {
+        auto conf = file->GetSceneConf();
+        setup(*conf);
+        file->SetSceneConf(conf);
+    }
+    file->InitializeResults();
+    for (int f = 0; f < frames; f++)
+    {
+        for (int d = 0; d < file->GetResultsDomainCount(); d++)
+        {
+            std::vector<int> size = file->GetResultsFrameLevelSize(d, 0);
+            auto frame = std::make_shared<OpenPSTD::Kernel::PSTD_FRAME>(size[0] * size[1]);
+            for (size_t i = 0; i < frame->size(); i++)
+            {
+                (*frame)[i] = value(d, f, i);
+            }
+            file->SaveNextResultsFrame(d, frame);
+        }
+    }
+    file->Commit();
+    return file;
+}
+
+#endif //OPENPSTD_TEST_RESULTSFIXTURE_H
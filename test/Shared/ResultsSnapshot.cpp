@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the snapshot reads of the results
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(results_snapshot)
+
+    BOOST_AUTO_TEST_CASE(test_watermark)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("snapshot-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            BOOST_REQUIRE(file->GetResultsDomainCount() > 0);
+
+            auto before = file->GetResultsSnapshot();
+            BOOST_CHECK_EQUAL(before->GetResultsFrameCount(0), 0);
+
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+            PSTD_FRAME_PTR written = std::make_shared<PSTD_FRAME>(size[0] * size[1], 0.0f);
+            (*written)[2] = 3;
+            file->SaveNextResultsFrame(0, written);
+
+            //not yet published
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsFrameCount(0), 0);
+            BOOST_CHECK(!file->GetSnapshotFrame(*before, 0, 0));
+
+            file->Commit();
+            auto after = file->GetResultsSnapshot();
+            BOOST_CHECK_EQUAL(after->GetResultsFrameCount(0), 1);
+
+            auto frame = file->GetSnapshotFrame(*after, 0, 0);
+            BOOST_REQUIRE(frame);
+            BOOST_CHECK_EQUAL(frame->size(), written->size());
+            BOOST_CHECK_EQUAL((*frame)[2], 3);
+
+            //deleting the results makes the old snapshot outdated
+            file->DeleteResults();
+            file->SetFrameCacheSize(0);
+            BOOST_CHECK(!file->GetSnapshotFrame(*after, 0, 0));
+            BOOST_CHECK_EQUAL(file->GetResultsSnapshot()->GetResultsDomainCount(), 0);
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_frame_cache_eviction)
+    {
+        ResultsFrameCache cache(2 * 4 * sizeof(PSTD_FRAME_UNIT));
+        cache.Put(0, 0, 0, std::make_shared<const PSTD_FRAME>(4, 0.0f));
+        cache.Put(0, 1, 0, std::make_shared<const PSTD_FRAME>(4, 1.0f));
+        //use frame 0, so frame 1 is the least recently used
+        BOOST_CHECK(cache.Get(0, 0, 0));
+        cache.Put(0, 2, 0, std::make_shared<const PSTD_FRAME>(4, 2.0f));
+
+        BOOST_CHECK(cache.Get(0, 0, 0));
+        BOOST_CHECK(!cache.Get(0, 1, 0));
+        BOOST_CHECK(cache.Get(0, 2, 0));
+        BOOST_CHECK(!cache.Get(1, 2, 0));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
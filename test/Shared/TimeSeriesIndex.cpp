@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the time-major index of the results
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <shared/PSTDFile.h>
+#include <shared/TimeSeriesIndex.h>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+BOOST_AUTO_TEST_SUITE(time_series_index)
+
+    BOOST_AUTO_TEST_CASE(test_layout)
+    {
+        TimeSeriesLayout layout;
+        layout.TileSize = 8;
+        layout.BlockFrames = 4;
+        layout.Width = 20;
+        layout.Height = 9;
+        layout.Frames = 10;
+
+        BOOST_CHECK_EQUAL(layout.GetTilesX(), 3);
+        BOOST_CHECK_EQUAL(layout.GetTilesY(), 2);
+        BOOST_CHECK_EQUAL(layout.GetBlockCount(), 3);
+        BOOST_CHECK_EQUAL(layout.GetBlockLength(0), 4);
+        BOOST_CHECK_EQUAL(layout.GetBlockLength(2), 2);
+        BOOST_CHECK_EQUAL(layout.GetTileWidth(2), 4);
+        BOOST_CHECK_EQUAL(layout.GetTileHeight(1), 1);
+        //cell (1, 1) of the last tile, which is 4 cells wide
+        BOOST_CHECK_EQUAL(layout.GetCellOffset(17, 9, 2), (1 * 4 + 1) * 2);
+
+        std::vector<char> encoded = layout.Encode();
+        TimeSeriesLayout decoded = TimeSeriesLayout::Decode(encoded.data(), encoded.size());
+        BOOST_CHECK(decoded.IsCompatible(layout));
+        BOOST_CHECK_EQUAL(decoded.Frames, 10);
+        BOOST_CHECK(TimeSeriesLayout::Decode(encoded.data(), 3).IsEmpty());
+    }
+
+    BOOST_AUTO_TEST_CASE(test_time_series)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("timeseries-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+
+            auto write = [&](int frames)
+            {
+                for (int f = 0; f < frames; f++)
+                {
+                    int frame = file->GetResultsFrameCount(0);
+                    PSTD_FRAME_PTR data = std::make_shared<PSTD_FRAME>(size[0] * size[1]);
+                    for (int i = 0; i < data->size(); i++)
+                        (*data)[i] = i * 0.5f + frame;
+                    file->SaveNextResultsFrame(0, data);
+                }
+            };
+            auto check = [&](int x, int y, int frames)
+            {
+                PSTD_RECEIVER_DATA_PTR values = file->GetResultsTimeSeries(0, x, y);
+                BOOST_REQUIRE_EQUAL(values->size(), frames);
+                for (int f = 0; f < frames; f++)
+                    BOOST_CHECK_EQUAL((*values)[f], (y * size[0] + x) * 0.5f + f);
+            };
+
+            write(10);
+            //without an index the frames are read one by one
+            check(3, 2, 10);
+
+            file->BuildTimeSeriesIndex(8, 4);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 10);
+            check(0, 0, 10);
+            check(size[0] - 1, size[1] - 1, 10);
+
+            //the frames after the index are read from the frames, until the index is extended
+            write(5);
+            check(size[0] - 1, 1, 15);
+            file->BuildTimeSeriesIndex(8, 4);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 15);
+            check(size[0] / 2, size[1] - 1, 15);
+
+            BOOST_CHECK_THROW(file->GetResultsTimeSeries(0, size[0], 0), std::out_of_range);
+
+            file->DeleteResults();
+            file->InitializeResults();
+            BOOST_CHECK(file->GetTimeSeriesLayout(0).IsEmpty());
+        }
+        boost::filesystem::remove(path);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_interrupted_extension)
+    {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                       boost::filesystem::unique_path("timeseries-%%%%%%%%.pstd");
+        {
+            std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+            file->InitializeResults();
+            std::vector<int> size = file->GetResultsFrameLevelSize(0, 0);
+
+            auto write = [&](int frames, float offset)
+            {
+                for (int f = 0; f < frames; f++)
+                {
+                    int frame = file->GetResultsFrameCount(0);
+                    PSTD_FRAME_PTR data = std::make_shared<PSTD_FRAME>(size[0] * size[1]);
+                    for (int i = 0; i < data->size(); i++)
+                        (*data)[i] = i * 0.5f + frame + offset;
+                    file->SaveNextResultsFrame(0, data);
+
+                    //the other domain and the receiver are only written for the truncation of the results
+                    std::vector<int> otherSize = file->GetResultsFrameLevelSize(1, 0);
+                    file->SaveNextResultsFrame(1, std::make_shared<PSTD_FRAME>(otherSize[0] * otherSize[1]));
+                    file->SaveReceiverData(0, std::make_shared<PSTD_RECEIVER_DATA>(1));
+                }
+            };
+            //all the cells are checked, a corrupted tile of the index is found as well
+            auto check = [&](int frames, int rewritten, float offset)
+            {
+                for (int y = 0; y < size[1]; y++)
+                {
+                    for (int x = 0; x < size[0]; x++)
+                    {
+                        PSTD_RECEIVER_DATA_PTR values = file->GetResultsTimeSeries(0, x, y);
+                        BOOST_REQUIRE_EQUAL(values->size(), frames);
+                        for (int f = 0; f < frames; f++)
+                            BOOST_REQUIRE_EQUAL((*values)[f], (y * size[0] + x) * 0.5f + f +
+                                                              (f >= rewritten ? offset : 0));
+                    }
+                }
+            };
+            //cancels the build after the first block is written, like the long operation does
+            auto cancel = [](float) { throw std::runtime_error("cancelled"); };
+
+            //the blocks have 4 frames, the incomplete last block of 2 frames is written again with 4 frames
+            write(10, 0);
+            file->BuildTimeSeriesIndex(8, 4);
+            write(5, 0);
+            BOOST_CHECK_THROW(file->BuildTimeSeriesIndex(8, 4, cancel), std::runtime_error);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 10);
+            check(15, 15, 0);
+
+            file->BuildTimeSeriesIndex(8, 4);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 15);
+            check(15, 15, 0);
+
+            //an interrupted build with other tiles keeps the existing index
+            BOOST_CHECK_THROW(file->BuildTimeSeriesIndex(4, 4, cancel), std::runtime_error);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).TileSize, 8);
+            check(15, 15, 0);
+
+            //frames that are removed and written again(a resumed simulation) are not read from the index, only the
+            //complete blocks before the removed frames are kept
+            file->TruncateResults(9);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 8);
+            write(6, 100);
+            check(15, 9, 100);
+            file->BuildTimeSeriesIndex(8, 4);
+            BOOST_CHECK_EQUAL(file->GetTimeSeriesLayout(0).Frames, 15);
+            check(15, 9, 100);
+        }
+        boost::filesystem::remove(path);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the patches of the vendored unqlite(see
+//      unqlite/unqlite.cmake)
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <unqlite.h>
+#include <map>
+#include <random>
+#include <string>
+
+/**
+ * Stores and deletes random records of up to 1.5 KB in a new database, and commits after every commitInterval
+ * operations. After every commit all records are read back.
+ * @return the number of records that are missing or have other data
+ */
+int run_unqlite_workload(unsigned int seed, unsigned int keys, int commitInterval, int commits)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                   boost::filesystem::unique_path("unqlite-%%%%%%%%.db");
+    unqlite *db;
+    BOOST_REQUIRE_EQUAL(unqlite_open(&db, path.string().c_str(), UNQLITE_OPEN_CREATE), UNQLITE_OK);
+
+    std::map<std::string, std::string> expected;
+    std::mt19937 generator(seed);
+    int errors = 0;
+    for (int c = 0; c < commits && errors == 0; c++)
+    {
+        for (int i = 0; i < commitInterval; i++)
+        {
+            std::string key = "k" + std::to_string(generator() % keys);
+            if (generator() % 3 == 0)
+            {
+                unqlite_kv_delete(db, key.c_str(), -1);
+                expected.erase(key);
+            }
+            else
+            {
+                std::string value(20 + generator() % 1500, (char) ('a' + generator() % 26));
+                BOOST_REQUIRE_EQUAL(unqlite_kv_store(db, key.c_str(), -1, value.data(), value.size()), UNQLITE_OK);
+                expected[key] = value;
+            }
+        }
+        BOOST_REQUIRE_EQUAL(unqlite_commit(db), UNQLITE_OK);
+
+        for (auto &record: expected)
+        {
+            unqlite_int64 size = 0;
+            if (unqlite_kv_fetch(db, record.first.c_str(), -1, NULL, &size) != UNQLITE_OK ||
+                size != (unqlite_int64) record.second.size())
+            {
+                errors++;
+                continue;
+            }
+            std::string value(size, 0);
+            unqlite_kv_fetch(db, record.first.c_str(), -1, &value[0], &size);
+            if (value != record.second)
+            {
+                errors++;
+            }
+        }
+    }
+
+    unqlite_close(db);
+    boost::filesystem::remove(path);
+    return errors;
+}
+
+BOOST_AUTO_TEST_SUITE(unqlite_store)
+
+    BOOST_AUTO_TEST_CASE(test_defragment_slave_pages)
+    {
+        //with frequent commits the pages are defragmented often, without lhPageDefragment walking the cell list of
+        //the master page this loses records on slave pages for seeds 1 and 7
+        for (unsigned int seed = 1; seed <= 8; seed++)
+        {
+            BOOST_CHECK_EQUAL(run_unqlite_workload(seed, 200, 100, 40), 0);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(test_hot_dirty_pages)
+    {
+        //with many changes per commit the pager writes hot dirty pages while they are still referenced, when these
+        //are released the records of seven of the eight seeds are lost
+        for (unsigned int seed = 1; seed <= 8; seed++)
+        {
+            BOOST_CHECK_EQUAL(run_unqlite_workload(seed, 400, 500, 40), 0);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,251 @@
+//////////////////////////////////////////////////////////////////////////
+// This file is part of openPSTD.                                       //
+//                                                                      //
+// openPSTD is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU General Public License as published by //
+// the Free Software Foundation, either version 3 of the License, or    //
+// (at your option) any later version.                                  //
+//                                                                      //
+// openPSTD is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with openPSTD.  If not, see <http://www.gnu.org/licenses/>.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//
+// Purpose: Test suite for the WAV export of the receivers
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <shared/PSTDFile.h>
+#include <shared/export/Wav.h>
+
+using namespace OpenPSTD::Shared;
+using namespace OpenPSTD::Kernel;
+
+/**
+ * Creates a results file with two receivers with a constant value, the second receiver has half the samples
+ */
+std::shared_ptr<PSTDFile> create_wav_results(boost::filesystem::path path, int samples, float first, float second)
+{
+    std::shared_ptr<PSTDFile> file = PSTDFile::New(path);
+    auto conf = file->GetSceneConf();
+    conf->Receivers.clear();
+    conf->Receivers.push_back(QVector3D(6, 5, 0));
+    conf->Receivers.push_back(QVector3D(7, 5, 0));
+    file->SetSceneConf(conf);
+    file->InitializeResults();
+    file->SaveReceiverData(0, std::make_shared<PSTD_RECEIVER_DATA>(samples, first));
+    file->SaveReceiverData(1, std::make_shared<PSTD_RECEIVER_DATA>(samples / 2, second));
+    file->Commit();
+    return file;
+}
+
+/**
+ * The sample rate of the receivers, the WAV file is written at this rate so that the length does not change
+ */
+int receiver_rate(std::shared_ptr<PSTDFile> file)
+{
+    return (int) std::lround(1.0 / (file->GetResultsMetadata().TimeStep *
+                                    file->GetResultsSceneConf()->Settings.GetSaveNth()));
+}
+
+/**
+ * A WAV file with the fields of the header and the samples converted to floats
+ */
+struct WavFile
+{
+    std::string data;
+    uint32_t riffSize;
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t byteRate;
+    uint16_t blockAlign;
+    uint16_t bitsPerSample;
+    uint32_t factFrames = 0;
+    uint32_t dataSize;
+    std::vector<float> samples;
+
+    uint32_t Read(size_t offset, int bytes) const
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; i++)
+        {
+            value |= (uint32_t) (unsigned char) data[offset + i] << (8 * i);
+        }
+        return value;
+    }
+
+    float Sample(size_t frame, size_t channel) const
+    {
+        return samples[frame * channels + channel];
+    }
+
+    size_t Frames() const
+    {
+        return samples.size() / channels;
+    }
+};
+
+WavFile read_wav_file(boost::filesystem::path path)
+{
+    WavFile wav;
+    std::ifstream in(path.string(), std::ios::binary);
+    wav.data = std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    BOOST_REQUIRE(wav.data.size() >= 44);
+    BOOST_REQUIRE_EQUAL(wav.data.substr(0, 4), "RIFF");
+    BOOST_REQUIRE_EQUAL(wav.data.substr(8, 4), "WAVE");
+    BOOST_REQUIRE_EQUAL(wav.data.substr(12, 4), "fmt ");
+    BOOST_REQUIRE_EQUAL(wav.Read(16, 4), 16u);
+
+    wav.riffSize = wav.Read(4, 4);
+    wav.format = (uint16_t) wav.Read(20, 2);
+    wav.channels = (uint16_t) wav.Read(22, 2);
+    wav.sampleRate = wav.Read(24, 4);
+    wav.byteRate = wav.Read(28, 4);
+    wav.blockAlign = (uint16_t) wav.Read(32, 2);
+    wav.bitsPerSample = (uint16_t) wav.Read(34, 2);
+
+    size_t offset = 36;
+    if (wav.data.substr(offset, 4) == "fact")
+    {
+        BOOST_REQUIRE_EQUAL(wav.Read(offset + 4, 4), 4u);
+        wav.factFrames = wav.Read(offset + 8, 4);
+        offset += 12;
+    }
+    BOOST_REQUIRE_EQUAL(wav.data.substr(offset, 4), "data");
+    wav.dataSize = wav.Read(offset + 4, 4);
+    offset += 8;
+    BOOST_REQUIRE_EQUAL(wav.data.size(), offset + wav.dataSize);
+
+    for (size_t i = offset; i < wav.data.size(); i += wav.bitsPerSample / 8)
+    {
+        if (wav.format == 3)
+        {
+            float value;
+            std::memcpy(&value, wav.data.data() + i, sizeof(float));
+            wav.samples.push_back(value);
+        }
+        else
+        {
+            wav.samples.push_back((int16_t) wav.Read(i, 2) / 32767.0f);
+        }
+    }
+    return wav;
+}
+
+BOOST_AUTO_TEST_SUITE(export_wav)
+
+    BOOST_AUTO_TEST_CASE(test_float_samples)
+    {
+        const int samples = 2000;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("wav-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_wav_results(directory / "results.pstd", samples, 0.5f, -0.25f);
+        int rate = receiver_rate(file);
+
+        ExportWav exporter;
+        exporter.SetSampleRate(rate);
+        exporter.SetFloatSamples(true);
+        exporter.ExportData("audio/wav", file, (directory / "receivers.wav").string(), {});
+
+        WavFile wav = read_wav_file(directory / "receivers.wav");
+        BOOST_CHECK_EQUAL(wav.riffSize, wav.data.size() - 8);
+        BOOST_CHECK_EQUAL(wav.format, 3);
+        BOOST_CHECK_EQUAL(wav.channels, 2);
+        BOOST_CHECK_EQUAL(wav.sampleRate, (uint32_t) rate);
+        BOOST_CHECK_EQUAL(wav.byteRate, (uint32_t) rate * 2 * 4);
+        BOOST_CHECK_EQUAL(wav.blockAlign, 2 * 4);
+        BOOST_CHECK_EQUAL(wav.bitsPerSample, 32);
+        BOOST_CHECK_EQUAL(wav.factFrames, wav.Frames());
+        BOOST_CHECK_EQUAL(wav.dataSize, wav.Frames() * 2 * 4);
+        //the rates are almost the same, so the length hardly changes
+        BOOST_CHECK(std::abs((long) wav.Frames() - samples) < 10);
+
+        //normalized to the peak of all the channels
+        float peak = 0;
+        for (float v : wav.samples)
+        {
+            peak = std::max(peak, std::abs(v));
+        }
+        BOOST_CHECK_CLOSE(peak, 1.0f, 1e-3);
+
+        //interleaved, the channels keep their ratio in the middle of the signal
+        size_t middle = samples / 4;
+        BOOST_CHECK(wav.Sample(middle, 0) > 0.8f);
+        BOOST_CHECK_CLOSE(wav.Sample(middle, 1) / wav.Sample(middle, 0), -0.5f, 1);
+
+        //the second receiver is shorter, it is padded with zeros
+        for (size_t f = samples * 3 / 4; f < wav.Frames(); f++)
+        {
+            BOOST_REQUIRE_EQUAL(wav.Sample(f, 1), 0.0f);
+        }
+        BOOST_CHECK(wav.Sample(wav.Frames() - 1 - samples / 8, 0) > 0.8f);
+
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_16_bit_clipping)
+    {
+        const int samples = 2000;
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("wav-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_wav_results(directory / "results.pstd", samples, 2.0f, -3.0f);
+
+        ExportWav exporter;
+        exporter.SetSampleRate(receiver_rate(file));
+        exporter.SetNormalize(false);
+        //only the second receiver
+        exporter.ExportData("audio/wav", file, (directory / "receiver.wav").string(), {1});
+
+        WavFile wav = read_wav_file(directory / "receiver.wav");
+        BOOST_CHECK_EQUAL(wav.format, 1);
+        BOOST_CHECK_EQUAL(wav.channels, 1);
+        BOOST_CHECK_EQUAL(wav.bitsPerSample, 16);
+        BOOST_CHECK_EQUAL(wav.blockAlign, 2);
+        BOOST_CHECK_EQUAL(wav.data.size(), 44 + wav.dataSize);
+        BOOST_CHECK(std::abs((long) wav.Frames() - samples / 2) < 10);
+
+        //the pressure is written directly and clipped to full scale
+        for (size_t f = samples / 8; f < samples * 3 / 8; f++)
+        {
+            BOOST_REQUIRE_EQUAL(wav.Sample(f, 0), -1.0f);
+        }
+
+        boost::filesystem::remove_all(directory);
+    }
+
+    BOOST_AUTO_TEST_CASE(test_unwritable_output)
+    {
+        boost::filesystem::path directory = boost::filesystem::temp_directory_path() /
+                                            boost::filesystem::unique_path("wav-%%%%%%%%");
+        boost::filesystem::create_directory(directory);
+        std::shared_ptr<PSTDFile> file = create_wav_results(directory / "results.pstd", 100, 0.5f, 0.5f);
+
+        ExportWav exporter;
+        BOOST_CHECK_THROW(exporter.ExportData("audio/wav", file, (directory / "missing" / "receivers.wav").string(),
+                                              {}), std::runtime_error);
+
+        boost::filesystem::remove_all(directory);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
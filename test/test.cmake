@@ -12,11 +12,22 @@ else()
     message(STATUS "Test file: ALL")
 
     # GUI test files
-    set(SOURCE_FILES_TEST ${SOURCE_FILES_TEST} test/GUI/Edges-test.cpp test/GUI/LongOperationRunner-test.cpp)
+    set(SOURCE_FILES_TEST ${SOURCE_FILES_TEST} test/GUI/Edges-test.cpp test/GUI/LongOperationRunner-test.cpp
+            test/GUI/SimulateLOperation-test.cpp)
     # Kernel test files
     set(SOURCE_FILES_TEST ${SOURCE_FILES_TEST} test/Kernel/kernel_functions.cpp
             test/Kernel/Speaker.cpp test/Kernel/Scene.cpp test/Kernel/Geometry.cpp test/Kernel/Domain.cpp
-            test/Kernel/WisdomCache.cpp)
+            test/Kernel/WisdomCache.cpp test/Kernel/Profiler.cpp test/Kernel/Tracer.cpp
+            test/Kernel/Estimator.cpp test/Kernel/Logger.cpp test/Kernel/Checkpoint.cpp
+            test/Kernel/SweepRunner.cpp test/Kernel/Partitioner.cpp test/Kernel/Transport.cpp
+            test/Kernel/DistributedSolver.cpp test/Kernel/Receiver.cpp)
+    # Shared test files
+    set(SOURCE_FILES_TEST ${SOURCE_FILES_TEST} test/Shared/CommitPolicy.cpp test/Shared/ResultsSnapshot.cpp
+            test/Shared/PSTDFile.cpp test/Shared/FrameCodec.cpp test/Shared/BoundedQueue.cpp
+            test/Shared/FrameStatistics.cpp test/Shared/ColorLUT.cpp test/Shared/FramePyramid.cpp
+            test/Shared/TimeSeriesIndex.cpp test/Shared/Resampler.cpp test/Shared/ExportVideo.cpp
+            test/Shared/HDF5Export.cpp test/Shared/Unqlite.cpp test/Shared/NpyExport.cpp
+            test/Shared/WavExport.cpp)
 endif()
 
 
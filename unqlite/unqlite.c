@@ -49785,8 +49785,10 @@ static int lhPageDefragment(lhpage *pPage)
 	lhcell *pCell;
 	/* Get a temporary page from the pager. This opertaion never fail */
 	zTmp = pEngine->pIo->xTmpPage(pEngine->pIo->pHandle);
-	/* Move the target cells to the begining */
-	pCell = pPage->pList;
+	/* Move the target cells to the begining.
+	 * Cells of slave pages are linked in the list of their master page.
+	 */
+	pCell = pPage->pMaster->pList;
 	/* Write the slave page number */
 	SyBigEndianPack64(&zTmp[2/*Offset of the first cell */+2/*Offset of the first free block */],pPage->sHdr.iSlave);
 	zPtr = &zTmp[L_HASH_PAGE_HDR_SZ]; /* Offset to start writing from */
@@ -57074,10 +57076,14 @@ static int pager_write_hot_dirty_pages(Pager *pPager,Page *pDirty)
 		}else{
 			pPager->pFirstDirty = pDirty->pDirtyPrev;
 		}
-		/* Discard */
-		pager_unlink_page(pPager,pDirty);
-		/* Release the page */
-		pager_release_page(pPager,pDirty);
+		if( pDirty->nRef < 1 ){
+			/* Discard. A page that was referenced again since it became hot is
+			 * still in use, it stays in the cache as a clean page.
+			 */
+			pager_unlink_page(pPager,pDirty);
+			/* Release the page */
+			pager_release_page(pPager,pDirty);
+		}
 		/* Next hot page */
 		pDirty = pNext;
 	}
@@ -1,4 +1,12 @@
 # Unqlite library
+#
+# unqlite/unqlite.c is UnQLite 1.1.6 (https://github.com/symisc/unqlite) with the following local patches, the
+# records they lose are reproduced by test/Shared/Unqlite.cpp:
+#  - lhPageDefragment walks the cell list of the master page. The cells of slave pages are linked in that list, the
+#    list of the slave page itself is empty, so defragmenting a slave page dropped its cells and the next records
+#    stored on that page overwrote them.
+#  - pager_write_hot_dirty_pages only releases the pages that are not referenced. Pages that were fetched again
+#    after they became hot were released while the engine still used them.
 add_library(unqlite SHARED unqlite/unqlite.c)
 
 # make sure the functions are hidden by default